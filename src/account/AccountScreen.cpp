@@ -1,9 +1,11 @@
 #include "account/AccountScreen.h"
 #include "ui/MatrixTheme.h"
+#include "ui/TextCache.h"
 #include "utils/Flash.h"
 #include <algorithm>
 #include <cstdlib>
 #include <cstdio>
+#include <cstring>
 #include <string>
 
 namespace tradeboy::account {
@@ -34,6 +36,15 @@ static bool try_parse_percent_double(const char* s, double* out) {
     return try_parse_double(buf, out);
 }
 
+// Display text derived from one input string: reformatted only when the
+// input changes, remeasured only when the font does.
+struct DerivedText {
+    std::string src;
+    tradeboy::ui::CachedText out;
+
+    bool stale(const char* s) const { return !out.valid || std::strcmp(src.c_str(), s) != 0; }
+};
+
 void render_account_screen(int selected_btn,
                            int flash_btn,
                            int flash_timer,
@@ -43,6 +54,8 @@ void render_account_screen(int selected_btn,
                            const char* hl_total_asset,
                            const char* hl_pnl_24h,
                            const char* hl_pnl_24h_pct,
+                           const char* hl_pnl_7d,
+                           const char* hl_pnl_30d,
                            const char* arb_address_short,
                            const char* arb_eth,
                            const char* arb_usdc,
@@ -129,26 +142,44 @@ void render_account_screen(int selected_btn,
             dl->AddText(font_reg, lblSz, ImVec2(bx, blockY), MatrixTheme::DIM, "24H_PNL_FLUX");
             const char* pnl_v = (hl_pnl_24h && hl_pnl_24h[0]) ? hl_pnl_24h : "UNKNOWN";
             const char* pct_v = (hl_pnl_24h_pct && hl_pnl_24h_pct[0]) ? hl_pnl_24h_pct : "UNKNOWN";
-            char pnl_buf[64];
-            char pct_buf[64];
-            bool pnl_ok = false;
-            bool pct_ok = false;
-            double pnl = 0.0;
-            double pct = 0.0;
-            if (try_parse_double(pnl_v, &pnl)) {
-                std::snprintf(pnl_buf, sizeof(pnl_buf), "%+.2f", pnl);
-                pnl_v = pnl_buf;
-                pnl_ok = true;
+            static DerivedText pnl_t;
+            static DerivedText pct_t;
+            if (pnl_t.stale(pnl_v)) {
+                pnl_t.src = pnl_v;
+                double pnl = 0.0;
+                if (try_parse_double(pnl_v, &pnl)) pnl_t.out.format(font_reg, vSz, "%+.2f", pnl);
+                else pnl_t.out.set(font_reg, vSz, pnl_v);
+            }
+            if (pct_t.stale(pct_v)) {
+                pct_t.src = pct_v;
+                double pct = 0.0;
+                if (try_parse_percent_double(pct_v, &pct)) pct_t.out.format(font_reg, vSz, "(%+.2f%%)", pct);
+                else pct_t.out.set(font_reg, vSz, pct_v);
             }
-            if (try_parse_percent_double(pct_v, &pct)) {
-                std::snprintf(pct_buf, sizeof(pct_buf), "(%+.2f%%)", pct);
-                pct_v = pct_buf;
-                pct_ok = true;
+            dl->AddText(font_reg, vSz, ImVec2(bx, blockY + lblSz + gap), MatrixTheme::TEXT, pnl_t.out.text);
+            dl->AddText(font_reg, vSz, ImVec2(bx, blockY + lblSz + gap + vSz + gap), MatrixTheme::TEXT, pct_t.out.text);
+
+            // Longer windows, right-aligned on the same two lines.
+            {
+                const float wSz = 20.0f;
+                const float rx = cx + innerP + innerW - 12.0f;
+                const char* v7 = (hl_pnl_7d && hl_pnl_7d[0]) ? hl_pnl_7d : "UNKNOWN";
+                const char* v30 = (hl_pnl_30d && hl_pnl_30d[0]) ? hl_pnl_30d : "UNKNOWN";
+                static DerivedText w7;
+                static DerivedText w30;
+                if (w7.stale(v7)) {
+                    w7.src = v7;
+                    w7.out.format(font_reg, wSz, "7D %s", v7);
+                }
+                if (w30.stale(v30)) {
+                    w30.src = v30;
+                    w30.out.format(font_reg, wSz, "30D %s", v30);
+                }
+                ImVec2 w_sz = w7.out.fit(font_reg, wSz);
+                dl->AddText(font_reg, wSz, ImVec2(rx - w_sz.x, blockY + lblSz + gap + (vSz - wSz)), MatrixTheme::DIM, w7.out.text);
+                w_sz = w30.out.fit(font_reg, wSz);
+                dl->AddText(font_reg, wSz, ImVec2(rx - w_sz.x, blockY + lblSz + gap + vSz + gap + (vSz - wSz)), MatrixTheme::DIM, w30.out.text);
             }
-            (void)pnl_ok;
-            (void)pct_ok;
-            dl->AddText(font_reg, vSz, ImVec2(bx, blockY + lblSz + gap), MatrixTheme::TEXT, pnl_v);
-            dl->AddText(font_reg, vSz, ImVec2(bx, blockY + lblSz + gap + vSz + gap), MatrixTheme::TEXT, pct_v);
             
             currY += boxH + 20.0f;
         }
@@ -162,7 +193,9 @@ void render_account_screen(int selected_btn,
 
             // Value: text-3xl -> 30px
             const char* v = (hl_usdc && hl_usdc[0]) ? hl_usdc : "UNKNOWN";
-            ImVec2 valSz = font_reg->CalcTextSizeA(26.0f, FLT_MAX, 0.0f, v);
+            static tradeboy::ui::CachedText val_t;
+            val_t.set(font_reg, 26.0f, v);
+            const ImVec2& valSz = val_t.size;
             dl->AddText(font_reg, 26.0f, ImVec2(cx + innerP + innerW - valSz.x, currY), MatrixTheme::TEXT, v);
         }
 
@@ -171,7 +204,9 @@ void render_account_screen(int selected_btn,
             currY += 40.0f;
             dl->AddText(font_reg, 26.0f, ImVec2(cx + innerP, currY), MatrixTheme::DIM, "USDC(PERP)");
             const char* v = (hl_perp_usdc && hl_perp_usdc[0]) ? hl_perp_usdc : "UNKNOWN";
-            ImVec2 valSz = font_reg->CalcTextSizeA(26.0f, FLT_MAX, 0.0f, v);
+            static tradeboy::ui::CachedText val_t;
+            val_t.set(font_reg, 26.0f, v);
+            const ImVec2& valSz = val_t.size;
             dl->AddText(font_reg, 26.0f, ImVec2(cx + innerP + innerW - valSz.x, currY), MatrixTheme::TEXT, v);
         }
 
@@ -210,8 +245,9 @@ void render_account_screen(int selected_btn,
                 dl->AddRectFilled(ImVec2(bx, btnY), ImVec2(bx + bw, btnY + btnH), btnBg, 0.0f);
                 dl->AddRect(ImVec2(bx, btnY), ImVec2(bx + bw, btnY + btnH), btnBorder, 0.0f, 0, 2.0f);
 
-                ImVec2 sz = font_bold ? font_bold->CalcTextSizeA(20.0f, FLT_MAX, 0.0f, lbl)
-                                      : (font_reg ? font_reg->CalcTextSizeA(20.0f, FLT_MAX, 0.0f, lbl) : ImGui::CalcTextSize(lbl));
+                static tradeboy::ui::CachedText lbl_t[2];
+                lbl_t[i].set(font_bold ? font_bold : font_reg, 20.0f, lbl);
+                const ImVec2& sz = lbl_t[i].size;
                 float tx = bx + (bw - sz.x) * 0.5f;
                 float ty = btnY + (btnH - sz.y) * 0.5f;
                 if (font_bold) dl->AddText(font_bold, 20.0f, ImVec2(tx, ty), btnFg, lbl);
@@ -266,11 +302,15 @@ void render_account_screen(int selected_btn,
             dl->AddRectFilled(ImVec2(rightEdge - btnSize, currY + (boxH-btnSize)*0.5f), 
                               ImVec2(rightEdge, currY + (boxH+btnSize)*0.5f), 
                               MatrixTheme::DIM, 2.0f);
-            ImVec2 xSz = ImGui::CalcTextSize("X");
+            static tradeboy::ui::CachedText x_t;
+            x_t.set(nullptr, 0.0f, "X");
+            const ImVec2& xSz = x_t.size;
             dl->AddText(ImVec2(rightEdge - btnSize + (btnSize-xSz.x)*0.5f, currY + (boxH-xSz.y)*0.5f), MatrixTheme::BLACK, "X");
             
             const char* addr = (arb_address_short && arb_address_short[0]) ? arb_address_short : "UNKNOWN";
-            ImVec2 addrSz = font_reg ? font_reg->CalcTextSizeA(20.0f, FLT_MAX, 0.0f, addr) : ImGui::CalcTextSize(addr);
+            static tradeboy::ui::CachedText addr_t;
+            addr_t.set(font_reg, 20.0f, addr);
+            const ImVec2& addrSz = addr_t.size;
             float addrX = rightEdge - btnSize - 8.0f - addrSz.x;
             dl->AddText(font_reg, 20.0f, ImVec2(addrX, currY + (boxH-addrSz.y)*0.5f), MatrixTheme::TEXT, addr);
             
@@ -278,28 +318,34 @@ void render_account_screen(int selected_btn,
         }
 
         // Assets
-        auto draw_row = [&](const char* label, const char* val) {
+        static tradeboy::ui::CachedText row_t[2];
+        auto draw_row = [&](tradeboy::ui::CachedText& val_t, const char* label, const char* val) {
             dl->AddText(font_reg, 26.0f, ImVec2(cx + innerP, currY), MatrixTheme::DIM, label);
 
-            ImVec2 valSz = font_reg ? font_reg->CalcTextSizeA(26.0f, FLT_MAX, 0.0f, val) : ImGui::CalcTextSize(val);
+            val_t.set(font_reg, 26.0f, val);
+            const ImVec2& valSz = val_t.size;
             dl->AddText(font_reg, 26.0f, ImVec2(cx + innerP + innerW - valSz.x, currY), MatrixTheme::TEXT, val);
             
             currY += 40.0f;
         };
         
-        draw_row("ETH", (arb_eth && arb_eth[0]) ? arb_eth : "UNKNOWN");
-        draw_row("USDC", (arb_usdc && arb_usdc[0]) ? arb_usdc : "UNKNOWN");
+        draw_row(row_t[0], "ETH", (arb_eth && arb_eth[0]) ? arb_eth : "UNKNOWN");
+        draw_row(row_t[1], "USDC", (arb_usdc && arb_usdc[0]) ? arb_usdc : "UNKNOWN");
         
         // GAS: default size (~14px)
         currY += 10.0f;
         const float subFont = 20.0f;
         const char* gas = (arb_gas && arb_gas[0]) ? arb_gas : "GAS: UNKNOWN";
-        ImVec2 gasSz = font_reg ? font_reg->CalcTextSizeA(subFont, FLT_MAX, 0.0f, gas) : ImGui::CalcTextSize(gas);
+        static tradeboy::ui::CachedText gas_t;
+        gas_t.set(font_reg, subFont, gas);
+        const ImVec2& gasSz = gas_t.size;
         dl->AddText(font_reg, subFont, ImVec2(cx + innerP + (innerW - gasSz.x) * 0.5f, currY), MatrixTheme::DIM, gas);
 
         currY += 22.0f;
         const char* fee = (arb_fee && arb_fee[0]) ? arb_fee : "TRANSATION FEE: $UNKNOWN";
-        ImVec2 feeSz = font_reg ? font_reg->CalcTextSizeA(subFont, FLT_MAX, 0.0f, fee) : ImGui::CalcTextSize(fee);
+        static tradeboy::ui::CachedText fee_t;
+        fee_t.set(font_reg, subFont, fee);
+        const ImVec2& feeSz = fee_t.size;
         dl->AddText(font_reg, subFont, ImVec2(cx + innerP + (innerW - feeSz.x) * 0.5f, currY), MatrixTheme::DIM, fee);
 
         // Bottom Button: <- DEPOSIT USDC
@@ -323,8 +369,9 @@ void render_account_screen(int selected_btn,
             
             const char* lbl = "<- DEPOSIT USDC";
             // Button Text (only button uses bold-italic font)
-            ImVec2 sz = font_bold ? font_bold->CalcTextSizeA(20.0f, FLT_MAX, 0.0f, lbl)
-                                  : (font_reg ? font_reg->CalcTextSizeA(20.0f, FLT_MAX, 0.0f, lbl) : ImGui::CalcTextSize(lbl));
+            static tradeboy::ui::CachedText lbl_t;
+            lbl_t.set(font_bold ? font_bold : font_reg, 20.0f, lbl);
+            const ImVec2& sz = lbl_t.size;
             
             float tx = cx + innerP + (innerW - sz.x) * 0.5f;
             float ty = btnY + (btnH - sz.y) * 0.5f;
@@ -15,6 +15,8 @@ void render_account_screen(int selected_btn,
                            const char* hl_total_asset,
                            const char* hl_pnl_24h,
                            const char* hl_pnl_24h_pct,
+                           const char* hl_pnl_7d,
+                           const char* hl_pnl_30d,
                            const char* arb_address_short,
                            const char* arb_eth,
                            const char* arb_usdc,
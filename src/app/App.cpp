@@ -1,6 +1,7 @@
 #include "app/App.h"
 
 #include <algorithm>
+#include <cctype>
 #include <cmath>
 #include <cstdio>
 #include <cstring>
@@ -14,15 +15,18 @@
 #include "../market/HyperliquidWgetDataSource.h"
 #include "../market/HyperliquidWsDataSource.h"
 #include "../model/TradeModel.h"
+#include "../model/StateCache.h"
 #include "../perp/PerpScreen.h"
 #include "../account/AccountScreen.h"
 #include "utils/File.h"
 #include "utils/Flash.h"
+#include "utils/FrameSchedule.h"
 #include "utils/Typewriter.h"
 #include "wallet/Wallet.h"
 #include "arb/ArbitrumRpc.h"
 #include "market/Hyperliquid.h"
 #include "market/HyperliquidExchange.h"
+#include "market/HyperliquidOrder.h"
 
 #include "utils/Format.h"
 
@@ -34,35 +38,17 @@
 #include "../ui/MatrixBackground.h"
 #include "../ui/MatrixTheme.h"
 #include "../ui/MainUI.h"
+#include "../ui/Sparkline.h"
+#include "../ui/FeedOverlay.h"
 
 #include "../ui/Dialog.h"
 
 namespace tradeboy::app {
 
 App::App() {
-    pthread_mutex_init(&arb_deposit_mu, nullptr);
-    pthread_mutex_init(&hl_transfer_mu, nullptr);
-    pthread_mutex_init(&hl_withdraw_mu, nullptr);
 }
 
 App::~App() {
-    pthread_mutex_destroy(&arb_deposit_mu);
-    pthread_mutex_destroy(&hl_transfer_mu);
-    pthread_mutex_destroy(&hl_withdraw_mu);
-}
-
-static void set_hl_transfer_alert(tradeboy::app::App& app, const std::string& body) {
-    pthread_mutex_lock(&app.hl_transfer_mu);
-    app.hl_transfer_alert_body = body;
-    pthread_mutex_unlock(&app.hl_transfer_mu);
-    app.hl_transfer_alert_pending.store(true);
-}
-
-static void set_hl_withdraw_alert(tradeboy::app::App& app, const std::string& body) {
-    pthread_mutex_lock(&app.hl_withdraw_mu);
-    app.hl_withdraw_alert_body = body;
-    pthread_mutex_unlock(&app.hl_withdraw_mu);
-    app.hl_withdraw_alert_pending.store(true);
 }
 
 static std::string truncate_for_alert(const std::string& s, size_t max_len) {
@@ -84,13 +70,6 @@ void App::set_alert(const std::string& body) {
     alert_dialog.open_dialog(body, 1);
 }
 
-static void set_deposit_alert(tradeboy::app::App& app, const std::string& body) {
-    pthread_mutex_lock(&app.arb_deposit_mu);
-    app.arb_deposit_alert_body = body;
-    pthread_mutex_unlock(&app.arb_deposit_mu);
-    app.arb_deposit_alert_pending.store(true);
-}
-
 static std::string trunc_2dp(double v) {
     double tv = tradeboy::utils::trunc_to_decimals(v, 2);
     char buf[64];
@@ -155,12 +134,47 @@ void App::startup() {
         }
     }
 
+    {
+        std::vector<tradeboy::model::PriceAlert> alerts;
+        for (const std::string& line : wallet_cfg.price_alerts) {
+            tradeboy::model::PriceAlert a;
+            if (tradeboy::model::parse_price_alert(line, a)) {
+                alerts.push_back(a);
+            } else {
+                log_str((std::string("[App] bad alert line: ") + line + "\n").c_str());
+            }
+        }
+        model.set_price_alerts(alerts);
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), "[App] price alerts=%d\n", (int)alerts.size());
+        log_str(buf);
+    }
+
+    {
+        // Last session's rows/balances so the first frame isn't empty; the
+        // market service reconciles them against live data as it arrives.
+        long long age_ms = 0;
+        std::string cache_err;
+        if (tradeboy::model::load_state_cache(model, tradeboy::model::kStateCachePath, age_ms, cache_err)) {
+            state_cache_loaded = true;
+            spot_row_idx = model.snapshot().spot_row_idx;
+            char buf[96];
+            std::snprintf(buf, sizeof(buf), "[App] state cache loaded age_s=%lld\n", age_ms / 1000LL);
+            log_str(buf);
+        } else {
+            log_str((std::string("[App] state cache not used: ") + cache_err + "\n").c_str());
+        }
+    }
+
+    if (!net.start()) {
+        log_str("[App] network reactor failed to start\n");
+    }
     if (!market_src) {
         log_str("[App] Market source: WS (forced)\n");
-        market_src.reset(new tradeboy::market::HyperliquidWsDataSource());
+        market_src.reset(new tradeboy::market::HyperliquidWsDataSource(net));
     }
     if (!market_service) {
-        market_service.reset(new tradeboy::market::MarketDataService(model, *market_src));
+        market_service.reset(new tradeboy::market::MarketDataService(model, *market_src, net));
     }
     if (!wallet_cfg.wallet_address.empty()) {
         market_src->set_user_address(wallet_cfg.wallet_address);
@@ -169,6 +183,7 @@ void App::startup() {
 
     if (!arb_rpc_service) {
         arb_rpc_service.reset(new tradeboy::arb::ArbitrumRpcService(model,
+                                                                    net,
                                                                     wallet_cfg.arb_rpc_url,
                                                                     wallet_cfg.wallet_address));
     } else {
@@ -176,19 +191,27 @@ void App::startup() {
     }
     arb_rpc_service->start();
     arb_rpc_last_ok = false;
+
+    if (!hl_order_client) {
+        hl_order_client.reset(new tradeboy::market::HyperliquidOrderClient());
+    }
+    {
+        const bool is_mainnet = (wallet_cfg.hl_exchange_url.find("testnet") == std::string::npos);
+        hl_order_client->configure(wallet_cfg.hl_exchange_url, is_mainnet);
+    }
+    // Deposit can sit ~90s waiting for confirmations; three workers keep an
+    // order or transfer from queueing behind it.
+    tasks.start(3);
+    // Open the /exchange connection now so the first order doesn't pay for it.
+    tasks.submit(tradeboy::core::TaskKind::Warm, [this](tradeboy::core::TaskResult&) {
+        hl_order_client->warm();
+    });
 }
 
 void App::shutdown() {
     log_str("[App] shutdown()\n");
-    if (arb_deposit_thread.joinable()) {
-        arb_deposit_thread.join();
-    }
-    if (hl_transfer_thread.joinable()) {
-        hl_transfer_thread.join();
-    }
-    if (hl_withdraw_thread.joinable()) {
-        hl_withdraw_thread.join();
-    }
+    tasks.stop();
+    hl_order_client.reset();
     if (arb_rpc_service) {
         arb_rpc_service->stop();
         arb_rpc_service.reset();
@@ -198,12 +221,137 @@ void App::shutdown() {
         market_service.reset();
     }
     market_src.reset();
+    net.stop();
+    {
+        std::string err;
+        if (tradeboy::model::save_state_cache(model, tradeboy::model::kStateCachePath, err)) {
+            log_str("[App] state cache saved\n");
+        } else {
+            log_str((std::string("[App] state cache save failed: ") + err + "\n").c_str());
+        }
+    }
 }
 
 void App::dec_frame_counter(int& v) {
     if (v > 0) v--;
 }
 
+const tradeboy::model::TradeModelSnapshot& App::spot_view_snapshot() {
+    // Version first: a change racing the copy only costs one extra copy.
+    const uint32_t ver = model.version(tradeboy::model::ModelSection::SpotRows);
+    const uint32_t sel_ver = model.version(tradeboy::model::ModelSection::SpotSelection);
+    if (ver != spot_view_ver) {
+        spot_view = model.snapshot();
+        spot_view_ver = ver;
+        spot_sel_ver = sel_ver;
+    } else if (sel_ver != spot_sel_ver) {
+        spot_view.spot_row_idx = model.spot_row_idx();
+        spot_sel_ver = sel_ver;
+    }
+    return spot_view;
+}
+
+const tradeboy::model::PerpSnapshot& App::perp_view_snapshot() {
+    const uint32_t ver = model.version(tradeboy::model::ModelSection::Perp);
+    if (ver != perp_view_ver) {
+        perp_view = model.perp_snapshot();
+        perp_view_ver = ver;
+    }
+    return perp_view;
+}
+
+const tradeboy::model::AccountSnapshot& App::account_view_snapshot() {
+    const uint32_t ver = model.version(tradeboy::model::ModelSection::Account);
+    const uint32_t arb_ver = model.version(tradeboy::model::ModelSection::Arb);
+    if (ver != account_view_ver || arb_ver != arb_view_ver) {
+        account_view = model.account_snapshot();
+        account_view_ver = ver;
+        arb_view_ver = arb_ver;
+    }
+    return account_view;
+}
+
+const AccountTexts& App::account_texts() {
+    const tradeboy::model::AccountSnapshot& account = account_view_snapshot();
+    const tradeboy::model::TradeModelSnapshot& snap = spot_view_snapshot();
+    AccountTexts& at = account_text;
+    if (at.account_ver == account_view_ver && at.arb_ver == arb_view_ver && at.spot_ver == spot_view_ver) return at;
+    at.account_ver = account_view_ver;
+    at.arb_ver = arb_view_ver;
+    at.spot_ver = spot_view_ver;
+
+    at.eth = account.arb_eth_str.empty() ? "UNKNOWN" : account.arb_eth_str;
+    at.usdc = "UNKNOWN";
+    if (!account.arb_usdc_str.empty()) {
+        double wallet_usdc = 0.0;
+        if (try_parse_double(account.arb_usdc_str, wallet_usdc)) {
+            at.usdc = trunc_2dp(wallet_usdc);
+        } else {
+            at.usdc = account.arb_usdc_str;
+        }
+    }
+    at.gas = account.arb_gas_str.empty() ? "GAS: UNKNOWN" : account.arb_gas_str;
+    const long double gas_price_wei = account.arb_gas_price_wei;
+    at.hl_usdc = account.hl_usdc_str.empty() ? "UNKNOWN" : trunc_2dp(account.hl_usdc);
+    at.hl_perp_usdc = account.hl_perp_usdc_str.empty() ? "UNKNOWN" : trunc_2dp(account.hl_perp_usdc);
+    at.hl_total_asset = account.hl_total_asset_str.empty() ? "UNKNOWN" : account.hl_total_asset_str;
+    at.hl_pnl_24h = account.hl_pnl_24h_str.empty() ? "UNKNOWN" : account.hl_pnl_24h_str;
+    at.hl_pnl_24h_pct = account.hl_pnl_24h_pct_str.empty() ? "UNKNOWN" : account.hl_pnl_24h_pct_str;
+    at.hl_pnl_7d = account.hl_pnl_7d_str.empty() ? "UNKNOWN" : account.hl_pnl_7d_str;
+    at.hl_pnl_30d = account.hl_pnl_30d_str.empty() ? "UNKNOWN" : account.hl_pnl_30d_str;
+
+    // Estimate Arbitrum USDC transfer fee in USD.
+    // Gas limit reference: 75,586
+    double eth_mid = 0.0;
+    for (const auto& r : snap.spot_rows) {
+        if (r.sym == "ETH") {
+            eth_mid = r.price;
+            break;
+        }
+    }
+
+    std::string fee_s = "TRANSATION FEE: $UNKNOWN";
+    if (gas_price_wei > 0.0L && eth_mid > 0.0) {
+        const long double gas_limit = 75586.0L;
+        long double fee_eth = (gas_price_wei * gas_limit) / 1000000000000000000.0L;
+        long double fee_usd = fee_eth * (long double)eth_mid;
+        // 4 decimals
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), "TRANSATION FEE: $%.4Lf", fee_usd);
+        fee_s = buf;
+    }
+    arb_tx_fee_str = fee_s;
+    return at;
+}
+
+void App::open_price_alert() {
+    tradeboy::model::TradeModelSnapshot snap = model.snapshot();
+    if (spot_row_idx < 0 || spot_row_idx >= (int)snap.spot_rows.size()) return;
+    const auto& row = snap.spot_rows[(size_t)spot_row_idx];
+    if (!(row.price > 0.0)) {
+        set_alert("Loading market data\nPlease wait...");
+        return;
+    }
+
+    price_alert_coin = row.sym;
+    price_alert_ref_px = row.price;
+
+    const int decimals = std::max(0, std::min(8, row.price_decimals));
+    char px_buf[64];
+    std::snprintf(px_buf, sizeof(px_buf), "NOW: $%.*f", decimals, row.price);
+
+    tradeboy::ui::NumberInputConfig cfg;
+    cfg.title = "ALERT " + row.sym;
+    cfg.title_color = MatrixTheme::TEXT;
+    cfg.min_value = std::pow(10.0, -decimals);
+    cfg.max_value = row.price * 100.0;
+    cfg.allowed_decimals = decimals;
+    cfg.available_label = "USD";
+    cfg.price_label = px_buf;
+    cfg.show_available_panel = false;
+    price_alert_amount.open_with(cfg);
+}
+
 void App::open_spot_order(bool buy) {
     tradeboy::model::TradeModelSnapshot snap = model.snapshot();
     if (snap.spot_rows.empty()) return;
@@ -228,7 +376,148 @@ void App::open_spot_order(bool buy) {
     }
 
     tradeboy::spotOrder::Side side = buy ? tradeboy::spotOrder::Side::Buy : tradeboy::spotOrder::Side::Sell;
-    spot_order.open_with(row, side, maxv);
+    follow_focus_coin(row);
+    spot_order.open_with(row, side, maxv, [this, buy](double amount, double& out_px) -> bool {
+        if (!market_src || !market_src->fetch_l2_book(l2_book_view, l2_book_view_ms)) return false;
+        double filled = 0.0;
+        return l2_book_view.vwap_for_size(buy, amount, out_px, filled);
+    });
+    spot_order.input_state.config.flow_text = trade_flow_text;
+
+    // Sign the preset sizes while the user is still choosing an amount.
+    if (hl_order_client) {
+        const tradeboy::model::WalletSnapshot w = model.wallet_snapshot();
+        if (!w.wallet_address.empty() && !w.private_key.empty()) {
+            tradeboy::market::OrderPrepareRequest req;
+            req.wallet_address_0x = w.wallet_address;
+            req.private_key_hex = w.private_key;
+            req.asset = row.asset_id;
+            req.is_buy = buy;
+            req.mid = row.price;
+            req.sz_decimals = row.sz_decimals;
+            req.max_size = maxv;
+            tradeboy::market::OrderPrepareJob job;
+            if (hl_order_client->begin_prepare(req, job)) {
+                // Deduped: a warm already waiting on the connection covers it.
+                tasks.submit(tradeboy::core::TaskKind::Warm, [this](tradeboy::core::TaskResult&) {
+                    hl_order_client->warm();
+                });
+                tasks.enqueue(tradeboy::core::TaskKind::Prepare, [this, job](tradeboy::core::TaskResult&) {
+                    hl_order_client->run_prepare(job);
+                });
+            }
+        }
+    }
+}
+
+void App::follow_focus_coin(const tradeboy::model::SpotRow& row) {
+    if (!market_src || row.asset_id == focus_asset_id) return;
+    focus_asset_id = row.asset_id;
+    char coin[32];
+    tradeboy::market::l2_spot_coin_for_asset(row.asset_id, coin, sizeof(coin));
+    market_src->set_focus_coin(coin, row.coin);
+    trade_flow.reset(coin);
+    trade_flow_text[0] = 0;
+    if (market_service) market_service->request_candle_history(row.coin);
+}
+
+void App::follow_visible_perps(const tradeboy::model::PerpSnapshot& snap) {
+    if (!market_src) return;
+    const int kPerpPageRows = 7;
+    std::vector<std::string> coins;
+    for (int i = perp_page_start_idx; i < perp_page_start_idx + kPerpPageRows && i < (int)snap.rows.size(); i++) {
+        if (i >= 0) coins.push_back(snap.rows[(size_t)i].name);
+    }
+    for (const auto& p : snap.positions) coins.push_back(p.coin);
+    std::sort(coins.begin(), coins.end());
+    coins.erase(std::unique(coins.begin(), coins.end()), coins.end());
+    if (coins == perp_streamed_coins) return;
+    perp_streamed_coins.swap(coins);
+    market_src->set_perp_ctx_coins(perp_streamed_coins);
+}
+
+void App::follow_tab_streams() {
+    if (!market_src) return;
+    if (tab != Tab::Spot && focus_asset_id >= 0) {
+        focus_asset_id = -1;
+        market_src->set_focus_coin("", "");
+    }
+    if (tab != Tab::Perp && !perp_streamed_coins.empty()) {
+        perp_streamed_coins.clear();
+        market_src->set_perp_ctx_coins(perp_streamed_coins);
+    }
+}
+
+static void format_usd_compact(double v, char* out, size_t cap) {
+    if (v >= 1e6) {
+        std::snprintf(out, cap, "$%.1fM", v / 1e6);
+    } else if (v >= 1e3) {
+        std::snprintf(out, cap, "$%.1fK", v / 1e3);
+    } else {
+        std::snprintf(out, cap, "$%.0f", v);
+    }
+}
+
+void App::drain_trade_tape() {
+    if (!market_src || focus_asset_id < 0) return;
+
+    bool changed = false;
+    bool drained = false;
+    tradeboy::market::TradePrint batch[32];
+    size_t n = 0;
+    while ((n = market_src->drain_trades(batch, sizeof(batch) / sizeof(batch[0]))) > 0) {
+        drained = true;
+        for (size_t i = 0; i < n; i++) {
+            if (trade_flow.add(batch[i])) changed = true;
+        }
+    }
+    if (drained) tradeboy::market::feed_stats().on_published(tradeboy::market::Feed::Trades);
+    const long long now_ms = (long long)std::chrono::duration_cast<std::chrono::milliseconds>(
+                                 std::chrono::system_clock::now().time_since_epoch())
+                                 .count();
+    if (trade_flow.advance(now_ms)) changed = true;
+    if (!changed) return;
+
+    if (trade_flow.trades <= 0) {
+        std::snprintf(trade_flow_text, sizeof(trade_flow_text), "1M: NO TRADES");
+        return;
+    }
+    char vol[24];
+    format_usd_compact(trade_flow.volume(), vol, sizeof(vol));
+    const int buy_pct = (int)((trade_flow.imbalance() + 1.0) * 50.0 + 0.5);
+    std::snprintf(trade_flow_text,
+                  sizeof(trade_flow_text),
+                  "1M VOL %s\nBUY %d%% LAST %s",
+                  vol,
+                  buy_pct,
+                  trade_flow.last_dir > 0 ? "B" : "S");
+}
+
+void App::apply_perp_ui_events(const std::vector<tradeboy::spot::SpotUiEvent>& ev) {
+    const int kPerpPageRows = 7;
+    for (const auto& e : ev) {
+        if (e.type != tradeboy::spot::SpotUiEventType::RowDelta && e.type != tradeboy::spot::SpotUiEventType::PageDelta) {
+            continue;
+        }
+        const int n = (int)model.perp_snapshot().rows.size();
+        if (n <= 0) {
+            perp_row_idx = 0;
+            perp_page_start_idx = 0;
+            continue;
+        }
+        const int max_start = std::max(0, n - kPerpPageRows);
+        if (e.type == tradeboy::spot::SpotUiEventType::RowDelta) {
+            perp_row_idx = std::max(0, std::min(n - 1, perp_row_idx + (e.value > 0 ? 1 : -1)));
+        } else {
+            const int offset_in_page = std::max(0, std::min(kPerpPageRows - 1, perp_row_idx - perp_page_start_idx));
+            perp_page_start_idx = std::max(0, std::min(max_start, perp_page_start_idx + (e.value > 0 ? kPerpPageRows : -kPerpPageRows)));
+            perp_row_idx = std::max(0, std::min(n - 1, perp_page_start_idx + offset_in_page));
+        }
+        if (perp_row_idx < perp_page_start_idx) perp_page_start_idx = perp_row_idx;
+        if (perp_row_idx >= perp_page_start_idx + kPerpPageRows) perp_page_start_idx = perp_row_idx - kPerpPageRows + 1;
+        perp_page_start_idx = std::max(0, std::min(max_start, perp_page_start_idx));
+        model.set_perp_row_idx(perp_row_idx);
+    }
 }
 
 void App::apply_spot_ui_events(const std::vector<tradeboy::spot::SpotUiEvent>& ev) {
@@ -237,8 +526,7 @@ void App::apply_spot_ui_events(const std::vector<tradeboy::spot::SpotUiEvent>& e
         switch (e.type) {
             case tradeboy::spot::SpotUiEventType::RowDelta:
                 {
-                    tradeboy::model::TradeModelSnapshot s = model.snapshot();
-                    const int n = (int)s.spot_rows.size();
+                    const int n = model.spot_row_count();
                     if (n <= 0) {
                         spot_row_idx = 0;
                         spot_page_start_idx = 0;
@@ -278,9 +566,8 @@ void App::apply_spot_ui_events(const std::vector<tradeboy::spot::SpotUiEvent>& e
 
                     model.set_spot_row_idx(spot_row_idx);
                     {
-                        tradeboy::model::TradeModelSnapshot s2 = model.snapshot();
-                        spot_row_idx = s2.spot_row_idx;
-                        const int n2 = (int)s2.spot_rows.size();
+                        spot_row_idx = model.spot_row_idx();
+                        const int n2 = model.spot_row_count();
                         const int max_start2 = std::max(0, n2 - kSpotPageRows);
                         spot_page_start_idx = std::max(0, std::min(max_start2, spot_page_start_idx));
                         // Ensure selected row stays visible.
@@ -293,8 +580,7 @@ void App::apply_spot_ui_events(const std::vector<tradeboy::spot::SpotUiEvent>& e
                 }
                 break;
             case tradeboy::spot::SpotUiEventType::PageDelta: {
-                tradeboy::model::TradeModelSnapshot s = model.snapshot();
-                const int n = (int)s.spot_rows.size();
+                const int n = model.spot_row_count();
                 if (n <= 0) {
                     spot_row_idx = 0;
                     spot_page_start_idx = 0;
@@ -315,10 +601,7 @@ void App::apply_spot_ui_events(const std::vector<tradeboy::spot::SpotUiEvent>& e
 
                 spot_row_idx = std::max(0, std::min(n - 1, spot_page_start_idx + offset_in_page));
                 model.set_spot_row_idx(spot_row_idx);
-                {
-                    tradeboy::model::TradeModelSnapshot s2 = model.snapshot();
-                    spot_row_idx = s2.spot_row_idx;
-                }
+                spot_row_idx = model.spot_row_idx();
             } break;
             case tradeboy::spot::SpotUiEventType::EnterActionFocus:
                 spot_action_focus = true;
@@ -341,7 +624,115 @@ void App::apply_spot_ui_events(const std::vector<tradeboy::spot::SpotUiEvent>& e
     }
 }
 
+void App::refresh_spot_index() {
+    const tradeboy::model::TradeModelSnapshot& snap = spot_view_snapshot();
+    if (spot_view_ver == spot_index_ver) return;
+    spot_index.update(snap.spot_rows);
+    spot_index_ver = spot_view_ver;
+}
+
+void App::spot_search_range(int& lo, int& hi) {
+    refresh_spot_index();
+    spot_index.find(spot_search_query.c_str(), lo, hi);
+}
+
+void App::open_spot_search() {
+    const tradeboy::model::TradeModelSnapshot& snap = spot_view_snapshot();
+    spot_search_open = true;
+    spot_search_prefix.clear();
+    spot_search_letter = 0;
+    spot_search_row = 0;
+    spot_search_page = 0;
+    // Start on the first letter of the selected coin.
+    if (spot_row_idx >= 0 && spot_row_idx < (int)snap.spot_rows.size()) {
+        const std::string& sym = snap.spot_rows[(size_t)spot_row_idx].sym;
+        const char c = sym.empty() ? 0 : (char)std::toupper((unsigned char)sym[0]);
+        const char* hit = c ? std::strchr(tradeboy::spot::kSearchAlphabet, c) : nullptr;
+        if (hit) spot_search_letter = (int)(hit - tradeboy::spot::kSearchAlphabet);
+    }
+    spot_search_query = spot_search_prefix + tradeboy::spot::kSearchAlphabet[spot_search_letter];
+}
+
+void App::close_spot_search(bool accept) {
+    spot_search_open = false;
+    if (!accept) return;
+    int lo = 0;
+    int hi = 0;
+    spot_search_range(lo, hi);
+    if (lo >= hi) return;
+    const int kSpotPageRows = 7;
+    const int pick = lo + std::max(0, std::min(hi - lo - 1, spot_search_row));
+    model.set_spot_row_idx(spot_index.order()[(size_t)pick]);
+    spot_row_idx = model.spot_row_idx();
+    const int n = model.spot_row_count();
+    const int max_start = std::max(0, n - kSpotPageRows);
+    spot_page_start_idx = std::max(0, std::min(max_start, spot_row_idx - kSpotPageRows / 2));
+}
+
+void App::handle_spot_search_input(const tradeboy::app::InputState& in, const tradeboy::app::EdgeState& edges) {
+    if (tradeboy::utils::pressed(in.b, edges.prev.b) || tradeboy::utils::pressed(in.y, edges.prev.y)) {
+        close_spot_search(false);
+        return;
+    }
+
+    const int kSpotPageRows = 7;
+    const int alpha_n = tradeboy::spot::kSearchAlphabetLen;
+    std::vector<tradeboy::spot::SpotUiEvent> ev = tradeboy::spot::collect_spot_ui_events(in, edges, tradeboy::spot::SpotUiState());
+    for (const auto& e : ev) {
+        switch (e.type) {
+            case tradeboy::spot::SpotUiEventType::RowDelta: {
+                // Step to the next letter that still matches something, so
+                // up/down jump straight between the symbols that exist.
+                refresh_spot_index();
+                int letter = spot_search_letter;
+                for (int tries = 0; tries < alpha_n; tries++) {
+                    letter = (letter + e.value + alpha_n) % alpha_n;
+                    int lo = 0;
+                    int hi = 0;
+                    const std::string q = spot_search_prefix + tradeboy::spot::kSearchAlphabet[letter];
+                    spot_index.find(q.c_str(), lo, hi);
+                    if (hi > lo) break;
+                }
+                spot_search_letter = letter;
+                spot_search_row = 0;
+                spot_search_page = 0;
+            } break;
+            case tradeboy::spot::SpotUiEventType::PageDelta: {
+                int lo = 0;
+                int hi = 0;
+                spot_search_range(lo, hi);
+                const int n = hi - lo;
+                spot_search_row = std::max(0, std::min(n - 1, spot_search_row + e.value));
+                if (spot_search_row < spot_search_page) spot_search_page = spot_search_row;
+                if (spot_search_row >= spot_search_page + kSpotPageRows) spot_search_page = spot_search_row - kSpotPageRows + 1;
+            } break;
+            case tradeboy::spot::SpotUiEventType::EnterActionFocus:
+                if (e.value == 0) {
+                    // Left: take the last placed letter back into the picker.
+                    if (!spot_search_prefix.empty()) {
+                        const char* hit = std::strchr(tradeboy::spot::kSearchAlphabet, spot_search_prefix.back());
+                        spot_search_letter = hit ? (int)(hit - tradeboy::spot::kSearchAlphabet) : 0;
+                        spot_search_prefix.pop_back();
+                    }
+                } else {
+                    spot_search_prefix.push_back(tradeboy::spot::kSearchAlphabet[spot_search_letter]);
+                    spot_search_letter = 0;
+                }
+                spot_search_row = 0;
+                spot_search_page = 0;
+                break;
+            case tradeboy::spot::SpotUiEventType::TriggerAction:
+                close_spot_search(true);
+                return;
+            default:
+                break;
+        }
+        spot_search_query = spot_search_prefix + tradeboy::spot::kSearchAlphabet[spot_search_letter];
+    }
+}
+
 void App::handle_input_edges(const tradeboy::app::InputState& in, const tradeboy::app::EdgeState& edges) {
+    nav_key_held = in.up || in.down;
     if (quit_requested) return;
 
     if (exit_poweroff_anim_active) {
@@ -406,6 +797,11 @@ void App::handle_input_edges(const tradeboy::app::InputState& in, const tradeboy
         return;
     }
 
+    // Global L2: feed latency overlay (debug); doesn't consume the frame.
+    if (tradeboy::utils::pressed(in.l2, edges.prev.l2)) {
+        feed_overlay = !feed_overlay;
+    }
+
     // Global M: open exit modal (even if other modals are open).
     if (tradeboy::utils::pressed(in.m, edges.prev.m)) {
         // Close any lower-priority modals to avoid state conflicts under the exit dialog.
@@ -414,6 +810,7 @@ void App::handle_input_edges(const tradeboy::app::InputState& in, const tradeboy
         internal_transfer_amount.close_with_result(tradeboy::ui::NumberInputResult::Cancelled, 0.0);
         withdraw_amount.close_with_result(tradeboy::ui::NumberInputResult::Cancelled, 0.0);
         deposit_amount.close_with_result(tradeboy::ui::NumberInputResult::Cancelled, 0.0);
+        price_alert_amount.close_with_result(tradeboy::ui::NumberInputResult::Cancelled, 0.0);
         internal_transfer_pending_dir = -1;
 
         exit_dialog.open_dialog("", 1);
@@ -433,6 +830,10 @@ void App::handle_input_edges(const tradeboy::app::InputState& in, const tradeboy
         return;
     }
 
+    if (tradeboy::ui::handle_input(price_alert_amount, in, edges)) {
+        return;
+    }
+
     if (tradeboy::spotOrder::handle_input(spot_order, in, edges)) {
         return;
     }
@@ -487,6 +888,19 @@ void App::handle_input_edges(const tradeboy::app::InputState& in, const tradeboy
     r1_btn_held = in.r1;
 
     if (tab == Tab::Spot) {
+        if (spot_search_open) {
+            handle_spot_search_input(in, edges);
+            return;
+        }
+        if (!spot_action_focus && tradeboy::utils::pressed(in.y, edges.prev.y)) {
+            open_spot_search();
+            return;
+        }
+        if (!spot_action_focus && tradeboy::utils::pressed(in.x, edges.prev.x)) {
+            open_price_alert();
+            return;
+        }
+
         tradeboy::spot::SpotUiState ui;
         ui.spot_action_focus = spot_action_focus;
         ui.spot_action_idx = spot_action_idx;
@@ -495,6 +909,10 @@ void App::handle_input_edges(const tradeboy::app::InputState& in, const tradeboy
 
         std::vector<tradeboy::spot::SpotUiEvent> ev = tradeboy::spot::collect_spot_ui_events(in, edges, ui);
         apply_spot_ui_events(ev);
+    } else if (tab == Tab::Perp) {
+        // Same row/page navigation as spot; perp has no actions yet.
+        std::vector<tradeboy::spot::SpotUiEvent> ev = tradeboy::spot::collect_spot_ui_events(in, edges, tradeboy::spot::SpotUiState());
+        apply_perp_ui_events(ev);
     } else if (tab == Tab::Account) {
         if (tradeboy::utils::pressed(in.x, edges.prev.x)) {
             account_address_dialog.open_dialog("", 1);
@@ -517,6 +935,9 @@ void App::handle_input_edges(const tradeboy::app::InputState& in, const tradeboy
 }
 
 void App::render() {
+    follow_tab_streams();
+    drain_trade_tape();
+
     // Process triggers
     if (buy_trigger_frames > 0) {
         buy_trigger_frames--;
@@ -604,12 +1025,11 @@ void App::render() {
         withdraw_amount.result_value = 0.0;
 
         if (res == tradeboy::ui::NumberInputResult::Confirmed) {
-            if (hl_withdraw_inflight.exchange(true)) {
+            if (tasks.busy(tradeboy::core::TaskKind::Withdraw)) {
                 set_alert("WITHDRAW_BUSY\nPLEASE_WAIT");
             } else {
                 const tradeboy::model::WalletSnapshot w = model.wallet_snapshot();
                 if (w.wallet_address.empty() || w.private_key.empty()) {
-                    hl_withdraw_inflight.store(false);
                     set_alert("WITHDRAW_FAILED\nMISSING_WALLET");
                 } else {
                     const unsigned long long nonce_ms = (unsigned long long)std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -620,11 +1040,7 @@ void App::render() {
 
                     set_alert("WITHDRAW_SUBMITTED\nPlease wait...");
 
-                    if (hl_withdraw_thread.joinable()) {
-                        hl_withdraw_thread.join();
-                    }
-
-                    hl_withdraw_thread = std::thread([this, w, dest, amt_s, nonce_ms]() {
+                    tasks.submit(tradeboy::core::TaskKind::Withdraw, [w, dest, amt_s, nonce_ms](tradeboy::core::TaskResult& out) {
                         std::string resp;
                         std::string err;
                         bool ok = tradeboy::market::exchange_withdraw3(
@@ -637,11 +1053,11 @@ void App::render() {
                             resp,
                             err);
 
+                        out.ok = ok;
                         if (ok) {
-                            hl_transfer_refresh_requested.store(true);
-                            set_hl_withdraw_alert(*this,
-                                                  std::string("WITHDRAW_OK\n") + truncate_for_alert(resp, 220) +
-                                                      "\nMay take a few minutes to arrive.");
+                            out.refresh_user = true;
+                            out.body = std::string("WITHDRAW_OK\n") + truncate_for_alert(resp, 220) +
+                                       "\nMay take a few minutes to arrive.";
                         } else {
                             std::string body = "WITHDRAW_FAILED\n";
                             if (!err.empty()) body += err;
@@ -650,16 +1066,42 @@ void App::render() {
                                 body += "\n";
                                 body += truncate_for_alert(resp, 220);
                             }
-                            set_hl_withdraw_alert(*this, body);
+                            out.body = body;
                         }
-
-                        hl_withdraw_inflight.store(false);
                     });
                 }
             }
         }
     }
 
+    if (price_alert_amount.result != tradeboy::ui::NumberInputResult::None) {
+        tradeboy::ui::NumberInputResult res = price_alert_amount.result;
+        double val = price_alert_amount.result_value;
+        price_alert_amount.result = tradeboy::ui::NumberInputResult::None;
+        price_alert_amount.result_value = 0.0;
+
+        if (res == tradeboy::ui::NumberInputResult::Confirmed && val > 0.0 && !price_alert_coin.empty()) {
+            tradeboy::model::PriceAlert a;
+            a.coin = price_alert_coin;
+            a.kind = (val >= price_alert_ref_px) ? tradeboy::model::PriceAlertKind::Above : tradeboy::model::PriceAlertKind::Below;
+            a.value = val;
+
+            std::vector<tradeboy::model::PriceAlert> alerts = model.price_alerts();
+            alerts.push_back(a);
+            model.set_price_alerts(alerts);
+
+            std::vector<std::string> lines;
+            for (const auto& x : alerts) lines.push_back(tradeboy::model::format_price_alert(x));
+            std::string save_err;
+            if (tradeboy::wallet::save_price_alerts("./tradeboy.cfg", lines, save_err)) {
+                wallet_cfg.price_alerts = lines;
+                set_alert(std::string("ALERT_SET\n") + tradeboy::model::describe_price_alert(a));
+            } else {
+                set_alert(std::string("ALERT_NOT_SAVED\n") + save_err);
+            }
+        }
+    }
+
     if (deposit_amount.result != tradeboy::ui::NumberInputResult::None) {
         tradeboy::ui::NumberInputResult res = deposit_amount.result;
         double val = deposit_amount.result_value;
@@ -667,19 +1109,14 @@ void App::render() {
         deposit_amount.result_value = 0.0;
 
         if (res == tradeboy::ui::NumberInputResult::Confirmed) {
-            if (arb_deposit_inflight.exchange(true)) {
+            if (tasks.busy(tradeboy::core::TaskKind::Deposit)) {
                 set_alert("DEPOSIT_BUSY\nPLEASE_WAIT");
             } else {
                 const tradeboy::model::WalletSnapshot w = model.wallet_snapshot();
                 const std::string rpc_url = wallet_cfg.arb_rpc_url;
                 if (rpc_url.empty() || w.wallet_address.empty() || w.private_key.empty()) {
                     set_alert_static(*this, "DEPOSIT_FAILED\nMISSING_WALLET");
-                    arb_deposit_inflight.store(false);
                 } else {
-                    if (arb_deposit_thread.joinable()) {
-                        arb_deposit_thread.join();
-                    }
-
                     const unsigned long long cents = (unsigned long long)(val * 100.0 + 1e-6);
                     const unsigned long long amount_micro = cents * 10000ULL; // USDC has 6 decimals
                     const std::string to_addr = "0x2Df1c51E09aECF9cacB7bc98cB1742757f163dF7";
@@ -698,8 +1135,8 @@ void App::render() {
 
                     set_alert("DEPOSIT_SUBMITTED\nPlease wait...");
 
-                    arb_deposit_thread = std::thread([this, rpc_url, w, to_addr, amount_micro]() {
-                        log_str("[HLD] deposit thread start\n");
+                    tasks.submit(tradeboy::core::TaskKind::Deposit, [rpc_url, w, to_addr, amount_micro](tradeboy::core::TaskResult& out) {
+                        log_str("[HLD] deposit task start\n");
 
                         std::string txh;
                         std::string err;
@@ -710,15 +1147,15 @@ void App::render() {
                                                                          amount_micro,
                                                                          txh,
                                                                          err);
+                        out.ok = ok;
                         if (ok) {
                             log_str("[HLD] deposit broadcast ok\n");
                             std::string cerr;
                             bool conf_ok = tradeboy::arb::wait_tx_confirmations(rpc_url, txh, 1, 90000, cerr);
                             if (conf_ok) {
                                 log_str("[HLD] deposit confirmed\n");
-                                set_deposit_alert(*this,
-                                                  std::string("DEPOSIT_OK\n") + txh +
-                                                      "\nDeposit should arrive within 1 minute.");
+                                out.body = std::string("DEPOSIT_OK\n") + txh +
+                                           "\nDeposit should arrive within 1 minute.";
                             } else {
                                 {
                                     char buf[256];
@@ -733,14 +1170,13 @@ void App::render() {
                                 body += (cerr.empty() ? "CONFIRM_FAILED" : cerr);
                                 body += "\n";
                                 body += txh;
-                                set_deposit_alert(*this, body);
+                                out.ok = false;
+                                out.body = body;
                             }
                         } else {
                             log_str("[HLD] deposit failed\n");
-                            set_deposit_alert(*this, std::string("DEPOSIT_FAILED\n") + err);
+                            out.body = std::string("DEPOSIT_FAILED\n") + err;
                         }
-
-                        arb_deposit_inflight.store(false);
                     });
                 }
             }
@@ -805,89 +1241,81 @@ void App::render() {
     }
 
     // Main header for top-level tabs (Spot/Perp/Account)
-    if (!spot_order.open() && !internal_transfer_amount.open && !withdraw_amount.open && !deposit_amount.open) {
+    if (!spot_order.open() && !internal_transfer_amount.open && !withdraw_amount.open && !deposit_amount.open && !price_alert_amount.open) {
         tradeboy::ui::render_main_header(tab, l1_flash, r1_flash, font_bold);
     }
 
     // Spot page now uses the new UI demo layout. Data layer is intentionally
     // not connected yet (render uses mock data only).
     // Hide base pages while an input modal is open to avoid overlap.
-    if (!spot_order.open() && !internal_transfer_amount.open && !withdraw_amount.open && !deposit_amount.open) {
+    if (!spot_order.open() && !internal_transfer_amount.open && !withdraw_amount.open && !deposit_amount.open && !price_alert_amount.open) {
         if (tab == Tab::Spot) {
-            tradeboy::model::TradeModelSnapshot snap = model.snapshot();
+            const tradeboy::model::TradeModelSnapshot& snap = spot_view_snapshot();
             spot_row_idx = snap.spot_row_idx;
+            if (!snap.spot_rows.empty()) first_useful_frame = true;
+            if (spot_row_idx >= 0 && spot_row_idx < (int)snap.spot_rows.size()) {
+                follow_focus_coin(snap.spot_rows[(size_t)spot_row_idx]);
+            }
+            tradeboy::spot::SpotSearchView search;
+            if (spot_search_open) {
+                int lo = 0;
+                int hi = 0;
+                spot_search_range(lo, hi);
+                search.order = spot_index.order().data() + lo;
+                search.count = hi - lo;
+                search.prefix = spot_search_prefix.c_str();
+                search.pending = tradeboy::spot::kSearchAlphabet[spot_search_letter];
+            }
             tradeboy::spot::render_spot_screen(
                 snap.spot_rows,
-                spot_page_start_idx,
-                spot_row_idx,
+                spot_search_open ? spot_search_page : spot_page_start_idx,
+                spot_search_open ? spot_search_row : spot_row_idx,
                 spot_action_idx,
                 buy_flash,
                 sell_flash,
                 font_bold,
                 action_btn_held,
                 l1_btn_held,
-                r1_btn_held);
+                r1_btn_held,
+                trade_flow_text,
+                [this, &snap](ImDrawList* dl, const ImVec2& a, const ImVec2& b, ImU32 col) {
+                    // The highlighted match is not the followed coin while searching.
+                    if (spot_search_open) return;
+                    if (spot_row_idx < 0 || spot_row_idx >= (int)snap.spot_rows.size()) return;
+                    model.read_candles(snap.spot_rows[(size_t)spot_row_idx].coin,
+                                       tradeboy::model::CandleRes::M1,
+                                       [&](const tradeboy::model::CandleRing& ring) {
+                                           tradeboy::ui::render_candle_sparkline(dl, ring, a, b, col);
+                                       });
+                });
         } else if (tab == Tab::Perp) {
-            tradeboy::perp::render_perp_screen(font_bold);
+            const tradeboy::model::PerpSnapshot& snap = perp_view_snapshot();
+            perp_row_idx = snap.perp_row_idx;
+            // Follow the selection when a re-sort moved it off the page.
+            const int kPerpPageRows = 7;
+            if (perp_row_idx < perp_page_start_idx) perp_page_start_idx = perp_row_idx;
+            if (perp_row_idx >= perp_page_start_idx + kPerpPageRows) perp_page_start_idx = perp_row_idx - kPerpPageRows + 1;
+            follow_visible_perps(snap);
+            tradeboy::perp::render_perp_screen(snap.rows, perp_page_start_idx, perp_row_idx, snap.positions, snap.account, font_bold);
         } else {
-            tradeboy::model::AccountSnapshot account = model.account_snapshot();
-            const std::string eth_s = account.arb_eth_str.empty() ? "UNKNOWN" : account.arb_eth_str;
-            std::string usdc_s = "UNKNOWN";
-            if (!account.arb_usdc_str.empty()) {
-                double wallet_usdc = 0.0;
-                if (try_parse_double(account.arb_usdc_str, wallet_usdc)) {
-                    usdc_s = trunc_2dp(wallet_usdc);
-                } else {
-                    usdc_s = account.arb_usdc_str;
-                }
-            }
-            const std::string gas_s = account.arb_gas_str.empty() ? "GAS: UNKNOWN" : account.arb_gas_str;
-            const long double gas_price_wei = account.arb_gas_price_wei;
-            const std::string hl_usdc_s = account.hl_usdc_str.empty() ? "UNKNOWN" : trunc_2dp(account.hl_usdc);
-            const std::string hl_perp_usdc_s = account.hl_perp_usdc_str.empty() ? "UNKNOWN" : trunc_2dp(account.hl_perp_usdc);
-            const std::string hl_total_asset_s = account.hl_total_asset_str.empty() ? "UNKNOWN" : account.hl_total_asset_str;
-            const std::string hl_pnl_24h_s = account.hl_pnl_24h_str.empty() ? "UNKNOWN" : account.hl_pnl_24h_str;
-            const std::string hl_pnl_24h_pct_s = account.hl_pnl_24h_pct_str.empty() ? "UNKNOWN" : account.hl_pnl_24h_pct_str;
-
-            // Estimate Arbitrum USDC transfer fee in USD.
-            // Gas limit reference: 75,586
-            double eth_mid = 0.0;
-            {
-                tradeboy::model::TradeModelSnapshot snap = model.snapshot();
-                for (const auto& r : snap.spot_rows) {
-                    if (r.sym == "ETH") {
-                        eth_mid = r.price;
-                        break;
-                    }
-                }
-            }
-
-            std::string fee_s = "TRANSATION FEE: $UNKNOWN";
-            if (gas_price_wei > 0.0L && eth_mid > 0.0) {
-                const long double gas_limit = 75586.0L;
-                long double fee_eth = (gas_price_wei * gas_limit) / 1000000000000000000.0L;
-                long double fee_usd = fee_eth * (long double)eth_mid;
-                // 4 decimals
-                char buf[64];
-                std::snprintf(buf, sizeof(buf), "TRANSATION FEE: $%.4Lf", fee_usd);
-                fee_s = buf;
-            }
-            arb_tx_fee_str = fee_s;
+            const AccountTexts& at = account_texts();
 
             tradeboy::account::render_account_screen(
                 account_selected_btn,
                 account_flash_btn,
                 account_flash_timer,
                 font_bold,
-                hl_usdc_s.c_str(),
-                hl_perp_usdc_s.c_str(),
-                hl_total_asset_s.c_str(),
-                hl_pnl_24h_s.c_str(),
-                hl_pnl_24h_pct_s.c_str(),
+                at.hl_usdc.c_str(),
+                at.hl_perp_usdc.c_str(),
+                at.hl_total_asset.c_str(),
+                at.hl_pnl_24h.c_str(),
+                at.hl_pnl_24h_pct.c_str(),
+                at.hl_pnl_7d.c_str(),
+                at.hl_pnl_30d.c_str(),
                 wallet_address_short.c_str(),
-                eth_s.c_str(),
-                usdc_s.c_str(),
-                gas_s.c_str(),
+                at.eth.c_str(),
+                at.usdc.c_str(),
+                at.gas.c_str(),
                 arb_tx_fee_str.c_str()
             );
         }
@@ -900,6 +1328,7 @@ void App::render() {
     tradeboy::ui::render(internal_transfer_amount, font_bold);
     tradeboy::ui::render(withdraw_amount, font_bold);
     tradeboy::ui::render(deposit_amount, font_bold);
+    tradeboy::ui::render(price_alert_amount, font_bold);
     tradeboy::spotOrder::render(spot_order, font_bold);
 
     if (internal_transfer_amount.result != tradeboy::ui::NumberInputResult::None) {
@@ -913,7 +1342,7 @@ void App::render() {
                 set_alert("TRANSFER_FAILED\nUNKNOWN_DIRECTION");
             } else if (val < 0.000001) {
                 set_alert("TRANSFER_FAILED\nAMOUNT_TOO_SMALL");
-            } else if (hl_transfer_inflight.exchange(true)) {
+            } else if (tasks.busy(tradeboy::core::TaskKind::Transfer)) {
                 set_alert("TRANSFER_BUSY\nPLEASE_WAIT");
             } else {
                 const bool to_perp = (internal_transfer_pending_dir == 0);
@@ -925,11 +1354,7 @@ void App::render() {
 
                 set_alert("TRANSFER_SUBMITTED\nPlease wait...");
 
-                if (hl_transfer_thread.joinable()) {
-                    hl_transfer_thread.join();
-                }
-
-                hl_transfer_thread = std::thread([this, w, to_perp, amt_s, nonce_ms]() {
+                tasks.submit(tradeboy::core::TaskKind::Transfer, [w, to_perp, amt_s, nonce_ms](tradeboy::core::TaskResult& out) {
                     std::string resp;
                     std::string err;
                     bool ok = tradeboy::market::exchange_usd_class_transfer(
@@ -942,9 +1367,10 @@ void App::render() {
                         resp,
                         err);
 
+                    out.ok = ok;
                     if (ok) {
-                        hl_transfer_refresh_requested.store(true);
-                        set_hl_transfer_alert(*this, std::string("TRANSFER_OK\n") + truncate_for_alert(resp, 220));
+                        out.refresh_user = true;
+                        out.body = std::string("TRANSFER_OK\n") + truncate_for_alert(resp, 220);
                     } else {
                         std::string body = "TRANSFER_FAILED\n";
                         if (!err.empty()) body += err;
@@ -953,9 +1379,8 @@ void App::render() {
                             body += "\n";
                             body += truncate_for_alert(resp, 220);
                         }
-                        set_hl_transfer_alert(*this, body);
+                        out.body = body;
                     }
-                    hl_transfer_inflight.store(false);
                 });
             }
         }
@@ -966,14 +1391,93 @@ void App::render() {
         tradeboy::ui::NumberInputResult res = spot_order.get_result();
         double val = spot_order.get_result_value();
         spot_order.clear_result();
-        
+
+        if (res == tradeboy::ui::NumberInputResult::Cancelled && hl_order_client) {
+            hl_order_client->cancel_prepare();
+        }
+
         if (res == tradeboy::ui::NumberInputResult::Confirmed) {
-            // TODO: Execute order
-            char msg[128];
-            std::snprintf(msg, sizeof(msg), "ORDER_SUBMITTED\n%s %.4f %s", 
-                spot_order.side == tradeboy::spotOrder::Side::Buy ? "BUY" : "SELL",
-                val, spot_order.sym.c_str());
-            set_alert(msg);
+            const long long confirm_ms = (long long)std::chrono::duration_cast<std::chrono::milliseconds>(
+                                             std::chrono::system_clock::now().time_since_epoch())
+                                             .count();
+            const bool is_buy = (spot_order.side == tradeboy::spotOrder::Side::Buy);
+
+            // Price the order off the freshest mid, not the one captured when the modal opened.
+            double mid = spot_order.price;
+            {
+                const tradeboy::model::TradeModelSnapshot snap = model.snapshot();
+                for (const auto& r : snap.spot_rows) {
+                    if (r.asset_id == spot_order.asset_id && r.price > 0.0) {
+                        mid = r.price;
+                        break;
+                    }
+                }
+            }
+
+            tradeboy::market::OrderWire order;
+            order.asset = spot_order.asset_id;
+            order.is_buy = is_buy;
+            if (hl_order_client) {
+                // Keeps the price fixed at modal open while the mid is steady, so a presigned size can be used as-is.
+                order.px = hl_order_client->limit_price_for(order.asset, is_buy, mid, spot_order.sz_decimals);
+            } else {
+                order.px = tradeboy::market::hl_wire_price(tradeboy::market::hl_market_limit_price(mid, is_buy), spot_order.sz_decimals, true);
+            }
+            order.sz = tradeboy::market::hl_wire_size(val, spot_order.sz_decimals);
+            order.tif = "Ioc";
+
+            if (spot_order.asset_id < 0 || mid <= 0.0) {
+                set_alert("ORDER_FAILED\nMARKET_DATA_NOT_READY");
+            } else if (order.sz == "0") {
+                set_alert("ORDER_FAILED\nSIZE_BELOW_LOT");
+            } else if (val * mid < 10.0) {
+                // Exchange-side minimum order value.
+                set_alert("ORDER_FAILED\nMIN_VALUE_10_USDC");
+            } else if (!hl_order_client) {
+                set_alert("ORDER_FAILED\nNOT_READY");
+            } else if (tasks.busy(tradeboy::core::TaskKind::Order)) {
+                set_alert("ORDER_BUSY\nPLEASE_WAIT");
+            } else {
+                const tradeboy::model::WalletSnapshot w = model.wallet_snapshot();
+                if (w.wallet_address.empty() || w.private_key.empty()) {
+                    set_alert("ORDER_FAILED\nMISSING_WALLET");
+                } else {
+                    char msg[128];
+                    std::snprintf(msg, sizeof(msg), "ORDER_SUBMITTED\n%s %s %s\nPlease wait...",
+                                  is_buy ? "BUY" : "SELL", order.sz.c_str(), spot_order.sym.c_str());
+                    set_alert(msg);
+
+                    tasks.submit(tradeboy::core::TaskKind::Order, [this, w, order, confirm_ms](tradeboy::core::TaskResult& out) {
+                        tradeboy::market::OrderStatus status;
+                        std::string resp;
+                        std::string err;
+                        bool ok = hl_order_client->place_order(
+                            w.wallet_address,
+                            w.private_key,
+                            order,
+                            confirm_ms,
+                            status,
+                            resp,
+                            err);
+
+                        out.ok = ok;
+                        if (ok) {
+                            out.body = std::string("ORDER_OK\n") + truncate_for_alert(status.text, 220);
+                        } else if (err == "outcome_unknown") {
+                            out.body = "ORDER_UNKNOWN\nNO_REPLY_CHECK_FILLS";
+                        } else {
+                            std::string body = "ORDER_FAILED\n";
+                            if (!err.empty()) body += truncate_for_alert(err, 220);
+                            else body += "UNKNOWN";
+                            if (!resp.empty() && status.text.empty()) {
+                                body += "\n";
+                                body += truncate_for_alert(resp, 220);
+                            }
+                            out.body = body;
+                        }
+                    });
+                }
+            }
         }
     }
 
@@ -1020,44 +1524,35 @@ void App::render() {
     {
         const bool now_ok = model.account_snapshot().arb_rpc_ok;
         if (!now_ok && arb_rpc_last_ok) {
-            if (!arb_deposit_inflight.load()) {
+            if (!tasks.busy(tradeboy::core::TaskKind::Deposit)) {
                 set_alert("RPC_CONNECTION_FAILED");
             }
         }
         arb_rpc_last_ok = now_ok;
     }
 
-    if (arb_deposit_alert_pending.exchange(false)) {
-        std::string body;
-        {
-            pthread_mutex_lock(&arb_deposit_mu);
-            body = arb_deposit_alert_body;
-            pthread_mutex_unlock(&arb_deposit_mu);
+    bool refresh_user = false;
+    tasks.drain([this, &refresh_user](const tradeboy::core::TaskResult& r) {
+        // Actions cancelled by the exit report failures nobody needs to see.
+        if (exit_poweroff_anim_active) return;
+        if (!r.body.empty()) set_alert(r.body);
+        if (r.refresh_user) refresh_user = true;
+    });
+
+    // Price alerts wait for the dialog so one alert never hides another.
+    const uint32_t alerts_ver = model.version(tradeboy::model::ModelSection::Alerts);
+    if (!alert_dialog.open && alerts_ver != alerts_seen_ver) {
+        alerts_seen_ver = alerts_ver;
+        std::vector<std::string> fired = model.take_fired_alerts();
+        if (!fired.empty()) {
+            std::string body = "PRICE_ALERT";
+            for (size_t i = 0; i < fired.size() && i < 3; i++) body += "\n" + fired[i];
+            if (fired.size() > 3) body += "\n+" + std::to_string(fired.size() - 3) + " MORE";
+            set_alert(body);
         }
-        set_alert(body);
     }
 
-    if (hl_transfer_alert_pending.exchange(false)) {
-        std::string body;
-        {
-            pthread_mutex_lock(&hl_transfer_mu);
-            body = hl_transfer_alert_body;
-            pthread_mutex_unlock(&hl_transfer_mu);
-        }
-        set_alert(body);
-    }
-
-    if (hl_withdraw_alert_pending.exchange(false)) {
-        std::string body;
-        {
-            pthread_mutex_lock(&hl_withdraw_mu);
-            body = hl_withdraw_alert_body;
-            pthread_mutex_unlock(&hl_withdraw_mu);
-        }
-        set_alert(body);
-    }
-
-    if (hl_transfer_refresh_requested.exchange(false)) {
+    if (refresh_user) {
         if (market_src && !wallet_cfg.wallet_address.empty()) {
             market_src->set_user_address(wallet_cfg.wallet_address);
         }
@@ -1071,6 +1566,7 @@ void App::render() {
     if (exit_dialog.open && !exit_dialog.closing) {
         if (exit_dialog.tick_flash()) {
             exit_dialog_quit_after_close = (exit_dialog.pending_action == 0);
+            if (exit_dialog_quit_after_close) exit_confirmed_t = std::chrono::steady_clock::now();
             exit_dialog.start_close();
         }
     }
@@ -1082,6 +1578,9 @@ void App::render() {
             if (exit_dialog_quit_after_close) {
                 exit_poweroff_anim_active = true;
                 exit_poweroff_anim_frames = 0;
+                // Let running actions unwind during the animation rather than
+                // at shutdown.
+                tasks.cancel();
             }
             exit_dialog_quit_after_close = false;
         }
@@ -1176,6 +1675,12 @@ void App::render() {
                                     nullptr);
     }
 
+    if (feed_overlay) {
+        const float overlay_h = 12.0f + 18.0f * (float)(tradeboy::market::kFeedCount + 1);
+        tradeboy::ui::render_feed_overlay(ImGui::GetWindowDrawList(), tradeboy::market::feed_stats(), ImVec2(6.0f, 480.0f - 6.0f - overlay_h), 708.0f);
+        tradeboy::utils::request_frame_at(ImGui::GetTime() + 0.5); // ages tick while idle
+    }
+
     // CRT power-off postprocess (after confirm exit, after exit dialog close completes).
     if (exit_poweroff_anim_active) {
         const int dur = 34;
@@ -1188,6 +1693,23 @@ void App::render() {
             quit_requested = true;
         }
     }
+
+    // Frame-counted animations advance once per drawn frame, so they need
+    // every vsync until they finish.
+    if (animating()) tradeboy::utils::request_frame();
+}
+
+bool App::animating() const {
+    if (boot_anim_active || exit_poweroff_anim_active) return true;
+    if (nav_key_held) return true; // row key repeat counts frames
+    if (buy_press_frames > 0 || sell_press_frames > 0 || buy_trigger_frames > 0 || sell_trigger_frames > 0) return true;
+    if (l1_flash_frames > 0 || r1_flash_frames > 0 || account_flash_timer > 0) return true;
+    if (exit_dialog.animating() || alert_dialog.animating() || account_address_dialog.animating() ||
+        internal_transfer_dialog.animating()) {
+        return true;
+    }
+    return spot_order.input_state.animating() || internal_transfer_amount.animating() || withdraw_amount.animating() ||
+           deposit_amount.animating() || price_alert_amount.animating();
 }
 
 } // namespace tradeboy::app
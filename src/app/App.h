@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <string>
 #include <vector>
 #include <memory>
@@ -11,11 +12,15 @@
 #include "imgui.h"
 
 #include "../spotOrder/SpotOrderScreen.h"
+#include "../spot/SpotIndex.h"
 #include "../market/IMarketDataSource.h"
 #include "../market/MarketDataService.h"
+#include "../market/HyperliquidOrder.h"
 #include "../model/TradeModel.h"
 
 #include "../arb/ArbitrumRpcService.h"
+#include "../core/Reactor.h"
+#include "../core/TaskPool.h"
 
 #include "../wallet/Wallet.h"
 #include "../ui/DialogState.h"
@@ -31,6 +36,24 @@ enum class Tab {
     Account = 2,
 };
 
+// Strings handed to the Account screen, rebuilt only when the account or
+// Arbitrum sections, or the spot rows (ETH price for the fee), moved.
+struct AccountTexts {
+    uint32_t account_ver = 0;
+    uint32_t arb_ver = 0;
+    uint32_t spot_ver = 0;
+    std::string eth;
+    std::string usdc;
+    std::string gas;
+    std::string hl_usdc;
+    std::string hl_perp_usdc;
+    std::string hl_total_asset;
+    std::string hl_pnl_24h;
+    std::string hl_pnl_24h_pct;
+    std::string hl_pnl_7d;
+    std::string hl_pnl_30d;
+};
+
 struct App {
     App();
     ~App();
@@ -46,9 +69,21 @@ struct App {
 
     int spot_row_idx = 0;
     int spot_page_start_idx = 0;
+    int perp_row_idx = 0;
+    int perp_page_start_idx = 0;
     int spot_action_idx = 0; // 0=buy, 1=sell
     bool spot_action_focus = false;
 
+    // Spot symbol search (Y): up/down pick a letter, right places it, left
+    // takes one back; the list narrows to the matching symbols.
+    bool spot_search_open = false;
+    std::string spot_search_prefix;
+    std::string spot_search_query; // prefix + the letter being picked
+    int spot_search_letter = 0;    // index into spot::kSearchAlphabet
+    int spot_search_row = 0;       // selection within the matches
+    int spot_search_page = 0;
+    tradeboy::spot::SpotSymbolIndex spot_index;
+
     // Account state
     int account_selected_btn = 0; // 0=S<>P, 1=Withdraw, 2=Deposit
     int account_flash_timer = 0;
@@ -67,15 +102,24 @@ struct App {
 
     tradeboy::ui::NumberInputState deposit_amount;
 
+    // Spot X: price alert for the selected coin. Above/below is picked from
+    // the entered price vs. the price when the modal opened.
+    tradeboy::ui::NumberInputState price_alert_amount;
+    std::string price_alert_coin;
+    double price_alert_ref_px = 0.0;
+
     int internal_transfer_pending_dir = -1; // 0=SPOT->PERP, 1=PERP->SPOT
 
     // Exit dialog specific state
     bool exit_dialog_quit_after_close = false;
+    // When the user confirmed exit; main times shutdown from here.
+    std::chrono::steady_clock::time_point exit_confirmed_t;
 
     // UI feedback state
     bool action_btn_held = false; // A button held
     bool l1_btn_held = false;
     bool r1_btn_held = false;
+    bool nav_key_held = false; // up/down: auto-repeat needs frames while held
 
     int l1_flash_frames = 0;
     int r1_flash_frames = 0;
@@ -92,6 +136,13 @@ struct App {
     int boot_anim_frames = 0;
     float boot_anim_t = 0.0f;
 
+    // Warm start: rows came from the state cache; first_useful_frame is set
+    // once a frame has drawn spot rows (main logs the time to it).
+    bool state_cache_loaded = false;
+    bool first_useful_frame = false;
+
+    bool feed_overlay = false; // L2: feed latency/staleness debug overlay
+
     bool overlay_rect_active = false;
     ImVec4 overlay_rect_uv = ImVec4(0, 0, 0, 0);
 
@@ -101,32 +152,46 @@ struct App {
 
     bool arb_rpc_last_ok = false;
 
-    std::atomic<bool> arb_deposit_inflight{false};
-    std::atomic<bool> arb_deposit_alert_pending{false};
-    mutable pthread_mutex_t arb_deposit_mu;
-    std::string arb_deposit_alert_body;
-
-    std::thread arb_deposit_thread;
-
-    std::atomic<bool> hl_transfer_inflight{false};
-    std::atomic<bool> hl_transfer_alert_pending{false};
-    std::atomic<bool> hl_transfer_refresh_requested{false};
-    mutable pthread_mutex_t hl_transfer_mu;
-    std::string hl_transfer_alert_body;
-
-    std::thread hl_transfer_thread;
-
-    std::atomic<bool> hl_withdraw_inflight{false};
-    std::atomic<bool> hl_withdraw_alert_pending{false};
-    mutable pthread_mutex_t hl_withdraw_mu;
-    std::string hl_withdraw_alert_body;
-
-    std::thread hl_withdraw_thread;
+    // Deposit, transfer, withdraw and order submits run here; results are
+    // drained once per frame in render().
+    tradeboy::core::TaskPool tasks;
+    std::unique_ptr<tradeboy::market::HyperliquidOrderClient> hl_order_client;
 
     tradeboy::model::TradeModel model;
+    // The WS pipe, market polls and wallet polls all run on this one thread.
+    // Declared before them so it outlives them.
+    tradeboy::core::Reactor net;
     std::unique_ptr<tradeboy::market::IMarketDataSource> market_src;
     std::unique_ptr<tradeboy::market::MarketDataService> market_service;
     std::unique_ptr<tradeboy::arb::ArbitrumRpcService> arb_rpc_service;
+
+    // UI-thread copy of the live book, refreshed in place when queried and
+    // only re-copied once the source has a newer one (l2_book_view_ms).
+    tradeboy::market::OrderBook l2_book_view;
+    long long l2_book_view_ms = 0;
+
+    // Spot coin whose l2Book/trades/candles are followed (see follow_focus_coin).
+    int focus_asset_id = -1;
+    // Perps whose activeAssetCtx is streamed: the visible page plus open
+    // positions while the Perp tab is up, none otherwise.
+    std::vector<std::string> perp_streamed_coins;
+    // Render copies of the model, retaken only when their section's version
+    // moved (TradeModel::version), so idle frames copy nothing.
+    tradeboy::model::TradeModelSnapshot spot_view;
+    uint32_t spot_view_ver = 0;
+    uint32_t spot_sel_ver = 0;
+    uint32_t spot_index_ver = 0; // spot_view_ver spot_index was last given
+    tradeboy::model::PerpSnapshot perp_view;
+    uint32_t perp_view_ver = 0;
+    tradeboy::model::AccountSnapshot account_view;
+    uint32_t account_view_ver = 0;
+    uint32_t arb_view_ver = 0;
+    uint32_t alerts_seen_ver = 0;
+    AccountTexts account_text;
+
+    // Fed from the trade tape each frame; text is reformatted only on change.
+    tradeboy::market::TradeFlowStats trade_flow;
+    char trade_flow_text[64] = {0};
     
     ImFont* font_bold = nullptr;
 
@@ -137,12 +202,32 @@ struct App {
     static void dec_frame_counter(int& v);
 
     void open_spot_order(bool buy);
+    void open_price_alert();
+    const tradeboy::model::TradeModelSnapshot& spot_view_snapshot();
+    const tradeboy::model::PerpSnapshot& perp_view_snapshot();
+    const tradeboy::model::AccountSnapshot& account_view_snapshot();
+    const AccountTexts& account_texts();
+    void follow_focus_coin(const tradeboy::model::SpotRow& row);
+    void follow_visible_perps(const tradeboy::model::PerpSnapshot& snap);
+    // Drops streams of screens that are no longer showing.
+    void follow_tab_streams();
+    void drain_trade_tape();
 
     void apply_spot_ui_events(const std::vector<tradeboy::spot::SpotUiEvent>& ev);
+    void open_spot_search();
+    void close_spot_search(bool accept);
+    void handle_spot_search_input(const tradeboy::app::InputState& in, const tradeboy::app::EdgeState& edges);
+    // Feeds spot_index the rows when spot_view was retaken since last time.
+    void refresh_spot_index();
+    // Matches of the current query as spot_index.order()[lo, hi).
+    void spot_search_range(int& lo, int& hi);
+    void apply_perp_ui_events(const std::vector<tradeboy::spot::SpotUiEvent>& ev);
 
     void handle_input_edges(const tradeboy::app::InputState& in, const tradeboy::app::EdgeState& edges);
 
     void render();
+    // Something on screen still advances per frame (flash, open/close, boot).
+    bool animating() const;
 
     void set_alert(const std::string& body);
 };
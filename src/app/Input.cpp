@@ -19,6 +19,7 @@ InputState poll_input_state_from_events(const std::vector<SDL_Event>& events) {
             case SDLK_a: st.l2 = down; break;
             case SDLK_s: st.r2 = down; break;
             case SDLK_c: st.x = down; break;
+            case SDLK_v: st.y = down; break;
             case SDLK_m: st.m = down; break;
             default: break;
         }
@@ -39,6 +40,7 @@ InputState poll_input_state_from_events(const std::vector<SDL_Event>& events) {
             switch (e.jbutton.button) {
                 case 0: st.a = down; break;
                 case 1: st.b = down; break;
+                case 2: st.y = down; break;
                 case 3: st.x = down; break;
                 case 4: st.l1 = down; break;
                 case 5: st.r1 = down; break;
@@ -1,5 +1,8 @@
 #include "arb/ArbitrumRpc.h"
 
+#include "arb/Eip1559Tx.h"
+
+#include "core/Cancel.h"
 #include "utils/Hex.h"
 #include "utils/Process.h"
 #include "utils/Format.h"
@@ -14,7 +17,6 @@
 #include <chrono>
 #include <sstream>
 #include <string>
-#include <thread>
 #include <vector>
 
 #include <openssl/bn.h>
@@ -22,10 +24,20 @@
 #include <openssl/ecdsa.h>
 #include <openssl/obj_mac.h>
 
+#include "../../third_party/picojson/picojson.h"
+
 extern void log_str(const char* s);
 
 namespace tradeboy::arb {
 
+static const unsigned long long kArbitrumOneChainId = 42161ULL;
+
+// USDC on Arbitrum One
+static const char* kUsdcContract = "0xaf88d065e77c8cC2239327C5EDb3A432268e5831";
+
+// keccak256("Transfer(address,address,uint256)")
+static const char* kErc20TransferTopic = "0xddf252ad1be2c89b69c2b068fc378daa952ba7f163c4a11628f55a4df523b3ef";
+
 static bool write_file(const char* path, const std::string& s) {
     FILE* f = std::fopen(path, "wb");
     if (!f) return false;
@@ -198,8 +210,16 @@ static bool rpc_call(const std::string& rpc_url, const std::string& body, std::s
     return http_post_json_wget(rpc_url, path, out_json);
 }
 
-static bool rpc_eth_getBalance(const std::string& rpc_url, const std::string& addr_0x, std::string& out_hex) {
-    std::string body = "{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"eth_getBalance\",\"params\":[\"" + addr_0x + "\",\"latest\"]}";
+// 0 means "latest".
+static std::string block_tag(unsigned long long block) {
+    if (block == 0) return std::string("latest");
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "0x%llx", block);
+    return std::string(buf);
+}
+
+static bool rpc_eth_getBalance(const std::string& rpc_url, const std::string& addr_0x, unsigned long long block, std::string& out_hex) {
+    std::string body = "{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"eth_getBalance\",\"params\":[\"" + addr_0x + "\",\"" + block_tag(block) + "\"]}";
     std::string resp;
     if (!rpc_call(rpc_url, body, resp)) return false;
     return parse_json_result_hex(resp, out_hex);
@@ -309,12 +329,12 @@ bool wait_tx_confirmations(const std::string& rpc_url,
         std::string receipt_resp;
         if (!rpc_eth_getTransactionReceipt_raw(rpc_url, txhash_0x, receipt_resp)) {
             last_soft_err = "receipt_rpc_failed";
-            std::this_thread::sleep_for(std::chrono::milliseconds(1200));
+            if (!tradeboy::core::cancellable_sleep_ms(1200)) break;
             continue;
         }
 
         if (rpc_receipt_is_null(receipt_resp)) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(1200));
+            if (!tradeboy::core::cancellable_sleep_ms(1200)) break;
             continue;
         }
 
@@ -322,7 +342,7 @@ bool wait_tx_confirmations(const std::string& rpc_url,
         unsigned long long tx_block = 0ULL;
         if (!rpc_receipt_parse_status_and_block(receipt_resp, success, tx_block)) {
             last_soft_err = rpc_resp_summary(receipt_resp);
-            std::this_thread::sleep_for(std::chrono::milliseconds(1200));
+            if (!tradeboy::core::cancellable_sleep_ms(1200)) break;
             continue;
         }
         if (!success) {
@@ -333,7 +353,7 @@ bool wait_tx_confirmations(const std::string& rpc_url,
         std::string head_hex;
         if (!rpc_eth_blockNumber(rpc_url, head_hex)) {
             last_soft_err = "blockNumber_rpc_failed";
-            std::this_thread::sleep_for(std::chrono::milliseconds(1200));
+            if (!tradeboy::core::cancellable_sleep_ms(1200)) break;
             continue;
         }
         unsigned long long head = hex_quantity_to_ull(head_hex);
@@ -351,8 +371,10 @@ bool wait_tx_confirmations(const std::string& rpc_url,
             return true;
         }
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(1200));
+        if (!tradeboy::core::cancellable_sleep_ms(1200)) break;
     }
+    out_err = "cancelled";
+    return false;
 }
 
 static bool rpc_eth_gasPrice_raw(const std::string& rpc_url, std::string& out_hex, std::string& out_resp) {
@@ -416,7 +438,7 @@ static bool rpc_eth_getBaseFeePerGas_raw(const std::string& rpc_url, std::string
     return parse_json_base_fee_per_gas_hex(out_resp, out_hex_0x);
 }
 
-static bool rpc_eth_call_balanceOf(const std::string& rpc_url, const std::string& usdc_contract_0x, const std::string& addr_0x, std::string& out_hex) {
+static bool rpc_eth_call_balanceOf(const std::string& rpc_url, const std::string& usdc_contract_0x, const std::string& addr_0x, unsigned long long block, std::string& out_hex) {
     // balanceOf(address) selector: 70a08231
     std::string addr40 = addr_to_40hex_lower_no0x(addr_0x);
     std::string data = "0x70a08231" + left_pad_64(addr40);
@@ -425,64 +447,215 @@ static bool rpc_eth_call_balanceOf(const std::string& rpc_url, const std::string
     body += "{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"eth_call\",\"params\":[{";
     body += "\"to\":\"" + usdc_contract_0x + "\",";
     body += "\"data\":\"" + data + "\"";
-    body += "},\"latest\"]}";
+    body += "},\"" + block_tag(block) + "\"]}";
 
     std::string resp;
     if (!rpc_call(rpc_url, body, resp)) return false;
     return parse_json_result_hex(resp, out_hex);
 }
 
-bool fetch_wallet_data(const std::string& rpc_url,
-                       const std::string& wallet_address_0x,
-                       WalletOnchainData& out,
-                       std::string& out_err) {
-    out = WalletOnchainData();
+void format_wallet_data(WalletOnchainData& d) {
+    long double eth = d.eth_wei / 1000000000000000000.0L;
+    long double gwei = d.gas_price_wei / 1000000000.0L;
+    long double usdc = (long double)d.usdc_micro / 1000000.0L;
+
+    d.eth_balance = tradeboy::utils::format_fixed_trunc_sig((double)eth, 7, 6);
+    d.usdc_balance = tradeboy::utils::format_fixed_trunc_sig((double)usdc, 7, 6);
+
+    std::string gwei_s = tradeboy::utils::format_fixed_trunc_sig((double)gwei, 7, 3);
+    d.gas = std::string("GAS: ") + gwei_s + " GWEI";
+}
+
+static const picojson::value* pj_find(const picojson::object& obj, const char* key) {
+    picojson::object::const_iterator it = obj.find(key);
+    if (it == obj.end()) return nullptr;
+    return &it->second;
+}
+
+static std::string pj_str(const picojson::object& obj, const char* key) {
+    const picojson::value* v = pj_find(obj, key);
+    if (!v || !v->is<std::string>()) return std::string();
+    return v->get<std::string>();
+}
+
+static std::string log_filter_json(unsigned long long from_block,
+                                   unsigned long long to_block,
+                                   const std::string& from_topic,
+                                   const std::string& to_topic) {
+    std::string f;
+    f += "{\"address\":\"";
+    f += kUsdcContract;
+    f += "\",\"fromBlock\":\"" + block_tag(from_block) + "\",\"toBlock\":\"" + block_tag(to_block) + "\",\"topics\":[\"";
+    f += kErc20TransferTopic;
+    f += "\",";
+    f += from_topic.empty() ? std::string("null") : ("\"" + from_topic + "\"");
+    f += ",";
+    f += to_topic.empty() ? std::string("null") : ("\"" + to_topic + "\"");
+    f += "]}";
+    return f;
+}
+
+// Sums the Transfer amounts of one eth_getLogs result. Returns false if a log
+// is malformed or an amount does not fit 64 bits (caller falls back to a full
+// reconciliation).
+static bool sum_transfer_logs(const picojson::value& result, unsigned long long& out_sum, int& out_n) {
+    out_sum = 0;
+    out_n = 0;
+    if (!result.is<picojson::array>()) return false;
+    const picojson::array& logs = result.get<picojson::array>();
+    for (size_t i = 0; i < logs.size(); i++) {
+        if (!logs[i].is<picojson::object>()) return false;
+        const picojson::object& lg = logs[i].get<picojson::object>();
+        const picojson::value* removed = pj_find(lg, "removed");
+        if (removed && removed->is<bool>() && removed->get<bool>()) continue;
+
+        std::string data = pj_str(lg, "data");
+        if (data.size() >= 2 && data[0] == '0' && (data[1] == 'x' || data[1] == 'X')) data = data.substr(2);
+        size_t nz = 0;
+        while (nz < data.size() && data[nz] == '0') nz++;
+        if (data.size() - nz > 16) return false;
+        out_sum += hex_quantity_to_ull(data.substr(nz));
+        out_n++;
+    }
+    return true;
+}
+
+std::string wallet_deltas_request(const std::string& wallet_address_0x,
+                                  unsigned long long from_block,
+                                  unsigned long long to_block) {
+    const bool want_logs = (from_block > 0 && from_block <= to_block);
+    const std::string wallet_topic = std::string("0x") + left_pad_64(addr_to_40hex_lower_no0x(wallet_address_0x));
+
+    // Batch: 1 = head, 2 = gas price, 3 = logs from wallet, 4 = logs to wallet.
+    std::string body = "[";
+    body += "{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"eth_blockNumber\",\"params\":[]},";
+    body += "{\"jsonrpc\":\"2.0\",\"id\":2,\"method\":\"eth_gasPrice\",\"params\":[]}";
+    if (want_logs) {
+        body += ",{\"jsonrpc\":\"2.0\",\"id\":3,\"method\":\"eth_getLogs\",\"params\":[" + log_filter_json(from_block, to_block, wallet_topic, std::string()) + "]}";
+        body += ",{\"jsonrpc\":\"2.0\",\"id\":4,\"method\":\"eth_getLogs\",\"params\":[" + log_filter_json(from_block, to_block, std::string(), wallet_topic) + "]}";
+    }
+    body += "]";
+    return body;
+}
+
+// Maps a batch response to results[id] for ids 1..n (batch replies may come
+// back in any order). False if the reply is not a JSON array.
+static bool split_batch_results(const std::string& resp,
+                                picojson::value& root,
+                                const picojson::value** results,
+                                int n,
+                                std::string& out_err) {
+    for (int i = 0; i <= n; i++) results[i] = nullptr;
+    std::string perr = picojson::parse(root, resp);
+    if (!perr.empty() || !root.is<picojson::array>()) {
+        out_err = std::string("batch_parse_failed ") + rpc_resp_summary(resp);
+        return false;
+    }
+    const picojson::array& arr = root.get<picojson::array>();
+    for (size_t i = 0; i < arr.size(); i++) {
+        if (!arr[i].is<picojson::object>()) continue;
+        const picojson::object& o = arr[i].get<picojson::object>();
+        const picojson::value* idv = pj_find(o, "id");
+        if (!idv || !idv->is<double>()) continue;
+        int id = (int)idv->get<double>();
+        if (id < 1 || id > n) continue;
+        results[id] = pj_find(o, "result");
+    }
+    return true;
+}
+
+bool parse_wallet_deltas(const std::string& resp, bool want_logs, WalletDeltaPoll& out, std::string& out_err) {
+    out = WalletDeltaPoll();
     out_err.clear();
 
-    if (rpc_url.empty() || wallet_address_0x.empty()) {
-        out_err = "missing_rpc_or_address";
+    picojson::value root;
+    const picojson::value* results[5];
+    if (!split_batch_results(resp, root, results, 4, out_err)) return false;
+
+    if (!results[1] || !results[1]->is<std::string>()) {
+        out_err = "eth_blockNumber_failed";
         return false;
     }
+    out.head_block = hex_quantity_to_ull(results[1]->get<std::string>());
+    if (results[2] && results[2]->is<std::string>()) {
+        out.gas_price_wei = hex_quantity_to_ld(results[2]->get<std::string>());
+    }
 
-    std::string bal_hex;
-    std::string gas_hex;
+    if (want_logs) {
+        unsigned long long out_sum = 0;
+        unsigned long long in_sum = 0;
+        int n_out = 0;
+        int n_in = 0;
+        if (!results[3] || !results[4] || !sum_transfer_logs(*results[3], out_sum, n_out) || !sum_transfer_logs(*results[4], in_sum, n_in)) {
+            out_err = "eth_getLogs_failed";
+            return false;
+        }
+        out.logs_queried = true;
+        out.usdc_delta_micro = (long long)in_sum - (long long)out_sum;
+        out.usdc_logs = n_out + n_in;
+    }
+    return true;
+}
 
-    if (!rpc_eth_getBalance(rpc_url, wallet_address_0x, bal_hex)) {
+std::string wallet_data_request(const std::string& wallet_address_0x, unsigned long long block) {
+    const std::string data = "0x70a08231" + left_pad_64(addr_to_40hex_lower_no0x(wallet_address_0x));
+
+    // Batch: 1 = ETH balance, 2 = gas price, 3 = USDC balanceOf.
+    std::string body = "[";
+    body += "{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"eth_getBalance\",\"params\":[\"" + wallet_address_0x + "\",\"" + block_tag(block) + "\"]},";
+    body += "{\"jsonrpc\":\"2.0\",\"id\":2,\"method\":\"eth_gasPrice\",\"params\":[]},";
+    body += "{\"jsonrpc\":\"2.0\",\"id\":3,\"method\":\"eth_call\",\"params\":[{";
+    body += "\"to\":\"" + std::string(kUsdcContract) + "\",";
+    body += "\"data\":\"" + data + "\"";
+    body += "},\"" + block_tag(block) + "\"]}";
+    body += "]";
+    return body;
+}
+
+bool parse_wallet_data(const std::string& resp, unsigned long long block, WalletOnchainData& out, std::string& out_err) {
+    out = WalletOnchainData();
+    out_err.clear();
+
+    picojson::value root;
+    const picojson::value* results[4];
+    if (!split_batch_results(resp, root, results, 3, out_err)) return false;
+
+    if (!results[1] || !results[1]->is<std::string>()) {
         out_err = "eth_getBalance_failed";
         return false;
     }
-    if (!rpc_eth_gasPrice(rpc_url, gas_hex)) {
+    if (!results[2] || !results[2]->is<std::string>()) {
         out_err = "eth_gasPrice_failed";
         return false;
     }
-
-    // USDC on Arbitrum One
-    const std::string usdc_contract = "0xaf88d065e77c8cC2239327C5EDb3A432268e5831";
-    std::string usdc_hex;
-    if (!rpc_eth_call_balanceOf(rpc_url, usdc_contract, wallet_address_0x, usdc_hex)) {
+    if (!results[3] || !results[3]->is<std::string>()) {
         out_err = "usdc_balanceOf_failed";
         return false;
     }
 
-    long double wei = hex_quantity_to_ld(bal_hex);
-    long double eth = wei / 1000000000000000000.0L;
-
-    long double gaswei = hex_quantity_to_ld(gas_hex);
-    long double gwei = gaswei / 1000000000.0L;
-
-    long double usdc_raw = hex_quantity_to_ld(usdc_hex);
-    long double usdc = usdc_raw / 1000000.0L;
-
-    // Format
-    out.eth_balance = tradeboy::utils::format_fixed_trunc_sig((double)eth, 7, 6);
-    out.usdc_balance = tradeboy::utils::format_fixed_trunc_sig((double)usdc, 7, 6);
+    out.eth_wei = hex_quantity_to_ld(results[1]->get<std::string>());
+    out.gas_price_wei = hex_quantity_to_ld(results[2]->get<std::string>());
+    out.usdc_micro = hex_quantity_to_ull(results[3]->get<std::string>());
+    out.block = block;
+    format_wallet_data(out);
 
-    std::string gwei_s = tradeboy::utils::format_fixed_trunc_sig((double)gwei, 7, 3);
-    out.gas = std::string("GAS: ") + gwei_s + " GWEI";
+    out.rpc_ok = true;
+    return true;
+}
 
-    out.gas_price_wei = gaswei;
+std::string eth_balance_request(const std::string& wallet_address_0x, unsigned long long block) {
+    return "{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"eth_getBalance\",\"params\":[\"" + wallet_address_0x + "\",\"" + block_tag(block) + "\"]}";
+}
 
-    out.rpc_ok = true;
+bool parse_eth_balance(const std::string& resp, long double& out_wei, std::string& out_err) {
+    out_wei = 0.0L;
+    out_err.clear();
+    std::string bal_hex;
+    if (!parse_json_result_hex(resp, bal_hex)) {
+        out_err = "eth_getBalance_failed";
+        return false;
+    }
+    out_wei = hex_quantity_to_ld(bal_hex);
     return true;
 }
 
@@ -501,142 +674,33 @@ static void ec_key_freep(EC_KEY*& p) {
     p = nullptr;
 }
 
-static std::vector<unsigned char> bn_to_bytes_32(const BIGNUM* bn) {
-    std::vector<unsigned char> out(32, 0);
+static void bn_to_be32(const BIGNUM* bn, unsigned char out[32]) {
+    std::memset(out, 0, 32);
     int n = BN_num_bytes(bn);
-    if (n <= 0) return out;
-    std::vector<unsigned char> tmp((size_t)n);
-    BN_bn2bin(bn, tmp.data());
-    if (tmp.size() >= 32) {
-        std::memcpy(out.data(), tmp.data() + (tmp.size() - 32), 32);
-    } else {
-        std::memcpy(out.data() + (32 - tmp.size()), tmp.data(), tmp.size());
-    }
-    return out;
+    if (n <= 0 || n > 32) return;
+    BN_bn2bin(bn, out + (32 - n));
 }
 
-static std::vector<unsigned char> hex_quantity_to_bytes_be(const std::string& hex_0x) {
-    std::vector<unsigned char> out;
-
-    // Accept odd-length quantities (e.g. 0xabc) by left-padding a nibble.
-    std::string s = hex_0x;
-    if (s.size() >= 2 && s[0] == '0' && (s[1] == 'x' || s[1] == 'X')) s = s.substr(2);
-    size_t i0 = 0;
-    while (i0 < s.size() && (s[i0] == ' ' || s[i0] == '\t' || s[i0] == '\n' || s[i0] == '\r')) i0++;
-    s = s.substr(i0);
-    if (s.empty()) return out;
-    if ((s.size() % 2) == 1) s = std::string("0") + s;
-    s = std::string("0x") + s;
-
+static bool addr_0x_to_20(const std::string& addr_0x, unsigned char out[20]) {
     std::vector<unsigned char> b;
-    if (!tradeboy::utils::hex_to_bytes(s, b)) return out;
-
-    size_t i = 0;
-    while (i < b.size() && b[i] == 0) i++;
-    if (i == b.size()) return out;
-    out.assign(b.begin() + (long)i, b.end());
-    return out;
-}
-
-static void rlp_encode_bytes(const unsigned char* data, size_t n, std::vector<unsigned char>& out) {
-    if (n == 0) {
-        out.push_back(0x80);
-        return;
-    }
-    if (n == 1 && data[0] < 0x80) {
-        out.push_back(data[0]);
-        return;
-    }
-    if (n <= 55) {
-        out.push_back((unsigned char)(0x80 + n));
-        out.insert(out.end(), data, data + n);
-        return;
-    }
-    std::vector<unsigned char> len;
-    size_t v = n;
-    while (v > 0) {
-        len.push_back((unsigned char)(v & 0xFF));
-        v >>= 8;
-    }
-    std::reverse(len.begin(), len.end());
-    out.push_back((unsigned char)(0xB7 + len.size()));
-    out.insert(out.end(), len.begin(), len.end());
-    out.insert(out.end(), data, data + n);
-}
-
-static void rlp_encode_bytes_vec(const std::vector<unsigned char>& v, std::vector<unsigned char>& out) {
-    rlp_encode_bytes(v.empty() ? nullptr : v.data(), v.size(), out);
-}
-
-static void rlp_encode_string(const std::string& s, std::vector<unsigned char>& out) {
-    rlp_encode_bytes((const unsigned char*)s.data(), s.size(), out);
-}
-
-static void rlp_encode_list(const std::vector<unsigned char>& payload, std::vector<unsigned char>& out) {
-    size_t n = payload.size();
-    if (n <= 55) {
-        out.push_back((unsigned char)(0xC0 + n));
-        out.insert(out.end(), payload.begin(), payload.end());
-        return;
-    }
-    std::vector<unsigned char> len;
-    size_t v = n;
-    while (v > 0) {
-        len.push_back((unsigned char)(v & 0xFF));
-        v >>= 8;
-    }
-    std::reverse(len.begin(), len.end());
-    out.push_back((unsigned char)(0xF7 + len.size()));
-    out.insert(out.end(), len.begin(), len.end());
-    out.insert(out.end(), payload.begin(), payload.end());
-}
-
-static std::vector<unsigned char> rlp_u256_be(const std::vector<unsigned char>& be_min) {
-    if (be_min.empty()) return std::vector<unsigned char>();
-    std::vector<unsigned char> v = be_min;
-    size_t i = 0;
-    while (i < v.size() && v[i] == 0) i++;
-    if (i == v.size()) return std::vector<unsigned char>();
-    if (i > 0) v.erase(v.begin(), v.begin() + (long)i);
-    return v;
-}
-
-static std::vector<unsigned char> addr_0x_to_20(const std::string& addr_0x) {
-    std::vector<unsigned char> out;
-    std::vector<unsigned char> b;
-    if (!tradeboy::utils::hex_to_bytes(addr_0x, b)) return out;
-    if (b.size() == 20) return b;
-    if (b.size() > 20) {
-        out.assign(b.end() - 20, b.end());
-        return out;
-    }
-    out.assign(20 - b.size(), 0);
-    out.insert(out.end(), b.begin(), b.end());
-    return out;
+    if (!tradeboy::utils::hex_to_bytes(addr_0x, b) || b.size() != 20) return false;
+    std::memcpy(out, b.data(), 20);
+    return true;
 }
 
-static std::vector<unsigned char> build_erc20_transfer_data(const std::string& to_addr_0x, unsigned long long amount) {
+static void build_erc20_transfer_data(const unsigned char to20[20], unsigned long long amount, unsigned char out[68]) {
     // transfer(address,uint256) selector: a9059cbb
-    std::vector<unsigned char> out;
-    out.reserve(4 + 32 + 32);
-    out.push_back(0xa9);
-    out.push_back(0x05);
-    out.push_back(0x9c);
-    out.push_back(0xbb);
-
-    std::vector<unsigned char> to20 = addr_0x_to_20(to_addr_0x);
-    out.insert(out.end(), 12, 0);
-    out.insert(out.end(), to20.begin(), to20.end());
-
-    unsigned char amt[32];
-    std::memset(amt, 0, sizeof(amt));
+    std::memset(out, 0, 68);
+    out[0] = 0xa9;
+    out[1] = 0x05;
+    out[2] = 0x9c;
+    out[3] = 0xbb;
+    std::memcpy(out + 4 + 12, to20, 20);
     unsigned long long v = amount;
     for (int i = 0; i < 8; i++) {
-        amt[31 - i] = (unsigned char)(v & 0xFF);
+        out[67 - i] = (unsigned char)(v & 0xFF);
         v >>= 8;
     }
-    out.insert(out.end(), amt, amt + 32);
-    return out;
 }
 
 static bool secp256k1_key_from_priv(const std::vector<unsigned char>& priv32, EC_KEY*& out_key, std::string& out_err) {
@@ -954,54 +1018,126 @@ static bool secp256k1_compute_recid(const unsigned char hash32[32], const std::v
     return false;
 }
 
-static std::vector<unsigned char> rlp_item_u64(unsigned long long v) {
-    std::vector<unsigned char> be;
-    if (v == 0) return be;
-    while (v > 0) {
-        be.push_back((unsigned char)(v & 0xFF));
-        v >>= 8;
-    }
-    std::reverse(be.begin(), be.end());
-    return be;
+static std::string wei_to_hex_quantity(unsigned long long v) {
+    std::ostringstream hx;
+    hx << std::hex << v;
+    return std::string("0x") + hx.str();
 }
 
-static void rlp_append_item_bytes(const std::vector<unsigned char>& bytes, std::vector<unsigned char>& payload) {
-    std::vector<unsigned char> enc;
-    rlp_encode_bytes(bytes.empty() ? nullptr : bytes.data(), bytes.size(), enc);
-    payload.insert(payload.end(), enc.begin(), enc.end());
-}
+// Signs tx (already carrying nonce and fees) and sends it. out_resp is the RPC
+// response, or the signing error.
+static bool sign_and_send_eip1559(const std::string& rpc_url,
+                                  const std::vector<unsigned char>& priv,
+                                  const Eip1559Tx& tx,
+                                  std::string& out_txh,
+                                  std::string& out_resp) {
+    unsigned char h[32];
+    eip1559_signing_hash(tx, h);
+
+    BIGNUM* r = nullptr;
+    BIGNUM* s = nullptr;
+    std::string sign_err;
+    if (!secp256k1_sign_rs(h, priv, r, s, sign_err)) {
+        out_resp = std::string("sign_failed:") + sign_err;
+        bn_freep(r);
+        bn_freep(s);
+        return false;
+    }
 
-static void rlp_append_item_u64(unsigned long long v, std::vector<unsigned char>& payload) {
-    std::vector<unsigned char> be = rlp_item_u64(v);
-    rlp_append_item_bytes(be, payload);
-}
+    BN_CTX* ctx = BN_CTX_new();
+    if (!ctx) {
+        out_resp = "BN_CTX_new_failed";
+        bn_freep(r);
+        bn_freep(s);
+        return false;
+    }
+    BN_CTX_start(ctx);
+    BIGNUM* n = BN_CTX_get(ctx);
+    BIGNUM* halfn = BN_CTX_get(ctx);
+    if (!halfn) {
+        BN_CTX_end(ctx);
+        BN_CTX_free(ctx);
+        out_resp = "BN_CTX_get_failed";
+        bn_freep(r);
+        bn_freep(s);
+        return false;
+    }
+    EC_GROUP* group = EC_GROUP_new_by_curve_name(NID_secp256k1);
+    if (!group) {
+        BN_CTX_end(ctx);
+        BN_CTX_free(ctx);
+        out_resp = "EC_GROUP_new_failed";
+        bn_freep(r);
+        bn_freep(s);
+        return false;
+    }
+    EC_GROUP_get_order(group, n, ctx);
+    BN_rshift1(halfn, n);
+    int s_was_high = 0;
+    if (BN_cmp(s, halfn) > 0) {
+        BIGNUM* s2 = BN_dup(s);
+        if (!s2) {
+            EC_GROUP_free(group);
+            BN_CTX_end(ctx);
+            BN_CTX_free(ctx);
+            out_resp = "BN_dup_failed";
+            bn_freep(r);
+            bn_freep(s);
+            return false;
+        }
+        BN_sub(s2, n, s2);
+        BN_free(s);
+        s = s2;
+        s_was_high = 1;
+    }
+    EC_GROUP_free(group);
+    BN_CTX_end(ctx);
+    BN_CTX_free(ctx);
 
-static void rlp_append_item_bn(const BIGNUM* bn, std::vector<unsigned char>& payload) {
-    if (!bn || BN_is_zero(bn)) {
-        rlp_append_item_bytes(std::vector<unsigned char>(), payload);
-        return;
+    int recid = -1;
+    std::string rec_err;
+    if (!secp256k1_compute_recid(h, priv, r, s, recid, rec_err)) {
+        out_resp = std::string("recid_failed:") + rec_err;
+        bn_freep(r);
+        bn_freep(s);
+        return false;
     }
-    int n = BN_num_bytes(bn);
-    std::vector<unsigned char> tmp((size_t)n);
-    BN_bn2bin(bn, tmp.data());
-    size_t i = 0;
-    while (i < tmp.size() && tmp[i] == 0) i++;
-    std::vector<unsigned char> be;
-    if (i < tmp.size()) be.assign(tmp.begin() + (long)i, tmp.end());
-    rlp_append_item_bytes(be, payload);
+    if (s_was_high) {
+        recid ^= 1;
+    }
+
+    unsigned char r32[32];
+    unsigned char s32[32];
+    bn_to_be32(r, r32);
+    bn_to_be32(s, s32);
+    bn_freep(r);
+    bn_freep(s);
+
+    const int y_parity = recid & 1;
+    const size_t raw_n = eip1559_signed_size(tx, y_parity, r32, s32);
+    std::string raw_0x;
+    if (raw_n <= 1024) {
+        unsigned char raw[1024];
+        eip1559_encode_signed(tx, y_parity, r32, s32, raw, sizeof(raw));
+        raw_0x = tradeboy::utils::bytes_to_hex_lower(raw, raw_n, true);
+    } else {
+        std::vector<unsigned char> raw(raw_n);
+        eip1559_encode_signed(tx, y_parity, r32, s32, raw.data(), raw.size());
+        raw_0x = tradeboy::utils::bytes_to_hex_lower(raw.data(), raw_n, true);
+    }
+    return rpc_eth_sendRawTransaction(rpc_url, raw_0x, out_txh, out_resp);
 }
 
-bool send_usdc_transfer_test(const std::string& rpc_url,
-                             const std::string& from_addr_0x,
-                             const std::string& privkey_0x,
-                             const std::string& to_addr_0x,
-                             unsigned long long amount_micro,
-                             std::string& out_txhash,
-                             std::string& out_err) {
+bool send_eip1559_tx(const std::string& rpc_url,
+                     const std::string& from_addr_0x,
+                     const std::string& privkey_0x,
+                     Eip1559Tx& tx,
+                     std::string& out_txhash,
+                     std::string& out_err) {
     out_txhash.clear();
     out_err.clear();
 
-    if (rpc_url.empty() || from_addr_0x.empty() || privkey_0x.empty() || to_addr_0x.empty()) {
+    if (rpc_url.empty() || from_addr_0x.empty() || privkey_0x.empty() || tx.gas_limit == 0) {
         out_err = "missing_params";
         return false;
     }
@@ -1013,9 +1149,7 @@ bool send_usdc_transfer_test(const std::string& rpc_url,
         return false;
     }
 
-    // Constants
-    const unsigned long long chain_id = 42161ULL;
-    const std::string usdc_contract = "0xaf88d065e77c8cC2239327C5EDb3A432268e5831";
+    if (tx.chain_id == 0) tx.chain_id = kArbitrumOneChainId;
 
     // Fetch nonce and gasPrice
     std::string nonce_hex;
@@ -1034,7 +1168,7 @@ bool send_usdc_transfer_test(const std::string& rpc_url,
             std::string s = oss.str();
             log_str(s.c_str());
             if (summary != "no_response") break;
-            std::this_thread::sleep_for(std::chrono::milliseconds(250));
+            if (!tradeboy::core::cancellable_sleep_ms(250)) break;
         }
         if (!ok) {
             std::string summary = rpc_resp_summary(nonce_resp);
@@ -1058,7 +1192,7 @@ bool send_usdc_transfer_test(const std::string& rpc_url,
             std::string s = oss.str();
             log_str(s.c_str());
             if (summary != "no_response") break;
-            std::this_thread::sleep_for(std::chrono::milliseconds(250));
+            if (!tradeboy::core::cancellable_sleep_ms(250)) break;
         }
         if (!ok) {
             std::string summary = rpc_resp_summary(gas_resp);
@@ -1080,11 +1214,7 @@ bool send_usdc_transfer_test(const std::string& rpc_url,
             oss << "[ARB] bump gasPrice: gasPrice=" << gp << " baseFeePerGas=" << bf << " -> " << bumped << "\n";
             std::string s = oss.str();
             log_str(s.c_str());
-            std::ostringstream hx;
-            hx << std::hex << bumped;
-            std::string hh = hx.str();
-            if ((hh.size() % 2) == 1) hh = std::string("0") + hh;
-            gas_hex = std::string("0x") + hh;
+            gas_hex = wei_to_hex_quantity(bumped);
         }
     } else {
         std::string p = basefee_resp.substr(0, 512);
@@ -1093,8 +1223,8 @@ bool send_usdc_transfer_test(const std::string& rpc_url,
         log_str(msg.c_str());
     }
 
-    std::vector<unsigned char> nonce_be = hex_quantity_to_bytes_be(nonce_hex);
-    unsigned long long gas_limit = 90000ULL;
+    tx.nonce = hex_quantity_to_ull(nonce_hex);
+    const unsigned long long gas_limit = tx.gas_limit;
 
     // Pre-check ETH balance for gas.
     {
@@ -1120,119 +1250,12 @@ bool send_usdc_transfer_test(const std::string& rpc_url,
         }
     }
 
-    std::vector<unsigned char> to20 = addr_0x_to_20(usdc_contract);
-    std::vector<unsigned char> data = build_erc20_transfer_data(to_addr_0x, amount_micro);
-
+    // Arbitrum ignores the priority fee, so the legacy gas price becomes the
+    // fee cap and the tip stays zero.
     auto try_send_with_gas = [&](const std::string& gas_hex_in, std::string& out_txh, std::string& out_resp) -> bool {
-        std::vector<unsigned char> gasprice_be = hex_quantity_to_bytes_be(gas_hex_in);
-
-        std::vector<unsigned char> payload;
-        rlp_append_item_bytes(rlp_u256_be(nonce_be), payload);
-        rlp_append_item_bytes(rlp_u256_be(gasprice_be), payload);
-        rlp_append_item_u64(gas_limit, payload);
-        rlp_append_item_bytes(to20, payload);
-        rlp_append_item_u64(0ULL, payload);
-        rlp_append_item_bytes(data, payload);
-        rlp_append_item_u64(chain_id, payload);
-        rlp_append_item_u64(0ULL, payload);
-        rlp_append_item_u64(0ULL, payload);
-        std::vector<unsigned char> rlp_unsigned;
-        rlp_encode_list(payload, rlp_unsigned);
-
-        unsigned char h[32];
-        tradeboy::utils::keccak_256(rlp_unsigned.data(), rlp_unsigned.size(), h);
-
-        BIGNUM* r = nullptr;
-        BIGNUM* s = nullptr;
-        std::string sign_err;
-        if (!secp256k1_sign_rs(h, priv, r, s, sign_err)) {
-            out_resp = std::string("sign_failed:") + sign_err;
-            bn_freep(r);
-            bn_freep(s);
-            return false;
-        }
-
-        BN_CTX* ctx = BN_CTX_new();
-        if (!ctx) {
-            out_resp = "BN_CTX_new_failed";
-            bn_freep(r);
-            bn_freep(s);
-            return false;
-        }
-        BN_CTX_start(ctx);
-        BIGNUM* n = BN_CTX_get(ctx);
-        BIGNUM* halfn = BN_CTX_get(ctx);
-        if (!halfn) {
-            BN_CTX_end(ctx);
-            BN_CTX_free(ctx);
-            out_resp = "BN_CTX_get_failed";
-            bn_freep(r);
-            bn_freep(s);
-            return false;
-        }
-        EC_GROUP* group = EC_GROUP_new_by_curve_name(NID_secp256k1);
-        if (!group) {
-            BN_CTX_end(ctx);
-            BN_CTX_free(ctx);
-            out_resp = "EC_GROUP_new_failed";
-            bn_freep(r);
-            bn_freep(s);
-            return false;
-        }
-        EC_GROUP_get_order(group, n, ctx);
-        BN_rshift1(halfn, n);
-        int s_was_high = 0;
-        if (BN_cmp(s, halfn) > 0) {
-            BIGNUM* s2 = BN_dup(s);
-            if (!s2) {
-                EC_GROUP_free(group);
-                BN_CTX_end(ctx);
-                BN_CTX_free(ctx);
-                out_resp = "BN_dup_failed";
-                bn_freep(r);
-                bn_freep(s);
-                return false;
-            }
-            BN_sub(s2, n, s2);
-            BN_free(s);
-            s = s2;
-            s_was_high = 1;
-        }
-        EC_GROUP_free(group);
-        BN_CTX_end(ctx);
-        BN_CTX_free(ctx);
-
-        int recid = -1;
-        std::string rec_err;
-        if (!secp256k1_compute_recid(h, priv, r, s, recid, rec_err)) {
-            out_resp = std::string("recid_failed:") + rec_err;
-            bn_freep(r);
-            bn_freep(s);
-            return false;
-        }
-        if (s_was_high) {
-            recid ^= 1;
-        }
-
-        unsigned long long v = chain_id * 2ULL + 35ULL + (unsigned long long)recid;
-
-        std::vector<unsigned char> payload2;
-        rlp_append_item_bytes(rlp_u256_be(nonce_be), payload2);
-        rlp_append_item_bytes(rlp_u256_be(gasprice_be), payload2);
-        rlp_append_item_u64(gas_limit, payload2);
-        rlp_append_item_bytes(to20, payload2);
-        rlp_append_item_u64(0ULL, payload2);
-        rlp_append_item_bytes(data, payload2);
-        rlp_append_item_u64(v, payload2);
-        rlp_append_item_bn(r, payload2);
-        rlp_append_item_bn(s, payload2);
-        std::vector<unsigned char> raw;
-        rlp_encode_list(payload2, raw);
-        bn_freep(r);
-        bn_freep(s);
-
-        std::string raw_0x = tradeboy::utils::bytes_to_hex_lower(raw.data(), raw.size(), true);
-        return rpc_eth_sendRawTransaction(rpc_url, raw_0x, out_txh, out_resp);
+        tx.max_priority_fee_per_gas = 0;
+        tx.max_fee_per_gas = hex_quantity_to_ull(gas_hex_in);
+        return sign_and_send_eip1559(rpc_url, priv, tx, out_txh, out_resp);
     };
 
     std::string resp;
@@ -1252,11 +1275,7 @@ bool send_usdc_transfer_test(const std::string& rpc_url,
         if (rpc_eth_getBaseFeePerGas_raw(rpc_url, basefee_hex2, basefee_resp2)) {
             unsigned long long bf2 = hex_quantity_to_ull(basefee_hex2);
             unsigned long long bumped2 = bf2 * 2ULL + 1ULL;
-            std::ostringstream hx;
-            hx << std::hex << bumped2;
-            std::string hh = hx.str();
-            if ((hh.size() % 2) == 1) hh = std::string("0") + hh;
-            std::string gas_hex2 = std::string("0x") + hh;
+            std::string gas_hex2 = wei_to_hex_quantity(bumped2);
 
             std::string resp2;
             std::string txh2;
@@ -1278,4 +1297,32 @@ bool send_usdc_transfer_test(const std::string& rpc_url,
     return false;
 }
 
+bool send_usdc_transfer_test(const std::string& rpc_url,
+                             const std::string& from_addr_0x,
+                             const std::string& privkey_0x,
+                             const std::string& to_addr_0x,
+                             unsigned long long amount_micro,
+                             std::string& out_txhash,
+                             std::string& out_err) {
+    out_txhash.clear();
+    out_err.clear();
+
+    const std::string usdc_contract = "0xaf88d065e77c8cC2239327C5EDb3A432268e5831";
+
+    unsigned char to20[20];
+    if (to_addr_0x.empty() || !addr_0x_to_20(to_addr_0x, to20)) {
+        out_err = "invalid_to_address";
+        return false;
+    }
+    unsigned char data[68];
+    build_erc20_transfer_data(to20, amount_micro, data);
+
+    Eip1559Tx tx;
+    addr_0x_to_20(usdc_contract, tx.to);
+    tx.gas_limit = 90000ULL;
+    tx.data = data;
+    tx.data_len = sizeof(data);
+    return send_eip1559_tx(rpc_url, from_addr_0x, privkey_0x, tx, out_txhash, out_err);
+}
+
 } // namespace tradeboy::arb
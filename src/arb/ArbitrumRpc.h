@@ -2,6 +2,8 @@
 
 #include <string>
 
+#include "arb/Eip1559Tx.h"
+
 namespace tradeboy::arb {
 
 struct WalletOnchainData {
@@ -11,13 +13,54 @@ struct WalletOnchainData {
     std::string gas;          // "GAS: ..."
 
     long double gas_price_wei = 0.0L;
+
+    // Raw values behind the formatted strings (see format_wallet_data).
+    long double eth_wei = 0.0L;
+    unsigned long long usdc_micro = 0;
+    unsigned long long block = 0; // block the balances were read at; 0 = latest
+};
+
+// Fills eth_balance / usdc_balance / gas from the raw fields.
+void format_wallet_data(WalletOnchainData& d);
+
+// One batched JSON-RPC round trip for the incremental balance tracker:
+// current head block and gas price, plus (when from_block <= to_block) the
+// USDC Transfer logs to or from the wallet in [from_block, to_block].
+struct WalletDeltaPoll {
+    unsigned long long head_block = 0;
+    long double gas_price_wei = 0.0L;
+
+    bool logs_queried = false;
+    long long usdc_delta_micro = 0; // net of incoming minus outgoing
+    int usdc_logs = 0;
 };
 
-bool fetch_wallet_data(const std::string& rpc_url,
-                       const std::string& wallet_address_0x,
-                       WalletOnchainData& out,
-                       std::string& out_err);
+// Wallet sync is split into request and reply halves; ArbitrumRpcService does
+// the HTTP round trip on the network reactor. Bodies are JSON-RPC batches;
+// parse_* take the raw reply.
+std::string wallet_deltas_request(const std::string& wallet_address_0x,
+                                  unsigned long long from_block,
+                                  unsigned long long to_block);
+bool parse_wallet_deltas(const std::string& resp, bool want_logs, WalletDeltaPoll& out, std::string& out_err);
+
+// ETH balance, gas price and USDC balance at one block, in one batch.
+std::string wallet_data_request(const std::string& wallet_address_0x, unsigned long long block);
+bool parse_wallet_data(const std::string& resp, unsigned long long block, WalletOnchainData& out, std::string& out_err);
+
+std::string eth_balance_request(const std::string& wallet_address_0x, unsigned long long block);
+bool parse_eth_balance(const std::string& resp, long double& out_wei, std::string& out_err);
+
+// Signs and broadcasts a type-2 transaction. The caller fills to/value/data/
+// gas_limit (and chain_id, default Arbitrum One); nonce and fees come from the
+// RPC, with one fee bump retry if the node reports the fee as too low.
+bool send_eip1559_tx(const std::string& rpc_url,
+                     const std::string& from_addr_0x,
+                     const std::string& privkey_0x,
+                     Eip1559Tx& tx,
+                     std::string& out_txhash,
+                     std::string& out_err);
 
+// ERC-20 USDC transfer on Arbitrum One, built on send_eip1559_tx.
 bool send_usdc_transfer_test(const std::string& rpc_url,
                              const std::string& from_addr_0x,
                              const std::string& privkey_0x,
@@ -26,6 +69,8 @@ bool send_usdc_transfer_test(const std::string& rpc_url,
                              std::string& out_txhash,
                              std::string& out_err);
 
+// Polls the receipt until min_confirmations. Returns early with out_err
+// "cancelled" when the thread's core::current_cancel() fires.
 bool wait_tx_confirmations(const std::string& rpc_url,
                            const std::string& txhash_0x,
                            int min_confirmations,
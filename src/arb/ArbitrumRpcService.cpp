@@ -1,18 +1,32 @@
 #include "ArbitrumRpcService.h"
 
-#include "arb/ArbitrumRpc.h"
+#include "core/WgetFetch.h"
 #include "model/TradeModel.h"
 
 #include <chrono>
+#include <cstdio>
 
 extern void log_str(const char* s);
 
 namespace tradeboy::arb {
 
+// One batched request per poll; cheap enough to run every second.
+static const int kPollIntervalMs = 1000;
+static const long long kReconcileIntervalMs = 60000;
+// ~20 minutes of Arbitrum blocks; longer gaps (sleep, network loss) re-read instead.
+static const unsigned long long kMaxLogRangeBlocks = 5000;
+
+static long long now_ms() {
+    return (long long)std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
 ArbitrumRpcService::ArbitrumRpcService(tradeboy::model::TradeModel& model,
+                                       tradeboy::core::Reactor& reactor,
                                        const std::string& rpc_url,
                                        const std::string& wallet_address_0x)
-    : model(model), rpc_url_(rpc_url), wallet_address_0x_(wallet_address_0x) {
+    : model(model), reactor_(reactor), rpc_url_(rpc_url), wallet_address_0x_(wallet_address_0x) {
     pthread_mutex_init(&mu, nullptr);
 }
 
@@ -22,14 +36,21 @@ ArbitrumRpcService::~ArbitrumRpcService() {
 }
 
 void ArbitrumRpcService::start() {
-    if (th.joinable()) return;
-    stop_flag = false;
-    th = std::thread([this]() { run(); });
+    reactor_.run_sync([this]() {
+        if (running_) return;
+        running_ = true;
+        timer_ = reactor_.add_timer(0, [this]() { poll(); });
+    });
 }
 
 void ArbitrumRpcService::stop() {
-    stop_flag = true;
-    if (th.joinable()) th.join();
+    reactor_.run_sync([this]() {
+        running_ = false;
+        reactor_.cancel_timer(timer_);
+        reactor_.cancel_spawn(inflight_);
+        timer_ = 0;
+        inflight_ = 0;
+    });
 }
 
 void ArbitrumRpcService::set_wallet(const std::string& rpc_url, const std::string& wallet_address_0x) {
@@ -39,38 +60,156 @@ void ArbitrumRpcService::set_wallet(const std::string& rpc_url, const std::strin
     pthread_mutex_unlock(&mu);
 }
 
-void ArbitrumRpcService::run() {
-    while (!stop_flag.load()) {
-        std::string rpc_url;
-        std::string wallet_address_0x;
-        {
-            pthread_mutex_lock(&mu);
-            rpc_url = rpc_url_;
-            wallet_address_0x = wallet_address_0x_;
-            pthread_mutex_unlock(&mu);
+void ArbitrumRpcService::schedule_next() {
+    if (!running_) return;
+    timer_ = reactor_.add_timer(kPollIntervalMs, [this]() { poll(); });
+}
+
+void ArbitrumRpcService::publish() {
+    format_wallet_data(base_);
+    model.set_arb_wallet_data(base_.eth_balance, base_.usdc_balance, base_.gas, base_.gas_price_wei, true);
+}
+
+void ArbitrumRpcService::fail(const std::string& err) {
+    have_base_ = false;
+    model.set_arb_wallet_data("", "", "", 0.0L, false);
+    if (!err.empty()) {
+        std::string line = std::string("[ARB] wallet poll failed: ") + err + "\n";
+        log_str(line.c_str());
+    }
+}
+
+void ArbitrumRpcService::poll() {
+    timer_ = 0;
+    {
+        pthread_mutex_lock(&mu);
+        const std::string rpc_url = rpc_url_;
+        const std::string wallet_address_0x = wallet_address_0x_;
+        pthread_mutex_unlock(&mu);
+        if (rpc_url != tracked_url_ || wallet_address_0x != tracked_wallet_) {
+            tracked_url_ = rpc_url;
+            tracked_wallet_ = wallet_address_0x;
+            have_base_ = false;
         }
+    }
 
-        if (!rpc_url.empty() && !wallet_address_0x.empty()) {
-            tradeboy::arb::WalletOnchainData d;
-            std::string e;
-            bool ok = tradeboy::arb::fetch_wallet_data(rpc_url, wallet_address_0x, d, e);
-            if (ok && d.rpc_ok) {
-                model.set_arb_wallet_data(d.eth_balance, d.usdc_balance, d.gas, d.gas_price_wei, true);
-            } else {
-                model.set_arb_wallet_data("", "", "", 0.0L, false);
-                if (!e.empty()) {
-                    log_str("[ARB] fetch_wallet_data failed\n");
-                }
-            }
-        } else {
-            model.set_arb_wallet_data("", "", "", 0.0L, false);
+    if (tracked_url_.empty() || tracked_wallet_.empty()) {
+        have_base_ = false;
+        model.set_arb_wallet_data("", "", "", 0.0L, false);
+        schedule_next();
+        return;
+    }
+
+    poll_ms_ = now_ms();
+    need_reconcile_ = !have_base_ || (poll_ms_ - last_reconcile_ms_) >= kReconcileIntervalMs;
+
+    // Logs are queried up to the head from the previous poll, so the range
+    // never runs past what the node has already reported.
+    from_block_ = (have_base_ && !need_reconcile_) ? last_block_ + 1 : 0;
+    to_block_ = known_head_;
+    if (from_block_ > 0 && to_block_ >= from_block_ && (to_block_ - from_block_) > kMaxLogRangeBlocks) {
+        need_reconcile_ = true;
+        from_block_ = 0;
+    }
+
+    inflight_ = tradeboy::core::wget_post_json(reactor_,
+                                               tracked_url_,
+                                               wallet_deltas_request(tracked_wallet_, from_block_, to_block_) + "\n",
+                                               [this](bool ok, std::string& resp) {
+                                                   inflight_ = 0;
+                                                   on_deltas(ok, resp);
+                                               });
+    if (!inflight_) {
+        fail("rpc_spawn_failed");
+        schedule_next();
+    }
+}
+
+void ArbitrumRpcService::on_deltas(bool ok, const std::string& resp) {
+    if (!ok) {
+        fail("rpc_no_response");
+        schedule_next();
+        return;
+    }
+    const bool want_logs = (from_block_ > 0 && from_block_ <= to_block_);
+    WalletDeltaPoll poll;
+    std::string e;
+    if (!parse_wallet_deltas(resp, want_logs, poll, e)) {
+        fail(e);
+        schedule_next();
+        return;
+    }
+    known_head_ = poll.head_block;
+
+    if (need_reconcile_) {
+        const unsigned long long head = poll.head_block;
+        inflight_ = tradeboy::core::wget_post_json(reactor_,
+                                                   tracked_url_,
+                                                   wallet_data_request(tracked_wallet_, head) + "\n",
+                                                   [this, head](bool ok2, std::string& resp2) {
+                                                       inflight_ = 0;
+                                                       on_reconcile(ok2, resp2, head);
+                                                   });
+        if (!inflight_) {
+            fail("rpc_spawn_failed");
+            schedule_next();
         }
+        return;
+    }
 
-        for (int i = 0; i < 20; i++) {
-            if (stop_flag.load()) break;
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    base_.gas_price_wei = poll.gas_price_wei;
+    if (poll.logs_queried) {
+        const long long next = (long long)base_.usdc_micro + poll.usdc_delta_micro;
+        if (next < 0) {
+            // Missed a log somewhere; re-read on the next tick.
+            have_base_ = false;
+            schedule_next();
+            return;
+        }
+        base_.usdc_micro = (unsigned long long)next;
+        last_block_ = to_block_;
+        if (poll.usdc_logs > 0) {
+            char line[128];
+            std::snprintf(line, sizeof(line), "[ARB] usdc logs=%d delta_micro=%lld blocks=%llu..%llu\n",
+                          poll.usdc_logs, poll.usdc_delta_micro, from_block_, to_block_);
+            log_str(line);
+            // An outgoing transfer also spent gas; incoming native ETH shows
+            // up at the next reconciliation.
+            inflight_ = tradeboy::core::wget_post_json(reactor_,
+                                                       tracked_url_,
+                                                       eth_balance_request(tracked_wallet_, to_block_) + "\n",
+                                                       [this](bool ok2, std::string& resp2) {
+                                                           inflight_ = 0;
+                                                           on_eth_balance(ok2, resp2);
+                                                       });
+            if (inflight_) return;
         }
     }
+    publish();
+    schedule_next();
+}
+
+void ArbitrumRpcService::on_reconcile(bool ok, const std::string& resp, unsigned long long head) {
+    WalletOnchainData d;
+    std::string e = "rpc_no_response";
+    if (ok && parse_wallet_data(resp, head, d, e) && d.rpc_ok) {
+        base_ = d;
+        have_base_ = true;
+        last_block_ = head;
+        last_reconcile_ms_ = poll_ms_;
+        publish();
+    } else {
+        fail(e);
+    }
+    schedule_next();
+}
+
+void ArbitrumRpcService::on_eth_balance(bool ok, const std::string& resp) {
+    long double wei = 0.0L;
+    std::string e;
+    if (ok && parse_eth_balance(resp, wei, e)) base_.eth_wei = wei;
+    publish();
+    schedule_next();
 }
 
 } // namespace tradeboy::arb
@@ -1,17 +1,21 @@
 #pragma once
 
-#include <atomic>
 #include <string>
-#include <thread>
 
 #include <pthread.h>
 
+#include "arb/ArbitrumRpc.h"
+#include "core/Reactor.h"
+
 namespace tradeboy::model { struct TradeModel; }
 
 namespace tradeboy::arb {
 
+// Wallet balance tracker, run as timers and wget children on the network
+// reactor: one poll in flight at a time, the next one a second after it ends.
 struct ArbitrumRpcService {
     ArbitrumRpcService(tradeboy::model::TradeModel& model,
+                       tradeboy::core::Reactor& reactor,
                        const std::string& rpc_url,
                        const std::string& wallet_address_0x);
     ~ArbitrumRpcService();
@@ -22,16 +26,44 @@ struct ArbitrumRpcService {
     void set_wallet(const std::string& rpc_url, const std::string& wallet_address_0x);
 
 private:
-    void run();
+    // Reactor thread.
+    void poll();
+    void on_deltas(bool ok, const std::string& resp);
+    void on_reconcile(bool ok, const std::string& resp, unsigned long long head);
+    void on_eth_balance(bool ok, const std::string& resp);
+    void publish();
+    void fail(const std::string& err);
+    void schedule_next();
 
     tradeboy::model::TradeModel& model;
+    tradeboy::core::Reactor& reactor_;
 
     pthread_mutex_t mu = PTHREAD_MUTEX_INITIALIZER;
     std::string rpc_url_;
     std::string wallet_address_0x_;
 
-    std::atomic<bool> stop_flag{false};
-    std::thread th;
+    // Reactor thread only.
+    bool running_ = false;
+    tradeboy::core::Reactor::TimerId timer_ = 0;
+    tradeboy::core::Reactor::ProcId inflight_ = 0;
+
+    // Incremental tracking: balances are read once at a known block, then
+    // advanced from USDC Transfer logs for each new block range. A full
+    // re-read reconciles periodically and whenever the delta path can't be
+    // trusted (RPC failure, long gap, odd amounts).
+    std::string tracked_url_;
+    std::string tracked_wallet_;
+    bool have_base_ = false;
+    WalletOnchainData base_;
+    unsigned long long last_block_ = 0;  // balances in base_ include this block
+    unsigned long long known_head_ = 0;  // head seen by the previous poll
+    long long last_reconcile_ms_ = 0;
+
+    // The poll in flight.
+    long long poll_ms_ = 0;
+    bool need_reconcile_ = false;
+    unsigned long long from_block_ = 0;
+    unsigned long long to_block_ = 0;
 };
 
 } // namespace tradeboy::arb
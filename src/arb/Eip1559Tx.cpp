@@ -0,0 +1,101 @@
+#include "arb/Eip1559Tx.h"
+
+#include "utils/Keccak.h"
+#include "utils/Rlp.h"
+
+#include <vector>
+
+namespace tradeboy::arb {
+
+using tradeboy::utils::RlpWriter;
+
+static const unsigned char kTxType = 0x02;
+
+// Signing payloads up to this size are hashed from a stack buffer. An ERC-20
+// transfer is ~120 bytes; only unusually large calldata falls back to the heap.
+static const size_t kStackTxBytes = 1024;
+
+void Eip1559Tx::set_value_u64(unsigned long long wei) {
+    for (int i = 0; i < 32; i++) value[i] = 0;
+    for (int i = 0; i < 8; i++) {
+        value[31 - i] = (unsigned char)(wei & 0xFF);
+        wei >>= 8;
+    }
+}
+
+static size_t fields_len(const Eip1559Tx& tx) {
+    return tradeboy::utils::rlp_len_u64(tx.chain_id) +
+           tradeboy::utils::rlp_len_u64(tx.nonce) +
+           tradeboy::utils::rlp_len_u64(tx.max_priority_fee_per_gas) +
+           tradeboy::utils::rlp_len_u64(tx.max_fee_per_gas) +
+           tradeboy::utils::rlp_len_u64(tx.gas_limit) +
+           tradeboy::utils::rlp_len_bytes(tx.to, 20) +
+           tradeboy::utils::rlp_len_u256(tx.value) +
+           tradeboy::utils::rlp_len_bytes(tx.data, tx.data_len) +
+           tradeboy::utils::rlp_len_list(0); // access_list
+}
+
+static void write_fields(const Eip1559Tx& tx, RlpWriter& w) {
+    w.u64(tx.chain_id);
+    w.u64(tx.nonce);
+    w.u64(tx.max_priority_fee_per_gas);
+    w.u64(tx.max_fee_per_gas);
+    w.u64(tx.gas_limit);
+    w.bytes(tx.to, 20);
+    w.u256(tx.value);
+    w.bytes(tx.data, tx.data_len);
+    w.list(0);
+}
+
+static size_t sig_len(int y_parity, const unsigned char r32[32], const unsigned char s32[32]) {
+    return tradeboy::utils::rlp_len_u64((unsigned long long)y_parity) +
+           tradeboy::utils::rlp_len_u256(r32) +
+           tradeboy::utils::rlp_len_u256(s32);
+}
+
+size_t eip1559_unsigned_size(const Eip1559Tx& tx) {
+    return 1 + tradeboy::utils::rlp_len_list(fields_len(tx));
+}
+
+size_t eip1559_encode_unsigned(const Eip1559Tx& tx, unsigned char* out, size_t cap) {
+    RlpWriter w(out, cap);
+    w.raw_byte(kTxType);
+    w.list(fields_len(tx));
+    write_fields(tx, w);
+    return w.overflow() ? 0 : w.size();
+}
+
+void eip1559_signing_hash(const Eip1559Tx& tx, unsigned char out_hash32[32]) {
+    const size_t n = eip1559_unsigned_size(tx);
+    if (n <= kStackTxBytes) {
+        unsigned char buf[kStackTxBytes];
+        eip1559_encode_unsigned(tx, buf, sizeof(buf));
+        tradeboy::utils::keccak_256(buf, n, out_hash32);
+        return;
+    }
+    std::vector<unsigned char> buf(n);
+    eip1559_encode_unsigned(tx, buf.data(), buf.size());
+    tradeboy::utils::keccak_256(buf.data(), n, out_hash32);
+}
+
+size_t eip1559_signed_size(const Eip1559Tx& tx, int y_parity, const unsigned char r32[32], const unsigned char s32[32]) {
+    return 1 + tradeboy::utils::rlp_len_list(fields_len(tx) + sig_len(y_parity, r32, s32));
+}
+
+size_t eip1559_encode_signed(const Eip1559Tx& tx,
+                             int y_parity,
+                             const unsigned char r32[32],
+                             const unsigned char s32[32],
+                             unsigned char* out,
+                             size_t cap) {
+    RlpWriter w(out, cap);
+    w.raw_byte(kTxType);
+    w.list(fields_len(tx) + sig_len(y_parity, r32, s32));
+    write_fields(tx, w);
+    w.u64((unsigned long long)y_parity);
+    w.u256(r32);
+    w.u256(s32);
+    return w.overflow() ? 0 : w.size();
+}
+
+} // namespace tradeboy::arb
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+
+namespace tradeboy::arb {
+
+// EIP-1559 (type 2) transaction with an empty access list.
+// Fixed-size fields plus a borrowed calldata pointer, so building, hashing and
+// serialising one does not allocate (see Eip1559Tx.cpp for the stack limit).
+struct Eip1559Tx {
+    unsigned long long chain_id = 0;
+    unsigned long long nonce = 0;
+    unsigned long long max_priority_fee_per_gas = 0;
+    unsigned long long max_fee_per_gas = 0;
+    unsigned long long gas_limit = 0;
+    unsigned char to[20] = {0};
+    unsigned char value[32] = {0}; // wei, uint256 big-endian
+    const unsigned char* data = nullptr; // not owned; must outlive the tx
+    size_t data_len = 0;
+
+    void set_value_u64(unsigned long long wei);
+};
+
+// Payload that is signed: 0x02 || rlp([chain_id, ..., data, access_list]).
+size_t eip1559_unsigned_size(const Eip1559Tx& tx);
+// Returns the number of bytes written, 0 if cap is too small.
+size_t eip1559_encode_unsigned(const Eip1559Tx& tx, unsigned char* out, size_t cap);
+void eip1559_signing_hash(const Eip1559Tx& tx, unsigned char out_hash32[32]);
+
+// Raw transaction for eth_sendRawTransaction: 0x02 || rlp([..., y_parity, r, s]).
+size_t eip1559_signed_size(const Eip1559Tx& tx, int y_parity, const unsigned char r32[32], const unsigned char s32[32]);
+size_t eip1559_encode_signed(const Eip1559Tx& tx,
+                             int y_parity,
+                             const unsigned char r32[32],
+                             const unsigned char s32[32],
+                             unsigned char* out,
+                             size_t cap);
+
+} // namespace tradeboy::arb
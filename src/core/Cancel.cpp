@@ -0,0 +1,126 @@
+#include "Cancel.h"
+
+#include <cerrno>
+#include <ctime>
+
+#include <poll.h>
+#include <stdint.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace tradeboy::core {
+
+static thread_local const CancelToken* tls_cancel = nullptr;
+
+static long long mono_ms() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000LL + (long long)(ts.tv_nsec / 1000000L);
+}
+
+// poll() that restarts on EINTR with whatever time is left.
+static int poll_for(pollfd* fds, nfds_t n, int timeout_ms) {
+    const long long deadline = (timeout_ms >= 0) ? mono_ms() + timeout_ms : -1;
+    for (;;) {
+        int wait_ms = -1;
+        if (deadline >= 0) {
+            const long long left = deadline - mono_ms();
+            wait_ms = (left > 0) ? (int)left : 0;
+        }
+        const int rc = poll(fds, n, wait_ms);
+        if (rc >= 0 || errno != EINTR) return rc;
+    }
+}
+
+CancelToken::CancelToken() {
+    fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+}
+
+CancelToken::~CancelToken() {
+    if (fd_ >= 0) close(fd_);
+}
+
+void CancelToken::cancel() {
+    if (cancelled_.exchange(true)) return;
+    // Never read back: the eventfd stays readable for every waiter.
+    const uint64_t one = 1;
+    if (fd_ >= 0) (void)write(fd_, &one, sizeof(one));
+}
+
+bool CancelToken::sleep_ms(int ms) const {
+    if (cancelled()) return false;
+    pollfd p;
+    p.fd = fd_;
+    p.events = POLLIN;
+    p.revents = 0;
+    (void)poll_for(&p, 1, ms);
+    return !cancelled();
+}
+
+int CancelToken::wait_readable(int fd, int timeout_ms) const {
+    return wait_fd(fd, POLLIN, timeout_ms);
+}
+
+int CancelToken::wait_writable(int fd, int timeout_ms) const {
+    return wait_fd(fd, POLLOUT, timeout_ms);
+}
+
+int CancelToken::wait_fd(int fd, short events, int timeout_ms) const {
+    if (cancelled()) return -1;
+    pollfd p[2];
+    p[0].fd = fd;
+    p[0].events = events;
+    p[0].revents = 0;
+    p[1].fd = fd_;
+    p[1].events = POLLIN;
+    p[1].revents = 0;
+    const int rc = poll_for(p, 2, timeout_ms);
+    if (rc < 0 || cancelled()) return -1;
+    if (rc == 0) return 0;
+    // Hangup/error count as ready: the read or write that follows reports it.
+    return (p[0].revents != 0) ? 1 : 0;
+}
+
+const CancelToken* current_cancel() {
+    return tls_cancel;
+}
+
+CancelScope::CancelScope(const CancelToken* token) : prev_(tls_cancel) {
+    tls_cancel = token;
+}
+
+CancelScope::~CancelScope() {
+    tls_cancel = prev_;
+}
+
+bool cancellable_sleep_ms(int ms) {
+    const CancelToken* t = tls_cancel;
+    if (t) return t->sleep_ms(ms);
+    pollfd none;
+    (void)poll_for(&none, 0, ms);
+    return true;
+}
+
+static int wait_fd(int fd, short events, int timeout_ms) {
+    pollfd p;
+    p.fd = fd;
+    p.events = events;
+    p.revents = 0;
+    const int rc = poll_for(&p, 1, timeout_ms);
+    if (rc < 0) return -1;
+    return (rc > 0) ? 1 : 0;
+}
+
+int wait_readable(int fd, int timeout_ms) {
+    const CancelToken* t = tls_cancel;
+    if (t) return t->wait_readable(fd, timeout_ms);
+    return wait_fd(fd, POLLIN, timeout_ms);
+}
+
+int wait_writable(int fd, int timeout_ms) {
+    const CancelToken* t = tls_cancel;
+    if (t) return t->wait_writable(fd, timeout_ms);
+    return wait_fd(fd, POLLOUT, timeout_ms);
+}
+
+} // namespace tradeboy::core
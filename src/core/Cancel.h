@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+
+namespace tradeboy::core {
+
+// One-shot abort signal for blocking work. Backed by an eventfd that turns
+// readable on cancel(), so a worker parked in poll() on a pipe or socket wakes
+// at once instead of at its next timeout.
+class CancelToken {
+public:
+    CancelToken();
+    ~CancelToken();
+
+    // Any thread; idempotent.
+    void cancel();
+    bool cancelled() const { return cancelled_.load(std::memory_order_acquire); }
+
+    // Sleeps up to ms. False if cancelled before or during the sleep.
+    bool sleep_ms(int ms) const;
+    // 1 when fd is readable, 0 on timeout (timeout_ms < 0 waits forever),
+    // -1 when cancelled or poll failed.
+    int wait_readable(int fd, int timeout_ms) const;
+    // Same for writable (a non-blocking connect() completing).
+    int wait_writable(int fd, int timeout_ms) const;
+
+private:
+    int wait_fd(int fd, short events, int timeout_ms) const;
+
+    int fd_ = -1;
+    std::atomic<bool> cancelled_{false};
+
+    CancelToken(const CancelToken&) = delete;
+    CancelToken& operator=(const CancelToken&) = delete;
+};
+
+// The token that governs blocking calls made on this thread, or nullptr. Set
+// by TaskPool workers around each task, so helpers deep in an action (wget
+// children, RPC retry sleeps, keep-alive reads) abort without every signature
+// in between carrying the token.
+const CancelToken* current_cancel();
+
+class CancelScope {
+public:
+    explicit CancelScope(const CancelToken* token);
+    ~CancelScope();
+
+private:
+    const CancelToken* prev_;
+
+    CancelScope(const CancelScope&) = delete;
+    CancelScope& operator=(const CancelScope&) = delete;
+};
+
+// current_cancel() aware versions of sleep and poll; plain blocking calls when
+// the thread has no token.
+bool cancellable_sleep_ms(int ms);
+int wait_readable(int fd, int timeout_ms);
+int wait_writable(int fd, int timeout_ms);
+
+} // namespace tradeboy::core
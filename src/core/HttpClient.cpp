@@ -0,0 +1,433 @@
+#include "HttpClient.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <unistd.h>
+
+#include "Cancel.h"
+#include "utils/Log.h"
+
+extern char** environ;
+
+namespace tradeboy::core {
+
+// Servers drop idle keep-alive sockets; reconnect proactively rather than
+// discovering a dead connection on the order path.
+static const long long kMaxIdleMs = 45000;
+static const int kConnectTimeoutMs = 5000;
+
+static long long now_ms() {
+    return (long long)std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+static std::string lower_ascii(std::string s) {
+    for (auto& c : s) c = (char)std::tolower((unsigned char)c);
+    return s;
+}
+
+// openssl is exec'd directly with its own argv, so the configured host never
+// goes through a shell, and in its own process group so a kill reaches it.
+static bool spawn_s_client(const std::string& host, int port, int& out_rfd, int& out_wfd, pid_t& out_pid) {
+    int in_pipe[2];
+    int out_pipe[2];
+    if (pipe2(in_pipe, O_CLOEXEC) != 0) return false;
+    if (pipe2(out_pipe, O_CLOEXEC) != 0) {
+        close(in_pipe[0]);
+        close(in_pipe[1]);
+        return false;
+    }
+
+    const std::string connect = host + ":" + std::to_string(port);
+    const char* argv[] = {"openssl", "s_client", "-quiet", "-connect", connect.c_str(), "-servername", host.c_str(),
+                          nullptr};
+
+    posix_spawn_file_actions_t fa;
+    posix_spawn_file_actions_init(&fa);
+    posix_spawn_file_actions_adddup2(&fa, in_pipe[0], STDIN_FILENO);
+    posix_spawn_file_actions_adddup2(&fa, out_pipe[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addopen(&fa, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP);
+    posix_spawnattr_setpgroup(&attr, 0);
+
+    pid_t pid = -1;
+    const int rc = posix_spawn(&pid, "/usr/bin/openssl", &fa, &attr, (char* const*)argv, environ);
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&fa);
+    close(in_pipe[0]);
+    close(out_pipe[1]);
+    if (rc != 0) {
+        close(in_pipe[1]);
+        close(out_pipe[0]);
+        return false;
+    }
+
+    out_wfd = in_pipe[1];
+    out_rfd = out_pipe[0];
+    out_pid = pid;
+    return true;
+}
+
+static bool connect_tcp(const std::string& host, int port, int& out_fd) {
+    out_fd = -1;
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    addrinfo* res = nullptr;
+    const std::string port_s = std::to_string(port);
+    if (getaddrinfo(host.c_str(), port_s.c_str(), &hints, &res) != 0 || !res) return false;
+
+    for (addrinfo* ai = res; ai; ai = ai->ai_next) {
+        int fd = socket(ai->ai_family, ai->ai_socktype | SOCK_NONBLOCK, ai->ai_protocol);
+        if (fd < 0) continue;
+        // Non-blocking connect so a cancelled task (exit) stops waiting on it.
+        bool connected = (::connect(fd, ai->ai_addr, ai->ai_addrlen) == 0);
+        if (!connected && errno == EINPROGRESS && wait_writable(fd, kConnectTimeoutMs) > 0) {
+            int so_err = 0;
+            socklen_t len = sizeof(so_err);
+            connected = (getsockopt(fd, SOL_SOCKET, SO_ERROR, &so_err, &len) == 0 && so_err == 0);
+        }
+        if (connected) {
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            out_fd = fd;
+            break;
+        }
+        close(fd);
+        const CancelToken* cancel = current_cancel();
+        if (cancel && cancel->cancelled()) break;
+    }
+    freeaddrinfo(res);
+    return out_fd >= 0;
+}
+
+HttpKeepAliveClient::HttpKeepAliveClient() {
+    pthread_mutex_init(&mu_, nullptr);
+}
+
+HttpKeepAliveClient::~HttpKeepAliveClient() {
+    disconnect();
+    pthread_mutex_destroy(&mu_);
+}
+
+bool HttpKeepAliveClient::set_url(const std::string& url) {
+    std::string rest;
+    bool tls = false;
+    int port = 0;
+    if (url.rfind("https://", 0) == 0) {
+        tls = true;
+        port = 443;
+        rest = url.substr(8);
+    } else if (url.rfind("http://", 0) == 0) {
+        tls = false;
+        port = 80;
+        rest = url.substr(7);
+    } else {
+        return false;
+    }
+
+    size_t slash = rest.find('/');
+    std::string hostport = (slash == std::string::npos) ? rest : rest.substr(0, slash);
+    std::string path = (slash == std::string::npos) ? std::string("/") : rest.substr(slash);
+    std::string host = hostport;
+    size_t colon = hostport.rfind(':');
+    if (colon != std::string::npos) {
+        host = hostport.substr(0, colon);
+        port = std::atoi(hostport.c_str() + colon + 1);
+    }
+    if (host.empty() || port <= 0) return false;
+
+    pthread_mutex_lock(&mu_);
+    if (url != url_) {
+        disconnect_locked();
+        url_ = url;
+        host_ = host;
+        path_ = path;
+        port_ = port;
+        tls_ = tls;
+    }
+    pthread_mutex_unlock(&mu_);
+    return true;
+}
+
+bool HttpKeepAliveClient::is_connected() const {
+    pthread_mutex_lock(&mu_);
+    bool ok = (rfd_ >= 0 && wfd_ >= 0);
+    pthread_mutex_unlock(&mu_);
+    return ok;
+}
+
+bool HttpKeepAliveClient::warm() {
+    const CancelToken* cancel = current_cancel();
+    pthread_mutex_lock(&mu_);
+    bool ok = true;
+    if (cancel && cancel->cancelled()) {
+        ok = false;
+    } else if (rfd_ < 0 || stale_locked()) {
+        disconnect_locked();
+        ok = connect_locked();
+    }
+    pthread_mutex_unlock(&mu_);
+    return ok;
+}
+
+void HttpKeepAliveClient::disconnect() {
+    pthread_mutex_lock(&mu_);
+    disconnect_locked();
+    pthread_mutex_unlock(&mu_);
+}
+
+bool HttpKeepAliveClient::connect_locked() {
+    if (host_.empty()) return false;
+    const long long t0 = now_ms();
+    bool ok = false;
+    if (tls_) {
+        ok = spawn_s_client(host_, port_, rfd_, wfd_, pid_);
+    } else {
+        int fd = -1;
+        ok = connect_tcp(host_, port_, fd);
+        if (ok) {
+            rfd_ = fd;
+            wfd_ = fd;
+        }
+    }
+    rx_.clear();
+    last_used_ms_ = now_ms();
+
+    std::string line = std::string("[HTTP] connect ") + host_ + ":" + std::to_string(port_) +
+                       (ok ? " ok" : " failed") + " ms=" + std::to_string(last_used_ms_ - t0) + "\n";
+    log_str(line.c_str());
+    return ok;
+}
+
+void HttpKeepAliveClient::disconnect_locked() {
+    if (wfd_ >= 0 && wfd_ != rfd_) close(wfd_);
+    if (rfd_ >= 0) close(rfd_);
+    rfd_ = -1;
+    wfd_ = -1;
+    rx_.clear();
+
+    // s_client has nothing to flush once its pipes are closed; killing it
+    // outright keeps exit and reconnects from waiting on it.
+    if (pid_ > 0) {
+        int st = 0;
+        kill(-pid_, SIGKILL);
+        while (waitpid(pid_, &st, 0) < 0 && errno == EINTR) {
+        }
+    }
+    pid_ = -1;
+}
+
+bool HttpKeepAliveClient::stale_locked() {
+    if (rfd_ < 0) return true;
+    if ((now_ms() - last_used_ms_) > kMaxIdleMs) return true;
+
+    // A readable fd between requests means the peer closed (EOF) or sent junk.
+    fd_set rfds;
+    FD_ZERO(&rfds);
+    FD_SET(rfd_, &rfds);
+    timeval tv;
+    tv.tv_sec = 0;
+    tv.tv_usec = 0;
+    int rc = select(rfd_ + 1, &rfds, nullptr, nullptr, &tv);
+    return rc != 0;
+}
+
+bool HttpKeepAliveClient::write_all_locked(const char* p, size_t n) {
+    size_t off = 0;
+    while (off < n) {
+        ssize_t w = ::write(wfd_, p + off, n - off);
+        if (w <= 0) return false;
+        off += (size_t)w;
+    }
+    return true;
+}
+
+bool HttpKeepAliveClient::fill_locked(int timeout_ms) {
+    // Also wakes (and fails the request) when the calling task is cancelled.
+    if (wait_readable(rfd_, timeout_ms) <= 0) {
+        rx_timed_out_ = true;
+        return false;
+    }
+
+    char buf[4096];
+    ssize_t r = ::read(rfd_, buf, sizeof(buf));
+    if (r <= 0) return false;
+    rx_.append(buf, (size_t)r);
+    rx_any_ = true;
+    return true;
+}
+
+bool HttpKeepAliveClient::read_line_locked(std::string& out, int timeout_ms) {
+    while (true) {
+        size_t nl = rx_.find("\r\n");
+        if (nl != std::string::npos) {
+            out.assign(rx_, 0, nl);
+            rx_.erase(0, nl + 2);
+            return true;
+        }
+        if (rx_.size() > 16384) return false;
+        if (!fill_locked(timeout_ms)) return false;
+    }
+}
+
+bool HttpKeepAliveClient::read_n_locked(size_t n, std::string& out, int timeout_ms) {
+    while (rx_.size() < n) {
+        if (!fill_locked(timeout_ms)) return false;
+    }
+    out.append(rx_, 0, n);
+    rx_.erase(0, n);
+    return true;
+}
+
+bool HttpKeepAliveClient::read_response_locked(int& out_status, std::string& out_body, bool& out_keep_alive, int timeout_ms) {
+    out_status = 0;
+    out_body.clear();
+    out_keep_alive = true;
+
+    std::string line;
+    if (!read_line_locked(line, timeout_ms)) return false;
+    // "HTTP/1.1 200 OK"
+    size_t sp = line.find(' ');
+    if (sp == std::string::npos || line.rfind("HTTP/", 0) != 0) return false;
+    out_status = std::atoi(line.c_str() + sp + 1);
+
+    long long content_len = -1;
+    bool chunked = false;
+    while (true) {
+        if (!read_line_locked(line, timeout_ms)) return false;
+        if (line.empty()) break;
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) continue;
+        std::string k = lower_ascii(line.substr(0, colon));
+        std::string v = line.substr(colon + 1);
+        while (!v.empty() && v[0] == ' ') v.erase(0, 1);
+        if (k == "content-length") {
+            content_len = std::atoll(v.c_str());
+        } else if (k == "transfer-encoding") {
+            chunked = (lower_ascii(v).find("chunked") != std::string::npos);
+        } else if (k == "connection") {
+            if (lower_ascii(v).find("close") != std::string::npos) out_keep_alive = false;
+        }
+    }
+
+    if (chunked) {
+        while (true) {
+            if (!read_line_locked(line, timeout_ms)) return false;
+            unsigned long n = std::strtoul(line.c_str(), nullptr, 16);
+            if (n == 0) {
+                // Trailer section ends with an empty line.
+                while (read_line_locked(line, timeout_ms) && !line.empty()) {
+                }
+                break;
+            }
+            if (!read_n_locked((size_t)n, out_body, timeout_ms)) return false;
+            if (!read_line_locked(line, timeout_ms)) return false;
+        }
+        return true;
+    }
+
+    if (content_len >= 0) {
+        return read_n_locked((size_t)content_len, out_body, timeout_ms);
+    }
+
+    // No framing: body runs until the peer closes.
+    out_keep_alive = false;
+    while (fill_locked(timeout_ms)) {
+    }
+    out_body.swap(rx_);
+    rx_.clear();
+    return true;
+}
+
+bool HttpKeepAliveClient::post_json(const std::string& body,
+                                    int& out_status,
+                                    std::string& out_body,
+                                    int timeout_ms,
+                                    bool& out_outcome_unknown) {
+    out_status = 0;
+    out_body.clear();
+    out_outcome_unknown = false;
+
+    pthread_mutex_lock(&mu_);
+
+    std::string req;
+    req.reserve(body.size() + 192);
+    req += "POST ";
+    req += path_;
+    req += " HTTP/1.1\r\nHost: ";
+    req += host_;
+    req += "\r\nContent-Type: application/json\r\nConnection: keep-alive\r\nContent-Length: ";
+    req += std::to_string(body.size());
+    req += "\r\n\r\n";
+    req += body;
+
+    // One transparent retry, only when the server cannot have acted on the
+    // request: the write failed, or a reused connection turned out to be dead
+    // (EOF/reset before any response byte). A retry after a timeout would
+    // re-submit an order that may already have filled, and the exchange would
+    // reject the duplicate nonce, so that is reported as an unknown outcome.
+    bool ok = false;
+    const CancelToken* cancel = current_cancel();
+    for (int attempt = 0; attempt < 2 && !ok; attempt++) {
+        if (cancel && cancel->cancelled()) break;
+        bool reused = true;
+        if (rfd_ < 0 || stale_locked()) {
+            disconnect_locked();
+            if (!connect_locked()) break;
+            reused = false;
+        }
+
+        if (!write_all_locked(req.data(), req.size())) {
+            log_str("[HTTP] write failed, retrying on a new connection\n");
+            disconnect_locked();
+            continue;
+        }
+
+        bool keep_alive = true;
+        rx_any_ = false;
+        rx_timed_out_ = false;
+        if (!read_response_locked(out_status, out_body, keep_alive, timeout_ms)) {
+            disconnect_locked();
+            if (reused && !rx_any_ && !rx_timed_out_) {
+                log_str("[HTTP] warm connection was dead, retrying\n");
+                continue;
+            }
+            log_str(rx_timed_out_ ? "[HTTP] no response in time, outcome unknown\n"
+                                  : "[HTTP] response cut off, outcome unknown\n");
+            out_outcome_unknown = true;
+            break;
+        }
+
+        ok = true;
+        last_used_ms_ = now_ms();
+        if (!keep_alive) disconnect_locked();
+    }
+
+    pthread_mutex_unlock(&mu_);
+    return ok;
+}
+
+} // namespace tradeboy::core
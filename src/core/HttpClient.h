@@ -0,0 +1,70 @@
+#pragma once
+
+#include <string>
+
+#include <pthread.h>
+#include <sys/types.h>
+
+namespace tradeboy::core {
+
+// Persistent HTTP/1.1 connection for latency-sensitive POSTs (order placement).
+// https:// goes through an `openssl s_client` child like the websocket feed;
+// plain http:// (e.g. a local stand-in /exchange for testing) uses a TCP socket.
+// The connection is opened ahead of time with warm() and reused across requests.
+struct HttpKeepAliveClient {
+    HttpKeepAliveClient();
+    ~HttpKeepAliveClient();
+
+    HttpKeepAliveClient(const HttpKeepAliveClient&) = delete;
+    HttpKeepAliveClient& operator=(const HttpKeepAliveClient&) = delete;
+
+    // Accepts http://host[:port]/path or https://host[:port]/path.
+    bool set_url(const std::string& url);
+    const std::string& url() const { return url_; }
+
+    // Connects if there is no live connection. Gives up when the thread's
+    // current_cancel() fires.
+    bool warm();
+    void disconnect();
+    bool is_connected() const;
+
+    // Sends one request on the warm connection (reconnecting if it went stale).
+    // out_status is the HTTP status code; out_body is the decoded body.
+    // Reads give up early when the thread's current_cancel() fires.
+    // out_outcome_unknown: the request went out but no complete response came
+    // back (timeout, cancel, cut-off reply); the server may have acted on it.
+    bool post_json(const std::string& body,
+                   int& out_status,
+                   std::string& out_body,
+                   int timeout_ms,
+                   bool& out_outcome_unknown);
+
+private:
+    bool connect_locked();
+    void disconnect_locked();
+    bool stale_locked();
+    bool write_all_locked(const char* p, size_t n);
+    bool fill_locked(int timeout_ms);
+    bool read_line_locked(std::string& out, int timeout_ms);
+    bool read_n_locked(size_t n, std::string& out, int timeout_ms);
+    bool read_response_locked(int& out_status, std::string& out_body, bool& out_keep_alive, int timeout_ms);
+
+    std::string url_;
+    std::string host_;
+    std::string path_;
+    int port_ = 0;
+    bool tls_ = false;
+
+    int rfd_ = -1;
+    int wfd_ = -1;
+    pid_t pid_ = -1;
+
+    std::string rx_;
+    bool rx_any_ = false;       // a response byte arrived for the current request
+    bool rx_timed_out_ = false; // a read gave up waiting (timeout or cancel)
+    long long last_used_ms_ = 0;
+
+    mutable pthread_mutex_t mu_;
+};
+
+} // namespace tradeboy::core
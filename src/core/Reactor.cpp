@@ -0,0 +1,343 @@
+#include "Reactor.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "utils/Log.h"
+
+extern char** environ;
+
+namespace tradeboy::core {
+
+// Set on the reactor thread so in_loop() needs no shared state.
+static thread_local const Reactor* tls_loop = nullptr;
+
+static long long mono_ms() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000LL + (long long)(ts.tv_nsec / 1000000L);
+}
+
+Reactor::Reactor() {
+    pthread_mutex_init(&mu_, nullptr);
+    pthread_cond_init(&done_cv_, nullptr);
+    ep_ = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (ep_ >= 0 && wake_fd_ >= 0 && timer_fd_ >= 0) {
+        epoll_event ev;
+        std::memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.fd = wake_fd_;
+        epoll_ctl(ep_, EPOLL_CTL_ADD, wake_fd_, &ev);
+        ev.data.fd = timer_fd_;
+        epoll_ctl(ep_, EPOLL_CTL_ADD, timer_fd_, &ev);
+    } else {
+        log_str("[Reactor] epoll/eventfd/timerfd setup failed\n");
+    }
+}
+
+Reactor::~Reactor() {
+    stop();
+    if (timer_fd_ >= 0) close(timer_fd_);
+    if (wake_fd_ >= 0) close(wake_fd_);
+    if (ep_ >= 0) close(ep_);
+    pthread_cond_destroy(&done_cv_);
+    pthread_mutex_destroy(&mu_);
+}
+
+bool Reactor::start() {
+    if (running_.load()) return true;
+    if (ep_ < 0 || wake_fd_ < 0 || timer_fd_ < 0) return false;
+    pthread_mutex_lock(&mu_);
+    quit_ = false;
+    pthread_mutex_unlock(&mu_);
+    running_.store(true);
+    th_ = std::thread([this]() { run(); });
+    log_str("[Reactor] started\n");
+    return true;
+}
+
+void Reactor::stop() {
+    if (!running_.load()) return;
+    run_sync([this]() {
+        for (auto& kv : procs_) drop_proc(kv.second, true);
+        procs_.clear();
+        timers_.clear();
+        timer_order_.clear();
+        for (auto& kv : watches_) epoll_ctl(ep_, EPOLL_CTL_DEL, kv.first, nullptr);
+        watches_.clear();
+    });
+    pthread_mutex_lock(&mu_);
+    quit_ = true;
+    pthread_mutex_unlock(&mu_);
+    const uint64_t one = 1;
+    (void)write(wake_fd_, &one, sizeof(one));
+    if (th_.joinable()) th_.join();
+    running_.store(false);
+    // Anything posted after the teardown never runs; drop it here.
+    pthread_mutex_lock(&mu_);
+    posted_.clear();
+    pthread_mutex_unlock(&mu_);
+    log_str("[Reactor] stopped\n");
+}
+
+bool Reactor::in_loop() const {
+    return tls_loop == this;
+}
+
+void Reactor::post(Fn fn) {
+    pthread_mutex_lock(&mu_);
+    posted_.push_back(std::move(fn));
+    pthread_mutex_unlock(&mu_);
+    const uint64_t one = 1;
+    (void)write(wake_fd_, &one, sizeof(one));
+}
+
+void Reactor::run_sync(const Fn& fn) {
+    if (in_loop() || !running_.load()) {
+        fn();
+        return;
+    }
+    bool done = false;
+    post([this, &fn, &done]() {
+        fn();
+        pthread_mutex_lock(&mu_);
+        done = true;
+        pthread_cond_broadcast(&done_cv_);
+        pthread_mutex_unlock(&mu_);
+    });
+    pthread_mutex_lock(&mu_);
+    while (!done) pthread_cond_wait(&done_cv_, &mu_);
+    pthread_mutex_unlock(&mu_);
+}
+
+Reactor::TimerId Reactor::add_timer(int delay_ms, Fn fn) {
+    if (delay_ms < 0) delay_ms = 0;
+    const TimerId id = next_timer_id_++;
+    Timer& t = timers_[id];
+    t.due_ms = mono_ms() + delay_ms;
+    t.fn = std::move(fn);
+    timer_order_.insert(std::make_pair(t.due_ms, id));
+    arm_timerfd();
+    return id;
+}
+
+void Reactor::cancel_timer(TimerId id) {
+    std::map<TimerId, Timer>::iterator it = timers_.find(id);
+    if (it == timers_.end()) return;
+    timer_order_.erase(std::make_pair(it->second.due_ms, id));
+    timers_.erase(it);
+}
+
+void Reactor::arm_timerfd() {
+    const long long due = timer_order_.empty() ? 0 : timer_order_.begin()->first;
+    if (due == armed_due_ms_) return;
+    itimerspec its;
+    std::memset(&its, 0, sizeof(its));
+    if (due > 0) {
+        its.it_value.tv_sec = (time_t)(due / 1000LL);
+        its.it_value.tv_nsec = (long)((due % 1000LL) * 1000000LL);
+        // A zero it_value disarms; anything already due fires right away.
+        if (its.it_value.tv_sec == 0 && its.it_value.tv_nsec == 0) its.it_value.tv_nsec = 1;
+    }
+    timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &its, nullptr);
+    armed_due_ms_ = due;
+}
+
+void Reactor::run_timers() {
+    uint64_t expirations = 0;
+    (void)read(timer_fd_, &expirations, sizeof(expirations));
+    armed_due_ms_ = -1;
+    const long long now = mono_ms();
+    while (!timer_order_.empty() && timer_order_.begin()->first <= now) {
+        const TimerId id = timer_order_.begin()->second;
+        timer_order_.erase(timer_order_.begin());
+        std::map<TimerId, Timer>::iterator it = timers_.find(id);
+        if (it == timers_.end()) continue;
+        Fn fn = std::move(it->second.fn);
+        timers_.erase(it);
+        fn();
+    }
+}
+
+bool Reactor::watch(int fd, uint32_t events, IoFn fn) {
+    epoll_event ev;
+    std::memset(&ev, 0, sizeof(ev));
+    ev.events = events;
+    ev.data.fd = fd;
+    const bool existed = watches_.count(fd) > 0;
+    if (epoll_ctl(ep_, existed ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &ev) != 0) return false;
+    watches_[fd] = std::make_shared<IoFn>(std::move(fn));
+    return true;
+}
+
+void Reactor::unwatch(int fd) {
+    std::map<int, std::shared_ptr<IoFn> >::iterator it = watches_.find(fd);
+    if (it == watches_.end()) return;
+    epoll_ctl(ep_, EPOLL_CTL_DEL, fd, nullptr);
+    watches_.erase(it);
+}
+
+Reactor::ProcId Reactor::spawn(const std::string& cmd, ProcFn done, const std::string& unlink_path) {
+    int pfd[2];
+    if (pipe2(pfd, O_CLOEXEC) != 0) {
+        if (!unlink_path.empty()) ::unlink(unlink_path.c_str());
+        return 0;
+    }
+
+    posix_spawn_file_actions_t fa;
+    posix_spawn_file_actions_init(&fa);
+    posix_spawn_file_actions_adddup2(&fa, pfd[1], STDOUT_FILENO);
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    // Own process group, so a cancel reaches whatever sh started too.
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP);
+    posix_spawnattr_setpgroup(&attr, 0);
+
+    pid_t pid = -1;
+    const char* argv[] = {"sh", "-c", cmd.c_str(), nullptr};
+    const int rc = posix_spawn(&pid, "/bin/sh", &fa, &attr, (char* const*)argv, environ);
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&fa);
+    close(pfd[1]);
+    if (rc != 0) {
+        close(pfd[0]);
+        if (!unlink_path.empty()) ::unlink(unlink_path.c_str());
+        return 0;
+    }
+    fcntl(pfd[0], F_SETFL, fcntl(pfd[0], F_GETFL) | O_NONBLOCK);
+
+    const ProcId id = next_proc_id_++;
+    Proc& p = procs_[id];
+    p.pid = pid;
+    p.fd = pfd[0];
+    p.unlink_path = unlink_path;
+    p.done = std::move(done);
+    if (!watch(p.fd, EPOLLIN, [this, id](uint32_t) { on_proc_readable(id); })) {
+        drop_proc(p, true);
+        procs_.erase(id);
+        return 0;
+    }
+    return id;
+}
+
+void Reactor::on_proc_readable(ProcId id) {
+    std::map<ProcId, Proc>::iterator it = procs_.find(id);
+    if (it == procs_.end()) return;
+    Proc& p = it->second;
+    char buf[4096];
+    for (;;) {
+        const ssize_t n = read(p.fd, buf, sizeof(buf));
+        if (n > 0) {
+            p.out.append(buf, (size_t)n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+        break; // EOF or error: the child closed stdout
+    }
+    unwatch(p.fd);
+    close(p.fd);
+    p.fd = -1;
+    reap(id);
+}
+
+void Reactor::reap(ProcId id) {
+    std::map<ProcId, Proc>::iterator it = procs_.find(id);
+    if (it == procs_.end()) return;
+    int st = 0;
+    const pid_t rc = waitpid(it->second.pid, &st, WNOHANG);
+    if (rc == 0) {
+        // stdout is closed but the child has not exited yet; look again shortly.
+        add_timer(10, [this, id]() { reap(id); });
+        return;
+    }
+    Proc p = std::move(it->second);
+    procs_.erase(it);
+    if (!p.unlink_path.empty()) ::unlink(p.unlink_path.c_str());
+    const bool ok = (rc == p.pid) && WIFEXITED(st) && WEXITSTATUS(st) == 0;
+    if (p.done) p.done(ok, p.out);
+}
+
+void Reactor::cancel_spawn(ProcId id) {
+    std::map<ProcId, Proc>::iterator it = procs_.find(id);
+    if (it == procs_.end()) return;
+    drop_proc(it->second, true);
+    procs_.erase(it);
+}
+
+void Reactor::drop_proc(Proc& p, bool kill_first) {
+    if (p.fd >= 0) {
+        unwatch(p.fd);
+        close(p.fd);
+        p.fd = -1;
+    }
+    if (p.pid > 0) {
+        if (kill_first) kill(-p.pid, SIGKILL);
+        int st = 0;
+        waitpid(p.pid, &st, 0);
+        p.pid = -1;
+    }
+    if (!p.unlink_path.empty()) {
+        ::unlink(p.unlink_path.c_str());
+        p.unlink_path.clear();
+    }
+}
+
+void Reactor::drain_posted() {
+    uint64_t n = 0;
+    (void)read(wake_fd_, &n, sizeof(n));
+    std::vector<Fn> batch;
+    pthread_mutex_lock(&mu_);
+    batch.swap(posted_);
+    pthread_mutex_unlock(&mu_);
+    for (size_t i = 0; i < batch.size(); i++) batch[i]();
+}
+
+void Reactor::run() {
+    tls_loop = this;
+    epoll_event evs[16];
+    for (;;) {
+        pthread_mutex_lock(&mu_);
+        const bool quit = quit_;
+        pthread_mutex_unlock(&mu_);
+        if (quit) break;
+
+        arm_timerfd();
+        const int n = epoll_wait(ep_, evs, (int)(sizeof(evs) / sizeof(evs[0])), -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            log_str("[Reactor] epoll_wait failed\n");
+            break;
+        }
+        for (int i = 0; i < n; i++) {
+            const int fd = evs[i].data.fd;
+            if (fd == wake_fd_) {
+                drain_posted();
+            } else if (fd == timer_fd_) {
+                run_timers();
+            } else {
+                // Looked up per event: an earlier callback may have dropped it.
+                std::map<int, std::shared_ptr<IoFn> >::iterator it = watches_.find(fd);
+                if (it == watches_.end()) continue;
+                std::shared_ptr<IoFn> fn = it->second;
+                (*fn)(evs[i].events);
+            }
+        }
+    }
+    tls_loop = nullptr;
+}
+
+} // namespace tradeboy::core
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+namespace tradeboy::core {
+
+// The one network thread. Sockets and child-process pipes are watched with
+// epoll, every timer shares a single timerfd, and other threads hand work in
+// through an eventfd, so the thread sleeps until something is actually due.
+// Callbacks run on the reactor thread and must not block.
+class Reactor {
+public:
+    typedef std::function<void()> Fn;
+    typedef std::function<void(uint32_t events)> IoFn;
+    // ok: the child exited 0. out: everything it wrote to stdout.
+    typedef std::function<void(bool ok, std::string& out)> ProcFn;
+    typedef unsigned long long TimerId;
+    typedef unsigned long long ProcId;
+
+    Reactor();
+    ~Reactor();
+
+    bool start();
+    // Kills outstanding children, drops timers and watches, joins the thread.
+    void stop();
+    bool in_loop() const;
+
+    // Any thread.
+    void post(Fn fn);
+    // Any thread; returns after fn ran. Inline on the reactor thread or when
+    // the reactor is not running.
+    void run_sync(const Fn& fn);
+
+    // Reactor thread (or before start). One-shot; re-add from the callback
+    // for periodic work.
+    TimerId add_timer(int delay_ms, Fn fn);
+    void cancel_timer(TimerId id);
+
+    bool watch(int fd, uint32_t events, IoFn fn);
+    void unwatch(int fd);
+
+    // Runs `sh -c cmd` in its own process group with stdout on a pipe the
+    // reactor drains. unlink_path (if any) is removed once the child is gone,
+    // whether it finished or was cancelled. Returns 0 if the spawn failed.
+    ProcId spawn(const std::string& cmd, ProcFn done, const std::string& unlink_path = std::string());
+    // Kills the child (and anything it started); done is never called.
+    void cancel_spawn(ProcId id);
+
+private:
+    struct Timer {
+        long long due_ms = 0;
+        Fn fn;
+    };
+
+    struct Proc {
+        pid_t pid = -1;
+        int fd = -1;
+        std::string out;
+        std::string unlink_path;
+        ProcFn done;
+    };
+
+    void run();
+    void drain_posted();
+    void run_timers();
+    void arm_timerfd();
+    void on_proc_readable(ProcId id);
+    void reap(ProcId id);
+    void drop_proc(Proc& p, bool kill_first);
+
+    int ep_ = -1;
+    int wake_fd_ = -1;
+    int timer_fd_ = -1;
+    long long armed_due_ms_ = -1;
+
+    std::thread th_;
+    std::atomic<bool> running_{false};
+    bool quit_ = false; // guarded by mu_
+
+    pthread_mutex_t mu_;
+    pthread_cond_t done_cv_;
+    std::vector<Fn> posted_;
+
+    TimerId next_timer_id_ = 1;
+    std::map<TimerId, Timer> timers_;
+    std::set<std::pair<long long, TimerId> > timer_order_;
+
+    std::map<int, std::shared_ptr<IoFn> > watches_;
+
+    ProcId next_proc_id_ = 1;
+    std::map<ProcId, Proc> procs_;
+
+    Reactor(const Reactor&) = delete;
+    Reactor& operator=(const Reactor&) = delete;
+};
+
+} // namespace tradeboy::core
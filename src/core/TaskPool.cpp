@@ -0,0 +1,130 @@
+#include "TaskPool.h"
+
+#include <cstdio>
+
+#include "utils/FrameSchedule.h"
+#include "utils/Log.h"
+
+namespace tradeboy::core {
+
+TaskPool::TaskPool() {
+    pthread_mutex_init(&mu_, nullptr);
+    pthread_cond_init(&cv_, nullptr);
+    for (int i = 0; i < kTaskKindCount; i++) busy_[i].store(false);
+}
+
+TaskPool::~TaskPool() {
+    stop();
+    drain([](const TaskResult&) {});
+    pthread_cond_destroy(&cv_);
+    pthread_mutex_destroy(&mu_);
+}
+
+void TaskPool::start(int workers) {
+    if (!threads_.empty()) return;
+    pthread_mutex_lock(&mu_);
+    stopping_ = false;
+    pthread_mutex_unlock(&mu_);
+    for (int i = 0; i < workers; i++) {
+        threads_.push_back(std::thread([this]() { run_worker(); }));
+    }
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "[TaskPool] started workers=%d\n", workers);
+    log_str(buf);
+}
+
+void TaskPool::cancel() {
+    cancel_.cancel();
+}
+
+void TaskPool::stop() {
+    if (threads_.empty()) return;
+    cancel_.cancel();
+    pthread_mutex_lock(&mu_);
+    stopping_ = true;
+    pthread_cond_broadcast(&cv_);
+    pthread_mutex_unlock(&mu_);
+    for (auto& t : threads_) {
+        if (t.joinable()) t.join();
+    }
+    threads_.clear();
+    log_str("[TaskPool] stopped\n");
+}
+
+bool TaskPool::busy(TaskKind kind) const {
+    return busy_[(int)kind].load();
+}
+
+bool TaskPool::submit(TaskKind kind, std::function<void(TaskResult&)> fn) {
+    if (busy_[(int)kind].exchange(true)) return false;
+    push(kind, true, std::move(fn));
+    return true;
+}
+
+void TaskPool::enqueue(TaskKind kind, std::function<void(TaskResult&)> fn) {
+    push(kind, false, std::move(fn));
+}
+
+void TaskPool::push(TaskKind kind, bool exclusive, std::function<void(TaskResult&)> fn) {
+    pthread_mutex_lock(&mu_);
+    Task t;
+    t.kind = kind;
+    t.exclusive = exclusive;
+    t.fn = std::move(fn);
+    queue_.push_back(std::move(t));
+    pthread_cond_signal(&cv_);
+    pthread_mutex_unlock(&mu_);
+}
+
+void TaskPool::run_worker() {
+    CancelScope scope(&cancel_);
+    for (;;) {
+        pthread_mutex_lock(&mu_);
+        while (queue_.empty() && !stopping_) pthread_cond_wait(&cv_, &mu_);
+        // Queued work still runs on stop so every submit gets its result;
+        // with the token cancelled it fails fast instead of blocking.
+        if (queue_.empty()) {
+            pthread_mutex_unlock(&mu_);
+            return;
+        }
+        Task t = std::move(queue_.front());
+        queue_.pop_front();
+        pthread_mutex_unlock(&mu_);
+
+        Done* d = new Done();
+        d->result.kind = t.kind;
+        t.fn(d->result);
+        if (t.exclusive) busy_[(int)t.kind].store(false);
+        post(d);
+    }
+}
+
+void TaskPool::post(Done* d) {
+    Done* head = done_.load();
+    do {
+        d->next = head;
+    } while (!done_.compare_exchange_weak(head, d));
+    tradeboy::utils::wake_frame_loop();
+}
+
+void TaskPool::drain(const std::function<void(const TaskResult&)>& fn) {
+    Done* list = done_.exchange(nullptr);
+    if (!list) return;
+
+    // Pushed newest first; flip so results are seen in completion order.
+    Done* fifo = nullptr;
+    while (list) {
+        Done* next = list->next;
+        list->next = fifo;
+        fifo = list;
+        list = next;
+    }
+    while (fifo) {
+        Done* next = fifo->next;
+        fn(fifo->result);
+        delete fifo;
+        fifo = next;
+    }
+}
+
+} // namespace tradeboy::core
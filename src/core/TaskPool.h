@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <pthread.h>
+
+#include "Cancel.h"
+
+namespace tradeboy::core {
+
+// Background actions the UI hands off. At most one of each kind is queued or
+// running at a time, except Prepare (see enqueue).
+enum class TaskKind {
+    Deposit = 0,
+    Transfer = 1,
+    Withdraw = 2,
+    Order = 3,
+    Warm = 4,
+    Prepare = 5,
+};
+
+static const int kTaskKindCount = 6;
+
+struct TaskResult {
+    TaskKind kind = TaskKind::Warm;
+    bool ok = false;
+    std::string body;           // alert text; empty means nothing to show
+    bool refresh_user = false;  // balances moved, restart the user streams
+};
+
+// Fixed set of worker threads fed from one queue. Results come back through a
+// lock-free list the UI thread drains once per frame, so the UI never waits on
+// a worker and no thread is created per action. Tasks run under the pool's
+// CancelToken (see current_cancel()), which is how exit interrupts them.
+class TaskPool {
+public:
+    TaskPool();
+    ~TaskPool();
+
+    void start(int workers);
+    // Any thread: aborts the blocking waits of running and queued tasks.
+    // Their results still arrive, as failures.
+    void cancel();
+    // Cancels, lets the workers unwind through what is still queued, then
+    // joins. Call once, at exit.
+    void stop();
+
+    bool busy(TaskKind kind) const;
+
+    // False (and fn dropped) when a task of this kind is already pending.
+    // fn runs on a worker and fills in the result; kind is preset.
+    bool submit(TaskKind kind, std::function<void(TaskResult&)> fn);
+    // submit without the one-per-kind limit, for work that notices on its own
+    // that a newer run superseded it (order prepare checks a generation).
+    void enqueue(TaskKind kind, std::function<void(TaskResult&)> fn);
+
+    // UI thread: hands each finished result to fn, oldest first.
+    void drain(const std::function<void(const TaskResult&)>& fn);
+
+private:
+    struct Task {
+        TaskKind kind;
+        bool exclusive;
+        std::function<void(TaskResult&)> fn;
+    };
+
+    struct Done {
+        TaskResult result;
+        Done* next = nullptr;
+    };
+
+    void push(TaskKind kind, bool exclusive, std::function<void(TaskResult&)> fn);
+    void run_worker();
+    void post(Done* d);
+
+    pthread_mutex_t mu_;
+    pthread_cond_t cv_;
+    std::deque<Task> queue_;
+    bool stopping_ = false;
+    std::vector<std::thread> threads_;
+
+    CancelToken cancel_;
+    std::atomic<bool> busy_[kTaskKindCount];
+    std::atomic<Done*> done_{nullptr};
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+};
+
+} // namespace tradeboy::core
@@ -0,0 +1,33 @@
+#include "WgetFetch.h"
+
+#include <cstdio>
+
+#include <unistd.h>
+
+namespace tradeboy::core {
+
+Reactor::ProcId wget_post_json(Reactor& reactor, const std::string& url, const std::string& body, Reactor::ProcFn done) {
+    // Requests overlap now, so each gets its own body file.
+    static unsigned long long seq = 0;
+    char path[64];
+    std::snprintf(path, sizeof(path), "/tmp/tb_post_%d_%llu.json", (int)getpid(), ++seq);
+
+    FILE* f = std::fopen(path, "wb");
+    if (!f) return 0;
+    const size_t w = std::fwrite(body.data(), 1, body.size(), f);
+    std::fclose(f);
+    if (w != body.size()) {
+        ::unlink(path);
+        return 0;
+    }
+
+    std::string cmd = "/usr/bin/wget -qO- --header=\"Content-Type: application/json\" --post-file=";
+    cmd += path;
+    cmd += " ";
+    cmd += url;
+    return reactor.spawn(cmd,
+                         [done](bool ok, std::string& out) { done(ok && !out.empty(), out); },
+                         path);
+}
+
+} // namespace tradeboy::core
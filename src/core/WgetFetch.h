@@ -0,0 +1,15 @@
+#pragma once
+
+#include <string>
+
+#include "Reactor.h"
+
+namespace tradeboy::core {
+
+// POSTs a JSON body through a /usr/bin/wget child on the reactor (the device
+// has wget with TLS but no TLS libs for us to link). done gets the response
+// body; ok is false if wget failed or returned nothing. Reactor thread only;
+// the returned id can be passed to Reactor::cancel_spawn.
+Reactor::ProcId wget_post_json(Reactor& reactor, const std::string& url, const std::string& body, Reactor::ProcFn done);
+
+} // namespace tradeboy::core
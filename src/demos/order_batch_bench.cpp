@@ -0,0 +1,133 @@
+// Order batch benchmark (host build: make order-batch-bench).
+//
+// Compares N orders in one signed action against N single-order actions.
+// Without arguments only the offline part (msgpack + keccak + ECDSA + JSON) is
+// measured. With an exchange URL (e.g. a local stand-in /exchange) it also
+// posts both variants over the keep-alive connection:
+//
+//   ./order-batch-bench http://127.0.0.1:18080/exchange
+//
+// Uses the well-known ethers.js test key; never point this at a real account.
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "market/HyperliquidOrder.h"
+
+static bool g_verbose = false;
+
+void log_str(const char* s) {
+    if (g_verbose && s) std::fputs(s, stderr);
+}
+
+static const char* kBenchWallet = "0x2c7536e3605d9c16a7a3d7b1898e529396a65c23";
+static const char* kBenchKey = "0x4c0883a69102937d6231471b5dbb6204fe5129617082792ae468d01a3f362318";
+
+static double now_us() {
+    return (double)std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// A buy ladder 0.1% apart below 25.0 on spot asset 10107.
+static void make_ladder(size_t n, std::vector<tradeboy::market::OrderWire>& out) {
+    out.clear();
+    out.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        tradeboy::market::OrderWire o;
+        o.asset = 10107;
+        o.is_buy = true;
+        o.px = tradeboy::market::hl_wire_price(25.0 * (1.0 - 0.001 * (double)(i + 1)), 2, true);
+        o.sz = tradeboy::market::hl_wire_size(0.5, 2);
+        o.tif = "Gtc";
+        out.push_back(o);
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string url;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "-v") == 0) g_verbose = true;
+        else url = argv[i];
+    }
+
+    static const size_t kSizes[] = {1, 2, 4, 8, 16, 32};
+    static const int kReps = 10;
+
+    tradeboy::market::HyperliquidOrderClient client;
+    client.configure(url, true);
+
+    std::vector<tradeboy::market::OrderWire> orders;
+    std::vector<tradeboy::market::OrderWire> single(1);
+    std::string body;
+    std::string err;
+    unsigned long long nonce = 1700000000000ULL;
+
+    std::printf("offline sign (avg of %d)\n", kReps);
+    std::printf("%6s %12s %14s %14s %8s\n", "n", "batch_ms", "per_order_ms", "singles_ms", "bytes");
+    for (size_t si = 0; si < sizeof(kSizes) / sizeof(kSizes[0]); si++) {
+        const size_t n = kSizes[si];
+        make_ladder(n, orders);
+
+        double t0 = now_us();
+        for (int r = 0; r < kReps; r++) {
+            if (!client.sign_orders(kBenchWallet, kBenchKey, orders, nonce++, body, err)) {
+                std::fprintf(stderr, "sign failed: %s\n", err.c_str());
+                return 1;
+            }
+        }
+        const double batch_ms = (now_us() - t0) / 1000.0 / kReps;
+        const size_t bytes = body.size();
+
+        t0 = now_us();
+        for (int r = 0; r < kReps; r++) {
+            for (size_t i = 0; i < n; i++) {
+                single[0] = orders[i];
+                client.sign_orders(kBenchWallet, kBenchKey, single, nonce++, body, err);
+            }
+        }
+        const double singles_ms = (now_us() - t0) / 1000.0 / kReps;
+
+        std::printf("%6u %12.3f %14.3f %14.3f %8u\n", (unsigned int)n, batch_ms, batch_ms / (double)n, singles_ms, (unsigned int)bytes);
+    }
+
+    if (url.empty()) return 0;
+
+    if (!client.warm()) {
+        std::fprintf(stderr, "connect failed: %s\n", url.c_str());
+        return 1;
+    }
+
+    std::vector<tradeboy::market::OrderStatus> statuses;
+    std::string resp;
+    std::printf("\nround trip via %s\n", url.c_str());
+    std::printf("%6s %12s %14s %14s %6s\n", "n", "batch_ms", "per_order_ms", "singles_ms", "ok");
+    for (size_t si = 0; si < sizeof(kSizes) / sizeof(kSizes[0]); si++) {
+        const size_t n = kSizes[si];
+        make_ladder(n, orders);
+
+        double t0 = now_us();
+        if (!client.place_orders(kBenchWallet, kBenchKey, orders, 0, statuses, resp, err)) {
+            std::fprintf(stderr, "batch failed: %s\n", err.c_str());
+            return 1;
+        }
+        const double batch_ms = (now_us() - t0) / 1000.0;
+        unsigned int ok_n = 0;
+        for (size_t i = 0; i < statuses.size(); i++) {
+            if (statuses[i].ok) ok_n++;
+        }
+
+        t0 = now_us();
+        for (size_t i = 0; i < n; i++) {
+            single[0] = orders[i];
+            client.place_orders(kBenchWallet, kBenchKey, single, 0, statuses, resp, err);
+        }
+        const double singles_ms = (now_us() - t0) / 1000.0;
+
+        std::printf("%6u %12.3f %14.3f %14.3f %3u/%-2u\n", (unsigned int)n, batch_ms, batch_ms / (double)n, singles_ms, ok_n, (unsigned int)n);
+    }
+    return 0;
+}
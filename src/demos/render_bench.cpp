@@ -0,0 +1,456 @@
+// Headless UI render benchmark (host build: make render-bench).
+//
+// Builds ImGui draw data for the screens and dialogs with no window and no GL
+// (the lists are generated, never submitted) and reports per frame: CPU time,
+// draw-list vertex/index counts and heap allocations.
+//
+//   ./render-bench [frames] [-v]
+//   ./render-bench-crt --crt [frames] [-v]
+//
+// --crt (make render-bench-crt) also submits the lists through the CRT filter
+// at each quality tier and reports wall time per frame including glFinish. It
+// needs a GLES2 context; none is shown, so a software renderer works:
+//
+//   EGL_PLATFORM=surfaceless LIBGL_ALWAYS_SOFTWARE=1 ./render-bench-crt --crt
+//
+// With cour-new.ttf / cour-new-BOLDITALIC.ttf in the working directory or
+// output/ the device fonts are used so text metrics match; otherwise the ImGui
+// default font stands in.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include "imgui.h"
+
+#include "account/AccountScreen.h"
+#include "model/TradeModel.h"
+#include "spot/SpotIndex.h"
+#include "spot/SpotScreen.h"
+#include "ui/Dialog.h"
+#include "ui/NumberInputModal.h"
+
+#ifdef RENDER_BENCH_CRT
+#include <EGL/egl.h>
+
+#include "backends/imgui_impl_opengl3.h"
+#include "filters/CrtFilter.h"
+#endif
+
+static bool g_verbose = false;
+static bool g_count_allocs = false;
+static unsigned long long g_allocs = 0;
+
+void log_str(const char* s) {
+    if (g_verbose && s) std::fputs(s, stderr);
+}
+
+// Every C++ and ImGui heap allocation in the timed region counts.
+void* operator new(size_t n) {
+    if (g_count_allocs) g_allocs++;
+    void* p = std::malloc(n ? n : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t n) {
+    if (g_count_allocs) g_allocs++;
+    void* p = std::malloc(n ? n : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+static void* imgui_alloc(size_t n, void*) {
+    if (g_count_allocs) g_allocs++;
+    return std::malloc(n);
+}
+
+static void imgui_free(void* p, void*) { std::free(p); }
+
+static double now_us() {
+    return (double)std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+static bool file_exists(const char* path) {
+    struct stat st;
+    return stat(path, &st) == 0;
+}
+
+static const char* find_file(const char* name, std::string& buf) {
+    if (file_exists(name)) return name;
+    buf = std::string("output/") + name;
+    return file_exists(buf.c_str()) ? buf.c_str() : nullptr;
+}
+
+static void make_rows(size_t n, std::vector<tradeboy::model::SpotRow>& out) {
+    out.clear();
+    out.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        char sym[16];
+        std::snprintf(sym, sizeof(sym), "C%04u", (unsigned int)i);
+        tradeboy::model::SpotRow r;
+        r.coin = std::string("@") + std::to_string(i);
+        r.sym = sym;
+        r.price = 1.0 + 37.0 * (double)(i % 97);
+        r.prev_day_px = r.price * (1.0 + 0.01 * (double)((int)(i % 11) - 5));
+        r.price_decimals = (int)(i % 5);
+        r.asset_id = 10000 + (int)i;
+        r.balance = (i % 3 == 0) ? 0.5 * (double)(i % 7) : 0.0;
+        out.push_back(r);
+    }
+}
+
+struct Totals {
+    double us = 0.0;
+    double worst_us = 0.0;
+    unsigned long long vtx = 0;
+    unsigned long long idx = 0;
+    unsigned long long allocs = 0;
+    int frames = 0;
+};
+
+template <typename Fn>
+static void run_frame(Totals& t, Fn&& draw) {
+    ImGuiIO& io = ImGui::GetIO();
+    io.DeltaTime = 1.0f / 60.0f;
+
+    g_allocs = 0;
+    g_count_allocs = true;
+    const double t0 = now_us();
+
+    ImGui::NewFrame();
+    ImGui::SetNextWindowPos(ImVec2(0, 0), ImGuiCond_Always);
+    ImGui::SetNextWindowSize(io.DisplaySize, ImGuiCond_Always);
+    ImGuiWindowFlags wflags = ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoResize |
+                              ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoSavedSettings |
+                              ImGuiWindowFlags_NoBackground;
+    ImGui::Begin("Bench", nullptr, wflags);
+    draw();
+    ImGui::End();
+    ImGui::Render();
+
+    const double dt = now_us() - t0;
+    g_count_allocs = false;
+
+    const ImDrawData* dd = ImGui::GetDrawData();
+    t.us += dt;
+    if (dt > t.worst_us) t.worst_us = dt;
+    t.vtx += dd ? (unsigned long long)dd->TotalVtxCount : 0;
+    t.idx += dd ? (unsigned long long)dd->TotalIdxCount : 0;
+    t.allocs += g_allocs;
+    t.frames++;
+}
+
+static void report(const char* name, size_t rows, const Totals& t) {
+    const double n = t.frames > 0 ? (double)t.frames : 1.0;
+    std::printf("%-14s %6u %10.3f %10.3f %9.0f %9.0f %10.1f\n",
+                name,
+                (unsigned int)rows,
+                t.us / n / 1000.0,
+                t.worst_us / 1000.0,
+                (double)t.vtx / n,
+                (double)t.idx / n,
+                (double)t.allocs / n);
+}
+
+#ifdef RENDER_BENCH_CRT
+// Offscreen GLES2 context on a pbuffer the size of the device screen.
+static bool make_gl_context(int w, int h) {
+    EGLDisplay dpy = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (dpy == EGL_NO_DISPLAY || !eglInitialize(dpy, nullptr, nullptr)) return false;
+    const EGLint cfg_attrs[] = {EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+                                EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+                                EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+                                EGL_DEPTH_SIZE, 16,
+                                EGL_NONE};
+    EGLConfig cfg;
+    EGLint n = 0;
+    if (!eglChooseConfig(dpy, cfg_attrs, &cfg, 1, &n) || n < 1) return false;
+    const EGLint surf_attrs[] = {EGL_WIDTH, w, EGL_HEIGHT, h, EGL_NONE};
+    EGLSurface surf = eglCreatePbufferSurface(dpy, cfg, surf_attrs);
+    if (surf == EGL_NO_SURFACE) return false;
+    eglBindAPI(EGL_OPENGL_ES_API);
+    const EGLint ctx_attrs[] = {EGL_CONTEXT_CLIENT_VERSION, 2, EGL_NONE};
+    EGLContext ctx = eglCreateContext(dpy, cfg, EGL_NO_CONTEXT, ctx_attrs);
+    if (ctx == EGL_NO_CONTEXT) return false;
+    return eglMakeCurrent(dpy, surf, surf, ctx) == EGL_TRUE;
+}
+
+// One frame as main.cpp presents it: through the filter's FBO unless the tier
+// is Off. glFinish so the GPU (or llvmpipe) work lands inside the timing.
+template <typename Fn>
+static void run_crt_frame(Totals& t, tradeboy::filters::CrtFilter& crt, bool overlay, Fn&& draw) {
+    ImGuiIO& io = ImGui::GetIO();
+    io.DeltaTime = 1.0f / 60.0f;
+    const double t0 = now_us();
+
+    ImGui_ImplOpenGL3_NewFrame();
+    ImGui::NewFrame();
+    ImGui::SetNextWindowPos(ImVec2(0, 0), ImGuiCond_Always);
+    ImGui::SetNextWindowSize(io.DisplaySize, ImGuiCond_Always);
+    ImGui::Begin("Bench", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoSavedSettings);
+    draw();
+    ImGui::End();
+    ImGui::Render();
+
+    if (crt.active()) {
+        crt.begin();
+        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        crt.set_overlay_rect_uv(ImVec4(0.2f, 0.25f, 0.8f, 0.75f), overlay);
+        crt.end((float)t.frames / 60.0f);
+    } else {
+        glViewport(0, 0, (int)io.DisplaySize.x, (int)io.DisplaySize.y);
+        glClearColor(0.10f, 0.11f, 0.09f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    }
+    glFinish();
+
+    const double dt = now_us() - t0;
+    t.us += dt;
+    if (dt > t.worst_us) t.worst_us = dt;
+    t.frames++;
+}
+
+static int run_crt_bench(int frames, ImFont* font_bold) {
+    ImGuiIO& io = ImGui::GetIO();
+    const int w = (int)io.DisplaySize.x;
+    const int h = (int)io.DisplaySize.y;
+    if (!make_gl_context(w, h)) {
+        std::fprintf(stderr, "no GLES2 context (try EGL_PLATFORM=surfaceless LIBGL_ALWAYS_SOFTWARE=1)\n");
+        return 1;
+    }
+    std::printf("GL_RENDERER=%s\n", (const char*)glGetString(GL_RENDERER));
+    ImGui_ImplOpenGL3_Init("#version 100");
+
+    tradeboy::filters::CrtFilter crt;
+    if (!crt.init(w, h)) {
+        std::fprintf(stderr, "CRT filter init failed\n");
+        ImGui_ImplOpenGL3_Shutdown();
+        return 1;
+    }
+
+    std::vector<tradeboy::model::SpotRow> rows;
+    make_rows(500, rows);
+    std::printf("%-14s %8s %10s %10s\n", "case", "tier", "frame_ms", "worst_ms");
+
+    static const tradeboy::filters::CrtQuality kTiers[] = {
+        tradeboy::filters::CrtQuality::Full,
+        tradeboy::filters::CrtQuality::Reduced,
+        tradeboy::filters::CrtQuality::Off,
+    };
+    for (size_t ti = 0; ti < sizeof(kTiers) / sizeof(kTiers[0]); ti++) {
+        crt.set_quality(kTiers[ti]);
+        // set_quality falls back a tier when the driver rejects a program.
+        const char* tier = tradeboy::filters::crt_quality_name(crt.quality());
+
+        Totals tick;
+        for (int f = 0; f < frames; f++) {
+            for (size_t i = 0; i < rows.size(); i++) rows[i].price *= (f & 1) ? 1.0001 : (1.0 / 1.0001);
+            run_crt_frame(tick, crt, false, [&] { tradeboy::spot::render_spot_screen(rows, 0, 0, 0, false, false, font_bold); });
+        }
+        const double n = (double)std::max(1, tick.frames);
+        std::printf("%-14s %8s %10.3f %10.3f\n", "spot-tick", tier, tick.us / n / 1000.0, tick.worst_us / 1000.0);
+
+        // Dialog open: the backdrop blur is the expensive part of the shader.
+        Totals dlg;
+        int sel = 1;
+        for (int f = 0; f < frames; f++) {
+            run_crt_frame(dlg, crt, true, [&] {
+                tradeboy::spot::render_spot_screen(rows, 0, 0, 0, false, false, font_bold);
+                tradeboy::ui::render_dialog("BenchDialog", "> ", "Order placed\nPress A to close", "OK", "CANCEL",
+                                            &sel, 0, 1.0f, font_bold, nullptr);
+            });
+        }
+        const double nd = (double)std::max(1, dlg.frames);
+        std::printf("%-14s %8s %10.3f %10.3f\n", "dialog-blur", tier, dlg.us / nd / 1000.0, dlg.worst_us / 1000.0);
+    }
+
+    crt.shutdown();
+    ImGui_ImplOpenGL3_Shutdown();
+    return 0;
+}
+#endif
+
+int main(int argc, char** argv) {
+    int frames = 600;
+    bool crt_mode = false;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "-v") == 0) g_verbose = true;
+        else if (std::strcmp(argv[i], "--crt") == 0) crt_mode = true;
+        else frames = std::max(1, std::atoi(argv[i]));
+    }
+#ifndef RENDER_BENCH_CRT
+    if (crt_mode) {
+        std::fprintf(stderr, "built without GL; use make render-bench-crt for --crt\n");
+        return 1;
+    }
+#endif
+
+    ImGui::SetAllocatorFunctions(imgui_alloc, imgui_free, nullptr);
+    IMGUI_CHECKVERSION();
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename = nullptr;
+    io.DisplaySize = ImVec2(720.0f, 480.0f);
+
+    std::string path_buf;
+    std::string bold_buf;
+    const char* font_path = find_file("cour-new.ttf", path_buf);
+    const char* font_path_bold = find_file("cour-new-BOLDITALIC.ttf", bold_buf);
+    ImFont* font_bold = nullptr;
+    if (font_path) {
+        ImFontConfig cfg;
+        cfg.OversampleH = 1;
+        cfg.OversampleV = 1;
+        cfg.PixelSnapH = true;
+        ImFont* f = io.Fonts->AddFontFromFileTTF(font_path, 28.0f, &cfg);
+        if (f) io.FontDefault = f;
+    }
+    if (font_path_bold) {
+        ImFontConfig cfg;
+        cfg.OversampleH = 1;
+        cfg.OversampleV = 1;
+        cfg.PixelSnapH = true;
+        font_bold = io.Fonts->AddFontFromFileTTF(font_path_bold, 28.0f, &cfg);
+    }
+    unsigned char* pixels = nullptr;
+    int tex_w = 0, tex_h = 0;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &tex_w, &tex_h);
+
+    std::printf("%d frames per case, font=%s\n", frames, font_path ? font_path : "imgui-default");
+#ifdef RENDER_BENCH_CRT
+    if (crt_mode) {
+        const int rc = run_crt_bench(frames, font_bold);
+        ImGui::DestroyContext();
+        return rc;
+    }
+#endif
+    std::printf("%-14s %6s %10s %10s %9s %9s %10s\n", "case", "rows", "cpu_ms", "worst_ms", "vtx", "idx", "allocs");
+
+    static const size_t kRowCounts[] = {10, 500, 5000};
+    std::vector<tradeboy::model::SpotRow> rows;
+    for (size_t ri = 0; ri < sizeof(kRowCounts) / sizeof(kRowCounts[0]); ri++) {
+        const size_t n = kRowCounts[ri];
+        make_rows(n, rows);
+
+        // Nothing changes between frames: the steady state the device idles in.
+        Totals idle;
+        for (int f = 0; f < frames; f++) {
+            run_frame(idle, [&] { tradeboy::spot::render_spot_screen(rows, 0, 0, 0, false, false, font_bold); });
+        }
+        report("spot-idle", n, idle);
+
+        // Every price moves every frame, as with a busy allMids stream.
+        Totals tick;
+        for (int f = 0; f < frames; f++) {
+            for (size_t i = 0; i < rows.size(); i++) rows[i].price *= (f & 1) ? 1.0001 : (1.0 / 1.0001);
+            run_frame(tick, [&] { tradeboy::spot::render_spot_screen(rows, 0, 0, 0, false, false, font_bold); });
+        }
+        report("spot-tick", n, tick);
+
+        // Selection walks down the list one row per frame, paging as it goes.
+        Totals scroll;
+        for (int f = 0; f < frames; f++) {
+            const int sel = f % (int)n;
+            const int page = (sel / 7) * 7;
+            run_frame(scroll, [&] { tradeboy::spot::render_spot_screen(rows, page, sel, 0, false, false, font_bold); });
+        }
+        report("spot-scroll", n, scroll);
+
+        // Symbol search narrowing one letter at a time ("C", "C0", "C00", ...)
+        // with the lookup inside the timed frame, as App::render does it.
+        tradeboy::spot::SpotSymbolIndex index;
+        static const char* kQueries[] = {"C", "C0", "C00", "C001", "C0012"};
+        Totals search;
+        for (int f = 0; f < frames; f++) {
+            const char* q = kQueries[(f / 10) % 5];
+            run_frame(search, [&] {
+                index.update(rows);
+                int lo = 0;
+                int hi = 0;
+                index.find(q, lo, hi);
+                tradeboy::spot::SpotSearchView view;
+                view.order = index.order().data() + lo;
+                view.count = hi - lo;
+                view.prefix = q;
+                view.pending = 'A';
+                tradeboy::spot::render_spot_screen(rows, 0, 0, 0, false, false, font_bold, false, false, false, nullptr, nullptr, &view);
+            });
+        }
+        report("spot-search", n, search);
+    }
+
+    {
+        Totals acct;
+        for (int f = 0; f < frames; f++) {
+            run_frame(acct, [&] {
+                tradeboy::account::render_account_screen(0, -1, 0, font_bold,
+                                                         "1234.56", "789.01", "$2,023.57",
+                                                         "12.3456", "0.61%", "+40.12", "-3.50",
+                                                         "0x2c75...5c23", "0.012345", "250.00",
+                                                         "GAS: 0.01 GWEI", "TRANSATION FEE: $0.0123");
+            });
+        }
+        report("account", 0, acct);
+    }
+
+    {
+        make_rows(500, rows);
+        Totals dlg;
+        int sel = 1;
+        for (int f = 0; f < frames; f++) {
+            run_frame(dlg, [&] {
+                tradeboy::spot::render_spot_screen(rows, 0, 0, 0, false, false, font_bold);
+                tradeboy::ui::render_dialog("BenchDialog",
+                                            "> ",
+                                            "Order placed\nBUY 0.5 C0001 @ 38.00\nPress A to close",
+                                            "OK",
+                                            "CANCEL",
+                                            &sel,
+                                            0,
+                                            1.0f,
+                                            font_bold,
+                                            nullptr);
+            });
+        }
+        report("dialog", 500, dlg);
+    }
+
+    {
+        tradeboy::ui::NumberInputState modal;
+        tradeboy::ui::NumberInputConfig cfg;
+        cfg.title = "BUY C0001";
+        cfg.min_value = 0.01;
+        cfg.max_value = 1000.0;
+        cfg.allowed_decimals = 2;
+        cfg.available_label = "USDC";
+        cfg.price_label = "PRICE: $38.00";
+        cfg.price = 38.0;
+        modal.open_with(cfg);
+        modal.input = "12.5";
+        Totals num;
+        for (int f = 0; f < frames; f++) {
+            run_frame(num, [&] { tradeboy::ui::render(modal, font_bold); });
+        }
+        report("number-input", 0, num);
+    }
+
+    ImGui::DestroyContext();
+    return 0;
+}
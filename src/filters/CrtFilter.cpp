@@ -1,6 +1,10 @@
 #include "filters/CrtFilter.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdio>
+#include <string>
+#include <vector>
 
 #include "utils/Log.h"
 
@@ -43,11 +47,255 @@ static GLuint link_program(GLuint vs, GLuint fs) {
     return prog;
 }
 
+static GLuint make_texture(int w, int h, GLint filter, const void* pixels) {
+    GLuint tex = 0;
+    glGenTextures(1, &tex);
+    glBindTexture(GL_TEXTURE_2D, tex);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return tex;
+}
+
+static const char* kCrtVsSrc =
+    "attribute vec2 aPos;\n"
+    "attribute vec2 aUV;\n"
+    "varying vec2 vUV;\n"
+    "void main(){\n"
+    "  vUV = aUV;\n"
+    "  gl_Position = vec4(aPos, 0.0, 1.0);\n"
+    "}\n";
+
+static const char* kCrtFsSrc =
+    "precision mediump float;\n"
+    // 16-bit lookup coordinates need more than fp16 to decode exactly.
+    "#ifdef GL_FRAGMENT_PRECISION_HIGH\n"
+    "#define LUTP highp\n"
+    "#else\n"
+    "#define LUTP mediump\n"
+    "#endif\n"
+    "varying vec2 vUV;\n"
+    "uniform sampler2D uTex;\n"
+    "uniform LUTP sampler2D uLut;\n"
+    "uniform sampler2D uBlurTex;\n"
+    "uniform float uUseLut;\n"
+    "uniform float uBlurHalf;\n"
+    "uniform vec2 uResolution;\n"
+    "uniform float uTime;\n"
+    "uniform float uScanStrength;\n"
+    "uniform float uVignetteStrength;\n"
+    "uniform float uRgbShift;\n"
+    "uniform float uBulge;\n"
+    "uniform float uZoom;\n"
+    "uniform vec3 uTint;\n"
+    "uniform vec4 uOverlayRect;\n"
+    "uniform float uOverlayActive;\n"
+    "uniform float uOverlayBlurStrength;\n"
+    "uniform float uOverlayDarken;\n"
+    "uniform float uPoweroffT;\n"
+    "uniform float uPoweroffActive;\n"
+    "uniform float uBootT;\n"
+    "uniform float uBootActive;\n"
+    "float hash12(vec2 p){\n"
+    "  vec3 p3 = fract(vec3(p.xyx) * 0.1031);\n"
+    "  p3 += dot(p3, p3.yzx + 33.33);\n"
+    "  return fract((p3.x + p3.y) * p3.z);\n"
+    "}\n"
+    "float easeInOut(float t){\n"
+    "  t = clamp(t, 0.0, 1.0);\n"
+    "  return t * t * (3.0 - 2.0 * t);\n"
+    "}\n"
+    "float sat(float x){ return clamp(x, 0.0, 1.0); }\n"
+    "vec2 quantUV(vec2 uv, float cells){\n"
+    "  vec2 g = vec2(cells, cells * (uResolution.y / uResolution.x));\n"
+    "  return (floor(uv * g) + 0.5) / g;\n"
+    "}\n"
+    "void main(){\n"
+    "  vec2 baseUV = vUV;\n"
+    "  LUTP vec2 uv = baseUV;\n"
+    "  bool poweroffOn = (uPoweroffActive > 0.5);\n"
+    "  bool bootOn = (!poweroffOn && uBootActive > 0.5);\n"
+    // Zoom + bulge come from the lookup built at init; the power-off squeeze
+    // changes the mapping every frame, so it keeps the per-pixel math.
+    "  if (!poweroffOn && uUseLut > 0.5) {\n"
+    "    LUTP vec4 l = texture2D(uLut, baseUV);\n"
+    "    if (l.r > 0.999 && l.g > 0.999) {\n"
+    "      gl_FragColor = vec4(0.0,0.0,0.0,1.0);\n"
+    "      return;\n"
+    "    }\n"
+    "    const LUTP vec2 kDec = vec2(65280.0 / 65535.0, 255.0 / 65535.0);\n"
+    "    uv = vec2(dot(l.rg, kDec), dot(l.ba, kDec));\n"
+    "  } else {\n"
+    "  if (poweroffOn) {\n"
+    "    float t = clamp(uPoweroffT, 0.0, 1.0);\n"
+    "    float tLine = easeInOut(min(1.0, t / 0.65));\n"
+    "    float tDot  = easeInOut((t - 0.65) / 0.35);\n"
+    "    float sy = mix(1.0, 0.006, tLine);\n"
+    "    float sx = mix(1.0, 0.006, tDot);\n"
+    "    uv = (uv - 0.5) * vec2(sx, sy) + 0.5;\n"
+    "  }\n"
+    "  uv = (uv - 0.5) / uZoom + 0.5;\n"
+    "  vec2 c = uv * 2.0 - 1.0;\n"
+    "  float r2 = dot(c,c);\n"
+    "  uv = (c * (1.0 + uBulge * r2)) * 0.5 + 0.5;\n"
+    "  if (uv.x < 0.0 || uv.x > 1.0 || uv.y < 0.0 || uv.y > 1.0) {\n"
+    "    gl_FragColor = vec4(0.0,0.0,0.0,1.0);\n"
+    "    return;\n"
+    "  }\n"
+    "  }\n"
+    "  vec2 px = vec2(1.0 / uResolution.x, 1.0 / uResolution.y);\n"
+    "  vec2 shift = vec2(uRgbShift * px.x, 0.0);\n"
+    "  bool outsideOverlay = false;\n"
+    "  if (uOverlayActive > 0.5) {\n"
+    "    outsideOverlay = (baseUV.x < uOverlayRect.x || baseUV.x > uOverlayRect.z || baseUV.y < uOverlayRect.y || baseUV.y > uOverlayRect.w);\n"
+    "  }\n"
+    "  vec4 colC;\n"
+    "  if (outsideOverlay && uBlurHalf > 0.5) {\n"
+    "    colC = vec4(texture2D(uBlurTex, uv).rgb, 1.0);\n"
+    "  } else {\n"
+    "    colC = texture2D(uTex, uv);\n"
+    "  }\n"
+    "#if CRT_FULL\n"
+    "  if (outsideOverlay && uBlurHalf < 0.5) {\n"
+    "    float s = uOverlayBlurStrength;\n"
+    "    vec2 o = px * (1.5 * s);\n"
+    "    vec3 c1 = texture2D(uTex, uv + vec2(o.x, 0.0)).rgb;\n"
+    "    vec3 c2 = texture2D(uTex, uv - vec2(o.x, 0.0)).rgb;\n"
+    "    vec3 c3 = texture2D(uTex, uv + vec2(0.0, o.y)).rgb;\n"
+    "    vec3 c4 = texture2D(uTex, uv - vec2(0.0, o.y)).rgb;\n"
+    "    vec3 cb = (colC.rgb * 0.40 + (c1 + c2 + c3 + c4) * 0.15);\n"
+    "    colC = vec4(cb, 1.0);\n"
+    "  }\n"
+    "  float r = texture2D(uTex, uv + shift).r;\n"
+    "  float g = colC.g;\n"
+    "  float b = texture2D(uTex, uv - shift).b;\n"
+    "  vec3 col = vec3(r,g,b);\n"
+    "#else\n"
+    "  vec3 col = colC.rgb;\n"
+    "#endif\n"
+    "  float scan = 0.5 + 0.5 * sin((uv.y * uResolution.y) * 3.14159);\n"
+    "  col *= 1.0 - uScanStrength * scan;\n"
+    "  vec2 dv = uv - 0.5;\n"
+    "  float vig = 1.0 - uVignetteStrength * smoothstep(0.15, 0.70, dot(dv,dv));\n"
+    "  col *= vig;\n"
+    "#if CRT_FULL\n"
+    "  float n = (hash12(uv * uResolution + uTime * 60.0) - 0.5) * 0.02;\n"
+    "  col += n;\n"
+    "#endif\n"
+    "  float luma = dot(col, vec3(0.299, 0.587, 0.114));\n"
+    "  float tintW = 1.0 - smoothstep(0.55, 0.78, luma);\n"
+    "  tintW = tintW * tintW;\n"
+    "  float maxRB = max(col.r, col.b);\n"
+    "  float greenDom = smoothstep(0.06, 0.22, col.g - maxRB);\n"
+    "  float w = tintW * greenDom;\n"
+    "  float kRG = uTint.x;\n"
+    "  float gGain = uTint.y;\n"
+    "  float bCut = uTint.z;\n"
+    "  float g2 = col.g * mix(1.0, gGain, w);\n"
+    "  col.r = mix(col.r, col.r + g2 * kRG, w);\n"
+    "  col.g = g2;\n"
+    "  col.b = mix(col.b, col.b * (1.0 - bCut), w);\n"
+    "  col = clamp(col, 0.0, 1.0);\n"
+    "  if (outsideOverlay) {\n"
+    "    col *= (1.0 - uOverlayDarken);\n"
+    "  }\n"
+    "  if (poweroffOn) {\n"
+    "    float t = clamp(uPoweroffT, 0.0, 1.0);\n"
+    "    float tLine = easeInOut(min(1.0, t / 0.65));\n"
+    "    float tDot  = easeInOut((t - 0.65) / 0.35);\n"
+    "    float sy = mix(1.0, 0.006, tLine);\n"
+    "    float sx = mix(1.0, 0.006, tDot);\n"
+    "    float ay = abs(baseUV.y - 0.5);\n"
+    "    float ax = abs(baseUV.x - 0.5);\n"
+    "    float fy = 0.020 + 0.030 * (1.0 - tLine);\n"
+    "    float fx = 0.020 + 0.030 * (1.0 - tDot);\n"
+    "    float my = 1.0 - smoothstep(sy * 0.5, sy * 0.5 + fy, ay);\n"
+    "    float mx = 1.0 - smoothstep(sx * 0.5, sx * 0.5 + fx, ax);\n"
+    "    float m = my * mix(1.0, mx, tDot);\n"
+    "    float glow = (1.0 - t) * 0.45;\n"
+    "    col *= m;\n"
+    "    col += glow * m;\n"
+    "  }\n"
+
+    "  if (bootOn) {\n"
+    "    float t = clamp(uBootT, 0.0, 1.0);\n"
+    "    float wSnow = 1.0 - smoothstep(0.26, 0.38, t);\n"
+    "    float wMosaic = smoothstep(0.22, 0.40, t) * (1.0 - smoothstep(0.86, 0.98, t));\n"
+    "    float wNormal = smoothstep(0.86, 1.00, t);\n"
+
+    "    float n0 = hash12(baseUV * uResolution + uTime * 120.0);\n"
+    "    float n1 = hash12(baseUV * uResolution * 0.7 + uTime * 240.0);\n"
+    "    float snow = sat(n0 * 0.65 + n1 * 0.35);\n"
+    "    snow = pow(snow, 1.6);\n"
+
+    "    float jitterW = 1.0 - smoothstep(0.40, 0.85, t);\n"
+    "    float jitter = (hash12(vec2(uTime * 60.0, baseUV.y * 931.0)) - 0.5) * jitterW;\n"
+    "    vec2 uvJ = clamp(baseUV + vec2(jitter * 0.025, 0.0), 0.0, 1.0);\n"
+
+    "    float tm = smoothstep(0.40, 0.90, t);\n"
+    "    float cells = mix(22.0, 110.0, tm);\n"
+    "    vec2 uvM = quantUV(uvJ, cells);\n"
+    "    vec3 cM = texture2D(uTex, uvM).rgb;\n"
+    "    float grain = mix(0.36, 0.08, tm);\n"
+    "    vec3 g = vec3(hash12(baseUV * uResolution * mix(0.9, 2.6, tm) + uTime * 190.0) - 0.5);\n"
+    "    cM = clamp(cM + g * grain, 0.0, 1.0);\n"
+
+    "    vec3 outCol = vec3(0.0);\n"
+    "    outCol += vec3(snow) * wSnow;\n"
+    "    outCol += cM * wMosaic;\n"
+    "    outCol += col * wNormal;\n"
+
+    "    float flick = 0.90 + 0.10 * sin(uTime * 40.0);\n"
+    "    outCol *= flick;\n"
+    "    col = outCol;\n"
+    "  }\n"
+    "  gl_FragColor = vec4(col, 1.0);\n"
+    "}\n";
+
+// Overlay blur pre-pass, drawn into a half-size target: the bilinear
+// downsample already averages 2x2 texels, so the 5 taps run on a quarter of
+// the pixels.
+static const char* kBlurFsSrc =
+    "precision mediump float;\n"
+    "varying vec2 vUV;\n"
+    "uniform sampler2D uTex;\n"
+    "uniform vec2 uPx;\n"
+    "uniform float uStrength;\n"
+    "void main(){\n"
+    "  vec2 o = uPx * (1.5 * uStrength);\n"
+    "  vec3 c0 = texture2D(uTex, vUV).rgb;\n"
+    "  vec3 c1 = texture2D(uTex, vUV + vec2(o.x, 0.0)).rgb;\n"
+    "  vec3 c2 = texture2D(uTex, vUV - vec2(o.x, 0.0)).rgb;\n"
+    "  vec3 c3 = texture2D(uTex, vUV + vec2(0.0, o.y)).rgb;\n"
+    "  vec3 c4 = texture2D(uTex, vUV - vec2(0.0, o.y)).rgb;\n"
+    "  gl_FragColor = vec4(c0 * 0.40 + (c1 + c2 + c3 + c4) * 0.15, 1.0);\n"
+    "}\n";
+
 } // namespace
 
 namespace tradeboy {
 namespace filters {
 
+const char* crt_quality_name(CrtQuality q) {
+    switch (q) {
+        case CrtQuality::Full: return "full";
+        case CrtQuality::Reduced: return "reduced";
+        case CrtQuality::Off: return "off";
+    }
+    return "?";
+}
+
+bool parse_crt_quality(const std::string& s, CrtQuality& out) {
+    if (s == "full") out = CrtQuality::Full;
+    else if (s == "reduced") out = CrtQuality::Reduced;
+    else if (s == "off") out = CrtQuality::Off;
+    else return false;
+    return true;
+}
+
 CrtFilter::CrtFilter()
     : scan_strength(0.20f)
     , vignette_strength(0.93f)
@@ -59,6 +307,8 @@ CrtFilter::CrtFilter()
     , phosphor_b_cut(0.22f)
     , overlay_blur_strength(1.0f)
     , overlay_darken(0.55f)
+    , blur_half_res(true)
+    , quality_(CrtQuality::Full)
     , width_(0)
     , height_(0)
     , prog_(0)
@@ -68,7 +318,18 @@ CrtFilter::CrtFilter()
     , tex_(0)
     , depth_(0)
     , vbo_(0)
+    , lut_tex_(0)
+    , lut_bulge_(0.0f)
+    , lut_zoom_(0.0f)
+    , blur_prog_(0)
+    , blur_fs_(0)
+    , blur_fbo_(0)
+    , blur_tex_(0)
     , u_tex_(-1)
+    , u_lut_(-1)
+    , u_blur_tex_(-1)
+    , u_use_lut_(-1)
+    , u_blur_half_(-1)
     , u_resolution_(-1)
     , u_time_(-1)
     , u_scan_strength_(-1)
@@ -85,6 +346,9 @@ CrtFilter::CrtFilter()
     , u_poweroff_active_(-1)
     , u_boot_t_(-1)
     , u_boot_active_(-1)
+    , u_bp_tex_(-1)
+    , u_bp_px_(-1)
+    , u_bp_strength_(-1)
     , overlay_rect_uv_(0, 0, 0, 0)
     , overlay_active_(false)
     , poweroff_t_(0.0f)
@@ -93,215 +357,19 @@ CrtFilter::CrtFilter()
     , boot_active_(false) {}
 
 
-bool CrtFilter::init(int width, int height) {
+bool CrtFilter::init(int width, int height, CrtQuality quality) {
     shutdown();
 
     width_ = width;
     height_ = height;
 
-    const char* crt_vs_src =
-        "attribute vec2 aPos;\n"
-        "attribute vec2 aUV;\n"
-        "varying vec2 vUV;\n"
-        "void main(){\n"
-        "  vUV = aUV;\n"
-        "  gl_Position = vec4(aPos, 0.0, 1.0);\n"
-        "}\n";
-
-    const char* crt_fs_src =
-        "precision mediump float;\n"
-        "varying vec2 vUV;\n"
-        "uniform sampler2D uTex;\n"
-        "uniform vec2 uResolution;\n"
-        "uniform float uTime;\n"
-        "uniform float uScanStrength;\n"
-        "uniform float uVignetteStrength;\n"
-        "uniform float uRgbShift;\n"
-        "uniform float uBulge;\n"
-        "uniform float uZoom;\n"
-        "uniform vec3 uTint;\n"
-        "uniform vec4 uOverlayRect;\n"
-        "uniform float uOverlayActive;\n"
-        "uniform float uOverlayBlurStrength;\n"
-        "uniform float uOverlayDarken;\n"
-        "uniform float uPoweroffT;\n"
-        "uniform float uPoweroffActive;\n"
-        "uniform float uBootT;\n"
-        "uniform float uBootActive;\n"
-        "float hash12(vec2 p){\n"
-        "  vec3 p3 = fract(vec3(p.xyx) * 0.1031);\n"
-        "  p3 += dot(p3, p3.yzx + 33.33);\n"
-        "  return fract((p3.x + p3.y) * p3.z);\n"
-        "}\n"
-        "float easeInOut(float t){\n"
-        "  t = clamp(t, 0.0, 1.0);\n"
-        "  return t * t * (3.0 - 2.0 * t);\n"
-        "}\n"
-        "float sat(float x){ return clamp(x, 0.0, 1.0); }\n"
-        "vec2 quantUV(vec2 uv, float cells){\n"
-        "  vec2 g = vec2(cells, cells * (uResolution.y / uResolution.x));\n"
-        "  return (floor(uv * g) + 0.5) / g;\n"
-        "}\n"
-        "void main(){\n"
-        "  vec2 baseUV = vUV;\n"
-        "  vec2 uv = baseUV;\n"
-        "  bool poweroffOn = (uPoweroffActive > 0.5);\n"
-        "  bool bootOn = (!poweroffOn && uBootActive > 0.5);\n"
-        "  if (poweroffOn) {\n"
-        "    float t = clamp(uPoweroffT, 0.0, 1.0);\n"
-        "    float tLine = easeInOut(min(1.0, t / 0.65));\n"
-        "    float tDot  = easeInOut((t - 0.65) / 0.35);\n"
-        "    float sy = mix(1.0, 0.006, tLine);\n"
-        "    float sx = mix(1.0, 0.006, tDot);\n"
-        "    uv = (uv - 0.5) * vec2(sx, sy) + 0.5;\n"
-        "  }\n"
-        "  uv = (uv - 0.5) / uZoom + 0.5;\n"
-        "  vec2 c = uv * 2.0 - 1.0;\n"
-        "  float r2 = dot(c,c);\n"
-        "  uv = (c * (1.0 + uBulge * r2)) * 0.5 + 0.5;\n"
-        "  if (uv.x < 0.0 || uv.x > 1.0 || uv.y < 0.0 || uv.y > 1.0) {\n"
-        "    gl_FragColor = vec4(0.0,0.0,0.0,1.0);\n"
-        "    return;\n"
-        "  }\n"
-        "  vec2 px = vec2(1.0 / uResolution.x, 1.0 / uResolution.y);\n"
-        "  vec2 shift = vec2(uRgbShift * px.x, 0.0);\n"
-        "  bool outsideOverlay = false;\n"
-        "  if (uOverlayActive > 0.5) {\n"
-        "    outsideOverlay = (baseUV.x < uOverlayRect.x || baseUV.x > uOverlayRect.z || baseUV.y < uOverlayRect.y || baseUV.y > uOverlayRect.w);\n"
-        "  }\n"
-        "  vec4 colC = texture2D(uTex, uv);\n"
-        "  if (outsideOverlay) {\n"
-        "    float s = uOverlayBlurStrength;\n"
-        "    vec2 o = px * (1.5 * s);\n"
-        "    vec3 c0 = texture2D(uTex, uv).rgb;\n"
-        "    vec3 c1 = texture2D(uTex, uv + vec2(o.x, 0.0)).rgb;\n"
-        "    vec3 c2 = texture2D(uTex, uv - vec2(o.x, 0.0)).rgb;\n"
-        "    vec3 c3 = texture2D(uTex, uv + vec2(0.0, o.y)).rgb;\n"
-        "    vec3 c4 = texture2D(uTex, uv - vec2(0.0, o.y)).rgb;\n"
-        "    vec3 cb = (c0 * 0.40 + (c1 + c2 + c3 + c4) * 0.15);\n"
-        "    colC = vec4(cb, 1.0);\n"
-        "  }\n"
-        "  float r = texture2D(uTex, uv + shift).r;\n"
-        "  float g = colC.g;\n"
-        "  float b = texture2D(uTex, uv - shift).b;\n"
-        "  vec3 col = vec3(r,g,b);\n"
-        "  float scan = 0.5 + 0.5 * sin((uv.y * uResolution.y) * 3.14159);\n"
-        "  col *= 1.0 - uScanStrength * scan;\n"
-        "  vec2 dv = uv - 0.5;\n"
-        "  float vig = 1.0 - uVignetteStrength * smoothstep(0.15, 0.70, dot(dv,dv));\n"
-        "  col *= vig;\n"
-        "  float n = (hash12(uv * uResolution + uTime * 60.0) - 0.5) * 0.02;\n"
-        "  col += n;\n"
-        "  float luma = dot(col, vec3(0.299, 0.587, 0.114));\n"
-        "  float tintW = 1.0 - smoothstep(0.55, 0.78, luma);\n"
-        "  tintW = tintW * tintW;\n"
-        "  float maxRB = max(col.r, col.b);\n"
-        "  float greenDom = smoothstep(0.06, 0.22, col.g - maxRB);\n"
-        "  float w = tintW * greenDom;\n"
-        "  float kRG = uTint.x;\n"
-        "  float gGain = uTint.y;\n"
-        "  float bCut = uTint.z;\n"
-        "  float g2 = col.g * mix(1.0, gGain, w);\n"
-        "  col.r = mix(col.r, col.r + g2 * kRG, w);\n"
-        "  col.g = g2;\n"
-        "  col.b = mix(col.b, col.b * (1.0 - bCut), w);\n"
-        "  col = clamp(col, 0.0, 1.0);\n"
-        "  if (outsideOverlay) {\n"
-        "    col *= (1.0 - uOverlayDarken);\n"
-        "  }\n"
-        "  if (poweroffOn) {\n"
-        "    float t = clamp(uPoweroffT, 0.0, 1.0);\n"
-        "    float tLine = easeInOut(min(1.0, t / 0.65));\n"
-        "    float tDot  = easeInOut((t - 0.65) / 0.35);\n"
-        "    float sy = mix(1.0, 0.006, tLine);\n"
-        "    float sx = mix(1.0, 0.006, tDot);\n"
-        "    float ay = abs(baseUV.y - 0.5);\n"
-        "    float ax = abs(baseUV.x - 0.5);\n"
-        "    float fy = 0.020 + 0.030 * (1.0 - tLine);\n"
-        "    float fx = 0.020 + 0.030 * (1.0 - tDot);\n"
-        "    float my = 1.0 - smoothstep(sy * 0.5, sy * 0.5 + fy, ay);\n"
-        "    float mx = 1.0 - smoothstep(sx * 0.5, sx * 0.5 + fx, ax);\n"
-        "    float m = my * mix(1.0, mx, tDot);\n"
-        "    float glow = (1.0 - t) * 0.45;\n"
-        "    col *= m;\n"
-        "    col += glow * m;\n"
-        "  }\n"
-
-        "  if (bootOn) {\n"
-        "    float t = clamp(uBootT, 0.0, 1.0);\n"
-        "    float wSnow = 1.0 - smoothstep(0.26, 0.38, t);\n"
-        "    float wMosaic = smoothstep(0.22, 0.40, t) * (1.0 - smoothstep(0.86, 0.98, t));\n"
-        "    float wNormal = smoothstep(0.86, 1.00, t);\n"
-
-        "    float n0 = hash12(baseUV * uResolution + uTime * 120.0);\n"
-        "    float n1 = hash12(baseUV * uResolution * 0.7 + uTime * 240.0);\n"
-        "    float snow = sat(n0 * 0.65 + n1 * 0.35);\n"
-        "    snow = pow(snow, 1.6);\n"
-
-        "    float jitterW = 1.0 - smoothstep(0.40, 0.85, t);\n"
-        "    float jitter = (hash12(vec2(uTime * 60.0, baseUV.y * 931.0)) - 0.5) * jitterW;\n"
-        "    vec2 uvJ = clamp(baseUV + vec2(jitter * 0.025, 0.0), 0.0, 1.0);\n"
-
-        "    float tm = smoothstep(0.40, 0.90, t);\n"
-        "    float cells = mix(22.0, 110.0, tm);\n"
-        "    vec2 uvM = quantUV(uvJ, cells);\n"
-        "    vec3 cM = texture2D(uTex, uvM).rgb;\n"
-        "    float grain = mix(0.36, 0.08, tm);\n"
-        "    vec3 g = vec3(hash12(baseUV * uResolution * mix(0.9, 2.6, tm) + uTime * 190.0) - 0.5);\n"
-        "    cM = clamp(cM + g * grain, 0.0, 1.0);\n"
-
-        "    vec3 outCol = vec3(0.0);\n"
-        "    outCol += vec3(snow) * wSnow;\n"
-        "    outCol += cM * wMosaic;\n"
-        "    outCol += col * wNormal;\n"
-
-        "    float flick = 0.90 + 0.10 * sin(uTime * 40.0);\n"
-        "    outCol *= flick;\n"
-        "    col = outCol;\n"
-        "  }\n"
-        "  gl_FragColor = vec4(col, 1.0);\n"
-        "}\n";
-
-    vs_ = compile_shader(GL_VERTEX_SHADER, crt_vs_src);
-    fs_ = compile_shader(GL_FRAGMENT_SHADER, crt_fs_src);
-    if (!vs_ || !fs_) {
-        shutdown();
-        return false;
-    }
-
-    prog_ = link_program(vs_, fs_);
-    if (!prog_) {
+    vs_ = compile_shader(GL_VERTEX_SHADER, kCrtVsSrc);
+    if (!vs_) {
         shutdown();
         return false;
     }
 
-    u_tex_ = glGetUniformLocation(prog_, "uTex");
-    u_resolution_ = glGetUniformLocation(prog_, "uResolution");
-    u_time_ = glGetUniformLocation(prog_, "uTime");
-    u_scan_strength_ = glGetUniformLocation(prog_, "uScanStrength");
-    u_vignette_strength_ = glGetUniformLocation(prog_, "uVignetteStrength");
-    u_rgb_shift_ = glGetUniformLocation(prog_, "uRgbShift");
-    u_bulge_ = glGetUniformLocation(prog_, "uBulge");
-    u_zoom_ = glGetUniformLocation(prog_, "uZoom");
-    u_tint_ = glGetUniformLocation(prog_, "uTint");
-    u_overlay_rect_ = glGetUniformLocation(prog_, "uOverlayRect");
-    u_overlay_active_ = glGetUniformLocation(prog_, "uOverlayActive");
-    u_overlay_blur_strength_ = glGetUniformLocation(prog_, "uOverlayBlurStrength");
-    u_overlay_darken_ = glGetUniformLocation(prog_, "uOverlayDarken");
-    u_poweroff_t_ = glGetUniformLocation(prog_, "uPoweroffT");
-    u_poweroff_active_ = glGetUniformLocation(prog_, "uPoweroffActive");
-
-    u_boot_t_ = glGetUniformLocation(prog_, "uBootT");
-    u_boot_active_ = glGetUniformLocation(prog_, "uBootActive");
-
-    glGenTextures(1, &tex_);
-    glBindTexture(GL_TEXTURE_2D, tex_);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width_, height_, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    tex_ = make_texture(width_, height_, GL_LINEAR, nullptr);
 
     glGenRenderbuffers(1, &depth_);
     glBindRenderbuffer(GL_RENDERBUFFER, depth_);
@@ -333,14 +401,156 @@ bool CrtFilter::init(int width, int height) {
     glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)sizeof(quad), quad, GL_STATIC_DRAW);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
+    build_lut();
+    build_blur_pass();
+
+    set_quality(quality);
+    if (!prog_ && quality_ != CrtQuality::Off) {
+        shutdown();
+        return false;
+    }
     return true;
 }
 
+bool CrtFilter::build_program(CrtQuality q) {
+    if (prog_) glDeleteProgram(prog_);
+    if (fs_) glDeleteShader(fs_);
+    prog_ = 0;
+    fs_ = 0;
+    if (q == CrtQuality::Off) return true;
+
+    const std::string src = std::string("#define CRT_FULL ") + (q == CrtQuality::Full ? "1" : "0") + "\n" + kCrtFsSrc;
+    fs_ = compile_shader(GL_FRAGMENT_SHADER, src.c_str());
+    if (!fs_) return false;
+    prog_ = link_program(vs_, fs_);
+    if (!prog_) {
+        glDeleteShader(fs_);
+        fs_ = 0;
+        return false;
+    }
+
+    u_tex_ = glGetUniformLocation(prog_, "uTex");
+    u_lut_ = glGetUniformLocation(prog_, "uLut");
+    u_blur_tex_ = glGetUniformLocation(prog_, "uBlurTex");
+    u_use_lut_ = glGetUniformLocation(prog_, "uUseLut");
+    u_blur_half_ = glGetUniformLocation(prog_, "uBlurHalf");
+    u_resolution_ = glGetUniformLocation(prog_, "uResolution");
+    u_time_ = glGetUniformLocation(prog_, "uTime");
+    u_scan_strength_ = glGetUniformLocation(prog_, "uScanStrength");
+    u_vignette_strength_ = glGetUniformLocation(prog_, "uVignetteStrength");
+    u_rgb_shift_ = glGetUniformLocation(prog_, "uRgbShift");
+    u_bulge_ = glGetUniformLocation(prog_, "uBulge");
+    u_zoom_ = glGetUniformLocation(prog_, "uZoom");
+    u_tint_ = glGetUniformLocation(prog_, "uTint");
+    u_overlay_rect_ = glGetUniformLocation(prog_, "uOverlayRect");
+    u_overlay_active_ = glGetUniformLocation(prog_, "uOverlayActive");
+    u_overlay_blur_strength_ = glGetUniformLocation(prog_, "uOverlayBlurStrength");
+    u_overlay_darken_ = glGetUniformLocation(prog_, "uOverlayDarken");
+    u_poweroff_t_ = glGetUniformLocation(prog_, "uPoweroffT");
+    u_poweroff_active_ = glGetUniformLocation(prog_, "uPoweroffActive");
+
+    u_boot_t_ = glGetUniformLocation(prog_, "uBootT");
+    u_boot_active_ = glGetUniformLocation(prog_, "uBootActive");
+    return true;
+}
+
+void CrtFilter::set_quality(CrtQuality q) {
+    if (!vs_) {
+        quality_ = q;
+        return;
+    }
+    // A GPU that rejects a tier (instruction or varying limits on Mali)
+    // gets the next cheaper one instead of no CRT at all.
+    while (!build_program(q)) {
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), "[CRT] %s program failed\n", crt_quality_name(q));
+        log_str(buf);
+        q = (q == CrtQuality::Full) ? CrtQuality::Reduced : CrtQuality::Off;
+    }
+    quality_ = q;
+    char buf[48];
+    std::snprintf(buf, sizeof(buf), "[CRT] quality=%s\n", crt_quality_name(q));
+    log_str(buf);
+}
+
+// Zoom + barrel bulge per output pixel, so the shader does one fetch instead
+// of the math. Each coordinate is 16-bit fixed point split over two 8-bit
+// channels (x in RG, y in BA); NEAREST sampling at native size keeps the byte
+// pairs intact. 0xFFFF in x marks pixels that fall outside the picture.
+void CrtFilter::build_lut() {
+    if (lut_tex_) glDeleteTextures(1, &lut_tex_);
+    lut_tex_ = 0;
+    if (width_ <= 0 || height_ <= 0 || zoom <= 0.0f) return;
+
+    std::vector<unsigned char> px((size_t)width_ * (size_t)height_ * 4);
+    for (int y = 0; y < height_; y++) {
+        for (int x = 0; x < width_; x++) {
+            const float bx = ((float)x + 0.5f) / (float)width_;
+            const float by = ((float)y + 0.5f) / (float)height_;
+            const float zx = (bx - 0.5f) / zoom + 0.5f;
+            const float zy = (by - 0.5f) / zoom + 0.5f;
+            const float cx = zx * 2.0f - 1.0f;
+            const float cy = zy * 2.0f - 1.0f;
+            const float k = 1.0f + bulge * (cx * cx + cy * cy);
+            const float u = cx * k * 0.5f + 0.5f;
+            const float v = cy * k * 0.5f + 0.5f;
+
+            unsigned qx = 0xFFFFu;
+            unsigned qy = 0xFFFFu;
+            if (u >= 0.0f && u <= 1.0f && v >= 0.0f && v <= 1.0f) {
+                qx = (unsigned)std::lround(u * 65534.0f);
+                qy = (unsigned)std::lround(v * 65534.0f);
+            }
+            unsigned char* p = &px[((size_t)y * (size_t)width_ + (size_t)x) * 4];
+            p[0] = (unsigned char)(qx >> 8);
+            p[1] = (unsigned char)(qx & 0xFFu);
+            p[2] = (unsigned char)(qy >> 8);
+            p[3] = (unsigned char)(qy & 0xFFu);
+        }
+    }
+    lut_tex_ = make_texture(width_, height_, GL_NEAREST, px.data());
+    lut_bulge_ = bulge;
+    lut_zoom_ = zoom;
+}
+
+void CrtFilter::build_blur_pass() {
+    const int bw = std::max(1, width_ / 2);
+    const int bh = std::max(1, height_ / 2);
+    blur_fs_ = compile_shader(GL_FRAGMENT_SHADER, kBlurFsSrc);
+    if (blur_fs_) blur_prog_ = link_program(vs_, blur_fs_);
+    if (!blur_prog_) {
+        log_str("[CRT] half-res blur unavailable\n");
+        return;
+    }
+    u_bp_tex_ = glGetUniformLocation(blur_prog_, "uTex");
+    u_bp_px_ = glGetUniformLocation(blur_prog_, "uPx");
+    u_bp_strength_ = glGetUniformLocation(blur_prog_, "uStrength");
+
+    blur_tex_ = make_texture(bw, bh, GL_LINEAR, nullptr);
+    glGenFramebuffers(1, &blur_fbo_);
+    glBindFramebuffer(GL_FRAMEBUFFER, blur_fbo_);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, blur_tex_, 0);
+    const bool ok = (glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (!ok) {
+        log_str("[CRT] half-res blur FBO incomplete\n");
+        glDeleteFramebuffers(1, &blur_fbo_);
+        glDeleteTextures(1, &blur_tex_);
+        blur_fbo_ = 0;
+        blur_tex_ = 0;
+    }
+}
+
 void CrtFilter::shutdown() {
     if (vbo_) glDeleteBuffers(1, &vbo_);
     if (fbo_) glDeleteFramebuffers(1, &fbo_);
     if (depth_) glDeleteRenderbuffers(1, &depth_);
     if (tex_) glDeleteTextures(1, &tex_);
+    if (lut_tex_) glDeleteTextures(1, &lut_tex_);
+    if (blur_fbo_) glDeleteFramebuffers(1, &blur_fbo_);
+    if (blur_tex_) glDeleteTextures(1, &blur_tex_);
+    if (blur_prog_) glDeleteProgram(blur_prog_);
+    if (blur_fs_) glDeleteShader(blur_fs_);
     if (prog_) glDeleteProgram(prog_);
     if (vs_) glDeleteShader(vs_);
     if (fs_) glDeleteShader(fs_);
@@ -349,11 +559,20 @@ void CrtFilter::shutdown() {
     fbo_ = 0;
     depth_ = 0;
     tex_ = 0;
+    lut_tex_ = 0;
+    blur_fbo_ = 0;
+    blur_tex_ = 0;
+    blur_prog_ = 0;
+    blur_fs_ = 0;
     prog_ = 0;
     vs_ = 0;
     fs_ = 0;
 
     u_tex_ = -1;
+    u_lut_ = -1;
+    u_blur_tex_ = -1;
+    u_use_lut_ = -1;
+    u_blur_half_ = -1;
     u_resolution_ = -1;
     u_time_ = -1;
     u_scan_strength_ = -1;
@@ -374,6 +593,10 @@ void CrtFilter::shutdown() {
     u_boot_t_ = -1;
     u_boot_active_ = -1;
 
+    u_bp_tex_ = -1;
+    u_bp_px_ = -1;
+    u_bp_strength_ = -1;
+
     width_ = 0;
     height_ = 0;
 }
@@ -397,6 +620,10 @@ bool CrtFilter::is_ready() const {
     return prog_ && fbo_ && tex_ && vbo_ && width_ > 0 && height_ > 0;
 }
 
+bool CrtFilter::active() const {
+    return quality_ != CrtQuality::Off && is_ready();
+}
+
 void CrtFilter::begin() {
     if (!is_ready()) return;
     glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
@@ -405,23 +632,60 @@ void CrtFilter::begin() {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
+void CrtFilter::draw_quad() {
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * (GLsizei)sizeof(float), (const void*)0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * (GLsizei)sizeof(float), (const void*)(2 * sizeof(float)));
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glDisableVertexAttribArray(0);
+    glDisableVertexAttribArray(1);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
 void CrtFilter::end(float time_seconds) {
     if (!is_ready()) return;
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glViewport(0, 0, width_, height_);
-    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
+    if (lut_bulge_ != bulge || lut_zoom_ != zoom) build_lut();
 
     glDisable(GL_DEPTH_TEST);
     glDisable(GL_CULL_FACE);
     glDisable(GL_BLEND);
 
+    // Reduced always blurs at half resolution; Full only when asked.
+    const bool half_blur = overlay_active_ && blur_fbo_ && (blur_half_res || quality_ == CrtQuality::Reduced);
+    if (half_blur) {
+        glBindFramebuffer(GL_FRAMEBUFFER, blur_fbo_);
+        glViewport(0, 0, std::max(1, width_ / 2), std::max(1, height_ / 2));
+        glUseProgram(blur_prog_);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, tex_);
+        if (u_bp_tex_ >= 0) glUniform1i(u_bp_tex_, 0);
+        if (u_bp_px_ >= 0) glUniform2f(u_bp_px_, 1.0f / (float)width_, 1.0f / (float)height_);
+        if (u_bp_strength_ >= 0) glUniform1f(u_bp_strength_, overlay_blur_strength);
+        draw_quad();
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, width_, height_);
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
     glUseProgram(prog_);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, tex_);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, lut_tex_);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, half_blur ? blur_tex_ : 0);
+    glActiveTexture(GL_TEXTURE0);
 
     if (u_tex_ >= 0) glUniform1i(u_tex_, 0);
+    if (u_lut_ >= 0) glUniform1i(u_lut_, 1);
+    if (u_blur_tex_ >= 0) glUniform1i(u_blur_tex_, 2);
+    if (u_use_lut_ >= 0) glUniform1f(u_use_lut_, lut_tex_ ? 1.0f : 0.0f);
+    if (u_blur_half_ >= 0) glUniform1f(u_blur_half_, half_blur ? 1.0f : 0.0f);
     if (u_resolution_ >= 0) glUniform2f(u_resolution_, (float)width_, (float)height_);
     if (u_time_ >= 0) glUniform1f(u_time_, time_seconds);
     if (u_scan_strength_ >= 0) glUniform1f(u_scan_strength_, scan_strength);
@@ -443,16 +707,13 @@ void CrtFilter::end(float time_seconds) {
     if (u_boot_t_ >= 0) glUniform1f(u_boot_t_, boot_t_);
     if (u_boot_active_ >= 0) glUniform1f(u_boot_active_, boot_active_ ? 1.0f : 0.0f);
 
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-    glEnableVertexAttribArray(0);
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * (GLsizei)sizeof(float), (const void*)0);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * (GLsizei)sizeof(float), (const void*)(2 * sizeof(float)));
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-    glDisableVertexAttribArray(0);
-    glDisableVertexAttribArray(1);
+    draw_quad();
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, 0);
     glUseProgram(0);
 }
@@ -1,19 +1,40 @@
 #pragma once
 
+#include <string>
+
 #include "imgui.h"
 #include <SDL_opengles2.h>
 
 namespace tradeboy {
 namespace filters {
 
+// Post-process cost tiers. Reduced drops the RGB-shift taps and grain and
+// always blurs the dialog backdrop at half resolution; Off skips the FBO and
+// renders straight to the backbuffer.
+enum class CrtQuality {
+    Full = 0,
+    Reduced = 1,
+    Off = 2,
+};
+
+const char* crt_quality_name(CrtQuality q);
+// "full" | "reduced" | "off"
+bool parse_crt_quality(const std::string& s, CrtQuality& out);
+
 class CrtFilter {
 public:
     CrtFilter();
 
-    bool init(int width, int height);
+    bool init(int width, int height, CrtQuality quality = CrtQuality::Full);
     void shutdown();
 
+    // Rebuilds the program; falls back a tier if the GPU rejects it.
+    void set_quality(CrtQuality quality);
+    CrtQuality quality() const { return quality_; }
+
     bool is_ready() const;
+    // Ready and not Off: the caller should render through begin()/end().
+    bool active() const;
 
     void begin();
     void end(float time_seconds);
@@ -35,7 +56,17 @@ public:
     float overlay_blur_strength;
     float overlay_darken;
 
+    // Blur the dialog backdrop in a half-size pass instead of 5 taps per pixel.
+    bool blur_half_res;
+
 private:
+    bool build_program(CrtQuality q);
+    void build_lut();
+    void build_blur_pass();
+    void draw_quad();
+
+    CrtQuality quality_;
+
     int width_;
     int height_;
 
@@ -48,7 +79,21 @@ private:
     GLuint depth_;
     GLuint vbo_;
 
+    // Zoom/bulge lookup, rebuilt when either parameter changes.
+    GLuint lut_tex_;
+    float lut_bulge_;
+    float lut_zoom_;
+
+    GLuint blur_prog_;
+    GLuint blur_fs_;
+    GLuint blur_fbo_;
+    GLuint blur_tex_;
+
     GLint u_tex_;
+    GLint u_lut_;
+    GLint u_blur_tex_;
+    GLint u_use_lut_;
+    GLint u_blur_half_;
     GLint u_resolution_;
     GLint u_time_;
     GLint u_scan_strength_;
@@ -69,6 +114,10 @@ private:
     GLint u_boot_t_;
     GLint u_boot_active_;
 
+    GLint u_bp_tex_;
+    GLint u_bp_px_;
+    GLint u_bp_strength_;
+
     ImVec4 overlay_rect_uv_;
     bool overlay_active_;
 
@@ -5,6 +5,10 @@
 #include "backends/imgui_impl_opengl3.h"
 #include "backends/imgui_impl_sdl2.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
 #include <fstream>
 #include <string>
 #include <vector>
@@ -18,6 +22,8 @@
 #include "app/App.h"
 #include "app/Input.h"
 #include "filters/CrtFilter.h"
+#include "market/FeedStats.h"
+#include "utils/FrameSchedule.h"
 #include "utils/Log.h"
 #include "core/Logger.h"
 
@@ -32,6 +38,20 @@ void log_str(const char* s) {
     tradeboy::core::logger_log(s);
 }
 
+// Wakes the idle main loop: a user event pushed from any thread, coalesced so
+// a burst of model changes queues only one.
+static Uint32 g_wake_event = (Uint32)-1;
+static std::atomic<bool> g_wake_pending{false};
+
+static void push_wake_event() {
+    if (g_wake_event == (Uint32)-1) return;
+    if (g_wake_pending.exchange(true)) return;
+    SDL_Event ev;
+    SDL_zero(ev);
+    ev.type = g_wake_event;
+    if (SDL_PushEvent(&ev) != 1) g_wake_pending.store(false);
+}
+
 static void crash_signal_handler(int sig) {
     FILE* f = fopen("crash.txt", "a");
     if (f) {
@@ -65,6 +85,7 @@ static bool dir_exists(const char* path) {
 int main(int argc, char** argv) {
     static const int APP_ABI_GUARD = 1;
     (void)APP_ABI_GUARD;
+    const std::chrono::steady_clock::time_point boot_t0 = std::chrono::steady_clock::now();
 
     // On device, the app may be launched with CWD=/, but our assets live under
     // /mnt/mmc/Roms/APPS. If that directory exists, switch CWD so relative
@@ -78,6 +99,8 @@ int main(int argc, char** argv) {
     signal(SIGABRT, crash_signal_handler);
     signal(SIGFPE, crash_signal_handler);
     signal(SIGILL, crash_signal_handler);
+    // Writes to a dropped keep-alive socket / s_client pipe must fail with EPIPE, not kill the app.
+    signal(SIGPIPE, SIG_IGN);
 
     // Initialize logger (clears log file on startup)
     tradeboy::core::logger_init("log.txt");
@@ -92,6 +115,7 @@ int main(int argc, char** argv) {
     }
 
     SDL_JoystickEventState(SDL_ENABLE);
+    g_wake_event = SDL_RegisterEvents(1);
 
     SDL_DisplayMode mode;
     if (SDL_GetCurrentDisplayMode(0, &mode) != 0) {
@@ -251,26 +275,86 @@ int main(int argc, char** argv) {
     log_str("[Main] init_demo_data begin\n");
     app.init_demo_data();
     log_str("[Main] init_demo_data done\n");
+    // Before startup(): the listener must be in place before any writer thread.
+    tradeboy::utils::set_frame_wake_hook(push_wake_event);
+    app.model.set_change_listener([](unsigned) { push_wake_event(); });
     log_str("[Main] calling startup\n");
     app.startup();
     log_str("[Main] app.startup done\n");
 
+    if (!app.wallet_cfg.crt_quality.empty()) {
+        tradeboy::filters::CrtQuality q = tradeboy::filters::CrtQuality::Full;
+        if (tradeboy::filters::parse_crt_quality(app.wallet_cfg.crt_quality, q)) {
+            if (q != crt.quality()) crt.set_quality(q);
+        } else {
+            log_str("[CRT] unknown crt= value, keeping full\n");
+        }
+    }
+
     tradeboy::app::EdgeState edges;
 
     bool running = true;
     log_str("[Main] entering main loop\n");
     int frame_counter = 0;
+    bool logged_first_useful = false;
+
+    // A frame is drawn only for input, a wake (model change, trade tape,
+    // action result), or a deadline declared by an animation; otherwise the
+    // loop sleeps in SDL_WaitEventTimeout. The heartbeat bounds how long a
+    // change nobody announced can stay off screen.
+    const int kIdleHeartbeatMs = 1000;
+    double next_frame_t = 0.0; // ImGui time of the earliest requested frame, <0 none
+    Uint64 last_frame_counter = SDL_GetPerformanceCounter();
+    int frames_this_period = 0;
+    int wakes_this_period = 0;
+    std::chrono::steady_clock::time_point period_t0 = std::chrono::steady_clock::now();
+    std::vector<SDL_Event> events;
+    // When exit was confirmed in the dialog (or SDL_QUIT arrived); shutdown,
+    // including the poweroff animation, is timed from here. teardown_t0 is
+    // when the loop was told to stop, so the second span leaves the
+    // animation out.
+    std::chrono::steady_clock::time_point quit_t0;
+    std::chrono::steady_clock::time_point teardown_t0;
     while (running) {
-        std::vector<SDL_Event> events;
-        SDL_Event e;
-        while (SDL_PollEvent(&e)) {
-            ImGui_ImplSDL2_ProcessEvent(&e);
-            events.push_back(e);
-            if (e.type == SDL_QUIT) {
+        events.clear();
+        bool redraw = false;
+        auto take_event = [&](SDL_Event& ev) {
+            ImGui_ImplSDL2_ProcessEvent(&ev);
+            if (ev.type == g_wake_event) {
+                g_wake_pending.store(false);
+                wakes_this_period++;
+                redraw = true;
+                return;
+            }
+            if (ev.type == SDL_QUIT) {
                 log_str("[Main] SDL_QUIT event\n");
                 running = false;
+                quit_t0 = std::chrono::steady_clock::now();
+                teardown_t0 = quit_t0;
             }
+            // Stick noise must not keep the screen awake; input ignores axes.
+            if (ev.type == SDL_JOYAXISMOTION) return;
+            events.push_back(ev);
+            redraw = true;
+        };
+
+        SDL_Event e;
+        const double since_ms = (double)(SDL_GetPerformanceCounter() - last_frame_counter) * 1000.0 /
+                                (double)SDL_GetPerformanceFrequency();
+        int timeout_ms = kIdleHeartbeatMs - (int)since_ms;
+        if (next_frame_t >= 0.0) {
+            const double until_ms = (next_frame_t - ImGui::GetTime()) * 1000.0 - since_ms;
+            timeout_ms = std::min(timeout_ms, (int)std::ceil(until_ms));
         }
+        if (timeout_ms <= 0) {
+            redraw = true;
+        } else if (SDL_WaitEventTimeout(&e, timeout_ms)) {
+            take_event(e);
+        } else {
+            redraw = true;
+        }
+        while (SDL_PollEvent(&e)) take_event(e);
+        if (!redraw && running) continue;
 
         tradeboy::app::InputState in = tradeboy::app::poll_input_state_from_events(events);
         app.handle_input_edges(in, edges);
@@ -279,6 +363,8 @@ int main(int argc, char** argv) {
         if (app.quit_requested) {
             log_str("[Main] app.quit_requested\n");
             running = false;
+            quit_t0 = app.exit_confirmed_t;
+            teardown_t0 = std::chrono::steady_clock::now();
         }
 
         frame_counter++;
@@ -286,6 +372,7 @@ int main(int argc, char** argv) {
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplSDL2_NewFrame();
         ImGui::NewFrame();
+        last_frame_counter = SDL_GetPerformanceCounter();
 
         ImGui::SetNextWindowPos(ImVec2(0, 0), ImGuiCond_Always);
         ImGui::SetNextWindowSize(ImVec2((float)mode.w, (float)mode.h), ImGuiCond_Always);
@@ -298,7 +385,7 @@ int main(int argc, char** argv) {
         ImGui::End();
         ImGui::Render();
 
-        if (crt.is_ready()) {
+        if (crt.active()) {
             crt.begin();
             ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
             crt.set_overlay_rect_uv(app.overlay_rect_uv, app.overlay_rect_active);
@@ -313,6 +400,34 @@ int main(int argc, char** argv) {
         }
 
         SDL_GL_SwapWindow(window);
+        tradeboy::market::feed_stats().on_frame();
+        next_frame_t = tradeboy::utils::take_frame_deadline();
+
+        frames_this_period++;
+        const std::chrono::steady_clock::time_point now_t = std::chrono::steady_clock::now();
+        if (now_t - period_t0 >= std::chrono::seconds(60)) {
+            char buf[96];
+            std::snprintf(buf, sizeof(buf), "[Frame] drawn=%d wakes=%d per_min\n", frames_this_period, wakes_this_period);
+            log_str(buf);
+            frames_this_period = 0;
+            wakes_this_period = 0;
+            period_t0 = now_t;
+        }
+
+        if (!logged_first_useful && app.first_useful_frame) {
+            logged_first_useful = true;
+            const long long ms = (long long)std::chrono::duration_cast<std::chrono::milliseconds>(
+                                     std::chrono::steady_clock::now() - boot_t0)
+                                     .count();
+            char buf[96];
+            std::snprintf(buf,
+                          sizeof(buf),
+                          "[Boot] first useful frame ms=%lld frame=%d source=%s\n",
+                          ms,
+                          frame_counter,
+                          app.state_cache_loaded ? "cache" : "live");
+            log_str(buf);
+        }
     }
 
     log_str("[Main] main loop exit -> begin shutdown\n");
@@ -357,6 +472,17 @@ int main(int argc, char** argv) {
     SDL_Quit();
     log_str("[Main] SDL_Quit done\n");
 
+    {
+        const std::chrono::steady_clock::time_point end_t = std::chrono::steady_clock::now();
+        const long long ms = (long long)std::chrono::duration_cast<std::chrono::milliseconds>(end_t - quit_t0).count();
+        const long long teardown_ms =
+            (long long)std::chrono::duration_cast<std::chrono::milliseconds>(end_t - teardown_t0).count();
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), "[Main] exit ms=%lld\n", ms);
+        log_str(buf);
+        std::snprintf(buf, sizeof(buf), "[Main] teardown ms=%lld\n", teardown_ms);
+        log_str(buf);
+    }
     tradeboy::core::logger_shutdown();
 
     return 0;
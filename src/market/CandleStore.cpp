@@ -0,0 +1,350 @@
+#include "CandleStore.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "../model/TradeModel.h"
+#include "utils/JsonScan.h"
+#include "utils/Log.h"
+
+namespace tradeboy::market {
+
+using tradeboy::model::CandleRes;
+using tradeboy::utils::JsonScan;
+using tradeboy::utils::json_key_is;
+
+static const char kCacheDir[] = "./cache";
+static const char kCandleMagic[8] = {'T', 'B', 'C', 'N', 'D', 'L', '1', 0};
+static const unsigned int kCandleVersion = 1;
+
+struct CandleFileHeader {
+    char magic[8];
+    unsigned int version;
+    unsigned int record_size;
+    long long interval_ms;
+    long long reserved;
+};
+
+static_assert(sizeof(CandleFileHeader) == 32, "candle header layout");
+static_assert(sizeof(CandleRecord) == 48, "candle record layout");
+
+static bool write_all(int fd, const void* p, size_t n, off_t off) {
+    const char* b = (const char*)p;
+    while (n > 0) {
+        ssize_t w = ::pwrite(fd, b, n, off);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        b += w;
+        n -= (size_t)w;
+        off += w;
+    }
+    return true;
+}
+
+CandleFile::~CandleFile() {
+    close();
+}
+
+void CandleFile::close() {
+    if (map_) ::munmap(map_, map_len_);
+    map_ = nullptr;
+    map_len_ = 0;
+    n_records_ = 0;
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+}
+
+const CandleRecord* CandleFile::records() const {
+    if (!map_) return nullptr;
+    return (const CandleRecord*)((const char*)map_ + sizeof(CandleFileHeader));
+}
+
+bool CandleFile::open(const std::string& path, long long interval_ms, std::string& out_err) {
+    close();
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        out_err = "candle_cache_open_failed";
+        return false;
+    }
+
+    CandleFileHeader want;
+    std::memset(&want, 0, sizeof(want));
+    std::memcpy(want.magic, kCandleMagic, sizeof(want.magic));
+    want.version = kCandleVersion;
+    want.record_size = (unsigned int)sizeof(CandleRecord);
+    want.interval_ms = interval_ms;
+
+    struct stat st;
+    if (::fstat(fd_, &st) != 0) {
+        out_err = "candle_cache_stat_failed";
+        close();
+        return false;
+    }
+
+    CandleFileHeader have;
+    bool header_ok = false;
+    if ((size_t)st.st_size >= sizeof(have) && ::pread(fd_, &have, sizeof(have), 0) == (ssize_t)sizeof(have)) {
+        header_ok = (std::memcmp(have.magic, want.magic, sizeof(want.magic)) == 0 && have.version == want.version &&
+                     have.record_size == want.record_size && have.interval_ms == want.interval_ms);
+    }
+    if (!header_ok) {
+        if (::ftruncate(fd_, 0) != 0 || !write_all(fd_, &want, sizeof(want), 0)) {
+            out_err = "candle_cache_init_failed";
+            close();
+            return false;
+        }
+    } else {
+        const size_t body = (size_t)st.st_size - sizeof(CandleFileHeader);
+        const size_t whole = body - (body % sizeof(CandleRecord));
+        if (whole != body && ::ftruncate(fd_, (off_t)(sizeof(CandleFileHeader) + whole)) != 0) {
+            out_err = "candle_cache_truncate_failed";
+            close();
+            return false;
+        }
+    }
+    return remap(out_err);
+}
+
+bool CandleFile::remap(std::string& out_err) {
+    if (map_) ::munmap(map_, map_len_);
+    map_ = nullptr;
+    map_len_ = 0;
+    n_records_ = 0;
+
+    struct stat st;
+    if (::fstat(fd_, &st) != 0) {
+        out_err = "candle_cache_stat_failed";
+        return false;
+    }
+    const size_t len = (size_t)st.st_size;
+    if (len <= sizeof(CandleFileHeader)) return true;
+
+    void* m = ::mmap(nullptr, len, PROT_READ, MAP_SHARED, fd_, 0);
+    if (m == MAP_FAILED) {
+        out_err = "candle_cache_mmap_failed";
+        return false;
+    }
+    map_ = m;
+    map_len_ = len;
+    n_records_ = (len - sizeof(CandleFileHeader)) / sizeof(CandleRecord);
+    return true;
+}
+
+bool CandleFile::append(const CandleRecord* recs, size_t n, std::string& out_err) {
+    if (fd_ < 0) {
+        out_err = "candle_cache_not_open";
+        return false;
+    }
+    long long last = last_t_ms();
+    size_t first = 0;
+    while (first < n && recs[first].t_ms <= last) first++;
+    if (first >= n) return true;
+
+    const off_t end = (off_t)(sizeof(CandleFileHeader) + n_records_ * sizeof(CandleRecord));
+    if (!write_all(fd_, recs + first, (n - first) * sizeof(CandleRecord), end)) {
+        out_err = "candle_cache_write_failed";
+        return false;
+    }
+    return remap(out_err);
+}
+
+const char* candle_interval_name(CandleRes res) {
+    switch (res) {
+        case CandleRes::M1: return "1m";
+        case CandleRes::M5: return "5m";
+        case CandleRes::H1: return "1h";
+        case CandleRes::D1: return "1d";
+    }
+    return "1m";
+}
+
+std::string candle_cache_path(const std::string& coin, CandleRes res) {
+    std::string safe;
+    safe.reserve(coin.size());
+    for (char ch : coin) {
+        const bool ok = (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') || ch == '-';
+        safe.push_back(ok ? ch : '_');
+    }
+    return std::string(kCacheDir) + "/candles_" + safe + "_" + candle_interval_name(res) + ".bin";
+}
+
+static bool parse_candle(JsonScan& sc, CandleRecord& out, std::string* out_coin = nullptr) {
+    if (!sc.eat('{')) return false;
+    if (sc.eat('}')) return true;
+    while (true) {
+        const char* k;
+        size_t kn;
+        if (!sc.str(k, kn) || !sc.eat(':')) return false;
+        double v = 0.0;
+        if (json_key_is(k, kn, "t")) {
+            if (!sc.number(v)) return false;
+            out.t_ms = (long long)v;
+        } else if (json_key_is(k, kn, "o")) {
+            if (!sc.number(out.o)) return false;
+        } else if (json_key_is(k, kn, "h")) {
+            if (!sc.number(out.h)) return false;
+        } else if (json_key_is(k, kn, "l")) {
+            if (!sc.number(out.l)) return false;
+        } else if (json_key_is(k, kn, "c")) {
+            if (!sc.number(out.c)) return false;
+        } else if (json_key_is(k, kn, "v")) {
+            if (!sc.number(out.v)) return false;
+        } else if (out_coin && json_key_is(k, kn, "s")) {
+            const char* cs;
+            size_t cn;
+            if (!sc.str(cs, cn)) return false;
+            out_coin->assign(cs, cn);
+        } else if (!sc.skip_value()) {
+            return false;
+        }
+        if (sc.eat(',')) continue;
+        return sc.eat('}');
+    }
+}
+
+bool parse_candle_snapshot_json(const char* json, size_t len, std::vector<CandleRecord>& out) {
+    out.clear();
+    if (!json || len == 0) return false;
+    JsonScan sc(json, len);
+    if (!sc.eat('[')) return false;
+    if (sc.eat(']')) return true;
+    while (true) {
+        CandleRecord r;
+        if (!parse_candle(sc, r)) return false;
+        if (r.t_ms > 0 && (out.empty() || r.t_ms > out.back().t_ms)) out.push_back(r);
+        if (sc.eat(',')) continue;
+        return sc.eat(']');
+    }
+}
+
+bool parse_ws_candle_json(const char* json, size_t len, std::string& out_coin, CandleRecord& out) {
+    out_coin.clear();
+    if (!json || len == 0) return false;
+    JsonScan sc(json, len);
+    return parse_candle(sc, out, &out_coin) && out.t_ms > 0 && !out_coin.empty();
+}
+
+static std::string candle_snapshot_request(const std::string& coin, CandleRes res, long long start_ms, long long end_ms) {
+    char req[256];
+    std::snprintf(req,
+                  sizeof(req),
+                  "{\"type\":\"candleSnapshot\",\"req\":{\"coin\":\"%s\",\"interval\":\"%s\",\"startTime\":%lld,\"endTime\":%lld}}\n",
+                  coin.c_str(),
+                  candle_interval_name(res),
+                  start_ms,
+                  end_ms);
+    return std::string(req);
+}
+
+// Copies the newest CandleRing::kCapacity candles of a + b (both time-ordered,
+// b after a) into the model ring.
+static void seed_model(tradeboy::model::TradeModel& model,
+                       const std::string& coin,
+                       CandleRes res,
+                       const CandleRecord* a,
+                       size_t na,
+                       const CandleRecord* b,
+                       size_t nb) {
+    const size_t cap = tradeboy::model::CandleRing::kCapacity;
+    tradeboy::model::Candle buf[tradeboy::model::CandleRing::kCapacity];
+    size_t skip = (na + nb > cap) ? (na + nb - cap) : 0;
+    int n = 0;
+    for (size_t i = 0; i < na + nb; i++) {
+        if (skip > 0) {
+            skip--;
+            continue;
+        }
+        const CandleRecord& r = (i < na) ? a[i] : b[i - na];
+        tradeboy::model::Candle& c = buf[n++];
+        c.t_ms = r.t_ms;
+        c.o = (float)r.o;
+        c.h = (float)r.h;
+        c.l = (float)r.l;
+        c.c = (float)r.c;
+    }
+    if (n > 0) model.seed_candles(coin, res, buf, n);
+}
+
+static void log_candle_sync(const CandleHistoryJob& job, size_t fetched) {
+    char buf[160];
+    std::snprintf(buf,
+                  sizeof(buf),
+                  "[HL] candles %s %s cached=%u fetched=%u\n",
+                  job.coin.c_str(),
+                  candle_interval_name(job.res),
+                  (unsigned)job.cached,
+                  (unsigned)fetched);
+    log_str(buf);
+}
+
+bool begin_candle_history(tradeboy::model::TradeModel& model,
+                          const std::string& coin,
+                          CandleRes res,
+                          long long now_ms,
+                          CandleHistoryJob& job,
+                          std::string& out_err) {
+    job = CandleHistoryJob();
+    job.coin = coin;
+    job.res = res;
+    if (coin.empty()) {
+        out_err = "candle_no_coin";
+        return false;
+    }
+    if (::mkdir(kCacheDir, 0755) != 0 && errno != EEXIST) {
+        out_err = "candle_cache_dir_failed";
+        return false;
+    }
+
+    const long long iv = tradeboy::model::candle_res_ms(res);
+    CandleFile f;
+    if (!f.open(candle_cache_path(coin, res), iv, out_err)) return false;
+
+    job.cached = f.size();
+    seed_model(model, coin, res, f.records(), f.size(), nullptr, 0);
+
+    // Only the gap after the last cached candle, and never more than the ring
+    // can show. The open bucket is left to live mids.
+    job.open_bucket_ms = now_ms - (now_ms % iv);
+    const long long window_start = job.open_bucket_ms - (long long)tradeboy::model::CandleRing::kCapacity * iv;
+    long long start = job.cached ? (f.last_t_ms() + iv) : window_start;
+    if (start < window_start) start = window_start;
+
+    if (start < job.open_bucket_ms) {
+        job.req = candle_snapshot_request(coin, res, start, now_ms);
+    } else {
+        log_candle_sync(job, 0);
+    }
+    return true;
+}
+
+bool finish_candle_history(tradeboy::model::TradeModel& model,
+                           const CandleHistoryJob& job,
+                           const std::string& resp,
+                           std::string& out_err) {
+    std::vector<CandleRecord> recs;
+    if (!parse_candle_snapshot_json(resp.data(), resp.size(), recs)) {
+        out_err = "candle_parse_failed";
+        return false;
+    }
+
+    CandleFile f;
+    if (!f.open(candle_cache_path(job.coin, job.res), tradeboy::model::candle_res_ms(job.res), out_err)) return false;
+    size_t n_closed = 0;
+    while (n_closed < recs.size() && recs[n_closed].t_ms < job.open_bucket_ms) n_closed++;
+    if (!f.append(recs.data(), n_closed, out_err)) return false;
+    seed_model(model, job.coin, job.res, f.records(), f.size(), recs.data() + n_closed, recs.size() - n_closed);
+
+    log_candle_sync(job, recs.size());
+    return true;
+}
+
+} // namespace tradeboy::market
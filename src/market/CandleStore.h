@@ -0,0 +1,85 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "../model/Candles.h"
+
+namespace tradeboy::model { struct TradeModel; }
+
+namespace tradeboy::market {
+
+// On-disk record: fixed width, native byte order, appended in time order.
+struct CandleRecord {
+    long long t_ms = 0; // bucket open time
+    double o = 0.0;
+    double h = 0.0;
+    double l = 0.0;
+    double c = 0.0;
+    double v = 0.0;
+};
+
+// One coin + interval: a 32-byte header followed by CandleRecords. Only closed
+// candles are appended, so the file never rewrites a record. Reads go through
+// a read-only mmap of the whole file.
+struct CandleFile {
+    CandleFile() = default;
+    ~CandleFile();
+    CandleFile(const CandleFile&) = delete;
+    CandleFile& operator=(const CandleFile&) = delete;
+
+    // Creates the file if needed. A file with a different layout/interval is
+    // reset; a torn trailing record (power loss) is dropped.
+    bool open(const std::string& path, long long interval_ms, std::string& out_err);
+    void close();
+
+    size_t size() const { return n_records_; }
+    const CandleRecord* records() const; // mapped; valid until append/close
+    long long last_t_ms() const { return n_records_ ? records()[n_records_ - 1].t_ms : 0; }
+
+    // Appends records newer than last_t_ms() (input must be time-ordered).
+    bool append(const CandleRecord* recs, size_t n, std::string& out_err);
+
+private:
+    bool remap(std::string& out_err);
+
+    int fd_ = -1;
+    void* map_ = nullptr;
+    size_t map_len_ = 0;
+    size_t n_records_ = 0;
+};
+
+const char* candle_interval_name(tradeboy::model::CandleRes res);
+// ./cache/candles_<coin>_<interval>.bin, coin sanitised for the filesystem.
+std::string candle_cache_path(const std::string& coin, tradeboy::model::CandleRes res);
+
+// candleSnapshot reply, oldest first.
+bool parse_candle_snapshot_json(const char* json, size_t len, std::vector<CandleRecord>& out);
+// data object of a candle WS message: {"t":..,"s":"BTC","i":"1m","o":..,...}.
+bool parse_ws_candle_json(const char* json, size_t len, std::string& out_coin, CandleRecord& out);
+
+// Candle history sync, split around the fetch so the network reactor does the
+// round trip. begin seeds the model's ring from the cache file straight away
+// and leaves the candleSnapshot body for the missing tail in req (empty when
+// the cache is already current); finish takes the reply, appends the closed
+// candles to the cache and reseeds.
+struct CandleHistoryJob {
+    std::string coin;
+    tradeboy::model::CandleRes res = tradeboy::model::CandleRes::M1;
+    long long open_bucket_ms = 0;
+    size_t cached = 0;
+    std::string req;
+};
+
+bool begin_candle_history(tradeboy::model::TradeModel& model,
+                          const std::string& coin,
+                          tradeboy::model::CandleRes res,
+                          long long now_ms,
+                          CandleHistoryJob& job,
+                          std::string& out_err);
+bool finish_candle_history(tradeboy::model::TradeModel& model,
+                           const CandleHistoryJob& job,
+                           const std::string& resp,
+                           std::string& out_err);
+
+} // namespace tradeboy::market
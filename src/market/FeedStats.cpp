@@ -0,0 +1,201 @@
+#include "FeedStats.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#include "utils/Log.h"
+
+namespace tradeboy::market {
+
+const char* feed_name(Feed f) {
+    switch (f) {
+        case Feed::Mids: return "mids";
+        case Feed::L2Book: return "book";
+        case Feed::Trades: return "trades";
+        case Feed::Candle: return "candle";
+        case Feed::PerpCtx: return "perpctx";
+        case Feed::User: return "user";
+    }
+    return "?";
+}
+
+bool feed_publishes(Feed f) {
+    return f != Feed::User;
+}
+
+long long feed_now_us() {
+    return (long long)std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+LatencyHistogram::LatencyHistogram() {
+    for (int i = 0; i < kBuckets; i++) b_[i].store(0, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::add(long long us) {
+    int i = 0;
+    while (i < kBuckets - 1 && us >= (2LL << i)) i++;
+    b_[i].fetch_add(1, std::memory_order_relaxed);
+}
+
+unsigned LatencyHistogram::count() const {
+    unsigned n = 0;
+    for (int i = 0; i < kBuckets; i++) n += b_[i].load(std::memory_order_relaxed);
+    return n;
+}
+
+long long LatencyHistogram::percentile_us(double q) const {
+    unsigned c[kBuckets];
+    unsigned n = 0;
+    for (int i = 0; i < kBuckets; i++) {
+        c[i] = b_[i].load(std::memory_order_relaxed);
+        n += c[i];
+    }
+    if (n == 0) return 0;
+    const unsigned want = std::max(1u, (unsigned)(q * (double)n + 0.5));
+    unsigned seen = 0;
+    for (int i = 0; i < kBuckets; i++) {
+        seen += c[i];
+        if (seen >= want) return 2LL << i;
+    }
+    return 2LL << (kBuckets - 1);
+}
+
+void LatencyHistogram::decay() {
+    for (int i = 0; i < kBuckets; i++) {
+        const unsigned v = b_[i].load(std::memory_order_relaxed);
+        b_[i].fetch_sub(v / 2, std::memory_order_relaxed);
+    }
+}
+
+FeedStats::FeedStats() {}
+
+void FeedStats::on_parsed(Feed f, long long recv_us, long long exch_ms) {
+    PerFeed& pf = feeds_[(int)f];
+    const long long now = feed_now_us();
+    pf.hist[(int)FeedStage::Parse].add(now - recv_us);
+    if (exch_ms > 0) {
+        const long long wall_ms = (long long)std::chrono::duration_cast<std::chrono::milliseconds>(
+                                      std::chrono::system_clock::now().time_since_epoch())
+                                      .count();
+        const long long parse_ms = (now - recv_us) / 1000;
+        if (wall_ms - parse_ms >= exch_ms) pf.hist[(int)FeedStage::Wire].add((wall_ms - parse_ms - exch_ms) * 1000LL);
+    }
+
+    const long long prev = pf.last_recv_us.exchange(recv_us, std::memory_order_relaxed);
+    if (prev > 0 && recv_us > prev) {
+        const long long iv = recv_us - prev;
+        const long long avg = pf.interval_us.load(std::memory_order_relaxed);
+        pf.interval_us.store(avg > 0 ? avg + (iv - avg) / 8 : iv, std::memory_order_relaxed);
+    }
+
+    long long zero = 0;
+    pf.pending_recv_us.compare_exchange_strong(zero, recv_us);
+    zero = 0;
+    pf.pending_parsed_us.compare_exchange_strong(zero, now);
+}
+
+void FeedStats::on_published(Feed f) {
+    PerFeed& pf = feeds_[(int)f];
+    const long long parsed = pf.pending_parsed_us.exchange(0);
+    const long long recv = pf.pending_recv_us.exchange(0);
+    if (parsed == 0) return;
+    const long long now = feed_now_us();
+    pf.hist[(int)FeedStage::Publish].add(now - parsed);
+
+    long long zero = 0;
+    pf.shown_recv_us.compare_exchange_strong(zero, recv);
+    zero = 0;
+    pf.shown_published_us.compare_exchange_strong(zero, now);
+}
+
+void FeedStats::on_frame() {
+    const long long now = feed_now_us();
+    for (int i = 0; i < kFeedCount; i++) {
+        PerFeed& pf = feeds_[i];
+        const long long published = pf.shown_published_us.exchange(0);
+        if (published == 0) continue;
+        const long long recv = pf.shown_recv_us.exchange(0);
+        pf.hist[(int)FeedStage::Frame].add(now - published);
+        if (recv > 0) pf.hist[(int)FeedStage::EndToEnd].add(now - recv);
+    }
+}
+
+long long FeedStats::age_ms(Feed f, long long now_us) const {
+    const long long last = feeds_[(int)f].last_recv_us.load(std::memory_order_relaxed);
+    if (last == 0) return -1;
+    return std::max(0LL, (now_us - last) / 1000);
+}
+
+long long FeedStats::interval_ms(Feed f) const {
+    return feeds_[(int)f].interval_us.load(std::memory_order_relaxed) / 1000;
+}
+
+long long FeedStats::stale_after_ms(Feed f) const {
+    const long long iv = interval_ms(f);
+    const long long t = (iv > 0) ? 8 * iv : 15000;
+    return std::max(5000LL, std::min(60000LL, t));
+}
+
+bool FeedStats::stale(Feed f, long long now_us) const {
+    const long long age = age_ms(f, now_us);
+    return age < 0 || age > stale_after_ms(f);
+}
+
+void format_latency_us(long long us, char* out, size_t cap) {
+    if (us < 1000) std::snprintf(out, cap, "%lldus", us);
+    else if (us < 1000000) std::snprintf(out, cap, "%lldms", us / 1000);
+    else std::snprintf(out, cap, "%.1fs", (double)us / 1e6);
+}
+
+void FeedStats::log_report() {
+    const long long now = feed_now_us();
+    for (int i = 0; i < kFeedCount; i++) {
+        const Feed f = (Feed)i;
+        const long long age = age_ms(f, now);
+        if (age < 0) continue;
+
+        char stage[kFeedStageCount][24];
+        for (int s = 0; s < kFeedStageCount; s++) {
+            const LatencyHistogram& h = hist(f, (FeedStage)s);
+            if (!feed_publishes(f) && s != (int)FeedStage::Parse) {
+                std::snprintf(stage[s], sizeof(stage[s]), "n/a");
+                continue;
+            }
+            if (h.count() == 0) {
+                std::snprintf(stage[s], sizeof(stage[s]), "-");
+                continue;
+            }
+            char p50[12];
+            char p99[12];
+            format_latency_us(h.percentile_us(0.50), p50, sizeof(p50));
+            format_latency_us(h.percentile_us(0.99), p99, sizeof(p99));
+            std::snprintf(stage[s], sizeof(stage[s]), "%s/%s", p50, p99);
+        }
+        char buf[256];
+        std::snprintf(buf,
+                      sizeof(buf),
+                      "[Feed] %s age_ms=%lld iv_ms=%lld stale=%d wire=%s parse=%s pub=%s frame=%s e2e=%s\n",
+                      feed_name(f),
+                      age,
+                      interval_ms(f),
+                      stale(f, now) ? 1 : 0,
+                      stage[(int)FeedStage::Wire],
+                      stage[(int)FeedStage::Parse],
+                      stage[(int)FeedStage::Publish],
+                      stage[(int)FeedStage::Frame],
+                      stage[(int)FeedStage::EndToEnd]);
+        log_str(buf);
+
+        for (int s = 0; s < kFeedStageCount; s++) feeds_[i].hist[s].decay();
+    }
+}
+
+FeedStats& feed_stats() {
+    static FeedStats stats;
+    return stats;
+}
+
+} // namespace tradeboy::market
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace tradeboy::market {
+
+enum class Feed {
+    Mids = 0,
+    L2Book = 1,
+    Trades = 2,
+    Candle = 3,
+    PerpCtx = 4,
+    User = 5, // webData3
+};
+
+static const int kFeedCount = 6;
+
+const char* feed_name(Feed f);
+// False for feeds that are only cached for staleness checks (webData3): they
+// are never applied to the model, so only their parse stage is reported.
+bool feed_publishes(Feed f);
+
+// Latency segments of one update. Wire needs an exchange timestamp (book,
+// trades) and compares it with the device wall clock, so it includes skew.
+enum class FeedStage {
+    Wire = 0,     // exchange timestamp -> socket receive
+    Parse = 1,    // socket receive -> parsed
+    Publish = 2,  // parsed -> in the model (includes the service's drain gate)
+    Frame = 3,    // in the model -> next frame on screen
+    EndToEnd = 4, // socket receive -> frame on screen
+};
+
+static const int kFeedStageCount = 5;
+
+// Monotonic clock used for every stage stamp.
+long long feed_now_us();
+
+// log2 histogram of microseconds: bucket i counts [2^i, 2^(i+1)) us, the last
+// one everything above. Any thread may add; readers see a consistent enough
+// picture for percentiles.
+struct LatencyHistogram {
+    static const int kBuckets = 26; // last bucket starts at ~33 s
+
+    LatencyHistogram();
+
+    void add(long long us);
+    unsigned count() const;
+    // Upper edge of the bucket holding quantile q (0..1); 0 when empty.
+    long long percentile_us(double q) const;
+    // Halves every bucket so old samples fade out.
+    void decay();
+
+private:
+    std::atomic<unsigned> b_[kBuckets];
+};
+
+// Per-feed stage latencies and staleness. Each stage only measures the oldest
+// update it has not passed on yet, so coalescing (e.g. several allMids frames
+// behind one 50 ms drain) shows up as latency rather than being hidden.
+struct FeedStats {
+    FeedStats();
+
+    // A message arrived at recv_us and has been parsed. exch_ms is the
+    // exchange's timestamp (epoch ms) when the message carries one.
+    void on_parsed(Feed f, long long recv_us, long long exch_ms = 0);
+    // The feed's latest parsed data is now in the model.
+    void on_published(Feed f);
+    // A frame was presented; whatever was published before it is on screen.
+    void on_frame();
+
+    // Since the last receive; -1 if nothing arrived yet.
+    long long age_ms(Feed f, long long now_us) const;
+    // Smoothed interval between receives; 0 until two have arrived.
+    long long interval_ms(Feed f) const;
+    // Quiet for far longer than the feed's own interval (bounds 5..60 s).
+    bool stale(Feed f, long long now_us) const;
+    long long stale_after_ms(Feed f) const;
+
+    const LatencyHistogram& hist(Feed f, FeedStage s) const { return feeds_[(int)f].hist[(int)s]; }
+
+    // Logs one line per active feed, then decays the histograms.
+    void log_report();
+
+private:
+    struct PerFeed {
+        std::atomic<long long> last_recv_us{0};
+        std::atomic<long long> interval_us{0};
+        // Oldest update parsed but not yet published.
+        std::atomic<long long> pending_recv_us{0};
+        std::atomic<long long> pending_parsed_us{0};
+        // Oldest update published but not yet on screen.
+        std::atomic<long long> shown_recv_us{0};
+        std::atomic<long long> shown_published_us{0};
+        LatencyHistogram hist[kFeedStageCount];
+    };
+
+    PerFeed feeds_[kFeedCount];
+};
+
+// Process-wide instance; the WS thread, market service and UI all report here.
+FeedStats& feed_stats();
+
+// "850us", "12ms", "2.5s".
+void format_latency_us(long long us, char* out, size_t cap);
+
+} // namespace tradeboy::market
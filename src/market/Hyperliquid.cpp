@@ -9,7 +9,9 @@
 
 #include "../../third_party/picojson/picojson.h"
 
+#include "core/WgetFetch.h"
 #include "utils/Log.h"
+#include "utils/Process.h"
 
 namespace tradeboy::market {
 
@@ -74,28 +76,30 @@ bool fetch_user_role_raw(const std::string& user_address_0x, std::string& out_js
     return fetch_info_raw(req, out_json);
 }
 
+tradeboy::core::Reactor::ProcId fetch_info_async(tradeboy::core::Reactor& reactor,
+                                                 const std::string& request_json,
+                                                 tradeboy::core::Reactor::ProcFn done) {
+    return tradeboy::core::wget_post_json(reactor, "https://api.hyperliquid.xyz/info", request_json, std::move(done));
+}
+
+std::string spot_clearinghouse_state_request(const std::string& user_address_0x) {
+    return std::string("{\"type\":\"spotClearinghouseState\",\"user\":\"") + user_address_0x + "\"}\n";
+}
+
+std::string perp_clearinghouse_state_request(const std::string& user_address_0x) {
+    return std::string("{\"type\":\"clearinghouseState\",\"user\":\"") + user_address_0x + "\"}\n";
+}
+
 bool fetch_spot_clearinghouse_state_raw(const std::string& user_address_0x, std::string& out_json) {
-    std::string req = std::string("{\"type\":\"spotClearinghouseState\",\"user\":\"") + user_address_0x + "\"}\n";
-    return fetch_info_raw(req, out_json);
+    return fetch_info_raw(spot_clearinghouse_state_request(user_address_0x), out_json);
 }
 
 bool fetch_perp_clearinghouse_state_raw(const std::string& user_address_0x, std::string& out_json) {
-    std::string req = std::string("{\"type\":\"clearinghouseState\",\"user\":\"") + user_address_0x + "\"}\n";
-    return fetch_info_raw(req, out_json);
+    return fetch_info_raw(perp_clearinghouse_state_request(user_address_0x), out_json);
 }
 
 static bool run_cmd_capture(const std::string& cmd, std::string& out) {
-    out.clear();
-    FILE* p = popen(cmd.c_str(), "r");
-    if (!p) return false;
-    char buf[4096];
-    while (true) {
-        size_t n = fread(buf, 1, sizeof(buf), p);
-        if (n > 0) out.append(buf, n);
-        if (n < sizeof(buf)) break;
-    }
-    int rc = pclose(p);
-    return rc == 0 && !out.empty();
+    return tradeboy::utils::run_cmd_capture(cmd, out) && !out.empty();
 }
 
 static bool hl_post_file(const char* json_path, std::string& out_json) {
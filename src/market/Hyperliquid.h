@@ -3,6 +3,8 @@
 #include <string>
 #include <vector>
 
+#include "core/Reactor.h"
+
 namespace tradeboy::market {
 
 bool fetch_all_mids_raw(std::string& out_json);
@@ -11,6 +13,15 @@ bool parse_mid_price(const std::string& all_mids_json, const std::string& coin,
 
 bool fetch_info_raw(const std::string& request_json, std::string& out_json);
 
+// Same POST to /info as a wget child on the network reactor; done gets the
+// raw reply. Reactor thread only.
+tradeboy::core::Reactor::ProcId fetch_info_async(tradeboy::core::Reactor& reactor,
+                                                 const std::string& request_json,
+                                                 tradeboy::core::Reactor::ProcFn done);
+
+std::string spot_clearinghouse_state_request(const std::string& user_address_0x);
+std::string perp_clearinghouse_state_request(const std::string& user_address_0x);
+
 bool fetch_user_role_raw(const std::string& user_address_0x, std::string& out_json);
 
 bool fetch_spot_clearinghouse_state_raw(const std::string& user_address_0x, std::string& out_json);
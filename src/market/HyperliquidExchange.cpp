@@ -912,6 +912,50 @@ static bool sign_digest_eth(const unsigned char digest32[32],
     return false;
 }
 
+static void eip712_hash_phantom_agent(bool is_mainnet,
+                                     const unsigned char connection_id32[32],
+                                     unsigned char out_digest32[32]) {
+    unsigned char typehash_domain[32];
+    keccak_256_str("EIP712Domain(string name,string version,uint256 chainId,address verifyingContract)", typehash_domain);
+
+    unsigned char name_hash[32];
+    unsigned char version_hash[32];
+    keccak_256_str("Exchange", name_hash);
+    keccak_256_str("1", version_hash);
+
+    unsigned char chain_id_u256[32];
+    store_u256_be(1337, chain_id_u256);
+
+    unsigned char verifying_contract[32];
+    std::memset(verifying_contract, 0, 32);
+
+    unsigned char domain_sep[32];
+    {
+        std::vector<unsigned char> enc = cat4_32(typehash_domain, name_hash, version_hash, chain_id_u256);
+        enc.insert(enc.end(), verifying_contract, verifying_contract + 32);
+        tradeboy::utils::keccak_256(enc.data(), enc.size(), domain_sep);
+    }
+
+    unsigned char typehash_msg[32];
+    keccak_256_str("Agent(string source,bytes32 connectionId)", typehash_msg);
+
+    unsigned char source_hash[32];
+    keccak_256_str(is_mainnet ? "a" : "b", source_hash);
+
+    unsigned char msg_hash[32];
+    {
+        std::vector<unsigned char> enc = cat3_32(typehash_msg, source_hash, connection_id32);
+        tradeboy::utils::keccak_256(enc.data(), enc.size(), msg_hash);
+    }
+
+    unsigned char dig[2 + 32 + 32];
+    dig[0] = 0x19;
+    dig[1] = 0x01;
+    std::memcpy(dig + 2, domain_sep, 32);
+    std::memcpy(dig + 34, msg_hash, 32);
+    tradeboy::utils::keccak_256(dig, sizeof(dig), out_digest32);
+}
+
 static std::string json_escape(const std::string& s) {
     std::string out;
     out.reserve(s.size() + 16);
@@ -928,6 +972,39 @@ static std::string json_escape(const std::string& s) {
     return out;
 }
 
+void exchange_l1_action_hash(const unsigned char* action_msgpack,
+                             size_t len,
+                             unsigned long long nonce_ms,
+                             unsigned char out_hash32[32]) {
+    // msgpack(action) || nonce (u64 BE) || vault flag (0x00: trading for self).
+    std::vector<unsigned char> pre;
+    pre.reserve(len + 9);
+    pre.insert(pre.end(), action_msgpack, action_msgpack + len);
+    for (int i = 7; i >= 0; i--) pre.push_back((unsigned char)((nonce_ms >> (8 * i)) & 0xFFu));
+    pre.push_back(0x00);
+    keccak_256_vec(pre, out_hash32);
+}
+
+bool exchange_sign_l1_action(const unsigned char connection_id32[32],
+                             bool is_mainnet,
+                             const std::string& wallet_address_0x,
+                             const std::vector<unsigned char>& priv32,
+                             std::string& out_r_0x,
+                             std::string& out_s_0x,
+                             int& out_v,
+                             std::string& out_err) {
+    unsigned char digest[32];
+    eip712_hash_phantom_agent(is_mainnet, connection_id32, digest);
+
+    std::string sign_err;
+    if (!sign_digest_eth(digest, priv32, wallet_address_0x, out_r_0x, out_s_0x, out_v, sign_err)) {
+        out_err = std::string("sign_failed:") + sign_err;
+        return false;
+    }
+    out_err.clear();
+    return true;
+}
+
 bool exchange_usd_class_transfer(const std::string& wallet_address_0x,
                                 const std::string& private_key_hex,
                                 bool to_perp,
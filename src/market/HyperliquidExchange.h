@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 namespace tradeboy::market {
 
@@ -22,4 +23,21 @@ bool exchange_withdraw3(const std::string& wallet_address_0x,
                         std::string& out_resp,
                         std::string& out_err);
 
+// L1 actions (order, cancel, ...) are not EIP-712 typed directly. The action is
+// msgpack-encoded, hashed together with the nonce into a connectionId, and that
+// hash is signed as a "phantom agent" under the Exchange/1337 domain.
+void exchange_l1_action_hash(const unsigned char* action_msgpack,
+                             size_t len,
+                             unsigned long long nonce_ms,
+                             unsigned char out_hash32[32]);
+
+bool exchange_sign_l1_action(const unsigned char connection_id32[32],
+                             bool is_mainnet,
+                             const std::string& wallet_address_0x,
+                             const std::vector<unsigned char>& priv32,
+                             std::string& out_r_0x,
+                             std::string& out_s_0x,
+                             int& out_v,
+                             std::string& out_err);
+
 } // namespace tradeboy::market
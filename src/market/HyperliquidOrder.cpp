@@ -0,0 +1,694 @@
+#include "HyperliquidOrder.h"
+
+#include "HyperliquidExchange.h"
+
+#include "core/Cancel.h"
+#include "utils/Hex.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "../../third_party/picojson/picojson.h"
+
+#include "utils/Log.h"
+
+namespace tradeboy::market {
+
+static const char* kMainnetExchangeUrl = "https://api.hyperliquid.xyz/exchange";
+static const char* kTestnetExchangeUrl = "https://api.hyperliquid-testnet.xyz/exchange";
+
+// Matches DEFAULT_SLIPPAGE in the reference python SDK. The order is IOC, so it
+// fills at the book and the slippage only bounds the worst price.
+static const double kMarketSlippage = 0.05;
+
+static const int kPostTimeoutMs = 8000;
+
+// A prepared limit price is reused while the mid stays within this band of
+// the mid it was computed from (well inside kMarketSlippage).
+static const double kPresignMaxDrift = 0.005;
+
+static long long now_ms() {
+    return (long long)std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+static const picojson::object* pj_get_obj(const picojson::value& v) {
+    if (!v.is<picojson::object>()) return nullptr;
+    return &v.get<picojson::object>();
+}
+
+static const picojson::array* pj_get_arr(const picojson::value& v) {
+    if (!v.is<picojson::array>()) return nullptr;
+    return &v.get<picojson::array>();
+}
+
+static const picojson::value* pj_find(const picojson::object& obj, const char* key) {
+    picojson::object::const_iterator it = obj.find(key);
+    if (it == obj.end()) return nullptr;
+    return &it->second;
+}
+
+static std::string pj_str_or_num(const picojson::value* v) {
+    if (!v) return std::string();
+    if (v->is<std::string>()) return v->get<std::string>();
+    if (v->is<double>()) {
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), "%.17g", v->get<double>());
+        return std::string(buf);
+    }
+    return std::string();
+}
+
+// Same normalisation as the SDK's float_to_wire: fixed 8 decimals, trailing
+// zeros stripped, never "-0".
+static std::string float_to_wire(double v) {
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "%.8f", v);
+    std::string s = buf;
+    if (s.find('.') != std::string::npos) {
+        while (!s.empty() && s.back() == '0') s.pop_back();
+        if (!s.empty() && s.back() == '.') s.pop_back();
+    }
+    if (s.empty() || s == "-0") s = "0";
+    return s;
+}
+
+std::string hl_wire_price(double px, int sz_decimals, bool is_spot) {
+    if (!std::isfinite(px) || px <= 0.0) return "0";
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "%.5g", px);
+    double v = std::strtod(buf, nullptr);
+    int decimals = (is_spot ? 8 : 6) - std::max(0, sz_decimals);
+    if (decimals < 0) decimals = 0;
+    const double p = std::pow(10.0, (double)decimals);
+    v = std::round(v * p) / p;
+    return float_to_wire(v);
+}
+
+std::string hl_wire_size(double sz, int sz_decimals) {
+    if (!std::isfinite(sz) || sz <= 0.0) return "0";
+    const int d = std::max(0, sz_decimals);
+    const double p = std::pow(10.0, (double)d);
+    // Epsilon keeps 0.3 * 10 from truncating to 2.
+    double v = std::floor(sz * p + 1e-9) / p;
+    return float_to_wire(v);
+}
+
+double hl_market_limit_price(double mid, bool is_buy) {
+    return is_buy ? mid * (1.0 + kMarketSlippage) : mid * (1.0 - kMarketSlippage);
+}
+
+bool parse_order_statuses(const std::string& resp, std::vector<OrderStatus>& out, std::string& out_err) {
+    out.clear();
+    out_err.clear();
+
+    picojson::value root;
+    std::string perr = picojson::parse(root, resp);
+    if (!perr.empty()) {
+        out_err = "resp_not_json";
+        return false;
+    }
+    const picojson::object* obj = pj_get_obj(root);
+    if (!obj) {
+        out_err = "resp_not_object";
+        return false;
+    }
+
+    const std::string status = pj_str_or_num(pj_find(*obj, "status"));
+    const picojson::value* rv = pj_find(*obj, "response");
+    if (status != "ok") {
+        out_err = (rv && rv->is<std::string>()) ? rv->get<std::string>() : std::string("exchange_error");
+        return false;
+    }
+
+    const picojson::object* robj = rv ? pj_get_obj(*rv) : nullptr;
+    const picojson::value* dv = robj ? pj_find(*robj, "data") : nullptr;
+    const picojson::object* dobj = dv ? pj_get_obj(*dv) : nullptr;
+    const picojson::value* sv = dobj ? pj_find(*dobj, "statuses") : nullptr;
+    const picojson::array* statuses = sv ? pj_get_arr(*sv) : nullptr;
+    if (!statuses) {
+        out_err = "missing_statuses";
+        return false;
+    }
+
+    out.reserve(statuses->size());
+    for (size_t i = 0; i < statuses->size(); i++) {
+        const picojson::value& s = (*statuses)[i];
+        OrderStatus st;
+        if (s.is<std::string>()) {
+            // Cancels answer with a bare "success".
+            st.ok = (s.get<std::string>() == "success");
+            st.text = s.get<std::string>();
+        } else if (const picojson::object* so = pj_get_obj(s)) {
+            const picojson::value* fv = pj_find(*so, "filled");
+            const picojson::value* restv = pj_find(*so, "resting");
+            const picojson::value* ev = pj_find(*so, "error");
+            if (fv && pj_get_obj(*fv)) {
+                const picojson::object& f = *pj_get_obj(*fv);
+                st.ok = true;
+                st.text = std::string("FILLED ") + pj_str_or_num(pj_find(f, "totalSz")) + " @ " + pj_str_or_num(pj_find(f, "avgPx"));
+                st.oid = std::strtoull(pj_str_or_num(pj_find(f, "oid")).c_str(), nullptr, 10);
+            } else if (restv && pj_get_obj(*restv)) {
+                st.ok = true;
+                const std::string oid = pj_str_or_num(pj_find(*pj_get_obj(*restv), "oid"));
+                st.text = std::string("RESTING oid=") + oid;
+                st.oid = std::strtoull(oid.c_str(), nullptr, 10);
+            } else if (ev) {
+                st.ok = false;
+                st.text = pj_str_or_num(ev);
+            } else {
+                st.ok = false;
+                st.text = "unknown_status";
+            }
+        } else {
+            st.ok = false;
+            st.text = "unknown_status";
+        }
+        out.push_back(st);
+    }
+    return true;
+}
+
+HyperliquidOrderClient::HyperliquidOrderClient() {
+    pthread_mutex_init(&mu_, nullptr);
+    pthread_mutex_init(&prep_mu_, nullptr);
+    mp_.reserve(512);
+    body_.reserve(1024);
+    http_.set_url(kMainnetExchangeUrl);
+}
+
+HyperliquidOrderClient::~HyperliquidOrderClient() {
+    pthread_mutex_destroy(&prep_mu_);
+    pthread_mutex_destroy(&mu_);
+}
+
+void HyperliquidOrderClient::configure(const std::string& exchange_url, bool is_mainnet) {
+    pthread_mutex_lock(&mu_);
+    pthread_mutex_lock(&prep_mu_);
+    is_mainnet_ = is_mainnet;
+    pthread_mutex_unlock(&prep_mu_);
+    const std::string url = !exchange_url.empty() ? exchange_url : std::string(is_mainnet ? kMainnetExchangeUrl : kTestnetExchangeUrl);
+    if (!http_.set_url(url)) {
+        std::string line = std::string("[HLO] invalid exchange url: ") + url + "\n";
+        log_str(line.c_str());
+    }
+    pthread_mutex_unlock(&mu_);
+}
+
+bool HyperliquidOrderClient::warm() {
+    return http_.warm();
+}
+
+unsigned long long HyperliquidOrderClient::reserve_nonce() {
+    // Millisecond timestamp, strictly increasing per client so a presigned
+    // candidate and a live order can never share a nonce.
+    unsigned long long prev = last_nonce_.load();
+    while (true) {
+        unsigned long long n = (unsigned long long)now_ms();
+        if (n <= prev) n = prev + 1;
+        if (last_nonce_.compare_exchange_weak(prev, n)) return n;
+    }
+}
+
+bool HyperliquidOrderClient::begin_prepare(const OrderPrepareRequest& req, OrderPrepareJob& out_job) {
+    // A run still signing for the previous job sees the new generation and
+    // drops what it produces; nothing here waits for it.
+    const unsigned int gen = prep_gen_.fetch_add(1) + 1;
+    const bool valid = req.asset >= 0 && req.mid > 0.0 && req.max_size > 0.0;
+    if (valid) {
+        out_job.req = req;
+        out_job.nonce_ms = reserve_nonce();
+        out_job.px = hl_wire_price(hl_market_limit_price(req.mid, req.is_buy), req.sz_decimals, true);
+        out_job.gen = gen;
+    }
+
+    pthread_mutex_lock(&prep_mu_);
+    prep_asset_ = valid ? req.asset : -1;
+    prep_is_buy_ = req.is_buy;
+    prep_mid_ = req.mid;
+    prep_px_ = valid ? out_job.px : std::string();
+    prep_nonce_ = valid ? out_job.nonce_ms : 0;
+    out_job.is_mainnet = is_mainnet_;
+    for (int i = 0; i < 4; i++) {
+        presigned_[i].ready = false;
+        presigned_[i].sz.clear();
+        presigned_[i].body.clear();
+    }
+    pthread_mutex_unlock(&prep_mu_);
+    return valid;
+}
+
+void HyperliquidOrderClient::cancel_prepare() {
+    prep_gen_.fetch_add(1);
+    pthread_mutex_lock(&prep_mu_);
+    prep_asset_ = -1;
+    for (int i = 0; i < 4; i++) presigned_[i].ready = false;
+    pthread_mutex_unlock(&prep_mu_);
+}
+
+void HyperliquidOrderClient::run_prepare(const OrderPrepareJob& job) {
+    const OrderPrepareRequest& req = job.req;
+    const unsigned int gen = job.gen;
+    const long long t0 = now_ms();
+
+    // Own writer: a superseded run may still be signing on another worker.
+    tradeboy::utils::MsgpackWriter mp;
+    mp.reserve(512);
+    int signed_n = 0;
+    const tradeboy::core::CancelToken* cancel = tradeboy::core::current_cancel();
+    for (int i = 0; i < 4; i++) {
+        if (prep_gen_.load() != gen) return;
+        if (cancel && cancel->cancelled()) return;
+
+        // Same rounding as NumberInputModal's percent presets, so the size the
+        // user confirms maps onto the same wire string.
+        const int pct = 25 * (i + 1);
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), "%.4f", (req.max_size * (double)pct) / 100.0);
+        const std::string sz = hl_wire_size(std::strtod(buf, nullptr), req.sz_decimals);
+        if (sz == "0") continue;
+
+        OrderWire o;
+        o.asset = req.asset;
+        o.is_buy = req.is_buy;
+        o.px = job.px;
+        o.sz = sz;
+        o.tif = "Ioc";
+
+        std::string body;
+        std::string err;
+        if (!build_signed_body(&o, 1, job.nonce_ms, job.is_mainnet, req.wallet_address_0x, req.private_key_hex, mp, body, err)) {
+            std::string line = std::string("[HLO] presign failed: ") + err + "\n";
+            log_str(line.c_str());
+            return;
+        }
+
+        pthread_mutex_lock(&prep_mu_);
+        if (prep_gen_.load() == gen) {
+            presigned_[i].sz = sz;
+            presigned_[i].body.swap(body);
+            presigned_[i].ready = true;
+            signed_n++;
+        }
+        pthread_mutex_unlock(&prep_mu_);
+    }
+
+    char line[128];
+    std::snprintf(line, sizeof(line), "[HLO] presigned asset=%d n=%d ms=%lld\n", req.asset, signed_n, now_ms() - t0);
+    log_str(line);
+}
+
+std::string HyperliquidOrderClient::limit_price_for(int asset, bool is_buy, double mid_now, int sz_decimals) {
+    pthread_mutex_lock(&prep_mu_);
+    std::string px;
+    if (prep_asset_ == asset && prep_is_buy_ == is_buy && prep_mid_ > 0.0 && mid_now > 0.0 &&
+        std::fabs(mid_now - prep_mid_) / prep_mid_ <= kPresignMaxDrift) {
+        px = prep_px_;
+    }
+    pthread_mutex_unlock(&prep_mu_);
+    if (px.empty()) {
+        px = hl_wire_price(hl_market_limit_price(mid_now, is_buy), sz_decimals, true);
+    }
+    return px;
+}
+
+static void encode_order_action(const OrderWire* orders, size_t n, tradeboy::utils::MsgpackWriter& mp) {
+    // Key order is part of the hash: type, orders, grouping / a, b, p, s, r, t.
+    mp.reset();
+    mp.map(3);
+    mp.str("type");
+    mp.str("order");
+    mp.str("orders");
+    mp.array(n);
+    for (size_t i = 0; i < n; i++) {
+        const OrderWire& o = orders[i];
+        mp.map(6);
+        mp.str("a");
+        mp.u64((unsigned long long)std::max(0, o.asset));
+        mp.str("b");
+        mp.boolean(o.is_buy);
+        mp.str("p");
+        mp.str(o.px);
+        mp.str("s");
+        mp.str(o.sz);
+        mp.str("r");
+        mp.boolean(o.reduce_only);
+        mp.str("t");
+        mp.map(1);
+        mp.str("limit");
+        mp.map(1);
+        mp.str("tif");
+        mp.str(o.tif);
+    }
+    mp.str("grouping");
+    mp.str("na");
+}
+
+static void append_order_action_json(const OrderWire* orders, size_t n, std::string& out) {
+    out += "{\"type\":\"order\",\"orders\":[";
+    for (size_t i = 0; i < n; i++) {
+        const OrderWire& o = orders[i];
+        char head[64];
+        std::snprintf(head, sizeof(head), "{\"a\":%d,\"b\":%s,", std::max(0, o.asset), o.is_buy ? "true" : "false");
+        if (i > 0) out += ",";
+        out += head;
+        out += "\"p\":\"";
+        out += o.px;
+        out += "\",\"s\":\"";
+        out += o.sz;
+        out += "\",\"r\":";
+        out += o.reduce_only ? "true" : "false";
+        out += ",\"t\":{\"limit\":{\"tif\":\"";
+        out += o.tif;
+        out += "\"}}}";
+    }
+    out += "],\"grouping\":\"na\"}";
+}
+
+static void encode_cancel_action(const CancelWire* cancels, size_t n, tradeboy::utils::MsgpackWriter& mp) {
+    // Key order is part of the hash: type, cancels / a, o.
+    mp.reset();
+    mp.map(2);
+    mp.str("type");
+    mp.str("cancel");
+    mp.str("cancels");
+    mp.array(n);
+    for (size_t i = 0; i < n; i++) {
+        mp.map(2);
+        mp.str("a");
+        mp.u64((unsigned long long)std::max(0, cancels[i].asset));
+        mp.str("o");
+        mp.u64(cancels[i].oid);
+    }
+}
+
+static void append_cancel_action_json(const CancelWire* cancels, size_t n, std::string& out) {
+    out += "{\"type\":\"cancel\",\"cancels\":[";
+    for (size_t i = 0; i < n; i++) {
+        char item[64];
+        std::snprintf(item, sizeof(item), "%s{\"a\":%d,\"o\":%llu}", i > 0 ? "," : "", std::max(0, cancels[i].asset), cancels[i].oid);
+        out += item;
+    }
+    out += "]}";
+}
+
+// Pads/truncates the exchange's statuses to one per submitted entry.
+static void align_statuses(std::vector<OrderStatus>& statuses, size_t n) {
+    if (statuses.size() > n) statuses.resize(n);
+    while (statuses.size() < n) {
+        OrderStatus st;
+        st.ok = false;
+        st.text = "missing_status";
+        statuses.push_back(st);
+    }
+}
+
+bool HyperliquidOrderClient::sign_action_into(const tradeboy::utils::MsgpackWriter& mp,
+                                              unsigned long long nonce_ms,
+                                              bool is_mainnet,
+                                              const std::string& wallet_address_0x,
+                                              const std::string& private_key_hex,
+                                              std::string& body,
+                                              std::string& out_err) {
+    std::vector<unsigned char> priv;
+    if (!tradeboy::utils::hex_to_bytes(private_key_hex, priv) || priv.size() != 32) {
+        out_err = "invalid_private_key";
+        return false;
+    }
+
+    unsigned char conn_id[32];
+    exchange_l1_action_hash(mp.data(), mp.size(), nonce_ms, conn_id);
+
+    std::string r_0x, s_0x;
+    int v = 0;
+    if (!exchange_sign_l1_action(conn_id, is_mainnet, wallet_address_0x, priv, r_0x, s_0x, v, out_err)) {
+        log_str("[HLO] sign_failed\n");
+        return false;
+    }
+
+    // body already holds {"action":<action>
+    char tail[96];
+    std::snprintf(tail, sizeof(tail), ",\"nonce\":%llu,\"signature\":{\"r\":\"", nonce_ms);
+    body += tail;
+    body += r_0x;
+    body += "\",\"s\":\"";
+    body += s_0x;
+    std::snprintf(tail, sizeof(tail), "\",\"v\":%d},\"vaultAddress\":null}", v);
+    body += tail;
+    return true;
+}
+
+bool HyperliquidOrderClient::build_signed_body(const OrderWire* orders,
+                                               size_t n,
+                                               unsigned long long nonce_ms,
+                                               bool is_mainnet,
+                                               const std::string& wallet_address_0x,
+                                               const std::string& private_key_hex,
+                                               tradeboy::utils::MsgpackWriter& mp,
+                                               std::string& out_body,
+                                               std::string& out_err) {
+    encode_order_action(orders, n, mp);
+    out_body.clear();
+    out_body += "{\"action\":";
+    append_order_action_json(orders, n, out_body);
+    return sign_action_into(mp, nonce_ms, is_mainnet, wallet_address_0x, private_key_hex, out_body, out_err);
+}
+
+bool HyperliquidOrderClient::build_signed_cancel_body(const CancelWire* cancels,
+                                                      size_t n,
+                                                      unsigned long long nonce_ms,
+                                                      bool is_mainnet,
+                                                      const std::string& wallet_address_0x,
+                                                      const std::string& private_key_hex,
+                                                      tradeboy::utils::MsgpackWriter& mp,
+                                                      std::string& out_body,
+                                                      std::string& out_err) {
+    encode_cancel_action(cancels, n, mp);
+    out_body.clear();
+    out_body += "{\"action\":";
+    append_cancel_action_json(cancels, n, out_body);
+    return sign_action_into(mp, nonce_ms, is_mainnet, wallet_address_0x, private_key_hex, out_body, out_err);
+}
+
+bool HyperliquidOrderClient::post_body(const std::string& body,
+                                       long long confirm_ms,
+                                       long long sign_ms,
+                                       bool presigned,
+                                       std::string& out_resp,
+                                       std::string& out_err) {
+    const long long t_post0 = now_ms();
+    int http_status = 0;
+    bool unknown = false;
+    const bool posted = http_.post_json(body, http_status, out_resp, kPostTimeoutMs, unknown);
+    const long long t_ack = now_ms();
+
+    {
+        char line[224];
+        std::snprintf(line, sizeof(line), "[HLO] order ack http=%d confirm_to_ack_ms=%lld sign_ms=%lld post_ms=%lld bytes=%u presigned=%d\n",
+                      http_status,
+                      confirm_ms > 0 ? (t_ack - confirm_ms) : -1LL,
+                      sign_ms,
+                      t_ack - t_post0,
+                      (unsigned int)body.size(),
+                      presigned ? 1 : 0);
+        log_str(line);
+    }
+
+    if (!posted) {
+        // Not resent: it may have been accepted, and the nonce is spent.
+        out_err = unknown ? "outcome_unknown" : "http_post_failed";
+        return false;
+    }
+    if (http_status != 200) {
+        out_err = std::string("http_status_") + std::to_string(http_status);
+        return false;
+    }
+    return true;
+}
+
+bool HyperliquidOrderClient::place_order(const std::string& wallet_address_0x,
+                                         const std::string& private_key_hex,
+                                         const OrderWire& order,
+                                         long long confirm_ms,
+                                         OrderStatus& out_status,
+                                         std::string& out_resp,
+                                         std::string& out_err) {
+    out_status = OrderStatus();
+    out_resp.clear();
+    out_err.clear();
+
+    if (order.asset < 0) {
+        out_err = "unknown_asset";
+        return false;
+    }
+    if (order.px == "0" || order.sz == "0") {
+        out_err = "size_or_price_zero";
+        return false;
+    }
+
+    {
+        std::string line = std::string("[HLO] order req asset=") + std::to_string(order.asset) +
+                           (order.is_buy ? " BUY" : " SELL") + " px=" + order.px + " sz=" + order.sz +
+                           " tif=" + order.tif + "\n";
+        log_str(line.c_str());
+    }
+
+    // Take a matching presigned candidate. Whatever happens next its nonce is
+    // spent, so the whole preparation is dropped either way.
+    bool hit = false;
+    pthread_mutex_lock(&mu_);
+    pthread_mutex_lock(&prep_mu_);
+    if (prep_asset_ == order.asset && prep_is_buy_ == order.is_buy && prep_px_ == order.px &&
+        !order.reduce_only && std::strcmp(order.tif, "Ioc") == 0) {
+        for (int i = 0; i < 4; i++) {
+            if (presigned_[i].ready && presigned_[i].sz == order.sz) {
+                body_.swap(presigned_[i].body);
+                hit = true;
+                break;
+            }
+        }
+    }
+    prep_gen_.fetch_add(1);
+    prep_asset_ = -1;
+    for (int i = 0; i < 4; i++) presigned_[i].ready = false;
+    pthread_mutex_unlock(&prep_mu_);
+
+    bool ok = false;
+    if (hit) {
+        ok = post_body(body_, confirm_ms, 0, true, out_resp, out_err);
+    } else {
+        const long long t_sign0 = now_ms();
+        ok = build_signed_body(&order, 1, reserve_nonce(), is_mainnet_, wallet_address_0x, private_key_hex, mp_, body_, out_err);
+        if (ok) ok = post_body(body_, confirm_ms, now_ms() - t_sign0, false, out_resp, out_err);
+    }
+    pthread_mutex_unlock(&mu_);
+    if (!ok) return false;
+
+    std::vector<OrderStatus> statuses;
+    std::string perr;
+    if (!parse_order_statuses(out_resp, statuses, perr)) {
+        out_err = perr;
+        return false;
+    }
+    if (statuses.empty()) {
+        out_err = "missing_statuses";
+        return false;
+    }
+    out_status = statuses[0];
+    if (!out_status.ok) {
+        out_err = out_status.text;
+        return false;
+    }
+    return true;
+}
+
+bool HyperliquidOrderClient::sign_orders(const std::string& wallet_address_0x,
+                                         const std::string& private_key_hex,
+                                         const std::vector<OrderWire>& orders,
+                                         unsigned long long nonce_ms,
+                                         std::string& out_body,
+                                         std::string& out_err) {
+    out_err.clear();
+    if (orders.empty()) {
+        out_err = "empty_batch";
+        return false;
+    }
+    pthread_mutex_lock(&mu_);
+    bool ok = build_signed_body(orders.data(), orders.size(), nonce_ms, is_mainnet_, wallet_address_0x, private_key_hex, mp_, out_body, out_err);
+    pthread_mutex_unlock(&mu_);
+    return ok;
+}
+
+bool HyperliquidOrderClient::place_orders(const std::string& wallet_address_0x,
+                                          const std::string& private_key_hex,
+                                          const std::vector<OrderWire>& orders,
+                                          long long confirm_ms,
+                                          std::vector<OrderStatus>& out_statuses,
+                                          std::string& out_resp,
+                                          std::string& out_err) {
+    out_statuses.clear();
+    out_resp.clear();
+    out_err.clear();
+
+    if (orders.empty()) {
+        out_err = "empty_batch";
+        return false;
+    }
+    for (size_t i = 0; i < orders.size(); i++) {
+        if (orders[i].asset < 0) {
+            out_err = "unknown_asset";
+            return false;
+        }
+        if (orders[i].px == "0" || orders[i].sz == "0") {
+            out_err = "size_or_price_zero";
+            return false;
+        }
+    }
+
+    {
+        char line[96];
+        std::snprintf(line, sizeof(line), "[HLO] batch req orders=%u\n", (unsigned int)orders.size());
+        log_str(line);
+    }
+
+    pthread_mutex_lock(&mu_);
+    const long long t_sign0 = now_ms();
+    bool ok = build_signed_body(orders.data(), orders.size(), reserve_nonce(), is_mainnet_, wallet_address_0x, private_key_hex, mp_, body_, out_err);
+    if (ok) ok = post_body(body_, confirm_ms, now_ms() - t_sign0, false, out_resp, out_err);
+    pthread_mutex_unlock(&mu_);
+    if (!ok) return false;
+
+    if (!parse_order_statuses(out_resp, out_statuses, out_err)) {
+        return false;
+    }
+    align_statuses(out_statuses, orders.size());
+    return true;
+}
+
+bool HyperliquidOrderClient::cancel_orders(const std::string& wallet_address_0x,
+                                           const std::string& private_key_hex,
+                                           const std::vector<CancelWire>& cancels,
+                                           std::vector<OrderStatus>& out_statuses,
+                                           std::string& out_resp,
+                                           std::string& out_err) {
+    out_statuses.clear();
+    out_resp.clear();
+    out_err.clear();
+
+    if (cancels.empty()) {
+        out_err = "empty_batch";
+        return false;
+    }
+    for (size_t i = 0; i < cancels.size(); i++) {
+        if (cancels[i].asset < 0 || cancels[i].oid == 0) {
+            out_err = "invalid_cancel";
+            return false;
+        }
+    }
+
+    {
+        char line[96];
+        std::snprintf(line, sizeof(line), "[HLO] cancel req n=%u\n", (unsigned int)cancels.size());
+        log_str(line);
+    }
+
+    pthread_mutex_lock(&mu_);
+    const long long t_sign0 = now_ms();
+    bool ok = build_signed_cancel_body(cancels.data(), cancels.size(), reserve_nonce(), is_mainnet_, wallet_address_0x, private_key_hex, mp_, body_, out_err);
+    if (ok) ok = post_body(body_, 0, now_ms() - t_sign0, false, out_resp, out_err);
+    pthread_mutex_unlock(&mu_);
+    if (!ok) return false;
+
+    if (!parse_order_statuses(out_resp, out_statuses, out_err)) {
+        return false;
+    }
+    align_statuses(out_statuses, cancels.size());
+    return true;
+}
+
+} // namespace tradeboy::market
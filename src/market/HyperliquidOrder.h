@@ -0,0 +1,199 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include <pthread.h>
+
+#include "core/HttpClient.h"
+#include "utils/Msgpack.h"
+
+namespace tradeboy::market {
+
+// One entry of an L1 "order" action. px/sz are already in wire form
+// (see hl_wire_price / hl_wire_size); the exchange rejects anything that is
+// off-tick or off-lot instead of rounding it.
+struct OrderWire {
+    int asset = -1;           // perp index, or 10000 + spot universe index
+    bool is_buy = true;
+    std::string px;
+    std::string sz;
+    bool reduce_only = false;
+    const char* tif = "Ioc";  // "Gtc" | "Ioc" | "Alo"
+};
+
+// One entry of an L1 "cancel" action.
+struct CancelWire {
+    int asset = -1;
+    unsigned long long oid = 0;
+};
+
+struct OrderStatus {
+    bool ok = false;
+    std::string text; // "FILLED 1.5 @ 23.01", "RESTING oid=...", or the exchange error
+    unsigned long long oid = 0; // filled/resting orders; 0 otherwise
+};
+
+// Hyperliquid tick rules: at most 5 significant figures and at most
+// (8 - szDecimals) decimals for spot, (6 - szDecimals) for perps.
+std::string hl_wire_price(double px, int sz_decimals, bool is_spot);
+// Lot rule: szDecimals decimals. Truncates so a 100% sell never exceeds the balance.
+std::string hl_wire_size(double sz, int sz_decimals);
+// Marketable IOC limit around the mid (same slippage as the reference SDK).
+double hl_market_limit_price(double mid, bool is_buy);
+
+bool parse_order_statuses(const std::string& resp, std::vector<OrderStatus>& out, std::string& out_err);
+
+// Everything about an order that is known when the amount modal opens.
+// Only the size is still missing.
+struct OrderPrepareRequest {
+    std::string wallet_address_0x;
+    std::string private_key_hex;
+    int asset = -1;
+    bool is_buy = true;
+    double mid = 0.0;
+    int sz_decimals = 0;
+    double max_size = 0.0; // modal max; presets are fractions of it
+};
+
+// What begin_prepare fixed on the UI thread; run_prepare signs from it.
+struct OrderPrepareJob {
+    OrderPrepareRequest req;
+    unsigned long long nonce_ms = 0;
+    std::string px;
+    unsigned int gen = 0;
+    bool is_mainnet = true; // signing domain, copied when the job was fixed
+};
+
+struct HyperliquidOrderClient {
+    HyperliquidOrderClient();
+    ~HyperliquidOrderClient();
+
+    HyperliquidOrderClient(const HyperliquidOrderClient&) = delete;
+    HyperliquidOrderClient& operator=(const HyperliquidOrderClient&) = delete;
+
+    // Empty url selects the public mainnet/testnet endpoint.
+    void configure(const std::string& exchange_url, bool is_mainnet);
+
+    // Opens (or refreshes) the keep-alive connection so the order POST skips
+    // process spawn + TLS handshake. Blocking; call off the UI thread.
+    bool warm();
+
+    // Speculative work while the amount modal is open, in two halves.
+    // begin_prepare (UI thread, non-blocking) replaces any previous
+    // preparation, reserves a nonce and fixes the limit price; false when
+    // there is nothing to sign. run_prepare (a worker) signs the 25/50/75/100%
+    // preset sizes, and drops its results once a newer begin_prepare,
+    // cancel_prepare or order has superseded the job. It does not touch the
+    // connection, so it never waits behind an order POST; warm() separately.
+    // Stops between signatures when the thread's current_cancel() fires.
+    bool begin_prepare(const OrderPrepareRequest& req, OrderPrepareJob& out_job);
+    void run_prepare(const OrderPrepareJob& job);
+    // Drops the prepared candidates (modal cancelled).
+    void cancel_prepare();
+
+    // Wire price to use for an order placed now: the prepared one if the mid
+    // hasn't drifted since preparation (so a presigned candidate can match),
+    // otherwise a fresh one from mid_now.
+    std::string limit_price_for(int asset, bool is_buy, double mid_now, int sz_decimals);
+
+    // Uses a presigned candidate when (asset, side, px, sz) match one, else
+    // signs on the spot. confirm_ms is when the user pressed confirm; the
+    // confirm-to-ack latency is logged from that point. out_err is
+    // "outcome_unknown" when the order went out but no reply came back: it may
+    // have filled, so it is not resent.
+    bool place_order(const std::string& wallet_address_0x,
+                     const std::string& private_key_hex,
+                     const OrderWire& order,
+                     long long confirm_ms,
+                     OrderStatus& out_status,
+                     std::string& out_resp,
+                     std::string& out_err);
+
+    // N orders (a grid or ladder) in one action: one signature, one request.
+    // out_statuses is index-aligned with orders; entries the exchange did not
+    // answer are filled with "missing_status". Returns false only when the
+    // request as a whole failed.
+    bool place_orders(const std::string& wallet_address_0x,
+                      const std::string& private_key_hex,
+                      const std::vector<OrderWire>& orders,
+                      long long confirm_ms,
+                      std::vector<OrderStatus>& out_statuses,
+                      std::string& out_resp,
+                      std::string& out_err);
+
+    // Bulk cancel, same shape as place_orders.
+    bool cancel_orders(const std::string& wallet_address_0x,
+                       const std::string& private_key_hex,
+                       const std::vector<CancelWire>& cancels,
+                       std::vector<OrderStatus>& out_statuses,
+                       std::string& out_resp,
+                       std::string& out_err);
+
+    // Builds the signed request body for a batch without sending it
+    // (order_batch_bench measures this against batch size).
+    bool sign_orders(const std::string& wallet_address_0x,
+                     const std::string& private_key_hex,
+                     const std::vector<OrderWire>& orders,
+                     unsigned long long nonce_ms,
+                     std::string& out_body,
+                     std::string& out_err);
+
+private:
+    struct Presigned {
+        bool ready = false;
+        std::string sz;
+        std::string body;
+    };
+
+    unsigned long long reserve_nonce();
+    bool build_signed_body(const OrderWire* orders,
+                           size_t n,
+                           unsigned long long nonce_ms,
+                           bool is_mainnet,
+                           const std::string& wallet_address_0x,
+                           const std::string& private_key_hex,
+                           tradeboy::utils::MsgpackWriter& mp,
+                           std::string& out_body,
+                           std::string& out_err);
+    bool build_signed_cancel_body(const CancelWire* cancels,
+                                  size_t n,
+                                  unsigned long long nonce_ms,
+                                  bool is_mainnet,
+                                  const std::string& wallet_address_0x,
+                                  const std::string& private_key_hex,
+                                  tradeboy::utils::MsgpackWriter& mp,
+                                  std::string& out_body,
+                                  std::string& out_err);
+    bool sign_action_into(const tradeboy::utils::MsgpackWriter& mp,
+                          unsigned long long nonce_ms,
+                          bool is_mainnet,
+                          const std::string& wallet_address_0x,
+                          const std::string& private_key_hex,
+                          std::string& body,
+                          std::string& out_err);
+    bool post_body(const std::string& body, long long confirm_ms, long long sign_ms, bool presigned, std::string& out_resp, std::string& out_err);
+
+    tradeboy::utils::MsgpackWriter mp_;
+    tradeboy::core::HttpKeepAliveClient http_;
+    std::string body_;
+    // Written under both mu_ and prep_mu_, so either one is enough to read it.
+    bool is_mainnet_ = true;
+    std::atomic<unsigned long long> last_nonce_{0};
+
+    mutable pthread_mutex_t mu_;
+
+    // Prepared state, guarded by prep_mu_. prep_gen_ invalidates in-flight
+    // signing when the modal is reopened or cancelled.
+    std::atomic<unsigned int> prep_gen_{0};
+    int prep_asset_ = -1;
+    bool prep_is_buy_ = true;
+    double prep_mid_ = 0.0;
+    std::string prep_px_;
+    unsigned long long prep_nonce_ = 0;
+    Presigned presigned_[4];
+    mutable pthread_mutex_t prep_mu_;
+};
+
+} // namespace tradeboy::market
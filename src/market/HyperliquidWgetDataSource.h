@@ -4,12 +4,13 @@
 
 namespace tradeboy::market {
 
+// Polls over wget inline. fetch_all_mids_raw blocks for the whole request, so
+// this source stalls the network reactor; the app runs the WS source.
 struct HyperliquidWgetDataSource final : public IMarketDataSource {
     bool fetch_all_mids_raw(std::string& out_json) override;
     void set_user_address(const std::string& user_address_0x) override;
+    std::string user_address() const override { return user_address_0x_; }
     bool fetch_user_webdata_raw(std::string& out_json) override;
-    bool fetch_spot_clearinghouse_state_raw(std::string& out_json) override;
-    bool fetch_perp_clearinghouse_state_raw(std::string& out_json) override;
 
 private:
     std::string user_address_0x_;
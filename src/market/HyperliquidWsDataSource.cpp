@@ -7,27 +7,44 @@
 #include <cstring>
 #include <ctime>
 #include <cstdint>
+#include <functional>
 #include <chrono>
 #include <string>
 #include <vector>
 
+#include <cerrno>
+
+#include <fcntl.h>
 #include <unistd.h>
+#include <sys/epoll.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <signal.h>
-#include <sys/select.h>
 
+#include "FeedStats.h"
 #include "Hyperliquid.h"
+#include "utils/FrameSchedule.h"
 #include "utils/Log.h"
 
 namespace tradeboy::market {
 
 struct Popen2 {
-    FILE* in = nullptr;  // to child stdin
-    FILE* out = nullptr; // from child stdout
+    FILE* in = nullptr; // to child stdin
+    int out = -1;       // from child stdout, nonblocking
     pid_t pid = -1;
 };
 
+static const int kMaxFramePayload = 2 * 1024 * 1024;
+static const int kMaxHandshakeBytes = 65536;
+static const int kHandshakeTimeoutMs = 10000;
+static const int kPingIntervalMs = 20000;
+
+static long long wall_ms() {
+    return (long long)std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
 static bool parse_post_id(const std::string& msg, unsigned int& out_id) {
     size_t p = msg.find("\"id\"");
     if (p == std::string::npos) return false;
@@ -83,14 +100,19 @@ static bool popen2_sh(const char* cmd, Popen2& p) {
     close(in_pipe[0]);
     close(out_pipe[1]);
 
+    // Our ends must not leak into the wget children the reactor spawns, or
+    // openssl would never see EOF on its stdin.
+    fcntl(in_pipe[1], F_SETFD, FD_CLOEXEC);
+    fcntl(out_pipe[0], F_SETFD, FD_CLOEXEC);
+    fcntl(out_pipe[0], F_SETFL, fcntl(out_pipe[0], F_GETFL) | O_NONBLOCK);
+
     p.in = fdopen(in_pipe[1], "w");
-    p.out = fdopen(out_pipe[0], "r");
+    p.out = out_pipe[0];
     p.pid = pid;
-    if (!p.in || !p.out) {
-        if (p.in) fclose(p.in);
-        if (p.out) fclose(p.out);
-        p.in = nullptr;
-        p.out = nullptr;
+    if (!p.in) {
+        close(in_pipe[1]);
+        close(out_pipe[0]);
+        p.out = -1;
         kill(pid, SIGKILL);
         int st = 0;
         waitpid(pid, &st, 0);
@@ -101,35 +123,35 @@ static bool popen2_sh(const char* cmd, Popen2& p) {
     return true;
 }
 
-static void pclose2(Popen2& p) {
+// Reaps from reactor timers so a slow child never stalls the loop.
+static void reap_later(tradeboy::core::Reactor& reactor, pid_t pid, int waited_ms) {
+    int st = 0;
+    const pid_t rc = waitpid(pid, &st, WNOHANG);
+    if (rc == pid || rc < 0) return;
+    if (waited_ms >= 1500) {
+        kill(pid, SIGKILL);
+        waitpid(pid, &st, 0);
+        return;
+    }
+    reactor.add_timer(50, [&reactor, pid, waited_ms]() { reap_later(reactor, pid, waited_ms + 50); });
+}
+
+// kill_now is for teardown: nothing will be left to run the reap timers.
+static void pclose2(tradeboy::core::Reactor& reactor, Popen2& p, bool kill_now) {
     if (p.in) fclose(p.in);
-    if (p.out) fclose(p.out);
+    if (p.out >= 0) close(p.out);
     p.in = nullptr;
-    p.out = nullptr;
-    if (p.pid > 0) {
+    p.out = -1;
+    if (p.pid > 0 && kill_now) {
         int st = 0;
-
-        // Avoid shutdown hangs if the child doesn't exit promptly.
+        kill(p.pid, SIGKILL);
+        while (waitpid(p.pid, &st, 0) < 0 && errno == EINTR) {
+        }
+    } else if (p.pid > 0) {
+        // Avoid stalls if the child doesn't exit promptly.
         // Try TERM first, then KILL after a short timeout.
         kill(p.pid, SIGTERM);
-        const long long start_ms = (long long)std::chrono::duration_cast<std::chrono::milliseconds>(
-                                       std::chrono::system_clock::now().time_since_epoch())
-                                       .count();
-        while (true) {
-            pid_t rc = waitpid(p.pid, &st, WNOHANG);
-            if (rc == p.pid) break;
-            if (rc < 0) break;
-
-            const long long now_ms = (long long)std::chrono::duration_cast<std::chrono::milliseconds>(
-                                          std::chrono::system_clock::now().time_since_epoch())
-                                          .count();
-            if ((now_ms - start_ms) > 1500) {
-                kill(p.pid, SIGKILL);
-                waitpid(p.pid, &st, 0);
-                break;
-            }
-            usleep(50 * 1000);
-        }
+        reap_later(reactor, p.pid, 0);
     }
     p.pid = -1;
 }
@@ -153,70 +175,6 @@ static std::string base64_encode(const unsigned char* data, size_t len) {
     return out;
 }
 
-static bool read_until(FILE* f, std::string& out, const char* needle, int max_bytes) {
-    out.clear();
-    const size_t nlen = std::strlen(needle);
-    if (nlen == 0) return true;
-
-    std::vector<char> window;
-    window.reserve(nlen);
-
-    int c = 0;
-    int read = 0;
-    while ((c = std::fgetc(f)) != EOF) {
-        out.push_back((char)c);
-        read++;
-        if ((int)window.size() < (int)nlen) window.push_back((char)c);
-        else {
-            window.erase(window.begin());
-            window.push_back((char)c);
-        }
-        if (window.size() == nlen && std::memcmp(window.data(), needle, nlen) == 0) {
-            return true;
-        }
-        if (read >= max_bytes) break;
-    }
-    return false;
-}
-
-static bool read_exact(FILE* f, unsigned char* buf, size_t n) {
-    size_t got = 0;
-    while (got < n) {
-        size_t r = std::fread(buf + got, 1, n - got, f);
-        if (r == 0) return false;
-        got += r;
-    }
-    return true;
-}
-
-static bool read_exact_timeout(FILE* f, unsigned char* buf, size_t n, int timeout_ms, const std::atomic<bool>* stop_flag) {
-    size_t got = 0;
-    const int fd = fileno(f);
-    while (got < n) {
-        if (stop_flag && stop_flag->load()) return false;
-
-        fd_set rfds;
-        FD_ZERO(&rfds);
-        FD_SET(fd, &rfds);
-        timeval tv;
-        tv.tv_sec = timeout_ms / 1000;
-        tv.tv_usec = (timeout_ms % 1000) * 1000;
-
-        int rc = select(fd + 1, &rfds, nullptr, nullptr, &tv);
-        if (rc == 0) {
-            continue; // timeout
-        }
-        if (rc < 0) {
-            return false;
-        }
-
-        size_t r = std::fread(buf + got, 1, n - got, f);
-        if (r == 0) return false;
-        got += r;
-    }
-    return true;
-}
-
 static bool ws_write_text(FILE* f, const std::string& s, unsigned int mask_seed) {
     std::array<unsigned char, 14> hdr;
     size_t hlen = 0;
@@ -307,118 +265,6 @@ static bool ws_write_frame(FILE* f, unsigned char opcode, const unsigned char* p
     return true;
 }
 
-static bool ws_read_text(FILE* f, std::string& out, int max_payload) {
-    out.clear();
-
-    unsigned char b2[2];
-    if (!read_exact(f, b2, 2)) return false;
-
-    const unsigned char fin_opcode = b2[0];
-    const unsigned char b1 = b2[1];
-
-    const unsigned char opcode = fin_opcode & 0x0F;
-    const bool masked = (b1 & 0x80) != 0;
-    unsigned long long plen = (unsigned long long)(b1 & 0x7F);
-
-    if (plen == 126) {
-        unsigned char ext[2];
-        if (!read_exact(f, ext, 2)) return false;
-        plen = ((unsigned long long)ext[0] << 8) | (unsigned long long)ext[1];
-    } else if (plen == 127) {
-        unsigned char ext[8];
-        if (!read_exact(f, ext, 8)) return false;
-        plen = 0;
-        for (int i = 0; i < 8; i++) plen = (plen << 8) | (unsigned long long)ext[i];
-    }
-
-    unsigned char mask[4] = {0, 0, 0, 0};
-    if (masked) {
-        if (!read_exact(f, mask, 4)) return false;
-    }
-
-    if ((int)plen > max_payload) {
-        std::vector<unsigned char> tmp;
-        tmp.resize((size_t)plen);
-        if (!read_exact(f, tmp.data(), (size_t)plen)) return false;
-        return false;
-    }
-
-    std::vector<unsigned char> payload;
-    payload.resize((size_t)plen);
-    if (plen > 0) {
-        if (!read_exact(f, payload.data(), (size_t)plen)) return false;
-    }
-
-    if (masked) {
-        for (size_t i = 0; i < (size_t)plen; i++) payload[i] ^= mask[i % 4];
-    }
-
-    if (opcode == 0x8) {
-        return false;
-    }
-    if (opcode == 0x9) {
-        return ws_read_text(f, out, max_payload);
-    }
-    if (opcode != 0x1) {
-        return ws_read_text(f, out, max_payload);
-    }
-
-    out.assign((const char*)payload.data(), payload.size());
-    return true;
-}
-
-static bool ws_read_frame_timeout(FILE* f,
-                                 unsigned char& out_opcode,
-                                 std::vector<unsigned char>& out_payload,
-                                 int max_payload,
-                                 int timeout_ms,
-                                 const std::atomic<bool>* stop_flag) {
-    out_payload.clear();
-
-    unsigned char b2[2];
-    if (!read_exact_timeout(f, b2, 2, timeout_ms, stop_flag)) return false;
-
-    const unsigned char fin_opcode = b2[0];
-    const unsigned char b1 = b2[1];
-
-    out_opcode = fin_opcode & 0x0F;
-    const bool masked = (b1 & 0x80) != 0;
-    unsigned long long plen = (unsigned long long)(b1 & 0x7F);
-
-    if (plen == 126) {
-        unsigned char ext[2];
-        if (!read_exact_timeout(f, ext, 2, timeout_ms, stop_flag)) return false;
-        plen = ((unsigned long long)ext[0] << 8) | (unsigned long long)ext[1];
-    } else if (plen == 127) {
-        unsigned char ext[8];
-        if (!read_exact_timeout(f, ext, 8, timeout_ms, stop_flag)) return false;
-        plen = 0;
-        for (int i = 0; i < 8; i++) plen = (plen << 8) | (unsigned long long)ext[i];
-    }
-
-    unsigned char mask[4] = {0, 0, 0, 0};
-    if (masked) {
-        if (!read_exact_timeout(f, mask, 4, timeout_ms, stop_flag)) return false;
-    }
-
-    if ((int)plen > max_payload) {
-        std::vector<unsigned char> tmp;
-        tmp.resize((size_t)plen);
-        if (!read_exact_timeout(f, tmp.data(), (size_t)plen, timeout_ms, stop_flag)) return false;
-        return false;
-    }
-
-    out_payload.resize((size_t)plen);
-    if (plen > 0) {
-        if (!read_exact_timeout(f, out_payload.data(), (size_t)plen, timeout_ms, stop_flag)) return false;
-    }
-
-    if (masked) {
-        for (size_t i = 0; i < (size_t)plen; i++) out_payload[i] ^= mask[i % 4];
-    }
-    return true;
-}
-
 static std::string extract_data_object_if_wrapped(const std::string& msg) {
     size_t p = msg.find("\"data\"");
     if (p == std::string::npos) return msg;
@@ -461,14 +307,8 @@ static std::string extract_object_after_key(const std::string& msg, const char*
     return std::string();
 }
 
-static bool ws_connect_and_subscribe(Popen2& p) {
-    const char* cmd = "/usr/bin/openssl s_client -quiet -connect api.hyperliquid.xyz:443 -servername api.hyperliquid.xyz";
-    if (!popen2_sh(cmd, p)) {
-        log_str("[WS] popen2 failed\n");
-        return false;
-    }
-
-    std::srand((unsigned int)(std::time(nullptr) ^ (unsigned int)p.pid));
+static std::string ws_upgrade_request(unsigned int seed) {
+    std::srand(seed);
 
     unsigned char key_raw[16];
     for (int i = 0; i < 16; i++) key_raw[i] = (unsigned char)(std::rand() & 0xFF);
@@ -482,51 +322,23 @@ static bool ws_connect_and_subscribe(Popen2& p) {
     req += "Sec-WebSocket-Key: " + key_b64 + "\r\n";
     req += "Sec-WebSocket-Version: 13\r\n";
     req += "\r\n";
-
-    if (std::fwrite(req.data(), 1, req.size(), p.in) != req.size()) {
-        pclose2(p);
-        return false;
-    }
-    std::fflush(p.in);
-
-    std::string headers;
-    if (!read_until(p.out, headers, "\r\n\r\n", 65536)) {
-        if (!headers.empty()) {
-            std::string prefix = headers;
-            if (prefix.size() > 512) prefix.resize(512);
-            log_str("[WS] handshake read headers failed (prefix)\n");
-        } else {
-            log_str("[WS] handshake read headers failed (read=0)\n");
-        }
-        pclose2(p);
-        return false;
-    }
-
-    if (headers.find(" 101 ") == std::string::npos && headers.find(" 101\r\n") == std::string::npos) {
-        log_str("[WS] handshake failed\n");
-        pclose2(p);
-        return false;
-    }
-
-    log_str("[WS] handshake ok\n");
-
-    const std::string sub = "{\"method\":\"subscribe\",\"subscription\":{\"type\":\"allMids\"}}";
-    if (!ws_write_text(p.in, sub, (unsigned int)std::rand())) {
-        pclose2(p);
-        return false;
-    }
-
-    return true;
+    return req;
 }
 
-HyperliquidWsDataSource::HyperliquidWsDataSource() {
+HyperliquidWsDataSource::HyperliquidWsDataSource(tradeboy::core::Reactor& reactor) : reactor_(reactor) {
     pthread_mutex_init(&mu_, nullptr);
-    th_ = std::thread([this]() { run(); });
+    subs_.set_group(WsSubGroup::Base, std::vector<std::string>(1, ws_sub_all_mids()));
+    reactor_.post([this]() { connect(); });
 }
 
 HyperliquidWsDataSource::~HyperliquidWsDataSource() {
-    stop_.store(true);
-    if (th_.joinable()) th_.join();
+    reactor_.run_sync([this]() {
+        stopped_ = true;
+        reactor_.cancel_timer(reconnect_timer_);
+        reconnect_timer_ = 0;
+        disconnect(false);
+        update_hook_ = std::function<void()>();
+    });
     pthread_mutex_destroy(&mu_);
 }
 
@@ -537,41 +349,76 @@ void HyperliquidWsDataSource::set_user_address(const std::string& user_address_0
         return;
     }
     user_address_0x_ = user_address_0x;
+    latest_user_json_.clear();
+    latest_user_ms_ = 0;
     pthread_mutex_unlock(&mu_);
-    reconnect_requested_.store(true);
+
+    std::vector<std::string> base(1, ws_sub_all_mids());
+    if (!user_address_0x.empty()) base.push_back(ws_sub_web_data3(user_address_0x));
+    subs_.set_group(WsSubGroup::Base, base);
+    reactor_.post([this]() { sync_subs(); });
 }
 
-bool HyperliquidWsDataSource::fetch_all_mids_raw(std::string& out_json) {
-    const long long now_ms = (long long)std::chrono::duration_cast<std::chrono::milliseconds>(
-                                 std::chrono::system_clock::now().time_since_epoch())
-                                 .count();
+std::string HyperliquidWsDataSource::user_address() const {
+    pthread_mutex_lock(&mu_);
+    const std::string addr = user_address_0x_;
+    pthread_mutex_unlock(&mu_);
+    return addr;
+}
+
+void HyperliquidWsDataSource::set_update_hook(const std::function<void()>& fn) {
+    update_hook_ = fn;
+}
 
+// Logs when a feed goes stale and when it recovers, with the measured age and
+// the threshold derived from its own receive interval.
+static void report_staleness(Feed f, bool stale, bool& was_stale) {
+    if (stale == was_stale) return;
+    was_stale = stale;
+    const FeedStats& st = feed_stats();
+    char buf[128];
+    std::snprintf(buf,
+                  sizeof(buf),
+                  "[WS] %s %s age_ms=%lld limit_ms=%lld iv_ms=%lld\n",
+                  feed_name(f),
+                  stale ? "stale" : "live again",
+                  st.age_ms(f, feed_now_us()),
+                  st.stale_after_ms(f),
+                  st.interval_ms(f));
+    log_str(buf);
+}
+
+bool HyperliquidWsDataSource::fetch_all_mids_raw(std::string& out_json) {
     pthread_mutex_lock(&mu_);
     if (latest_mids_json_.empty()) {
         pthread_mutex_unlock(&mu_);
         return false;
     }
     // If data is too old, let MarketDataService backoff/retry.
-    if (latest_mids_ms_ == 0 || (now_ms - latest_mids_ms_) > 15000) {
+    const bool stale = feed_stats().stale(Feed::Mids, feed_now_us());
+    report_staleness(Feed::Mids, stale, mids_stale_);
+    if (stale) {
         pthread_mutex_unlock(&mu_);
         return false;
     }
+    // Each update is handed out once, so an idle consumer does no work.
+    if (latest_mids_ms_ == mids_taken_ms_) {
+        pthread_mutex_unlock(&mu_);
+        return false;
+    }
+    mids_taken_ms_ = latest_mids_ms_;
     out_json = latest_mids_json_;
     pthread_mutex_unlock(&mu_);
     return true;
 }
 
 bool HyperliquidWsDataSource::fetch_user_webdata_raw(std::string& out_json) {
-    const long long now_ms = (long long)std::chrono::duration_cast<std::chrono::milliseconds>(
-                                 std::chrono::system_clock::now().time_since_epoch())
-                                 .count();
-
     pthread_mutex_lock(&mu_);
     if (latest_user_json_.empty()) {
         pthread_mutex_unlock(&mu_);
         return false;
     }
-    if (latest_user_ms_ == 0 || (now_ms - latest_user_ms_) > 15000) {
+    if (feed_stats().stale(Feed::User, feed_now_us())) {
         pthread_mutex_unlock(&mu_);
         return false;
     }
@@ -580,159 +427,415 @@ bool HyperliquidWsDataSource::fetch_user_webdata_raw(std::string& out_json) {
     return true;
 }
 
-bool HyperliquidWsDataSource::fetch_spot_clearinghouse_state_raw(std::string& out_json) {
-    std::string addr;
+void HyperliquidWsDataSource::set_focus_coin(const std::string& coin, const std::string& candle_coin) {
+    const std::string& cc = (candle_coin.empty() || coin.empty()) ? coin : candle_coin;
     pthread_mutex_lock(&mu_);
-    addr = user_address_0x_;
+    if (focus_coin_ == coin && focus_candle_coin_ == cc) {
+        pthread_mutex_unlock(&mu_);
+        return;
+    }
+    focus_coin_ = coin;
+    focus_candle_coin_ = cc;
+    l2_book_.clear();
+    l2_book_ms_ = 0;
+    focus_candle_new_ = false;
     pthread_mutex_unlock(&mu_);
-    if (addr.empty()) return false;
-    return tradeboy::market::fetch_spot_clearinghouse_state_raw(addr, out_json);
+
+    std::vector<std::string> subs;
+    if (!coin.empty()) {
+        subs.push_back(ws_sub_coin("l2Book", coin));
+        subs.push_back(ws_sub_coin("trades", coin));
+        subs.push_back(ws_sub_candle(cc, candle_interval_name(tradeboy::model::CandleRes::M1)));
+    }
+    subs_.set_group(WsSubGroup::Focus, subs);
+    reactor_.post([this]() { sync_subs(); });
+}
+
+bool HyperliquidWsDataSource::fetch_l2_book(OrderBook& out, long long& io_book_ms) {
+    pthread_mutex_lock(&mu_);
+    if (l2_book_.empty() || l2_book_ms_ == 0 || feed_stats().stale(Feed::L2Book, feed_now_us())) {
+        pthread_mutex_unlock(&mu_);
+        return false;
+    }
+    if (l2_book_ms_ != io_book_ms) {
+        out = l2_book_;
+        io_book_ms = l2_book_ms_;
+    }
+    pthread_mutex_unlock(&mu_);
+    return true;
 }
 
-bool HyperliquidWsDataSource::fetch_perp_clearinghouse_state_raw(std::string& out_json) {
-    std::string addr;
+size_t HyperliquidWsDataSource::drain_trades(TradePrint* out, size_t cap) {
+    size_t n = 0;
+    while (n < cap && trade_tape_.pop(out[n])) n++;
+    return n;
+}
+
+bool HyperliquidWsDataSource::fetch_focus_candle(std::string& out_coin, CandleRecord& out) {
     pthread_mutex_lock(&mu_);
-    addr = user_address_0x_;
+    const bool fresh = focus_candle_new_;
+    if (fresh) {
+        out_coin = focus_candle_coin_;
+        out = focus_candle_;
+        focus_candle_new_ = false;
+    }
     pthread_mutex_unlock(&mu_);
-    if (addr.empty()) return false;
-    return tradeboy::market::fetch_perp_clearinghouse_state_raw(addr, out_json);
+    return fresh;
 }
 
-void HyperliquidWsDataSource::run() {
-    int reconnect_backoff_ms = 1000;
-    unsigned int log_every = 0;
-    bool logged_binary_frame = false;
-    bool logged_post_seen = false;
+void HyperliquidWsDataSource::set_perp_ctx_coins(const std::vector<std::string>& coins) {
+    std::vector<std::string> subs;
+    subs.reserve(coins.size());
+    for (const auto& c : coins) subs.push_back(ws_sub_coin("activeAssetCtx", c));
+    subs_.set_group(WsSubGroup::PerpCtx, subs);
+    reactor_.post([this]() { sync_subs(); });
+}
 
-    while (!stop_.load()) {
-        Popen2 p;
-        if (!ws_connect_and_subscribe(p)) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(reconnect_backoff_ms));
-            reconnect_backoff_ms = std::min(30000, reconnect_backoff_ms * 2);
+size_t HyperliquidWsDataSource::drain_perp_ctxs(tradeboy::model::PerpCtxUpdate* out, size_t cap) {
+    size_t n = 0;
+    while (n < cap && perp_ctx_queue_.pop(out[n])) n++;
+    return n;
+}
+
+void HyperliquidWsDataSource::connect() {
+    reconnect_timer_ = 0;
+    if (stopped_ || state_ != ConnState::Idle) return;
+
+    const char* cmd = "/usr/bin/openssl s_client -quiet -connect api.hyperliquid.xyz:443 -servername api.hyperliquid.xyz";
+    Popen2 p;
+    if (!popen2_sh(cmd, p)) {
+        log_str("[WS] popen2 failed\n");
+        disconnect(true);
+        return;
+    }
+    child_ = p.pid;
+    child_in_ = p.in;
+    child_out_ = p.out;
+    state_ = ConnState::Handshake;
+    rx_.clear();
+
+    const std::string req = ws_upgrade_request((unsigned int)(std::time(nullptr) ^ (unsigned int)p.pid));
+    if (std::fwrite(req.data(), 1, req.size(), child_in_) != req.size() ||
+        !reactor_.watch(child_out_, EPOLLIN, [this](uint32_t) { on_readable(); })) {
+        disconnect(true);
+        return;
+    }
+    std::fflush(child_in_);
+
+    handshake_timer_ = reactor_.add_timer(kHandshakeTimeoutMs, [this]() {
+        handshake_timer_ = 0;
+        log_str("[WS] handshake timeout\n");
+        disconnect(true);
+    });
+}
+
+void HyperliquidWsDataSource::disconnect(bool reconnect) {
+    if (child_out_ >= 0) reactor_.unwatch(child_out_);
+    reactor_.cancel_timer(handshake_timer_);
+    reactor_.cancel_timer(ping_timer_);
+    handshake_timer_ = 0;
+    ping_timer_ = 0;
+
+    Popen2 p;
+    p.in = child_in_;
+    p.out = child_out_;
+    p.pid = child_;
+    pclose2(reactor_, p, stopped_);
+    child_in_ = nullptr;
+    child_out_ = -1;
+    child_ = -1;
+    state_ = ConnState::Idle;
+    rx_.clear();
+
+    if (reconnect && !stopped_ && !reconnect_timer_) {
+        reconnect_timer_ = reactor_.add_timer(reconnect_backoff_ms_, [this]() { connect(); });
+        reconnect_backoff_ms_ = std::min(30000, reconnect_backoff_ms_ * 2);
+    }
+}
+
+void HyperliquidWsDataSource::on_readable() {
+    unsigned char buf[16384];
+    bool eof = false;
+    for (;;) {
+        const ssize_t n = read(child_out_, buf, sizeof(buf));
+        if (n > 0) {
+            rx_.insert(rx_.end(), buf, buf + n);
             continue;
         }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        eof = true;
+        break;
+    }
 
-        std::string user_addr;
-        pthread_mutex_lock(&mu_);
-        user_addr = user_address_0x_;
-        pthread_mutex_unlock(&mu_);
-        if (!user_addr.empty()) {
-            const std::string sub_user = std::string("{\"method\":\"subscribe\",\"subscription\":{\"type\":\"webData3\",\"user\":\"") +
-                                         user_addr + "\"}}";
-            if (!ws_write_text(p.in, sub_user, (unsigned int)std::rand())) {
-                pclose2(p);
-                continue;
-            }
+    if (state_ == ConnState::Handshake && !on_handshake_data(eof)) {
+        disconnect(true);
+        return;
+    }
+    // Still reading headers, or the first subscribe already failed.
+    if (state_ != ConnState::Open) return;
+    if (!parse_frames() || eof) disconnect(true);
+}
+
+bool HyperliquidWsDataSource::on_handshake_data(bool eof) {
+    static const char kEnd[] = "\r\n\r\n";
+    const std::vector<unsigned char>::iterator end_it = std::search(rx_.begin(), rx_.end(), kEnd, kEnd + 4);
+    if (end_it == rx_.end()) {
+        if (!eof && (int)rx_.size() < kMaxHandshakeBytes) return true;
+        if (!rx_.empty()) {
+            log_str("[WS] handshake read headers failed (prefix)\n");
+        } else {
+            log_str("[WS] handshake read headers failed (read=0)\n");
         }
+        return false;
+    }
 
-        reconnect_backoff_ms = 1000;
-        log_every = 0;
+    const std::string headers(rx_.begin(), end_it + 4);
+    if (headers.find(" 101 ") == std::string::npos && headers.find(" 101\r\n") == std::string::npos) {
+        log_str("[WS] handshake failed\n");
+        return false;
+    }
+    // Frames may already follow the headers in the same read.
+    rx_.erase(rx_.begin(), end_it + 4);
 
-        long long last_ping_ms = 0;
+    log_str("[WS] handshake ok\n");
+    reactor_.cancel_timer(handshake_timer_);
+    handshake_timer_ = 0;
+    state_ = ConnState::Open;
+    reconnect_backoff_ms_ = 1000;
+    log_every_ = 0;
+
+    // Subscriptions don't survive a reconnect.
+    subs_.on_connected();
+    sync_subs();
+    // Proactive ping heartbeat (keepalive). The server may also send pings; we respond with pong.
+    if (state_ == ConnState::Open) send_ping();
+    return true;
+}
 
-        while (!stop_.load()) {
-            const long long now_ms = (long long)std::chrono::duration_cast<std::chrono::milliseconds>(
-                                         std::chrono::system_clock::now().time_since_epoch())
-                                         .count();
+void HyperliquidWsDataSource::sync_subs() {
+    if (state_ != ConnState::Open || !subs_.dirty()) return;
+    FILE* f = child_in_;
+    const std::function<bool(const std::string&)> send = [f](const std::string& msg) {
+        return ws_write_text(f, msg, (unsigned int)std::rand());
+    };
+    if (!subs_.sync(send)) disconnect(true);
+}
 
-            if (reconnect_requested_.exchange(false)) {
-                break;
-            }
+void HyperliquidWsDataSource::send_ping() {
+    ping_timer_ = 0;
+    if (state_ != ConnState::Open) return;
+    (void)ws_write_frame(child_in_, 0x9, nullptr, 0, (unsigned int)std::rand());
+    ping_timer_ = reactor_.add_timer(kPingIntervalMs, [this]() { send_ping(); });
+}
 
-            (void)now_ms;
+// Consumes every complete frame in rx_ and leaves a partial one for the next
+// read. False when the connection has to go (close frame, oversized payload).
+bool HyperliquidWsDataSource::parse_frames() {
+    const long long recv_us = feed_now_us();
+    const long long recv_ms = wall_ms();
+    size_t off = 0;
+    bool ok = true;
+    while (ok) {
+        const size_t avail = rx_.size() - off;
+        if (avail < 2) break;
+        const unsigned char* h = rx_.data() + off;
+        const unsigned char opcode = h[0] & 0x0F;
+        const bool masked = (h[1] & 0x80) != 0;
+        unsigned long long plen = (unsigned long long)(h[1] & 0x7F);
+        size_t hlen = 2;
+        if (plen == 126) {
+            if (avail < 4) break;
+            plen = ((unsigned long long)h[2] << 8) | (unsigned long long)h[3];
+            hlen = 4;
+        } else if (plen == 127) {
+            if (avail < 10) break;
+            plen = 0;
+            for (int i = 0; i < 8; i++) plen = (plen << 8) | (unsigned long long)h[2 + i];
+            hlen = 10;
+        }
+        if (masked) hlen += 4;
+        if (avail < hlen) break;
+        if (plen > (unsigned long long)kMaxFramePayload) {
+            log_str("[WS] frame too large\n");
+            return false;
+        }
+        if (avail - hlen < plen) break;
 
-            // Proactive ping heartbeat (keepalive). The server may also send pings; we respond with pong.
-            if (last_ping_ms == 0 || (now_ms - last_ping_ms) > 20000) {
-                (void)ws_write_frame(p.in, 0x9, nullptr, 0, (unsigned int)std::rand());
-                last_ping_ms = now_ms;
-            }
+        unsigned char* payload = rx_.data() + off + hlen;
+        if (masked) {
+            const unsigned char* mask = payload - 4;
+            for (size_t i = 0; i < (size_t)plen; i++) payload[i] ^= mask[i % 4];
+        }
+        off += hlen + (size_t)plen;
+        ok = handle_frame(opcode, payload, (size_t)plen, recv_us, recv_ms);
+    }
+    if (!ok) return false;
+    rx_.erase(rx_.begin(), rx_.begin() + off);
+    return true;
+}
 
-            unsigned char opcode = 0;
-            std::vector<unsigned char> payload;
-            if (!ws_read_frame_timeout(p.out, opcode, payload, 2 * 1024 * 1024, 1000, &stop_)) {
-                break;
-            }
+bool HyperliquidWsDataSource::handle_frame(unsigned char opcode,
+                                           const unsigned char* payload,
+                                           size_t n,
+                                           long long recv_us,
+                                           long long recv_ms) {
+    if (opcode == 0x8) {
+        return false;
+    }
 
-            if (opcode == 0x8) {
-                break;
-            }
+    if (opcode == 0x2) {
+        if (!logged_binary_frame_) {
+            logged_binary_frame_ = true;
+            log_str("[WS] binary frame seen\n");
+        }
+        return true;
+    }
 
-            if (opcode == 0x2) {
-                if (!logged_binary_frame) {
-                    logged_binary_frame = true;
-                    log_str("[WS] binary frame seen\n");
-                }
-                continue;
-            }
+    if (opcode == 0x9) {
+        // Ping -> Pong
+        (void)ws_write_frame(child_in_, 0xA, n == 0 ? nullptr : payload, n, (unsigned int)std::rand());
+        return true;
+    }
+    if (opcode != 0x1) {
+        return true;
+    }
 
-            if (opcode == 0x9) {
-                // Ping -> Pong
-                (void)ws_write_frame(p.in, 0xA, payload.empty() ? nullptr : payload.data(), payload.size(), (unsigned int)std::rand());
-                continue;
-            }
-            if (opcode != 0x1) {
-                continue;
-            }
+    handle_text(payload, n, recv_us, recv_ms);
+    return true;
+}
 
-            std::string msg((const char*)payload.data(), payload.size());
-            if (msg.find("\"mids\"") != std::string::npos) {
-                std::string data_obj = extract_data_object_if_wrapped(msg);
-                std::string mids_obj = extract_object_after_key(data_obj, "mids");
-                if (mids_obj.empty()) mids_obj = extract_object_after_key(msg, "mids");
-                if (!mids_obj.empty() && mids_obj.find("\":\"") != std::string::npos) {
-                    pthread_mutex_lock(&mu_);
-                    latest_mids_json_ = std::move(mids_obj);
-                    latest_mids_ms_ = now_ms;
-                    log_every++;
-                    if ((log_every % 20) == 1) {
-                        log_str("[WS] allMids mids cached\n");
-                    }
-                    pthread_mutex_unlock(&mu_);
+void HyperliquidWsDataSource::handle_text(const unsigned char* payload, size_t n, long long recv_us, long long recv_ms) {
+    // l2Book, trades, candle and activeAssetCtx are the busiest channels; parse them straight from the frame.
+    {
+        static const char kL2Channel[] = "\"channel\":\"l2Book\"";
+        static const char kDataKey[] = "\"data\"";
+        const char* data = (const char*)payload;
+        const char* end = data + n;
+        const char* head_end = data + std::min<size_t>(n, 64);
+        if (std::search(data, head_end, kL2Channel, kL2Channel + sizeof(kL2Channel) - 1) != head_end) {
+            const char* dp = std::search(data, end, kDataKey, kDataKey + sizeof(kDataKey) - 1);
+            if (dp != end) dp = std::find(dp, end, '{');
+            if (dp != end && l2_scratch_.apply_l2_snapshot_json(dp, (size_t)(end - dp))) {
+                feed_stats().on_parsed(Feed::L2Book, recv_us, l2_scratch_.time_ms);
+                bool published = false;
+                pthread_mutex_lock(&mu_);
+                // Drop frames for a coin we already switched away from.
+                if (l2_scratch_.is_coin(focus_coin_.c_str())) {
+                    l2_book_ = l2_scratch_;
+                    l2_book_ms_ = recv_ms;
+                    published = true;
+                }
+                pthread_mutex_unlock(&mu_);
+                if (published) {
+                    feed_stats().on_published(Feed::L2Book);
+                    tradeboy::utils::wake_frame_loop(); // depth on the spot screen
                 }
-                continue;
             }
-
-            if (msg.find("\"webData3\"") != std::string::npos) {
-                std::string data_obj = extract_data_object_if_wrapped(msg);
-                if (!data_obj.empty()) {
-                    pthread_mutex_lock(&mu_);
-                    latest_user_json_ = std::move(data_obj);
-                    latest_user_ms_ = now_ms;
-                    pthread_mutex_unlock(&mu_);
+            return;
+        }
+        static const char kTradesChannel[] = "\"channel\":\"trades\"";
+        if (std::search(data, head_end, kTradesChannel, kTradesChannel + sizeof(kTradesChannel) - 1) != head_end) {
+            const char* dp = std::search(data, end, kDataKey, kDataKey + sizeof(kDataKey) - 1);
+            if (dp != end) dp = std::find(dp, end, '[');
+            long long last_trade_ms = 0;
+            if (dp != end && trade_tape_.push_trades_json(dp, (size_t)(end - dp), recv_ms, &last_trade_ms) > 0) {
+                feed_stats().on_parsed(Feed::Trades, recv_us, last_trade_ms);
+                tradeboy::utils::wake_frame_loop(); // trade flow on the spot screen
+            }
+            return;
+        }
+        static const char kCandleChannel[] = "\"channel\":\"candle\"";
+        if (std::search(data, head_end, kCandleChannel, kCandleChannel + sizeof(kCandleChannel) - 1) != head_end) {
+            const char* dp = std::search(data, end, kDataKey, kDataKey + sizeof(kDataKey) - 1);
+            if (dp != end) dp = std::find(dp, end, '{');
+            std::string coin;
+            CandleRecord rec;
+            if (dp != end && parse_ws_candle_json(dp, (size_t)(end - dp), coin, rec)) {
+                pthread_mutex_lock(&mu_);
+                if (coin == focus_candle_coin_) {
+                    focus_candle_ = rec;
+                    focus_candle_new_ = true;
                 }
-                continue;
+                pthread_mutex_unlock(&mu_);
+                feed_stats().on_parsed(Feed::Candle, recv_us);
+                if (update_hook_) update_hook_();
+            }
+            return;
+        }
+        // Acks echo the subscription (which may contain "webData3"); nothing to cache.
+        static const char kSubAck[] = "\"channel\":\"subscriptionResponse\"";
+        if (std::search(data, head_end, kSubAck, kSubAck + sizeof(kSubAck) - 1) != head_end) {
+            return;
+        }
+        static const char kCtxChannel[] = "\"channel\":\"activeAssetCtx\"";
+        if (std::search(data, head_end, kCtxChannel, kCtxChannel + sizeof(kCtxChannel) - 1) != head_end) {
+            const char* dp = std::search(data, end, kDataKey, kDataKey + sizeof(kDataKey) - 1);
+            if (dp != end) dp = std::find(dp, end, '{');
+            tradeboy::model::PerpCtxUpdate u;
+            if (dp != end && parse_active_asset_ctx_json(dp, (size_t)(end - dp), u) && perp_ctx_queue_.push(u)) {
+                feed_stats().on_parsed(Feed::PerpCtx, recv_us);
+                if (update_hook_) update_hook_();
             }
+            return;
+        }
+    }
 
-            if (msg.find("\"channel\":\"post\"") != std::string::npos) {
-                if (!logged_post_seen) {
-                    logged_post_seen = true;
-                    log_str("[WS] post response seen\n");
-                }
-                unsigned int resp_id = 0;
-                if (parse_post_id(msg, resp_id)) {
-                    pthread_mutex_lock(&mu_);
-                    unsigned int expected = spot_request_sent_id_;
-                    pthread_mutex_unlock(&mu_);
-                    if (expected != 0 && resp_id == expected) {
-                        std::string data_obj = extract_object_after_key(msg, "response");
-                        if (data_obj.empty()) data_obj = extract_object_after_key(msg, "data");
-                        if (data_obj.empty()) data_obj = extract_data_object_if_wrapped(msg);
-                        if (data_obj.empty()) data_obj = msg;
-                        pthread_mutex_lock(&mu_);
-                        latest_spot_json_ = std::move(data_obj);
-                        latest_spot_ms_ = now_ms;
-                        pthread_mutex_unlock(&mu_);
-                        log_str("[WS] spot post cached\n");
-                    }
-                }
-                continue;
+    std::string msg((const char*)payload, n);
+    if (msg.find("\"mids\"") != std::string::npos) {
+        std::string data_obj = extract_data_object_if_wrapped(msg);
+        std::string mids_obj = extract_object_after_key(data_obj, "mids");
+        if (mids_obj.empty()) mids_obj = extract_object_after_key(msg, "mids");
+        if (!mids_obj.empty() && mids_obj.find("\":\"") != std::string::npos) {
+            pthread_mutex_lock(&mu_);
+            latest_mids_json_ = std::move(mids_obj);
+            latest_mids_ms_ = recv_ms;
+            log_every_++;
+            if ((log_every_ % 20) == 1) {
+                log_str("[WS] allMids mids cached\n");
             }
+            pthread_mutex_unlock(&mu_);
+            feed_stats().on_parsed(Feed::Mids, recv_us);
+            if (update_hook_) update_hook_();
+        }
+        return;
+    }
 
+    if (msg.find("\"webData3\"") != std::string::npos) {
+        std::string data_obj = extract_data_object_if_wrapped(msg);
+        if (!data_obj.empty()) {
+            pthread_mutex_lock(&mu_);
+            latest_user_json_ = std::move(data_obj);
+            latest_user_ms_ = recv_ms;
+            pthread_mutex_unlock(&mu_);
+            feed_stats().on_parsed(Feed::User, recv_us);
         }
+        return;
+    }
 
-        pclose2(p);
-        std::this_thread::sleep_for(std::chrono::milliseconds(reconnect_backoff_ms));
-        reconnect_backoff_ms = std::min(30000, reconnect_backoff_ms * 2);
+    if (msg.find("\"channel\":\"post\"") != std::string::npos) {
+        if (!logged_post_seen_) {
+            logged_post_seen_ = true;
+            log_str("[WS] post response seen\n");
+        }
+        unsigned int resp_id = 0;
+        if (parse_post_id(msg, resp_id)) {
+            pthread_mutex_lock(&mu_);
+            unsigned int expected = spot_request_sent_id_;
+            pthread_mutex_unlock(&mu_);
+            if (expected != 0 && resp_id == expected) {
+                std::string data_obj = extract_object_after_key(msg, "response");
+                if (data_obj.empty()) data_obj = extract_object_after_key(msg, "data");
+                if (data_obj.empty()) data_obj = extract_data_object_if_wrapped(msg);
+                if (data_obj.empty()) data_obj = msg;
+                pthread_mutex_lock(&mu_);
+                latest_spot_json_ = std::move(data_obj);
+                latest_spot_ms_ = recv_ms;
+                pthread_mutex_unlock(&mu_);
+                log_str("[WS] spot post cached\n");
+            }
+        }
+        return;
     }
 }
 
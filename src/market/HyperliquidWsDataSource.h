@@ -5,40 +5,85 @@
  * ARCHITECTURE CRITICAL - DO NOT MODIFY WITHOUT UNDERSTANDING:
  * 1. Uses pthread_mutex_t instead of std::mutex (RG34XX ABI compatibility)
  * 2. WebSocket via openssl s_client subprocess (no libwebsockets dependency)
- * 3. Background thread manages connection, reconnection, and data caching
+ * 3. Connection, reconnection and frame parsing run as callbacks on the
+ *    network reactor (nonblocking pipe + timers), never on a thread of their own
  * 4. Thread-safe getters return cached data to MarketDataService
  */
 #pragma once
 
 #include <atomic>
+#include <functional>
 #include <string>
-#include <thread>
+#include <vector>
 
 #include <pthread.h>
+#include <stdio.h>
+#include <sys/types.h>
 
+#include "core/Reactor.h"
 #include "IMarketDataSource.h"
+#include "WsSubscriptions.h"
 
 namespace tradeboy::market {
 
 struct HyperliquidWsDataSource : public IMarketDataSource {
-    HyperliquidWsDataSource();
+    explicit HyperliquidWsDataSource(tradeboy::core::Reactor& reactor);
     ~HyperliquidWsDataSource() override;
 
     bool fetch_all_mids_raw(std::string& out_json) override;
     void set_user_address(const std::string& user_address_0x) override;
+    std::string user_address() const override;
     bool fetch_user_webdata_raw(std::string& out_json) override;
-    bool fetch_spot_clearinghouse_state_raw(std::string& out_json) override;
-    bool fetch_perp_clearinghouse_state_raw(std::string& out_json) override;
+    void set_update_hook(const std::function<void()>& fn) override;
+    void set_focus_coin(const std::string& coin, const std::string& candle_coin) override;
+    bool fetch_l2_book(OrderBook& out, long long& io_book_ms) override;
+    size_t drain_trades(TradePrint* out, size_t cap) override;
+    bool fetch_focus_candle(std::string& out_coin, CandleRecord& out) override;
+    void set_perp_ctx_coins(const std::vector<std::string>& coins) override;
+    size_t drain_perp_ctxs(tradeboy::model::PerpCtxUpdate* out, size_t cap) override;
 
 private:
-    void run();
+    enum class ConnState {
+        Idle = 0,      // waiting for the reconnect timer
+        Handshake = 1, // upgrade sent, reading the HTTP response
+        Open = 2,
+    };
 
-    std::atomic<bool> stop_{false};
-    std::thread th_;
+    // Reactor thread only.
+    void connect();
+    // Closes the pipe and reaps openssl; reconnect arms the backoff timer.
+    void disconnect(bool reconnect);
+    void on_readable();
+    bool on_handshake_data(bool eof);
+    bool parse_frames();
+    bool handle_frame(unsigned char opcode, const unsigned char* payload, size_t n, long long recv_us, long long recv_ms);
+    void handle_text(const unsigned char* payload, size_t n, long long recv_us, long long recv_ms);
+    void send_ping();
+    void sync_subs();
+
+    tradeboy::core::Reactor& reactor_;
+
+    // Connection state; reactor thread only.
+    bool stopped_ = false;
+    ConnState state_ = ConnState::Idle;
+    pid_t child_ = -1;
+    FILE* child_in_ = nullptr; // to openssl stdin (unbuffered, blocking)
+    int child_out_ = -1;       // from openssl stdout (nonblocking, watched)
+    std::vector<unsigned char> rx_;
+    tradeboy::core::Reactor::TimerId reconnect_timer_ = 0;
+    tradeboy::core::Reactor::TimerId handshake_timer_ = 0;
+    tradeboy::core::Reactor::TimerId ping_timer_ = 0;
+    int reconnect_backoff_ms_ = 1000;
+    unsigned int log_every_ = 0;
+    bool logged_binary_frame_ = false;
+    bool logged_post_seen_ = false;
+    std::function<void()> update_hook_;
 
     mutable pthread_mutex_t mu_;
     std::string latest_mids_json_;
     long long latest_mids_ms_ = 0;
+    long long mids_taken_ms_ = 0; // latest_mids_ms_ last returned by fetch_all_mids_raw
+    bool mids_stale_ = false; // last reported staleness (see FeedStats)
 
     std::string latest_user_json_;
     long long latest_user_ms_ = 0;
@@ -52,7 +97,25 @@ private:
     long long spot_request_last_ms_ = 0;
     int spot_request_interval_ms_ = 3000;
 
-    std::atomic<bool> reconnect_requested_{false};
+    // Everything streamed is on demand; the reactor applies changes to the
+    // live socket and replays them after a reconnect.
+    WsSubscriptions subs_;
+
+    // focus_coin_ / l2_book_ / focus_candle_* are guarded by mu_. l2_scratch_
+    // is only touched on the reactor: frames are parsed there, then copied
+    // in under the lock.
+    std::string focus_coin_;
+    std::string focus_candle_coin_;
+    OrderBook l2_book_;
+    long long l2_book_ms_ = 0;
+    OrderBook l2_scratch_;
+    CandleRecord focus_candle_;
+    bool focus_candle_new_ = false;
+
+    // Lock-free: the reactor produces, drain_trades() consumes.
+    TradeTape trade_tape_;
+
+    PerpCtxQueue perp_ctx_queue_;
 };
 
 } // namespace tradeboy::market
@@ -1,19 +1,51 @@
 #pragma once
 
+#include <functional>
 #include <string>
+#include <vector>
 
+#include "CandleStore.h"
 #include "Hyperliquid.h"
+#include "OrderBook.h"
+#include "PerpFeed.h"
+#include "TradeTape.h"
 
 namespace tradeboy::market {
 
+// MarketDataService calls the fetch/drain methods on the network reactor
+// thread, so they must only read what the source already has cached.
 struct IMarketDataSource {
     virtual ~IMarketDataSource() = default;
 
+    // Latest allMids object; false when there is nothing newer than the last
+    // call (streamed sources hand each update out once).
     virtual bool fetch_all_mids_raw(std::string& out_json) = 0;
     virtual void set_user_address(const std::string& /*user_address_0x*/) {}
+    // Wallet the user feeds are for (empty = none). The service polls its
+    // clearinghouse state over /info itself.
+    virtual std::string user_address() const { return std::string(); }
     virtual bool fetch_user_webdata_raw(std::string& /*out_json*/) { return false; }
-    virtual bool fetch_spot_clearinghouse_state_raw(std::string& /*out_json*/) { return false; }
-    virtual bool fetch_perp_clearinghouse_state_raw(std::string& /*out_json*/) { return false; }
+
+    // Called on the reactor thread whenever something the drain methods
+    // below return was queued, so the consumer needs no polling loop.
+    virtual void set_update_hook(const std::function<void()>& /*fn*/) {}
+
+    // Live l2Book, trades and 1m candles for the coin on screen; empty coin
+    // unsubscribes. candle_coin is the candleSnapshot key when it differs
+    // from the book key (empty = same).
+    virtual void set_focus_coin(const std::string& /*coin*/, const std::string& /*candle_coin*/) {}
+    // True while the focused book is live. out is only copied into when the
+    // book is newer than io_book_ms (its receive time), which is then updated.
+    virtual bool fetch_l2_book(OrderBook& /*out*/, long long& /*io_book_ms*/) { return false; }
+    // Pops queued prints for the focused coin. Single consumer only.
+    virtual size_t drain_trades(TradePrint* /*out*/, size_t /*cap*/) { return 0; }
+    // Latest streamed 1m candle of the focused coin; true once per update.
+    virtual bool fetch_focus_candle(std::string& /*out_coin*/, CandleRecord& /*out*/) { return false; }
+
+    // Live activeAssetCtx for the perps on screen (replaces the previous set).
+    virtual void set_perp_ctx_coins(const std::vector<std::string>& /*coins*/) {}
+    // Pops queued perp context updates. Single consumer only.
+    virtual size_t drain_perp_ctxs(tradeboy::model::PerpCtxUpdate* /*out*/, size_t /*cap*/) { return 0; }
 };
 
 } // namespace tradeboy::market
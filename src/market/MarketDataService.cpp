@@ -3,22 +3,23 @@
 #include <algorithm>
 #include <chrono>
 #include <cstdio>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include "../../third_party/picojson/picojson.h"
 
+#include "../model/StateCache.h"
 #include "../model/TradeModel.h"
+#include "CandleStore.h"
+#include "FeedStats.h"
 #include "Hyperliquid.h"
+#include "PerpFeed.h"
+#include "PortfolioHistory.h"
 #include "utils/Log.h"
 
 namespace tradeboy::market {
 
-struct HistoryPoint {
-    long long ts_ms = 0;
-    double v = 0.0;
-};
-
 static bool pj_get_number_like(const picojson::value& v, double& out_num, std::string& out_str) {
     out_str.clear();
     if (v.is<double>()) {
@@ -373,6 +374,7 @@ static bool build_spot_rows_from_spot_meta_and_ctxs(const std::string& spot_meta
         std::string display_sym;
         std::string display_full;
         int fallback_decimals = 2;
+        int sz_decimals = 0;
         {
             const picojson::value* tv = pj_find(*pair, "tokens");
             const picojson::array* toks = tv ? pj_get_arr(*tv) : nullptr;
@@ -387,7 +389,10 @@ static bool build_spot_rows_from_spot_meta_and_ctxs(const std::string& spot_meta
                         const picojson::value* tfull = pj_find(*tok, "fullName");
                         if (tfull) (void)pj_get_string_like(*tfull, display_full);
                         const picojson::value* sdv = pj_find(*tok, "szDecimals");
-                        if (sdv && sdv->is<double>()) fallback_decimals = std::max(0, (int)sdv->get<double>());
+                        if (sdv && sdv->is<double>()) {
+                            sz_decimals = std::max(0, (int)sdv->get<double>());
+                            fallback_decimals = sz_decimals;
+                        }
                     }
                 }
             }
@@ -403,6 +408,8 @@ static bool build_spot_rows_from_spot_meta_and_ctxs(const std::string& spot_meta
 
         tradeboy::model::SpotRow r(price_key, display_sym, 0.0, 0.0, 0.0, 0.0);
         r.price_decimals = fallback_decimals;
+        r.asset_id = 10000 + index;
+        r.sz_decimals = sz_decimals;
 
         // assetCtxs coin key can be one of:
         // - BASE (e.g. BTC)
@@ -487,131 +494,59 @@ static bool parse_spot_balances_by_coin(const std::string& spot_state_json, std:
     return true;
 }
 
-static bool pj_parse_portfolio_root_obj(const std::string& s, picojson::object& out_obj) {
-    out_obj.clear();
-    picojson::value root;
-    std::string err = picojson::parse(root, s);
-    if (!err.empty()) return false;
-
-    if (root.is<picojson::object>()) {
-        out_obj = root.get<picojson::object>();
-        return true;
+// Carries balances (and a price where the context had none) from rows
+// restored at startup onto freshly built rows of the same coin.
+static void reconcile_warm_rows(const std::vector<tradeboy::model::SpotRow>& warm,
+                                std::vector<tradeboy::model::SpotRow>& rows) {
+    if (warm.empty()) return;
+    std::unordered_map<std::string, const tradeboy::model::SpotRow*> by_coin;
+    by_coin.reserve(warm.size());
+    for (const auto& r : warm) by_coin[r.coin] = &r;
+    for (auto& r : rows) {
+        auto it = by_coin.find(r.coin);
+        if (it == by_coin.end()) continue;
+        r.balance = it->second->balance;
+        r.entry_price = it->second->entry_price;
+        if (!(r.price > 0.0)) r.price = it->second->price;
     }
-    if (root.is<picojson::array>()) {
-        const picojson::array& a = root.get<picojson::array>();
-        // Observed schemas:
-        // - ["day", { ... }]
-        // - [["day", { ... }], ...]
-        if (!a.empty() && a[0].is<picojson::array>()) {
-            const picojson::array& row = a[0].get<picojson::array>();
-            if (row.size() >= 2 && row[1].is<picojson::object>()) {
-                out_obj = row[1].get<picojson::object>();
-                return true;
-            }
-        }
-        if (a.size() >= 2 && a[1].is<picojson::object>()) {
-            out_obj = a[1].get<picojson::object>();
-            return true;
-        }
-    }
-    return false;
 }
 
-static bool pj_parse_history_points_from_obj(const picojson::object& obj, const char* key, std::vector<HistoryPoint>& out) {
-    out.clear();
-    const picojson::value* hv = pj_find(obj, key);
-    if (!hv) return false;
-    const picojson::array* arr = pj_get_arr(*hv);
-    if (!arr) return false;
-
-    for (size_t i = 0; i < arr->size(); i++) {
-        const picojson::array* row = pj_get_arr((*arr)[i]);
-        if (!row || row->size() < 2) continue;
-
-        long long ts = 0;
-        if ((*row)[0].is<double>()) ts = (long long)(*row)[0].get<double>();
-        else if ((*row)[0].is<std::string>()) ts = std::strtoll((*row)[0].get<std::string>().c_str(), nullptr, 10);
-        else continue;
-
-        double num = 0.0;
-        std::string str;
-        if (!pj_get_number_like((*row)[1], num, str)) continue;
-
-        HistoryPoint hp;
-        hp.ts_ms = ts;
-        hp.v = num;
-        out.push_back(hp);
-    }
-
-    return !out.empty();
-}
-
-static bool parse_history_points(const std::string& s, const char* key, std::vector<HistoryPoint>& out) {
-    out.clear();
-    picojson::object obj;
-    if (!pj_parse_portfolio_root_obj(s, obj)) return false;
-    return pj_parse_history_points_from_obj(obj, key, out);
-}
-
-static bool compute_24h_pnl_from_history(const std::vector<HistoryPoint>& pts,
-                                        long long now_ms,
-                                        double& out_pnl) {
-    out_pnl = 0.0;
-    if (pts.size() < 2) return false;
-
-    const long long day_ms = 24LL * 60LL * 60LL * 1000LL;
-    const long long target = now_ms - day_ms;
-    const HistoryPoint& last = pts.back();
-
-    // Find latest point at or before target.
-    long long best_ts = -1;
-    double best_v = pts.front().v;
-    for (size_t i = 0; i < pts.size(); i++) {
-        if (pts[i].ts_ms <= target && pts[i].ts_ms > best_ts) {
-            best_ts = pts[i].ts_ms;
-            best_v = pts[i].v;
-        }
-    }
-
-    out_pnl = last.v - best_v;
-    return true;
-}
-
-static bool parse_account_value_str(const std::string& s, std::string& out) {
-    out.clear();
-    picojson::object obj;
-    if (!pj_parse_portfolio_root_obj(s, obj)) return false;
-
-    const char* keys[] = {"accountValue", "totalValue", "equity", "totalEquity"};
-    for (size_t i = 0; i < sizeof(keys) / sizeof(keys[0]); i++) {
-        const picojson::value* v = pj_find(obj, keys[i]);
-        if (!v) continue;
-        double num = 0.0;
-        std::string str;
-        if (pj_get_number_like(*v, num, str) && !str.empty()) {
-            out = str;
-            return true;
-        }
-    }
-
-    const picojson::value* hv = pj_find(obj, "accountValueHistory");
-    if (!hv) return false;
-    const picojson::array* h = pj_get_arr(*hv);
-    if (!h || h->empty()) return false;
-
-    // History format: [[ts,"val"], ...]
-    for (size_t i = h->size(); i > 0; i--) {
-        const picojson::array* row = pj_get_arr((*h)[i - 1]);
-        if (!row || row->size() < 2) continue;
-        double num = 0.0;
-        std::string str;
-        if (pj_get_number_like((*row)[1], num, str) && !str.empty()) {
-            out = str;
-            return true;
-        }
-    }
-
-    return false;
+// Publishes the last polled portfolio marked to the current mids: spot
+// holdings held at the poll are revalued, everything else is as polled.
+static void publish_portfolio(tradeboy::model::TradeModel& model,
+                              PortfolioHistory& hist,
+                              const std::vector<tradeboy::model::SpotRow>& rows,
+                              long long now_ms) {
+    double account_value = 0.0;
+    if (!hist.latest_account_value(account_value)) return;
+    hist.advance(now_ms);
+
+    const double drift = hist.mark_drift(rows);
+    const double total_asset = account_value + drift;
+    double pnl24 = 0.0;
+    double pnl7d = 0.0;
+    double pnl30d = 0.0;
+    const bool ok24 = hist.window_delta(PnlWindow::H24, pnl24);
+    const bool ok7d = hist.window_delta(PnlWindow::D7, pnl7d);
+    const bool ok30d = hist.window_delta(PnlWindow::D30, pnl30d);
+    if (ok24) pnl24 += drift;
+    if (ok7d) pnl7d += drift;
+    if (ok30d) pnl30d += drift;
+    const double pct = (ok24 && total_asset != 0.0) ? (pnl24 / total_asset) * 100.0 : 0.0;
+
+    char total_buf[64];
+    char pnl_buf[64];
+    char pct_buf[64];
+    std::snprintf(total_buf, sizeof(total_buf), "$%.2f", total_asset);
+    std::snprintf(pnl_buf, sizeof(pnl_buf), "%+.6f", pnl24);
+    std::snprintf(pct_buf, sizeof(pct_buf), "(%+.4f%%)", pct);
+    model.set_hl_portfolio(total_asset, total_buf, pnl24, pnl_buf, pct, pct_buf, ok24);
+
+    char buf_7d[64];
+    char buf_30d[64];
+    std::snprintf(buf_7d, sizeof(buf_7d), "%+.2f", pnl7d);
+    std::snprintf(buf_30d, sizeof(buf_30d), "%+.2f", pnl30d);
+    model.set_hl_pnl_windows(pnl7d, ok7d ? buf_7d : "UNKNOWN", pnl30d, ok30d ? buf_30d : "UNKNOWN");
 }
 
 static void log_portfolio_prefix_once(const std::string& s) {
@@ -655,251 +590,402 @@ static bool parse_perp_usdc_balance_any(const std::string& json, double& out_usd
     return tradeboy::market::parse_perp_usdc_balance(win, out_usdc);
 }
 
-MarketDataService::MarketDataService(tradeboy::model::TradeModel& model, IMarketDataSource& src)
-    : model(model), src(src) {}
+static long long wall_ms() {
+    return (long long)std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+static int next_backoff_ms(int backoff_ms) {
+    return (backoff_ms == 0) ? 5000 : std::min(30000, backoff_ms * 2);
+}
+
+MarketDataService::MarketDataService(tradeboy::model::TradeModel& model, IMarketDataSource& src, tradeboy::core::Reactor& reactor)
+    : model(model), src(src), reactor_(reactor) {
+}
 
 MarketDataService::~MarketDataService() {
     log_str("[Market] ~MarketDataService()\n");
     stop();
 }
 
+void MarketDataService::request_candle_history(const std::string& coin) {
+    reactor_.post([this, coin]() {
+        if (!running_) return;
+        candle_req_coin_ = coin;
+        if (!candles_.proc) poll_candles();
+    });
+}
+
 void MarketDataService::start() {
-    if (th.joinable()) return;
-    stop_flag = false;
-    th = std::thread([this]() {
-        try {
-            log_str("[Market] thread start\n");
-            run();
-            log_str("[Market] thread exit\n");
-        } catch (...) {
-            log_str("[Market] thread crashed (exception)\n");
-        }
+    reactor_.run_sync([this]() {
+        if (running_) return;
+        running_ = true;
+        log_str("[Market] start\n");
+
+        // A restart (after a transfer) begins from scratch, like a fresh run.
+        const std::string keep_candle = candle_req_coin_;
+        perp_meta_ = Poll();
+        spot_meta_ = Poll();
+        user_ = Poll();
+        perp_ = Poll();
+        portfolio_ = Poll();
+        candles_ = Poll();
+        housekeeping_ = Poll();
+        drain_ = Poll();
+        spot_rows_initialized_ = false;
+        spot_meta_done_ = false;
+        perp_meta_done_ = false;
+        logged_user_dump_ = false;
+        logged_user_fail_ = false;
+        logged_perp_dump_ = false;
+        logged_perp_fail_ = false;
+        logged_portfolio_once_ = false;
+        portfolio_failed_once_ = false;
+        last_feed_report_ms_ = wall_ms();
+        last_state_save_ms_ = 0;
+        candle_req_coin_ = keep_candle;
+
+        // Streamed updates arrive in bursts; one drain per 50 ms is plenty.
+        src.set_update_hook([this]() {
+            if (running_ && !drain_.timer) arm(drain_, 50, &MarketDataService::drain_streams);
+        });
+
+        arm(housekeeping_, 0, &MarketDataService::housekeeping);
+        arm(perp_meta_, 0, &MarketDataService::poll_perp_meta);
+        arm(spot_meta_, 0, &MarketDataService::poll_spot_meta);
+        arm(user_, 0, &MarketDataService::poll_user);
+        arm(perp_, 0, &MarketDataService::poll_perp);
+        arm(portfolio_, 0, &MarketDataService::poll_portfolio);
+        if (!candle_req_coin_.empty()) poll_candles();
     });
 }
 
 void MarketDataService::stop() {
     log_str("[Market] stop() called\n");
-    stop_flag = true;
-    if (th.joinable()) th.join();
-}
-
-void MarketDataService::run() {
-    log_str("[Market] run() enter\n");
-    std::string mids_json;
-    std::string user_json;
-    std::string perp_json;
-    std::string portfolio_json;
-    std::string perp_meta_json;
-    std::string spot_meta_json;
-    bool spot_rows_initialized = false;
-    bool logged_user_dump = false;
-    long long last_mids_ms = 0;
-    int mids_backoff_ms = 0;
-    long long last_user_ms = 0;
-    int user_backoff_ms = 0;
-    long long last_perp_ms = 0;
-    int perp_backoff_ms = 0;
-    long long last_portfolio_ms = 0;
-    long long last_heartbeat_ms = 0;
-    bool logged_user_fail = false;
-    bool logged_perp_dump = false;
-    bool logged_perp_fail = false;
-    bool logged_portfolio_once = false;
-    bool portfolio_failed_once = false;
-    bool perp_meta_done = false;
-    bool spot_meta_done = false;
-
-    while (!stop_flag.load()) {
-        long long now_ms = (long long)std::chrono::duration_cast<std::chrono::milliseconds>(
-                              std::chrono::system_clock::now().time_since_epoch())
-                              .count();
-
-        if (last_heartbeat_ms == 0 || (now_ms - last_heartbeat_ms) > 5000) {
-            log_str("[Market] heartbeat\n");
-            last_heartbeat_ms = now_ms;
+    reactor_.run_sync([this]() {
+        if (!running_) return;
+        running_ = false;
+        src.set_update_hook(std::function<void()>());
+        cancel(perp_meta_);
+        cancel(spot_meta_);
+        cancel(user_);
+        cancel(perp_);
+        cancel(portfolio_);
+        cancel(candles_);
+        cancel(housekeeping_);
+        cancel(drain_);
+    });
+}
+
+void MarketDataService::arm(Poll& p, int delay_ms, PollFn fn) {
+    if (!running_) return;
+    reactor_.cancel_timer(p.timer);
+    p.timer = reactor_.add_timer(delay_ms, [this, &p, fn]() {
+        p.timer = 0;
+        (this->*fn)();
+    });
+}
+
+void MarketDataService::arm_after(Poll& p, int interval_ms, PollFn fn) {
+    const long long elapsed = wall_ms() - p.started_ms;
+    arm(p, (int)std::max(0LL, (long long)interval_ms - elapsed), fn);
+}
+
+bool MarketDataService::fetch(Poll& p, const std::string& req, ReplyFn done) {
+    p.proc = fetch_info_async(reactor_, req, [this, &p, done](bool ok, std::string& resp) {
+        p.proc = 0;
+        (this->*done)(ok, resp);
+    });
+    return p.proc != 0;
+}
+
+void MarketDataService::cancel(Poll& p) {
+    reactor_.cancel_timer(p.timer);
+    reactor_.cancel_spawn(p.proc);
+    p.timer = 0;
+    p.proc = 0;
+}
+
+void MarketDataService::housekeeping() {
+    const long long now_ms = wall_ms();
+    log_str("[Market] heartbeat\n");
+    if (now_ms - last_feed_report_ms_ > 30000) {
+        feed_stats().log_report();
+        last_feed_report_ms_ = now_ms;
+    }
+
+    // Periodic warm-start snapshot (also written on clean exit), only once
+    // live rows have replaced whatever the cache restored.
+    if (spot_rows_initialized_ && now_ms - last_state_save_ms_ > 60000) {
+        std::string err;
+        if (!tradeboy::model::save_state_cache(model, tradeboy::model::kStateCachePath, err)) {
+            log_str((std::string("[Market] state cache save failed: ") + err + "\n").c_str());
         }
+        last_state_save_ms_ = now_ms;
+    }
 
-        if (!perp_meta_done) {
-            const std::string req = std::string("{\"type\":\"allPerpMetas\"}\n");
-            if (tradeboy::market::fetch_info_raw(req, perp_meta_json)) {
-                model.set_hl_perp_meta_json(perp_meta_json, true);
-                perp_meta_done = true;
-                log_str("[HL] allPerpMetas cached\n");
-            }
+    // Sources without an update hook still get drained.
+    drain_streams();
+    arm(housekeeping_, 5000, &MarketDataService::housekeeping);
+}
+
+void MarketDataService::drain_streams() {
+    apply_mids();
+
+    {
+        tradeboy::model::PerpCtxUpdate batch[64];
+        size_t n = 0;
+        size_t applied = 0;
+        while ((n = src.drain_perp_ctxs(batch, sizeof(batch) / sizeof(batch[0]))) > 0) {
+            applied += model.apply_perp_ctx_updates(batch, n);
+        }
+        if (applied > 0) {
+            model.sort_perp_rows();
+            feed_stats().on_published(Feed::PerpCtx);
         }
+    }
 
-        if (!spot_meta_done) {
-            const std::string req = std::string("{\"type\":\"spotMetaAndAssetCtxs\"}\n");
-            if (tradeboy::market::fetch_info_raw(req, spot_meta_json)) {
-                model.set_hl_spot_meta_json(spot_meta_json, true);
-                spot_meta_done = true;
-                log_str("[HL] spotMetaAndAssetCtxs cached\n");
-            }
+    {
+        std::string candle_coin;
+        CandleRecord rec;
+        if (src.fetch_focus_candle(candle_coin, rec)) {
+            tradeboy::model::Candle c;
+            c.t_ms = rec.t_ms;
+            c.o = (float)rec.o;
+            c.h = (float)rec.h;
+            c.l = (float)rec.l;
+            c.c = (float)rec.c;
+            model.merge_candle(candle_coin, tradeboy::model::CandleRes::M1, c);
+            feed_stats().on_published(Feed::Candle);
         }
+    }
+}
 
-        if (spot_meta_done && !spot_rows_initialized) {
-            std::vector<tradeboy::model::SpotRow> rows;
-            if (build_spot_rows_from_spot_meta_and_ctxs(spot_meta_json, rows)) {
-                int btc_idx = -1;
-                for (size_t i = 0; i < rows.size(); i++) {
-                    if (rows[i].sym == "BTC") {
-                        btc_idx = (int)i;
-                        break;
-                    }
-                }
-                model.set_spot_rows(std::move(rows));
-                if (btc_idx >= 0) model.set_spot_row_idx(btc_idx);
-                spot_rows_initialized = true;
-                log_str("[Model] spot_rows initialized from spotMetaAndAssetCtxs\n");
-            }
+// Perp universe + contexts; refreshed slowly for markets that are not on
+// screen (only those stream activeAssetCtx).
+void MarketDataService::poll_perp_meta() {
+    perp_meta_.started_ms = wall_ms();
+    if (!fetch(perp_meta_, "{\"type\":\"metaAndAssetCtxs\"}\n", &MarketDataService::on_perp_meta)) {
+        arm_after(perp_meta_, 5000, &MarketDataService::poll_perp_meta);
+    }
+}
+
+void MarketDataService::on_perp_meta(bool ok, std::string& resp) {
+    std::vector<tradeboy::model::PerpMarketMeta> metas;
+    std::vector<tradeboy::model::PerpAssetCtx> ctxs;
+    if (ok && parse_perp_meta_and_ctxs_json(resp.data(), resp.size(), metas, ctxs)) {
+        model.set_perp_markets(metas, ctxs);
+        if (!perp_meta_done_) {
+            char buf[96];
+            std::snprintf(buf, sizeof(buf), "[HL] metaAndAssetCtxs perps=%u\n", (unsigned)metas.size());
+            log_str(buf);
         }
+        perp_meta_done_ = true;
+    }
+    arm_after(perp_meta_, perp_meta_done_ ? 60000 : 5000, &MarketDataService::poll_perp_meta);
+}
 
-        const int mids_interval_ms = (mids_backoff_ms > 0) ? mids_backoff_ms : 2500;
-        if (now_ms - last_mids_ms > mids_interval_ms) {
-            if (src.fetch_all_mids_raw(mids_json)) {
-                model.update_mid_prices_from_allmids_json(mids_json);
-                model.sort_spot_rows();
-                mids_backoff_ms = 0;
-            } else {
-                mids_backoff_ms = (mids_backoff_ms == 0) ? 5000 : std::min(30000, mids_backoff_ms * 2);
-                log_str("[Market] allMids fetch failed\n");
-            }
-            last_mids_ms = now_ms;
+void MarketDataService::poll_spot_meta() {
+    spot_meta_.started_ms = wall_ms();
+    if (!fetch(spot_meta_, "{\"type\":\"spotMetaAndAssetCtxs\"}\n", &MarketDataService::on_spot_meta)) {
+        arm_after(spot_meta_, 2000, &MarketDataService::poll_spot_meta);
+    }
+}
+
+void MarketDataService::on_spot_meta(bool ok, std::string& resp) {
+    if (!ok) {
+        arm_after(spot_meta_, 2000, &MarketDataService::poll_spot_meta);
+        return;
+    }
+    spot_meta_json_.swap(resp);
+    model.set_hl_spot_meta_json(spot_meta_json_, true);
+    spot_meta_done_ = true;
+    log_str("[HL] spotMetaAndAssetCtxs cached\n");
+
+    if (spot_rows_initialized_) return;
+    std::vector<tradeboy::model::SpotRow> rows;
+    if (!build_spot_rows_from_spot_meta_and_ctxs(spot_meta_json_, rows)) {
+        // Try a fresh copy rather than rebuilding from the same bad one.
+        spot_meta_done_ = false;
+        arm_after(spot_meta_, 5000, &MarketDataService::poll_spot_meta);
+        return;
+    }
+    // Rows restored from the state cache keep their balances until the first
+    // user poll, and the selection stays on the same coin.
+    const tradeboy::model::TradeModelSnapshot warm = model.snapshot();
+    std::string sel_coin;
+    if (warm.spot_row_idx >= 0 && warm.spot_row_idx < (int)warm.spot_rows.size()) {
+        sel_coin = warm.spot_rows[(size_t)warm.spot_row_idx].coin;
+    }
+    reconcile_warm_rows(warm.spot_rows, rows);
+    int sel_idx = -1;
+    for (size_t i = 0; i < rows.size(); i++) {
+        if (sel_coin.empty() ? (rows[i].sym == "BTC") : (rows[i].coin == sel_coin)) {
+            sel_idx = (int)i;
+            break;
         }
+    }
+    model.set_spot_rows(std::move(rows));
+    if (sel_idx >= 0) model.set_spot_row_idx(sel_idx);
+    spot_rows_initialized_ = true;
+    log_str("[Model] spot_rows initialized from spotMetaAndAssetCtxs\n");
+}
 
-        const int user_interval_ms = (user_backoff_ms > 0) ? user_backoff_ms : 2000;
-        if (now_ms - last_user_ms > user_interval_ms) {
-            if (src.fetch_spot_clearinghouse_state_raw(user_json)) {
-                if (!logged_user_dump) {
-                    logged_user_dump = true;
-                    log_str("[Market] spotClearinghouseState raw received\n");
-                }
-                double usdc = 0.0;
-                if (parse_spot_usdc_balance_any(user_json, usdc)) {
-                    char buf[64];
-                    std::snprintf(buf, sizeof(buf), "%.2f", usdc);
-                    model.set_hl_usdc(usdc, buf, true);
-
-                    std::unordered_map<std::string, double> balances;
-                    if (parse_spot_balances_by_coin(user_json, balances)) {
-                        model.update_spot_balances(balances);
-                        model.sort_spot_rows();
-                    }
-                    user_backoff_ms = 0;
-                    logged_user_fail = false;
-                } else {
-                    if (!logged_user_fail) {
-                        logged_user_fail = true;
-                        log_str("[Market] spotClearinghouseState parse failed\n");
-                    }
-                    user_backoff_ms = (user_backoff_ms == 0) ? 5000 : std::min(30000, user_backoff_ms * 2);
-                }
-            } else {
-                user_backoff_ms = (user_backoff_ms == 0) ? 5000 : std::min(30000, user_backoff_ms * 2);
-            }
-            last_user_ms = now_ms;
+void MarketDataService::poll_candles() {
+    std::string coin;
+    coin.swap(candle_req_coin_);
+    if (coin.empty()) return;
+    std::string err;
+    if (!begin_candle_history(model, coin, tradeboy::model::CandleRes::M1, wall_ms(), candle_job_, err)) {
+        log_str((std::string("[HL] candle history failed: ") + err + "\n").c_str());
+    } else if (!candle_job_.req.empty() && fetch(candles_, candle_job_.req, &MarketDataService::on_candles)) {
+        return;
+    }
+    // A newer request may have come in meanwhile.
+    if (!candle_req_coin_.empty()) poll_candles();
+}
+
+void MarketDataService::on_candles(bool ok, std::string& resp) {
+    std::string err = "candle_fetch_failed";
+    if (!ok || !finish_candle_history(model, candle_job_, resp, err)) {
+        log_str((std::string("[HL] candle history failed: ") + err + "\n").c_str());
+    }
+    if (!candle_req_coin_.empty()) poll_candles();
+}
+
+// Streamed mids are applied as they arrive (see drain_streams), not on a timer.
+void MarketDataService::apply_mids() {
+    const long long now_ms = wall_ms();
+    if (src.fetch_all_mids_raw(mids_json_)) {
+        model.update_mid_prices_from_allmids_json(mids_json_);
+        feed_stats().on_published(Feed::Mids);
+        model.sort_spot_rows();
+        // Mark the last polled portfolio to the fresh mids.
+        if (portfolio_hist_.account_value.count() > 0) {
+            publish_portfolio(model, portfolio_hist_, model.snapshot().spot_rows, now_ms);
         }
+    }
+}
 
-        const int perp_interval_ms = (perp_backoff_ms > 0) ? perp_backoff_ms : 3000;
-        if (now_ms - last_perp_ms > perp_interval_ms) {
-            if (src.fetch_perp_clearinghouse_state_raw(perp_json)) {
-                if (!logged_perp_dump) {
-                    logged_perp_dump = true;
-                    log_str("[Market] clearinghouseState raw received\n");
-                }
-                double usdc = 0.0;
-                if (parse_perp_usdc_balance_any(perp_json, usdc)) {
-                    char buf[64];
-                    std::snprintf(buf, sizeof(buf), "%.2f", usdc);
-                    model.set_hl_perp_usdc(usdc, buf, true);
-                    perp_backoff_ms = 0;
-                    logged_perp_fail = false;
-                } else {
-                    if (!logged_perp_fail) {
-                        logged_perp_fail = true;
-                        log_str("[Market] clearinghouseState parse failed\n");
-                    }
-                    perp_backoff_ms = (perp_backoff_ms == 0) ? 5000 : std::min(30000, perp_backoff_ms * 2);
-                }
-            } else {
-                perp_backoff_ms = (perp_backoff_ms == 0) ? 5000 : std::min(30000, perp_backoff_ms * 2);
+void MarketDataService::poll_user() {
+    user_.started_ms = wall_ms();
+    const std::string addr = src.user_address();
+    if (addr.empty() || !fetch(user_, spot_clearinghouse_state_request(addr), &MarketDataService::on_user)) {
+        user_.backoff_ms = next_backoff_ms(user_.backoff_ms);
+        arm_after(user_, user_.backoff_ms, &MarketDataService::poll_user);
+    }
+}
+
+void MarketDataService::on_user(bool ok, std::string& user_json) {
+    if (ok) {
+        if (!logged_user_dump_) {
+            logged_user_dump_ = true;
+            log_str("[Market] spotClearinghouseState raw received\n");
+        }
+        double usdc = 0.0;
+        if (parse_spot_usdc_balance_any(user_json, usdc)) {
+            char buf[64];
+            std::snprintf(buf, sizeof(buf), "%.2f", usdc);
+            model.set_hl_usdc(usdc, buf, true);
+
+            std::unordered_map<std::string, double> balances;
+            if (parse_spot_balances_by_coin(user_json, balances)) {
+                model.update_spot_balances(balances);
+                model.sort_spot_rows();
+            }
+            user_.backoff_ms = 0;
+            logged_user_fail_ = false;
+        } else {
+            if (!logged_user_fail_) {
+                logged_user_fail_ = true;
+                log_str("[Market] spotClearinghouseState parse failed\n");
             }
-            last_perp_ms = now_ms;
+            user_.backoff_ms = next_backoff_ms(user_.backoff_ms);
         }
+    } else {
+        user_.backoff_ms = next_backoff_ms(user_.backoff_ms);
+    }
+    arm_after(user_, (user_.backoff_ms > 0) ? user_.backoff_ms : 2000, &MarketDataService::poll_user);
+}
 
-        // Minimal portfolio logging: only log TOTAL_ASSET_VALUE once (or every 30s if it succeeds).
-        const int portfolio_interval_ms = (logged_portfolio_once || portfolio_failed_once) ? 30000 : 5000;
-        if (now_ms - last_portfolio_ms > portfolio_interval_ms) {
-            tradeboy::model::WalletSnapshot w = model.wallet_snapshot();
-            if (!w.wallet_address.empty()) {
-                std::string req = std::string("{\"type\":\"portfolio\",\"user\":\"") + w.wallet_address + "\"}\n";
-                if (tradeboy::market::fetch_info_raw(req, portfolio_json)) {
-                    std::string v;
-                    if (parse_account_value_str(portfolio_json, v)) {
-                        std::string line = std::string("[HL] TOTAL_ASSET_VALUE=") + v + "\n";
-                        log_str(line.c_str());
-
-                        double total_asset = std::strtod(v.c_str(), nullptr);
-                        double pnl24 = 0.0;
-                        double pct = 0.0;
-                        bool ok = true;
-
-                        // 24H_PNL_FLUX from pnlHistory
-                        std::vector<HistoryPoint> pnl_pts;
-                        if (parse_history_points(portfolio_json, "pnlHistory", pnl_pts)) {
-                            if (compute_24h_pnl_from_history(pnl_pts, now_ms, pnl24)) {
-                                char buf[96];
-                                std::snprintf(buf, sizeof(buf), "[HL] 24H_PNL_FLUX=%+.6f\n", pnl24);
-                                log_str(buf);
-
-                                if (total_asset != 0.0) {
-                                    pct = (pnl24 / total_asset) * 100.0;
-                                    char buf2[96];
-                                    std::snprintf(buf2, sizeof(buf2), "[HL] 24H_PNL_FLUX_PCT=%+.4f%%\n", pct);
-                                    log_str(buf2);
-                                }
-                            } else {
-                                log_str("[HL] 24H_PNL_FLUX compute failed\n");
-                                ok = false;
-                            }
-                        } else {
-                            log_str("[HL] pnlHistory parse failed\n");
-                            ok = false;
-                        }
-
-                        {
-                            char total_buf[64];
-                            char pnl_buf[64];
-                            char pct_buf[64];
-                            std::snprintf(total_buf, sizeof(total_buf), "$%.2f", total_asset);
-                            std::snprintf(pnl_buf, sizeof(pnl_buf), "%+.6f", pnl24);
-                            std::snprintf(pct_buf, sizeof(pct_buf), "(%+.4f%%)", pct);
-                            model.set_hl_portfolio(total_asset,
-                                                   total_buf,
-                                                   pnl24,
-                                                   pnl_buf,
-                                                   pct,
-                                                   pct_buf,
-                                                   ok);
-                            log_str("[Model] hl_portfolio updated\n");
-                        }
+void MarketDataService::poll_perp() {
+    perp_.started_ms = wall_ms();
+    const std::string addr = src.user_address();
+    if (addr.empty() || !fetch(perp_, perp_clearinghouse_state_request(addr), &MarketDataService::on_perp)) {
+        perp_.backoff_ms = next_backoff_ms(perp_.backoff_ms);
+        arm_after(perp_, perp_.backoff_ms, &MarketDataService::poll_perp);
+    }
+}
 
-                        logged_portfolio_once = true;
-                    } else {
-                        log_str("[HL] TOTAL_ASSET_VALUE parse failed\n");
-                        log_portfolio_prefix_once(portfolio_json);
-                        portfolio_failed_once = true;
-                    }
-                } else {
-                    log_str("[HL] portfolio fetch failed\n");
-                    portfolio_failed_once = true;
-                }
+void MarketDataService::on_perp(bool ok, std::string& perp_json) {
+    if (ok) {
+        if (!logged_perp_dump_) {
+            logged_perp_dump_ = true;
+            log_str("[Market] clearinghouseState raw received\n");
+        }
+        tradeboy::model::PerpAccountState perp_state;
+        if (parse_clearinghouse_state_json(perp_json.data(), perp_json.size(), perp_state)) {
+            model.set_perp_account_state(perp_state);
+        }
+        double usdc = 0.0;
+        if (parse_perp_usdc_balance_any(perp_json, usdc)) {
+            char buf[64];
+            std::snprintf(buf, sizeof(buf), "%.2f", usdc);
+            model.set_hl_perp_usdc(usdc, buf, true);
+            perp_.backoff_ms = 0;
+            logged_perp_fail_ = false;
+        } else {
+            if (!logged_perp_fail_) {
+                logged_perp_fail_ = true;
+                log_str("[Market] clearinghouseState parse failed\n");
             }
-            last_portfolio_ms = now_ms;
+            perp_.backoff_ms = next_backoff_ms(perp_.backoff_ms);
         }
+    } else {
+        perp_.backoff_ms = next_backoff_ms(perp_.backoff_ms);
+    }
+    arm_after(perp_, (perp_.backoff_ms > 0) ? perp_.backoff_ms : 3000, &MarketDataService::poll_perp);
+}
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+// Minimal portfolio logging: only log TOTAL_ASSET_VALUE once (or every 30s if it succeeds).
+void MarketDataService::poll_portfolio() {
+    portfolio_.started_ms = wall_ms();
+    const tradeboy::model::WalletSnapshot w = model.wallet_snapshot();
+    if (!w.wallet_address.empty()) {
+        const std::string req = std::string("{\"type\":\"portfolio\",\"user\":\"") + w.wallet_address + "\"}\n";
+        if (fetch(portfolio_, req, &MarketDataService::on_portfolio)) return;
+        log_str("[HL] portfolio fetch failed\n");
+        portfolio_failed_once_ = true;
+    }
+    arm_after(portfolio_, (logged_portfolio_once_ || portfolio_failed_once_) ? 30000 : 5000, &MarketDataService::poll_portfolio);
+}
+
+void MarketDataService::on_portfolio(bool ok, std::string& portfolio_json) {
+    if (ok) {
+        const size_t added = portfolio_hist_.ingest_portfolio_json(portfolio_json.data(), portfolio_json.size());
+        double account_value = 0.0;
+        if (portfolio_hist_.latest_account_value(account_value)) {
+            char line[128];
+            std::snprintf(line, sizeof(line), "[HL] TOTAL_ASSET_VALUE=%.6f new_points=%u\n", account_value, (unsigned)added);
+            log_str(line);
+
+            const tradeboy::model::TradeModelSnapshot snap = model.snapshot();
+            portfolio_hist_.set_mark_base(snap.spot_rows);
+            publish_portfolio(model, portfolio_hist_, snap.spot_rows, wall_ms());
+            log_str("[Model] hl_portfolio updated\n");
+
+            logged_portfolio_once_ = true;
+        } else {
+            log_str("[HL] TOTAL_ASSET_VALUE parse failed\n");
+            log_portfolio_prefix_once(portfolio_json);
+            portfolio_failed_once_ = true;
+        }
+    } else {
+        log_str("[HL] portfolio fetch failed\n");
+        portfolio_failed_once_ = true;
     }
+    arm_after(portfolio_, (logged_portfolio_once_ || portfolio_failed_once_) ? 30000 : 5000, &MarketDataService::poll_portfolio);
 }
 
 } // namespace tradeboy::market
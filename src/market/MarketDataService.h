@@ -1,29 +1,97 @@
 #pragma once
 
-#include <atomic>
-#include <thread>
+#include <string>
 
+#include "core/Reactor.h"
+#include "CandleStore.h"
 #include "IMarketDataSource.h"
+#include "PortfolioHistory.h"
 
 namespace tradeboy::model { struct TradeModel; }
 
 namespace tradeboy::market {
 
+// Feeds the model from the market source and periodic /info polls. Runs
+// entirely on the network reactor: every poll is a timer plus a wget child,
+// and streamed data is drained when the source signals it.
 struct MarketDataService {
-    MarketDataService(tradeboy::model::TradeModel& model, IMarketDataSource& src);
+    MarketDataService(tradeboy::model::TradeModel& model, IMarketDataSource& src, tradeboy::core::Reactor& reactor);
     ~MarketDataService();
 
     void start();
     void stop();
 
+    // Loads candle history for a coin (cache first, then the missing tail).
+    // Only the latest request is kept.
+    void request_candle_history(const std::string& coin);
+
 private:
-    void run();
+    // One periodic job: its pending timer and, while a request is out, the
+    // wget child.
+    struct Poll {
+        tradeboy::core::Reactor::TimerId timer = 0;
+        tradeboy::core::Reactor::ProcId proc = 0;
+        long long started_ms = 0;
+        int backoff_ms = 0;
+    };
+    typedef void (MarketDataService::*PollFn)();
+    typedef void (MarketDataService::*ReplyFn)(bool ok, std::string& resp);
+
+    void arm(Poll& p, int delay_ms, PollFn fn);
+    // Next run interval_ms after the current one started.
+    void arm_after(Poll& p, int interval_ms, PollFn fn);
+    bool fetch(Poll& p, const std::string& req, ReplyFn done);
+    void cancel(Poll& p);
+
+    void poll_perp_meta();
+    void on_perp_meta(bool ok, std::string& resp);
+    void poll_spot_meta();
+    void on_spot_meta(bool ok, std::string& resp);
+    void poll_user();
+    void on_user(bool ok, std::string& resp);
+    void poll_perp();
+    void on_perp(bool ok, std::string& resp);
+    void poll_portfolio();
+    void on_portfolio(bool ok, std::string& resp);
+    void poll_candles();
+    void on_candles(bool ok, std::string& resp);
+    void housekeeping();
+    void drain_streams();
+    void apply_mids();
 
     tradeboy::model::TradeModel& model;
     IMarketDataSource& src;
+    tradeboy::core::Reactor& reactor_;
+
+    // Reactor thread only.
+    bool running_ = false;
+    Poll perp_meta_;
+    Poll spot_meta_;
+    Poll user_;
+    Poll perp_;
+    Poll portfolio_;
+    Poll candles_;
+    Poll housekeeping_;
+    Poll drain_;
+
+    std::string mids_json_;
+    std::string spot_meta_json_;
+    bool spot_rows_initialized_ = false;
+    bool spot_meta_done_ = false;
+    bool perp_meta_done_ = false;
+    bool logged_user_dump_ = false;
+    bool logged_user_fail_ = false;
+    bool logged_perp_dump_ = false;
+    bool logged_perp_fail_ = false;
+    bool logged_portfolio_once_ = false;
+    bool portfolio_failed_once_ = false;
+    long long last_feed_report_ms_ = 0;
+    long long last_state_save_ms_ = 0;
+
+    std::string candle_req_coin_;
+    CandleHistoryJob candle_job_;
 
-    std::atomic<bool> stop_flag{false};
-    std::thread th;
+    PortfolioHistory portfolio_hist_;
 };
 
 } // namespace tradeboy::market
@@ -0,0 +1,190 @@
+#include "OrderBook.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "utils/JsonScan.h"
+
+namespace tradeboy::market {
+
+using tradeboy::utils::JsonScan;
+using tradeboy::utils::json_key_is;
+
+static bool parse_level(JsonScan& sc, BookLevel& out) {
+    if (!sc.eat('{')) return false;
+    out = BookLevel();
+    if (sc.eat('}')) return true;
+    while (true) {
+        const char* k;
+        size_t kn;
+        if (!sc.str(k, kn) || !sc.eat(':')) return false;
+        if (json_key_is(k, kn, "px")) {
+            if (!sc.number(out.px)) return false;
+        } else if (json_key_is(k, kn, "sz")) {
+            if (!sc.number(out.sz)) return false;
+        } else if (json_key_is(k, kn, "n")) {
+            double v = 0.0;
+            if (!sc.number(v)) return false;
+            out.n = (int)v;
+        } else if (!sc.skip_value()) {
+            return false;
+        }
+        if (sc.eat(',')) continue;
+        return sc.eat('}');
+    }
+}
+
+// Reads one side; keeps the first kMaxLevels and skips the rest.
+static bool parse_side(JsonScan& sc, BookLevel* levels, int& out_n) {
+    out_n = 0;
+    if (!sc.eat('[')) return false;
+    if (sc.eat(']')) return true;
+    while (true) {
+        BookLevel lv;
+        if (!parse_level(sc, lv)) return false;
+        if (out_n < OrderBook::kMaxLevels && lv.px > 0.0 && lv.sz > 0.0) levels[out_n++] = lv;
+        if (sc.eat(',')) continue;
+        return sc.eat(']');
+    }
+}
+
+// The exchange already sends levels best-first; this only guards against a
+// reordered feed. Insertion sort: n <= kMaxLevels and usually already sorted.
+static void sort_side(BookLevel* levels, int n, bool descending) {
+    for (int i = 1; i < n; i++) {
+        BookLevel v = levels[i];
+        int j = i - 1;
+        while (j >= 0 && (descending ? (levels[j].px < v.px) : (levels[j].px > v.px))) {
+            levels[j + 1] = levels[j];
+            j--;
+        }
+        levels[j + 1] = v;
+    }
+}
+
+void OrderBook::clear() {
+    coin[0] = 0;
+    time_ms = 0;
+    n_bids = 0;
+    n_asks = 0;
+}
+
+bool OrderBook::is_coin(const char* c) const {
+    return c && std::strcmp(coin, c) == 0;
+}
+
+bool OrderBook::apply_l2_snapshot_json(const char* msg, size_t len) {
+    clear();
+    if (!msg || len == 0) return false;
+
+    JsonScan sc(msg, len);
+    if (!sc.eat('{')) return false;
+
+    bool have_levels = false;
+    while (!sc.peek('}')) {
+        const char* k;
+        size_t kn;
+        if (!sc.str(k, kn) || !sc.eat(':')) {
+            clear();
+            return false;
+        }
+        bool ok = true;
+        if (json_key_is(k, kn, "coin")) {
+            const char* s;
+            size_t n;
+            ok = sc.str(s, n) && n < sizeof(coin);
+            if (ok) {
+                std::memcpy(coin, s, n);
+                coin[n] = 0;
+            }
+        } else if (json_key_is(k, kn, "time")) {
+            double t = 0.0;
+            ok = sc.number(t);
+            time_ms = (long long)t;
+        } else if (json_key_is(k, kn, "levels")) {
+            ok = sc.eat('[') && parse_side(sc, bids, n_bids) && sc.eat(',') && parse_side(sc, asks, n_asks) && sc.eat(']');
+            have_levels = ok;
+        } else {
+            ok = sc.skip_value();
+        }
+        if (!ok) {
+            clear();
+            return false;
+        }
+        if (!sc.eat(',')) break;
+    }
+    if (!have_levels || coin[0] == 0) {
+        clear();
+        return false;
+    }
+
+    sort_side(bids, n_bids, true);
+    sort_side(asks, n_asks, false);
+    return true;
+}
+
+bool OrderBook::best_bid(double& out_px) const {
+    if (n_bids <= 0) return false;
+    out_px = bids[0].px;
+    return true;
+}
+
+bool OrderBook::best_ask(double& out_px) const {
+    if (n_asks <= 0) return false;
+    out_px = asks[0].px;
+    return true;
+}
+
+bool OrderBook::price_at_size(bool is_buy, double size, double& out_px) const {
+    const BookLevel* lv = is_buy ? asks : bids;
+    const int n = is_buy ? n_asks : n_bids;
+    if (n <= 0 || !(size > 0.0)) return false;
+    double left = size;
+    for (int i = 0; i < n; i++) {
+        out_px = lv[i].px;
+        left -= lv[i].sz;
+        if (left <= 0.0) return true;
+    }
+    return false;
+}
+
+bool OrderBook::vwap_for_size(bool is_buy, double size, double& out_vwap, double& out_filled) const {
+    out_vwap = 0.0;
+    out_filled = 0.0;
+    const BookLevel* lv = is_buy ? asks : bids;
+    const int n = is_buy ? n_asks : n_bids;
+    if (n <= 0 || !(size > 0.0)) return false;
+
+    double notional = 0.0;
+    for (int i = 0; i < n && out_filled < size; i++) {
+        const double take = (lv[i].sz < size - out_filled) ? lv[i].sz : (size - out_filled);
+        notional += take * lv[i].px;
+        out_filled += take;
+    }
+    if (out_filled > 0.0) out_vwap = notional / out_filled;
+    return out_filled >= size;
+}
+
+double OrderBook::depth_to_price(bool is_buy, double limit_px) const {
+    const BookLevel* lv = is_buy ? asks : bids;
+    const int n = is_buy ? n_asks : n_bids;
+    double total = 0.0;
+    for (int i = 0; i < n; i++) {
+        if (is_buy ? (lv[i].px > limit_px) : (lv[i].px < limit_px)) break;
+        total += lv[i].sz;
+    }
+    return total;
+}
+
+void l2_spot_coin_for_asset(int asset_id, char* out, size_t cap) {
+    if (!out || cap == 0) return;
+    const int index = asset_id - 10000;
+    if (index <= 0) {
+        std::snprintf(out, cap, "%s", index == 0 ? "PURR/USDC" : "");
+        return;
+    }
+    std::snprintf(out, cap, "@%d", index);
+}
+
+} // namespace tradeboy::market
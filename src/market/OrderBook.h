@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+
+namespace tradeboy::market {
+
+struct BookLevel {
+    double px = 0.0;
+    double sz = 0.0;
+    int n = 0; // number of orders at this level
+};
+
+// L2 book for one coin in fixed-capacity flat arrays: bids best (highest)
+// first, asks best (lowest) first. Applying a snapshot overwrites in place and
+// copying a book is a plain struct copy, so neither allocates.
+struct OrderBook {
+    static const int kMaxLevels = 64; // l2Book sends up to 20 per side
+
+    char coin[32] = {0};
+    long long time_ms = 0;  // exchange timestamp of the snapshot
+
+    BookLevel bids[kMaxLevels];
+    int n_bids = 0;
+    BookLevel asks[kMaxLevels];
+    int n_asks = 0;
+
+    void clear();
+    bool empty() const { return n_bids == 0 && n_asks == 0; }
+    bool is_coin(const char* c) const;
+
+    // Parses the data object of an l2Book channel message
+    // ({"coin":..,"time":..,"levels":[[bids..],[asks..]]}). The book is left
+    // cleared if the message is malformed.
+    bool apply_l2_snapshot_json(const char* msg, size_t len);
+
+    bool best_bid(double& out_px) const;
+    bool best_ask(double& out_px) const;
+
+    // Price of the last level touched when taking `size` from the opposite
+    // side (asks for a buy). False if the visible book is too thin.
+    bool price_at_size(bool is_buy, double size, double& out_px) const;
+    // Average fill price for taking `size`. out_filled is the size the visible
+    // book covers; returns false when it is less than `size`.
+    bool vwap_for_size(bool is_buy, double size, double& out_vwap, double& out_filled) const;
+    // Total size available from the best price up to limit_px.
+    double depth_to_price(bool is_buy, double limit_px) const;
+};
+
+// l2Book coin name for a spot pair: "@<index>", except the first pair which
+// the exchange names "PURR/USDC".
+void l2_spot_coin_for_asset(int asset_id, char* out, size_t cap);
+
+} // namespace tradeboy::market
@@ -0,0 +1,314 @@
+#include "PerpFeed.h"
+
+#include <cstring>
+
+#include "utils/JsonScan.h"
+
+namespace tradeboy::market {
+
+using tradeboy::model::PerpAssetCtx;
+using tradeboy::model::PerpCtxUpdate;
+using tradeboy::model::PerpAccountState;
+using tradeboy::model::PerpMarketMeta;
+using tradeboy::model::PerpPositionState;
+using tradeboy::utils::JsonScan;
+using tradeboy::utils::json_key_is;
+
+static const unsigned kQueueMask = PerpCtxQueue::kCapacity - 1;
+
+bool PerpCtxQueue::push(const PerpCtxUpdate& u) {
+    const unsigned h = head_.load(std::memory_order_relaxed);
+    const unsigned tl = tail_.load(std::memory_order_acquire);
+    if (h - tl >= kCapacity) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    buf_[h & kQueueMask] = u;
+    head_.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+bool PerpCtxQueue::pop(PerpCtxUpdate& out) {
+    const unsigned tl = tail_.load(std::memory_order_relaxed);
+    const unsigned h = head_.load(std::memory_order_acquire);
+    if (tl == h) return false;
+    out = buf_[tl & kQueueMask];
+    tail_.store(tl + 1, std::memory_order_release);
+    return true;
+}
+
+// Prices may be null (e.g. midPx with an empty book); those stay 0.
+static bool number_or_null(JsonScan& sc, double& out) {
+    if (sc.number(out)) return true;
+    out = 0.0;
+    return sc.skip_value();
+}
+
+static bool parse_ctx(JsonScan& sc, PerpAssetCtx& out) {
+    if (!sc.eat('{')) return false;
+    if (sc.eat('}')) return true;
+    while (true) {
+        const char* k;
+        size_t kn;
+        if (!sc.str(k, kn) || !sc.eat(':')) return false;
+        double* dst = nullptr;
+        if (json_key_is(k, kn, "markPx")) dst = &out.mark_px;
+        else if (json_key_is(k, kn, "oraclePx")) dst = &out.oracle_px;
+        else if (json_key_is(k, kn, "midPx")) dst = &out.mid_px;
+        else if (json_key_is(k, kn, "prevDayPx")) dst = &out.prev_day_px;
+        else if (json_key_is(k, kn, "funding")) dst = &out.funding;
+        else if (json_key_is(k, kn, "openInterest")) dst = &out.open_interest;
+        else if (json_key_is(k, kn, "dayNtlVlm")) dst = &out.day_ntl_vlm;
+        if (dst) {
+            if (!number_or_null(sc, *dst)) return false;
+        } else if (!sc.skip_value()) {
+            return false;
+        }
+        if (sc.eat(',')) continue;
+        return sc.eat('}');
+    }
+}
+
+static bool parse_meta(JsonScan& sc, PerpMarketMeta& out) {
+    if (!sc.eat('{')) return false;
+    if (sc.eat('}')) return true;
+    while (true) {
+        const char* k;
+        size_t kn;
+        if (!sc.str(k, kn) || !sc.eat(':')) return false;
+        double v = 0.0;
+        if (json_key_is(k, kn, "name")) {
+            const char* s;
+            size_t n;
+            if (!sc.str(s, n)) return false;
+            out.name.assign(s, n);
+        } else if (json_key_is(k, kn, "szDecimals")) {
+            if (!sc.number(v)) return false;
+            out.sz_decimals = (int)v;
+        } else if (json_key_is(k, kn, "maxLeverage")) {
+            if (!sc.number(v)) return false;
+            out.max_leverage = (int)v;
+        } else if (json_key_is(k, kn, "isDelisted")) {
+            sc.ws();
+            out.delisted = (sc.p + 4 <= sc.end && std::memcmp(sc.p, "true", 4) == 0);
+            if (!sc.skip_value()) return false;
+        } else if (!sc.skip_value()) {
+            return false;
+        }
+        if (sc.eat(',')) continue;
+        return sc.eat('}');
+    }
+}
+
+bool parse_perp_meta_and_ctxs_json(const char* json,
+                                   size_t len,
+                                   std::vector<PerpMarketMeta>& out_metas,
+                                   std::vector<PerpAssetCtx>& out_ctxs) {
+    out_metas.clear();
+    out_ctxs.clear();
+    if (!json || len == 0) return false;
+    JsonScan sc(json, len);
+    if (!sc.eat('[') || !sc.eat('{')) return false;
+
+    // Meta object: only "universe" matters.
+    if (!sc.eat('}')) {
+        while (true) {
+            const char* k;
+            size_t kn;
+            if (!sc.str(k, kn) || !sc.eat(':')) return false;
+            if (json_key_is(k, kn, "universe")) {
+                if (!sc.eat('[')) return false;
+                if (!sc.eat(']')) {
+                    while (true) {
+                        PerpMarketMeta m;
+                        if (!parse_meta(sc, m)) return false;
+                        out_metas.push_back(m);
+                        if (sc.eat(',')) continue;
+                        if (!sc.eat(']')) return false;
+                        break;
+                    }
+                }
+            } else if (!sc.skip_value()) {
+                return false;
+            }
+            if (sc.eat(',')) continue;
+            if (!sc.eat('}')) return false;
+            break;
+        }
+    }
+
+    if (!sc.eat(',') || !sc.eat('[')) return false;
+    out_ctxs.reserve(out_metas.size());
+    if (!sc.eat(']')) {
+        while (true) {
+            PerpAssetCtx c;
+            if (!parse_ctx(sc, c)) return false;
+            out_ctxs.push_back(c);
+            if (sc.eat(',')) continue;
+            if (!sc.eat(']')) return false;
+            break;
+        }
+    }
+    return !out_metas.empty();
+}
+
+bool parse_active_asset_ctx_json(const char* json, size_t len, PerpCtxUpdate& out) {
+    if (!json || len == 0) return false;
+    JsonScan sc(json, len);
+    if (!sc.eat('{')) return false;
+    bool have_ctx = false;
+    if (sc.eat('}')) return false;
+    while (true) {
+        const char* k;
+        size_t kn;
+        if (!sc.str(k, kn) || !sc.eat(':')) return false;
+        if (json_key_is(k, kn, "coin")) {
+            const char* s;
+            size_t n;
+            if (!sc.str(s, n) || n >= sizeof(out.coin)) return false;
+            std::memcpy(out.coin, s, n);
+            out.coin[n] = 0;
+        } else if (json_key_is(k, kn, "ctx")) {
+            if (!parse_ctx(sc, out.ctx)) return false;
+            have_ctx = true;
+        } else if (!sc.skip_value()) {
+            return false;
+        }
+        if (sc.eat(',')) continue;
+        break;
+    }
+    return have_ctx && out.coin[0] != 0;
+}
+
+// {"accountValue":"..",...} -> accountValue only.
+static bool parse_margin_summary(JsonScan& sc, double& out_account_value) {
+    if (!sc.eat('{')) return false;
+    if (sc.eat('}')) return true;
+    while (true) {
+        const char* k;
+        size_t kn;
+        if (!sc.str(k, kn) || !sc.eat(':')) return false;
+        if (json_key_is(k, kn, "accountValue")) {
+            if (!sc.number(out_account_value)) return false;
+        } else if (!sc.skip_value()) {
+            return false;
+        }
+        if (sc.eat(',')) continue;
+        return sc.eat('}');
+    }
+}
+
+// "leverage":{"type":"cross","value":20}
+static bool parse_leverage(JsonScan& sc, PerpPositionState& out) {
+    if (!sc.eat('{')) return false;
+    if (sc.eat('}')) return true;
+    while (true) {
+        const char* k;
+        size_t kn;
+        if (!sc.str(k, kn) || !sc.eat(':')) return false;
+        if (json_key_is(k, kn, "type")) {
+            const char* s;
+            size_t n;
+            if (!sc.str(s, n)) return false;
+            out.cross = !json_key_is(s, n, "isolated");
+        } else if (json_key_is(k, kn, "value")) {
+            if (!sc.number(out.leverage)) return false;
+        } else if (!sc.skip_value()) {
+            return false;
+        }
+        if (sc.eat(',')) continue;
+        return sc.eat('}');
+    }
+}
+
+static bool parse_position(JsonScan& sc, PerpPositionState& out) {
+    if (!sc.eat('{')) return false;
+    if (sc.eat('}')) return true;
+    while (true) {
+        const char* k;
+        size_t kn;
+        if (!sc.str(k, kn) || !sc.eat(':')) return false;
+        bool ok = true;
+        if (json_key_is(k, kn, "coin")) {
+            const char* s;
+            size_t n;
+            ok = sc.str(s, n);
+            if (ok) out.coin.assign(s, n);
+        } else if (json_key_is(k, kn, "szi")) {
+            ok = sc.number(out.szi);
+        } else if (json_key_is(k, kn, "entryPx")) {
+            ok = number_or_null(sc, out.entry_px);
+        } else if (json_key_is(k, kn, "marginUsed")) {
+            ok = sc.number(out.margin_used);
+        } else if (json_key_is(k, kn, "unrealizedPnl")) {
+            ok = sc.number(out.unrealized_pnl);
+        } else if (json_key_is(k, kn, "leverage")) {
+            ok = parse_leverage(sc, out);
+        } else {
+            ok = sc.skip_value();
+        }
+        if (!ok) return false;
+        if (sc.eat(',')) continue;
+        return sc.eat('}');
+    }
+}
+
+// [{"type":"oneWay","position":{...}}, ...]
+static bool parse_asset_positions(JsonScan& sc, std::vector<PerpPositionState>& out) {
+    if (!sc.eat('[')) return false;
+    if (sc.eat(']')) return true;
+    while (true) {
+        if (!sc.eat('{')) return false;
+        if (!sc.eat('}')) {
+            while (true) {
+                const char* k;
+                size_t kn;
+                if (!sc.str(k, kn) || !sc.eat(':')) return false;
+                if (json_key_is(k, kn, "position")) {
+                    PerpPositionState ps;
+                    if (!parse_position(sc, ps)) return false;
+                    if (!ps.coin.empty() && ps.szi != 0.0) out.push_back(ps);
+                } else if (!sc.skip_value()) {
+                    return false;
+                }
+                if (sc.eat(',')) continue;
+                if (!sc.eat('}')) return false;
+                break;
+            }
+        }
+        if (sc.eat(',')) continue;
+        return sc.eat(']');
+    }
+}
+
+bool parse_clearinghouse_state_json(const char* json, size_t len, PerpAccountState& out) {
+    out = PerpAccountState();
+    if (!json || len == 0) return false;
+    JsonScan sc(json, len);
+    if (!sc.eat('{')) return false;
+    if (sc.eat('}')) return false;
+    bool have_summary = false;
+    while (true) {
+        const char* k;
+        size_t kn;
+        if (!sc.str(k, kn) || !sc.eat(':')) return false;
+        bool ok = true;
+        if (json_key_is(k, kn, "marginSummary")) {
+            ok = parse_margin_summary(sc, out.account_value);
+            have_summary = ok;
+        } else if (json_key_is(k, kn, "crossMarginSummary")) {
+            ok = parse_margin_summary(sc, out.cross_account_value);
+        } else if (json_key_is(k, kn, "withdrawable")) {
+            ok = sc.number(out.withdrawable);
+        } else if (json_key_is(k, kn, "assetPositions")) {
+            ok = parse_asset_positions(sc, out.positions);
+        } else {
+            ok = sc.skip_value();
+        }
+        if (!ok) return false;
+        if (sc.eat(',')) continue;
+        return sc.eat('}') && have_summary;
+    }
+}
+
+} // namespace tradeboy::market
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "../model/PerpMarkets.h"
+#include "../model/PerpPositions.h"
+
+namespace tradeboy::market {
+
+// Lock-free single-producer/single-consumer queue of activeAssetCtx updates,
+// same scheme as TradeTape: the WS thread pushes, MarketDataService drains.
+// A full queue drops the new update; the next one for that coin replaces it.
+struct PerpCtxQueue {
+    static const unsigned kCapacity = 512; // power of two; > one update per perp
+
+    bool push(const tradeboy::model::PerpCtxUpdate& u);
+    bool pop(tradeboy::model::PerpCtxUpdate& out);
+    unsigned long long dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    tradeboy::model::PerpCtxUpdate buf_[kCapacity];
+    std::atomic<unsigned> head_{0};
+    std::atomic<unsigned> tail_{0};
+    std::atomic<unsigned long long> dropped_{0};
+};
+
+// {"type":"metaAndAssetCtxs"} response: [{"universe":[...]}, [ctx, ...]].
+// Contexts come back in universe order.
+bool parse_perp_meta_and_ctxs_json(const char* json,
+                                   size_t len,
+                                   std::vector<tradeboy::model::PerpMarketMeta>& out_metas,
+                                   std::vector<tradeboy::model::PerpAssetCtx>& out_ctxs);
+
+// data object of an activeAssetCtx message: {"coin":"BTC","ctx":{...}}.
+bool parse_active_asset_ctx_json(const char* json, size_t len, tradeboy::model::PerpCtxUpdate& out);
+
+// {"type":"clearinghouseState"} response: margin summaries, withdrawable and
+// assetPositions.
+bool parse_clearinghouse_state_json(const char* json, size_t len, tradeboy::model::PerpAccountState& out);
+
+} // namespace tradeboy::market
@@ -0,0 +1,196 @@
+#include "PortfolioHistory.h"
+
+#include "utils/JsonScan.h"
+
+namespace tradeboy::market {
+
+using tradeboy::utils::JsonScan;
+using tradeboy::utils::json_key_is;
+
+static const long long kWindowMs[kPnlWindowCount] = {
+    24LL * 60LL * 60LL * 1000LL,
+    7LL * 24LL * 60LL * 60LL * 1000LL,
+    30LL * 24LL * 60LL * 60LL * 1000LL,
+};
+
+bool PortfolioSeries::append(long long ts_ms, double v) {
+    if (count_ > 0 && ts_ms <= last()->ts_ms) return false;
+    Point& p = buf_[count_ & (kCapacity - 1)];
+    p.ts_ms = ts_ms;
+    p.v = v;
+    count_++;
+    return true;
+}
+
+// [[ts,"v"],...] -> fn per point; stops early when fn returns false.
+template <typename Fn>
+static void walk_history(const char* arr, const char* end, Fn fn) {
+    if (!arr) return;
+    JsonScan sc(arr, (size_t)(end - arr));
+    if (!sc.eat('[')) return;
+    if (sc.eat(']')) return;
+    while (true) {
+        double ts = 0.0;
+        double v = 0.0;
+        if (!sc.eat('[') || !sc.number(ts) || !sc.eat(',') || !sc.number(v) || !sc.eat(']')) return;
+        if (!fn((long long)ts, v)) return;
+        if (!sc.eat(',')) return;
+    }
+}
+
+// Returns the '[' of key's array inside a period object, or nullptr.
+static const char* find_history(JsonScan& sc, const char* key) {
+    const char* found = nullptr;
+    if (!sc.eat('{')) return nullptr;
+    if (sc.eat('}')) return nullptr;
+    while (true) {
+        const char* k;
+        size_t kn;
+        if (!sc.str(k, kn) || !sc.eat(':')) return nullptr;
+        sc.ws();
+        if (json_key_is(k, kn, key)) found = sc.p;
+        if (!sc.skip_value()) return nullptr;
+        if (sc.eat(',')) continue;
+        return sc.eat('}') ? found : nullptr;
+    }
+}
+
+// Appends points after the last held one. With rebase, they are shifted onto
+// the held base using the point at the held timestamp; if that point has
+// rolled out of the document the series starts over from it.
+static size_t append_new(PortfolioSeries& s, const char* arr, const char* end, bool rebase, bool& out_reset) {
+    out_reset = false;
+    if (!arr) return 0;
+    size_t added = 0;
+    if (s.count() > 0) {
+        const long long last_ts = s.last()->ts_ms;
+        const double held_v = s.last()->v;
+        double offset = 0.0;
+        bool anchored = !rebase;
+        bool lost = false;
+        walk_history(arr, end, [&](long long ts, double v) -> bool {
+            if (ts < last_ts) return true;
+            if (ts == last_ts) {
+                offset = held_v - v;
+                anchored = true;
+                return true;
+            }
+            if (!anchored) {
+                lost = true;
+                return false;
+            }
+            if (s.append(ts, v + (rebase ? offset : 0.0))) added++;
+            return true;
+        });
+        if (!lost) return added;
+        s.clear();
+        out_reset = true;
+        added = 0;
+    }
+    walk_history(arr, end, [&](long long ts, double v) -> bool {
+        if (s.append(ts, v)) added++;
+        return true;
+    });
+    return added;
+}
+
+size_t PortfolioHistory::ingest_portfolio_json(const char* json, size_t len) {
+    if (!json || len == 0) return 0;
+    const char* end = json + len;
+
+    // [["day",{...}],["week",{...}],["month",{...}],["allTime",{...}],...]
+    static const char* const kPeriods[kPnlWindowCount] = {"day", "week", "month"};
+    const char* pnl_arr[kPnlWindowCount] = {nullptr, nullptr, nullptr};
+    const char* av_arr = nullptr;
+
+    JsonScan sc(json, len);
+    if (!sc.eat('[')) return 0;
+    while (sc.eat('[')) {
+        const char* name;
+        size_t nn;
+        if (!sc.str(name, nn) || !sc.eat(',')) return 0;
+        int slot = -1;
+        for (int w = 0; w < kPnlWindowCount; w++) {
+            if (json_key_is(name, nn, kPeriods[w])) slot = w;
+        }
+        sc.ws();
+        const char* obj = sc.p;
+        if (!sc.skip_value()) return 0;
+        if (slot >= 0) {
+            JsonScan osc(obj, (size_t)(sc.p - obj));
+            pnl_arr[slot] = find_history(osc, "pnlHistory");
+            if (slot == (int)PnlWindow::H24) {
+                JsonScan asc(obj, (size_t)(sc.p - obj));
+                av_arr = find_history(asc, "accountValueHistory");
+            }
+        }
+        if (!sc.eat(']')) return 0;
+        if (!sc.eat(',')) break;
+    }
+
+    bool reset = false;
+    size_t added = append_new(account_value, av_arr, end, false, reset);
+    for (int w = 0; w < kPnlWindowCount; w++) {
+        added += append_new(pnl[w], pnl_arr[w], end, true, reset);
+        if (reset) base_seq_[w] = 0;
+    }
+    return added;
+}
+
+void PortfolioHistory::advance(long long now_ms) {
+    for (int w = 0; w < kPnlWindowCount; w++) {
+        const PortfolioSeries& s = pnl[w];
+        const unsigned long long n = s.count();
+        if (n == 0) continue;
+        const long long target = now_ms - kWindowMs[w];
+        unsigned long long seq = base_seq_[w];
+        if (seq < s.first_seq()) seq = s.first_seq();
+        while (seq + 1 < n && s.at_seq(seq + 1).ts_ms <= target) seq++;
+        base_seq_[w] = seq;
+    }
+}
+
+bool PortfolioHistory::window_delta(PnlWindow w, double& out) const {
+    out = 0.0;
+    const PortfolioSeries& s = pnl[(int)w];
+    if (s.count() < 2) return false;
+    unsigned long long seq = base_seq_[(int)w];
+    if (seq < s.first_seq()) seq = s.first_seq();
+    out = s.last()->v - s.at_seq(seq).v;
+    return true;
+}
+
+bool PortfolioHistory::latest_account_value(double& out) const {
+    const PortfolioSeries::Point* p = account_value.last();
+    if (!p) return false;
+    out = p->v;
+    return true;
+}
+
+void PortfolioHistory::set_mark_base(const std::vector<tradeboy::model::SpotRow>& rows) {
+    marks_.clear();
+    for (const auto& r : rows) {
+        if (r.balance > 0.0 && r.price > 0.0) {
+            Mark m;
+            m.coin = r.coin;
+            m.balance = r.balance;
+            m.px = r.price;
+            marks_.push_back(m);
+        }
+    }
+}
+
+double PortfolioHistory::mark_drift(const std::vector<tradeboy::model::SpotRow>& rows) const {
+    double drift = 0.0;
+    for (const Mark& m : marks_) {
+        for (const auto& r : rows) {
+            if (r.coin == m.coin) {
+                if (r.price > 0.0) drift += m.balance * (r.price - m.px);
+                break;
+            }
+        }
+    }
+    return drift;
+}
+
+} // namespace tradeboy::market
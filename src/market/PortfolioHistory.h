@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "../model/TradeModel.h"
+
+namespace tradeboy::market {
+
+// Time-ordered ring of (ts, value) points; only strictly newer points append.
+struct PortfolioSeries {
+    static const unsigned kCapacity = 4096; // power of two; ~30d at 15 min
+
+    struct Point {
+        long long ts_ms = 0;
+        double v = 0.0;
+    };
+
+    bool append(long long ts_ms, double v);
+    void clear() { count_ = 0; }
+
+    unsigned long long count() const { return count_; } // points ever appended
+    unsigned long long first_seq() const { return count_ > kCapacity ? count_ - kCapacity : 0; }
+    // seq in [first_seq(), count()).
+    const Point& at_seq(unsigned long long seq) const { return buf_[seq & (kCapacity - 1)]; }
+    const Point* last() const { return count_ ? &at_seq(count_ - 1) : nullptr; }
+
+private:
+    Point buf_[kCapacity];
+    unsigned long long count_ = 0;
+};
+
+enum class PnlWindow {
+    H24 = 0,
+    D7 = 1,
+    D30 = 2,
+};
+
+static const int kPnlWindowCount = 3;
+
+// Portfolio account value / pnl history kept across polls. Each poll only
+// appends points newer than those held, and the 24h/7d/30d base points are
+// cursors that only move forward, so neither step rescans the history.
+//
+// The exchange rebases each period's pnlHistory to start at 0 as the period
+// rolls, so new points are shifted by the offset measured at the last point
+// already held; that keeps every ring on one base.
+struct PortfolioHistory {
+    PortfolioSeries account_value;        // "day" accountValueHistory
+    PortfolioSeries pnl[kPnlWindowCount]; // "day" / "week" / "month" pnlHistory
+
+    // Walks the portfolio document in place (no JSON tree). Returns the number
+    // of points appended.
+    size_t ingest_portfolio_json(const char* json, size_t len);
+
+    // Moves the window cursors to now_ms.
+    void advance(long long now_ms);
+    // Latest pnl minus the pnl at the window start (or the oldest point held).
+    bool window_delta(PnlWindow w, double& out) const;
+    bool latest_account_value(double& out) const;
+
+    // Spot holdings valued at the time of the last poll. mark_drift() is how
+    // far live mids have moved that value since, used to mark to market
+    // between polls.
+    void set_mark_base(const std::vector<tradeboy::model::SpotRow>& rows);
+    double mark_drift(const std::vector<tradeboy::model::SpotRow>& rows) const;
+
+private:
+    struct Mark {
+        std::string coin;
+        double balance = 0.0;
+        double px = 0.0;
+    };
+
+    unsigned long long base_seq_[kPnlWindowCount] = {0, 0, 0};
+    std::vector<Mark> marks_;
+};
+
+} // namespace tradeboy::market
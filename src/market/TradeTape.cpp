@@ -0,0 +1,158 @@
+#include "TradeTape.h"
+
+#include <cstring>
+
+#include "utils/JsonScan.h"
+
+namespace tradeboy::market {
+
+using tradeboy::utils::JsonScan;
+using tradeboy::utils::json_key_is;
+
+static const unsigned kTapeMask = TradeTape::kCapacity - 1;
+
+bool TradeTape::push(const TradePrint& t) {
+    const unsigned h = head_.load(std::memory_order_relaxed);
+    const unsigned tl = tail_.load(std::memory_order_acquire);
+    if (h - tl >= kCapacity) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    buf_[h & kTapeMask] = t;
+    head_.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+bool TradeTape::pop(TradePrint& out) {
+    const unsigned tl = tail_.load(std::memory_order_relaxed);
+    const unsigned h = head_.load(std::memory_order_acquire);
+    if (tl == h) return false;
+    out = buf_[tl & kTapeMask];
+    tail_.store(tl + 1, std::memory_order_release);
+    return true;
+}
+
+static bool parse_print(JsonScan& sc, TradePrint& out) {
+    if (!sc.eat('{')) return false;
+    if (sc.eat('}')) return true;
+    while (true) {
+        const char* k;
+        size_t kn;
+        if (!sc.str(k, kn) || !sc.eat(':')) return false;
+        if (json_key_is(k, kn, "coin")) {
+            const char* s;
+            size_t n;
+            if (!sc.str(s, n) || n >= sizeof(out.coin)) return false;
+            std::memcpy(out.coin, s, n);
+            out.coin[n] = 0;
+        } else if (json_key_is(k, kn, "side")) {
+            const char* s;
+            size_t n;
+            if (!sc.str(s, n)) return false;
+            out.is_buy = (n == 1 && s[0] == 'B');
+        } else if (json_key_is(k, kn, "px")) {
+            if (!sc.number(out.px)) return false;
+        } else if (json_key_is(k, kn, "sz")) {
+            if (!sc.number(out.sz)) return false;
+        } else if (json_key_is(k, kn, "time")) {
+            double v = 0.0;
+            if (!sc.number(v)) return false;
+            out.time_ms = (long long)v;
+        } else if (!sc.skip_value()) {
+            return false;
+        }
+        if (sc.eat(',')) continue;
+        return sc.eat('}');
+    }
+}
+
+size_t TradeTape::push_trades_json(const char* msg, size_t len, long long recv_ms, long long* out_last_time_ms) {
+    if (!msg || len == 0) return 0;
+    JsonScan sc(msg, len);
+    if (!sc.eat('[')) return 0;
+    if (sc.eat(']')) return 0;
+    size_t pushed = 0;
+    while (true) {
+        TradePrint t;
+        if (!parse_print(sc, t)) break;
+        t.recv_ms = recv_ms;
+        if (t.coin[0] != 0 && t.px > 0.0 && t.sz > 0.0 && push(t)) {
+            pushed++;
+            if (out_last_time_ms && t.time_ms > *out_last_time_ms) *out_last_time_ms = t.time_ms;
+        }
+        if (!sc.eat(',')) break;
+    }
+    return pushed;
+}
+
+void TradeFlowStats::reset(const char* c) {
+    std::memset(coin, 0, sizeof(coin));
+    if (c) std::strncpy(coin, c, sizeof(coin) - 1);
+    buy_notional = 0.0;
+    sell_notional = 0.0;
+    trades = 0;
+    last_dir = 0;
+    last_px = 0.0;
+    for (int i = 0; i < kWindowSec; i++) buckets_[i] = Bucket();
+    last_sec_ = 0;
+}
+
+bool TradeFlowStats::advance(long long now_ms) {
+    const long long sec = now_ms / 1000;
+    if (last_sec_ == 0) {
+        last_sec_ = sec;
+        return false;
+    }
+    if (sec <= last_sec_) return false;
+
+    bool changed = false;
+    const long long steps = (sec - last_sec_ < kWindowSec) ? (sec - last_sec_) : kWindowSec;
+    for (long long i = 1; i <= steps; i++) {
+        Bucket& b = buckets_[(last_sec_ + i) % kWindowSec];
+        if (b.n > 0) {
+            buy_notional -= b.buy;
+            sell_notional -= b.sell;
+            trades -= b.n;
+            changed = true;
+        }
+        b = Bucket();
+    }
+    last_sec_ = sec;
+    // Running sums drift by rounding; snap back once the window is empty.
+    if (trades <= 0) {
+        trades = 0;
+        buy_notional = 0.0;
+        sell_notional = 0.0;
+    }
+    return changed;
+}
+
+bool TradeFlowStats::add(const TradePrint& t) {
+    if (std::strcmp(coin, t.coin) != 0) return false;
+    advance(t.recv_ms);
+    const long long sec = t.recv_ms / 1000;
+    if (sec <= last_sec_ - kWindowSec) return false;
+
+    const double notional = t.px * t.sz;
+    Bucket& b = buckets_[sec % kWindowSec];
+    if (t.is_buy) {
+        b.buy += notional;
+        buy_notional += notional;
+    } else {
+        b.sell += notional;
+        sell_notional += notional;
+    }
+    b.n++;
+    trades++;
+    last_dir = t.is_buy ? 1 : -1;
+    last_px = t.px;
+    return true;
+}
+
+double TradeFlowStats::imbalance() const {
+    const double v = volume();
+    if (!(v > 0.0)) return 0.0;
+    return (buy_notional - sell_notional) / v;
+}
+
+} // namespace tradeboy::market
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace tradeboy::market {
+
+struct TradePrint {
+    char coin[16] = {0};
+    long long time_ms = 0; // exchange timestamp
+    long long recv_ms = 0; // local clock when the frame arrived
+    double px = 0.0;
+    double sz = 0.0;
+    bool is_buy = false;   // aggressor side ("B")
+};
+
+// Fixed-size single-producer/single-consumer ring of recent prints. The WS
+// thread pushes, the UI thread pops; no locks and no allocation. When the
+// consumer falls behind, new prints are dropped (and counted) rather than
+// overwriting slots the consumer may be reading.
+struct TradeTape {
+    static const unsigned kCapacity = 256; // power of two
+
+    bool push(const TradePrint& t);
+    bool pop(TradePrint& out);
+    unsigned long long dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    // Parses the data array of a trades channel message and pushes each print.
+    // Producer side only. Returns the number of prints pushed; the newest
+    // exchange timestamp goes to out_last_time_ms when given.
+    size_t push_trades_json(const char* msg, size_t len, long long recv_ms, long long* out_last_time_ms = nullptr);
+
+private:
+    TradePrint buf_[kCapacity];
+    std::atomic<unsigned> head_{0}; // next slot to write (producer)
+    std::atomic<unsigned> tail_{0}; // next slot to read (consumer)
+    std::atomic<unsigned long long> dropped_{0};
+};
+
+// Rolling flow for one coin over the last minute, kept in per-second buckets
+// so each print and each elapsed second is O(1); the window is never rescanned.
+// Buckets are keyed by local receive time so a skewed device clock does not
+// expire fresh prints. Owned by the consumer thread.
+struct TradeFlowStats {
+    static const int kWindowSec = 60;
+
+    char coin[16] = {0};
+    double buy_notional = 0.0;  // USD taken from asks in the window
+    double sell_notional = 0.0; // USD hit into bids in the window
+    int trades = 0;
+    int last_dir = 0; // +1 buy, -1 sell, 0 none yet
+    double last_px = 0.0;
+
+    void reset(const char* c);
+    // Returns false if the print is for another coin or older than the window.
+    bool add(const TradePrint& t);
+    // Expires buckets that left the window; true if the totals changed.
+    bool advance(long long now_ms);
+
+    double volume() const { return buy_notional + sell_notional; }
+    // (buy - sell) / (buy + sell), in [-1, 1]; 0 when there is no volume.
+    double imbalance() const;
+
+private:
+    struct Bucket {
+        double buy = 0.0;
+        double sell = 0.0;
+        int n = 0;
+    };
+    Bucket buckets_[kWindowSec];
+    long long last_sec_ = 0; // newest second covered by the window
+};
+
+} // namespace tradeboy::market
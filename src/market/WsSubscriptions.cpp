@@ -0,0 +1,89 @@
+#include "WsSubscriptions.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+
+#include "utils/Log.h"
+
+namespace tradeboy::market {
+
+std::string ws_sub_all_mids() {
+    return "{\"type\":\"allMids\"}";
+}
+
+std::string ws_sub_web_data3(const std::string& user) {
+    return std::string("{\"type\":\"webData3\",\"user\":\"") + user + "\"}";
+}
+
+std::string ws_sub_coin(const char* type, const std::string& coin) {
+    return std::string("{\"type\":\"") + type + "\",\"coin\":\"" + coin + "\"}";
+}
+
+std::string ws_sub_candle(const std::string& coin, const char* interval) {
+    return std::string("{\"type\":\"candle\",\"coin\":\"") + coin + "\",\"interval\":\"" + interval + "\"}";
+}
+
+WsSubscriptions::WsSubscriptions() {
+    pthread_mutex_init(&mu_, nullptr);
+}
+
+WsSubscriptions::~WsSubscriptions() {
+    pthread_mutex_destroy(&mu_);
+}
+
+void WsSubscriptions::set_group(WsSubGroup group, const std::vector<std::string>& subs) {
+    pthread_mutex_lock(&mu_);
+    std::vector<std::string>& w = want_[(int)group];
+    if (w == subs) {
+        pthread_mutex_unlock(&mu_);
+        return;
+    }
+    w = subs;
+    pthread_mutex_unlock(&mu_);
+    dirty_.store(true, std::memory_order_release);
+}
+
+void WsSubscriptions::on_connected() {
+    live_.clear();
+    dirty_.store(true, std::memory_order_release);
+}
+
+bool WsSubscriptions::sync(const std::function<bool(const std::string&)>& send) {
+    if (!dirty_.exchange(false, std::memory_order_acq_rel)) return true;
+
+    std::vector<std::string> want;
+    pthread_mutex_lock(&mu_);
+    for (int g = 0; g < kWsSubGroupCount; g++) {
+        want.insert(want.end(), want_[g].begin(), want_[g].end());
+    }
+    pthread_mutex_unlock(&mu_);
+    std::sort(want.begin(), want.end());
+    want.erase(std::unique(want.begin(), want.end()), want.end());
+
+    std::vector<std::string> gone;
+    std::vector<std::string> added;
+    std::set_difference(live_.begin(), live_.end(), want.begin(), want.end(), std::back_inserter(gone));
+    std::set_difference(want.begin(), want.end(), live_.begin(), live_.end(), std::back_inserter(added));
+
+    // Unsubscribe first so the server never holds both sets at once.
+    for (const auto& s : gone) {
+        (void)send(std::string("{\"method\":\"unsubscribe\",\"subscription\":") + s + "}");
+    }
+    for (const auto& s : added) {
+        if (!send(std::string("{\"method\":\"subscribe\",\"subscription\":") + s + "}")) {
+            dirty_.store(true, std::memory_order_release);
+            return false;
+        }
+    }
+    live_.swap(want);
+
+    if (!added.empty() || !gone.empty()) {
+        char buf[96];
+        std::snprintf(buf, sizeof(buf), "[WS] subs=%u (+%u -%u)\n", (unsigned)live_.size(), (unsigned)added.size(), (unsigned)gone.size());
+        log_str(buf);
+    }
+    return true;
+}
+
+} // namespace tradeboy::market
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <pthread.h>
+
+namespace tradeboy::market {
+
+// Who owns a set of subscriptions; each group is replaced as a whole.
+enum class WsSubGroup {
+    Base = 0,    // allMids + webData3 for the wallet
+    Focus = 1,   // l2Book / trades / candle of the coin on screen
+    PerpCtx = 2, // activeAssetCtx of the perps on screen
+};
+
+static const int kWsSubGroupCount = 3;
+
+// Subscription objects, exactly as sent in {"method":..,"subscription":<sub>}.
+std::string ws_sub_all_mids();
+std::string ws_sub_web_data3(const std::string& user);
+std::string ws_sub_coin(const char* type, const std::string& coin); // l2Book, trades, activeAssetCtx
+std::string ws_sub_candle(const std::string& coin, const char* interval);
+
+// Subscriptions the UI wants on the live socket. Any thread replaces a group;
+// the reactor diffs the union of all groups against what the socket has and
+// sends only the unsubscribe/subscribe messages for the difference, so
+// switching markets costs a couple of messages instead of a reconnect. Nothing
+// is live after a reconnect, so the whole set goes out again.
+struct WsSubscriptions {
+    WsSubscriptions();
+    ~WsSubscriptions();
+
+    WsSubscriptions(const WsSubscriptions&) = delete;
+    WsSubscriptions& operator=(const WsSubscriptions&) = delete;
+
+    void set_group(WsSubGroup group, const std::vector<std::string>& subs);
+
+    // Reactor thread only.
+    void on_connected();
+    bool dirty() const { return dirty_.load(std::memory_order_acquire); }
+    // Writes the pending messages through send(). Returns false if a
+    // subscribe could not be written (the socket is gone).
+    bool sync(const std::function<bool(const std::string&)>& send);
+    size_t live_count() const { return live_.size(); }
+
+private:
+    mutable pthread_mutex_t mu_;
+    std::vector<std::string> want_[kWsSubGroupCount];
+    std::atomic<bool> dirty_{false};
+
+    std::vector<std::string> live_; // sorted; reactor thread only
+};
+
+} // namespace tradeboy::market
@@ -0,0 +1,93 @@
+#include "Candles.h"
+
+namespace tradeboy::model {
+
+long long candle_res_ms(CandleRes res) {
+    switch (res) {
+        case CandleRes::M1: return 60LL * 1000LL;
+        case CandleRes::M5: return 5LL * 60LL * 1000LL;
+        case CandleRes::H1: return 60LL * 60LL * 1000LL;
+        case CandleRes::D1: return 24LL * 60LL * 60LL * 1000LL;
+    }
+    return 60LL * 1000LL;
+}
+
+bool CandleRing::update(long long t_ms, long long res_ms, double px) {
+    if (!(px > 0.0) || res_ms <= 0) return false;
+    const long long open_ms = t_ms - (t_ms % res_ms);
+    const float p = (float)px;
+
+    if (count_ > 0) {
+        Candle& cur = buf_[(count_ - 1) & (kCapacity - 1)];
+        if (open_ms == cur.t_ms) {
+            if (p == cur.c && p <= cur.h && p >= cur.l) return false;
+            if (p > cur.h) cur.h = p;
+            if (p < cur.l) cur.l = p;
+            cur.c = p;
+            return true;
+        }
+        // Late tick for a closed bucket; the candle is already final.
+        if (open_ms < cur.t_ms) return false;
+    }
+
+    Candle next;
+    next.t_ms = open_ms;
+    next.o = p;
+    next.h = p;
+    next.l = p;
+    next.c = p;
+    push(next);
+    return true;
+}
+
+void CandleRing::push(const Candle& c) {
+    buf_[count_ & (kCapacity - 1)] = c;
+    count_++;
+}
+
+void CandleRing::seed(const Candle* hist, int n) {
+    if (!hist || n <= 0) return;
+    const long long hist_last = hist[n - 1].t_ms;
+
+    Candle live[kCapacity];
+    int n_live = 0;
+    for (int i = 0; i < size(); i++) {
+        if (at(i).t_ms > hist_last) live[n_live++] = at(i);
+    }
+
+    count_ = 0;
+    for (int i = (n > (int)kCapacity) ? (n - (int)kCapacity) : 0; i < n; i++) push(hist[i]);
+    for (int i = 0; i < n_live; i++) push(live[i]);
+}
+
+void CandleRing::merge(const Candle& c) {
+    if (c.t_ms <= 0 || !(c.c > 0.0f)) return;
+    if (count_ > 0) {
+        Candle& cur = buf_[(count_ - 1) & (kCapacity - 1)];
+        if (c.t_ms == cur.t_ms) {
+            // Trades can print outside the mids seen so far, and vice versa.
+            cur.o = c.o;
+            if (c.h > cur.h) cur.h = c.h;
+            if (c.l < cur.l) cur.l = c.l;
+            cur.c = c.c;
+            return;
+        }
+        if (c.t_ms < cur.t_ms) return;
+    }
+    push(c);
+}
+
+const Candle& CandleRing::at(int i) const {
+    const unsigned first = (count_ > kCapacity) ? (count_ - kCapacity) : 0u;
+    return buf_[(first + (unsigned)i) & (kCapacity - 1)];
+}
+
+bool CoinCandles::update(long long t_ms, double px) {
+    bool changed = false;
+    for (int i = 0; i < kCandleResCount; i++) {
+        if (res[i].update(t_ms, candle_res_ms((CandleRes)i), px)) changed = true;
+    }
+    return changed;
+}
+
+} // namespace tradeboy::model
@@ -0,0 +1,60 @@
+#pragma once
+
+namespace tradeboy::model {
+
+enum class CandleRes {
+    M1 = 0,
+    M5 = 1,
+    H1 = 2,
+    D1 = 3,
+};
+
+static const int kCandleResCount = 4;
+
+long long candle_res_ms(CandleRes res);
+
+struct Candle {
+    long long t_ms = 0; // bucket open time
+    float o = 0.0f;
+    float h = 0.0f;
+    float l = 0.0f;
+    float c = 0.0f;
+};
+
+// Fixed-capacity ring of candles at one resolution, oldest first via at().
+// A tick either extends the newest candle or opens the next one: O(1).
+struct CandleRing {
+    static const unsigned kCapacity = 128; // power of two
+
+    // False when the tick left every candle as it was.
+    bool update(long long t_ms, long long res_ms, double px);
+    // Replaces the contents with history (oldest first), keeping any live
+    // candles newer than the last historical one.
+    void seed(const Candle* hist, int n);
+    // Folds a streamed exchange candle into the newest bucket (or opens the
+    // next one); candles older than the newest are ignored.
+    void merge(const Candle& c);
+
+    int size() const { return (int)(count_ < kCapacity ? count_ : kCapacity); }
+    // i in [0, size()), 0 = oldest retained candle.
+    const Candle& at(int i) const;
+    const Candle* last() const { return count_ ? &buf_[(count_ - 1) & (kCapacity - 1)] : nullptr; }
+
+private:
+    void push(const Candle& c);
+
+    Candle buf_[kCapacity];
+    unsigned count_ = 0; // candles ever opened
+};
+
+// All resolutions for one coin (~12 KB, fixed).
+struct CoinCandles {
+    CandleRing res[kCandleResCount];
+
+    // False when no resolution changed.
+    bool update(long long t_ms, double px);
+    const CandleRing& ring(CandleRes r) const { return res[(int)r]; }
+    CandleRing& ring(CandleRes r) { return res[(int)r]; }
+};
+
+} // namespace tradeboy::model
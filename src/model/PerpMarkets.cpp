@@ -0,0 +1,131 @@
+#include "PerpMarkets.h"
+
+#include "utils/JsonScan.h"
+
+namespace tradeboy::model {
+
+using tradeboy::utils::JsonScan;
+
+void PerpMarketTable::reset(const std::vector<PerpMarketMeta>& metas, const std::vector<PerpAssetCtx>& ctxs) {
+    const size_t n = metas.size();
+    name.assign(n, std::string());
+    sz_decimals.assign(n, 0);
+    max_leverage.assign(n, 1);
+    mark_px.assign(n, 0.0);
+    oracle_px.assign(n, 0.0);
+    mid_px.assign(n, 0.0);
+    prev_day_px.assign(n, 0.0);
+    funding.assign(n, 0.0);
+    open_interest.assign(n, 0.0);
+    day_ntl_vlm.assign(n, 0.0);
+    order_.clear();
+    index_.clear();
+    index_.reserve(n);
+
+    for (size_t i = 0; i < n; i++) {
+        const PerpMarketMeta& m = metas[i];
+        name[i] = m.name;
+        sz_decimals[i] = m.sz_decimals;
+        max_leverage[i] = m.max_leverage;
+        index_[m.name] = (int)i;
+        if (!m.delisted) order_.push_back((int)i);
+        if (i < ctxs.size()) apply_ctx((int)i, ctxs[i]);
+    }
+    resort();
+}
+
+bool PerpMarketTable::same_universe(const std::vector<PerpMarketMeta>& metas) const {
+    if (metas.size() != name.size()) return false;
+    for (size_t i = 0; i < metas.size(); i++) {
+        if (metas[i].name != name[i]) return false;
+    }
+    return true;
+}
+
+int PerpMarketTable::find(const char* coin, size_t n) const {
+    key_.assign(coin, n);
+    auto it = index_.find(key_);
+    return it == index_.end() ? -1 : it->second;
+}
+
+void PerpMarketTable::apply_ctx(int asset, const PerpAssetCtx& ctx) {
+    if (asset < 0 || asset >= size()) return;
+    const size_t i = (size_t)asset;
+    if (ctx.mark_px > 0.0) mark_px[i] = ctx.mark_px;
+    if (ctx.oracle_px > 0.0) oracle_px[i] = ctx.oracle_px;
+    if (ctx.mid_px > 0.0) mid_px[i] = ctx.mid_px;
+    if (ctx.prev_day_px > 0.0) prev_day_px[i] = ctx.prev_day_px;
+    funding[i] = ctx.funding;
+    open_interest[i] = ctx.open_interest;
+    day_ntl_vlm[i] = ctx.day_ntl_vlm;
+}
+
+size_t PerpMarketTable::apply_all_mids_json(const char* json, size_t len) {
+    if (!json || len == 0 || name.empty()) return 0;
+    JsonScan sc(json, len);
+    if (!sc.eat('{')) return 0;
+    if (sc.eat('}')) return 0;
+    size_t applied = 0;
+    while (true) {
+        const char* k;
+        size_t kn;
+        if (!sc.str(k, kn) || !sc.eat(':')) break;
+        // Spot mids are keyed "@idx" / "PURR/USDC"; skip them without a lookup.
+        const int asset = (kn > 0 && k[0] != '@') ? find(k, kn) : -1;
+        if (asset >= 0) {
+            double px = 0.0;
+            if (!sc.number(px)) break;
+            if (px > 0.0) {
+                mid_px[(size_t)asset] = px;
+                applied++;
+            }
+        } else if (!sc.skip_value()) {
+            break;
+        }
+        if (!sc.eat(',')) break;
+    }
+    return applied;
+}
+
+bool PerpMarketTable::resort() {
+    bool changed = false;
+    const size_t n = order_.size();
+    for (size_t i = 1; i < n; i++) {
+        const int a = order_[i];
+        const double v = day_ntl_vlm[(size_t)a];
+        size_t j = i;
+        // Ties keep universe order so equal rows never swap back and forth.
+        while (j > 0) {
+            const int b = order_[j - 1];
+            const double bv = day_ntl_vlm[(size_t)b];
+            if (bv > v || (bv == v && b < a)) break;
+            order_[j] = b;
+            j--;
+        }
+        if (j != i) {
+            order_[j] = a;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+PerpRow PerpMarketTable::row(int asset) const {
+    PerpRow r;
+    if (asset < 0 || asset >= size()) return r;
+    const size_t i = (size_t)asset;
+    r.name = name[i];
+    r.asset = asset;
+    r.sz_decimals = sz_decimals[i];
+    r.max_leverage = max_leverage[i];
+    r.ctx.mark_px = mark_px[i];
+    r.ctx.oracle_px = oracle_px[i];
+    r.ctx.mid_px = mid_px[i];
+    r.ctx.prev_day_px = prev_day_px[i];
+    r.ctx.funding = funding[i];
+    r.ctx.open_interest = open_interest[i];
+    r.ctx.day_ntl_vlm = day_ntl_vlm[i];
+    return r;
+}
+
+} // namespace tradeboy::model
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tradeboy::model {
+
+struct PerpMarketMeta {
+    std::string name;
+    int sz_decimals = 0;
+    int max_leverage = 1;
+    bool delisted = false;
+};
+
+// Fields of one asset context (metaAndAssetCtxs / activeAssetCtx). Prices of 0
+// mean "not quoted".
+struct PerpAssetCtx {
+    double mark_px = 0.0;
+    double oracle_px = 0.0;
+    double mid_px = 0.0;
+    double prev_day_px = 0.0;
+    double funding = 0.0;       // hourly rate
+    double open_interest = 0.0; // in coins
+    double day_ntl_vlm = 0.0;
+};
+
+// One activeAssetCtx update as queued by the WS thread.
+struct PerpCtxUpdate {
+    char coin[16] = {0};
+    PerpAssetCtx ctx;
+};
+
+// Row copy handed to the UI (display order).
+struct PerpRow {
+    std::string name;
+    int asset = -1; // perp asset id = universe index
+    int sz_decimals = 0;
+    int max_leverage = 1;
+    PerpAssetCtx ctx;
+};
+
+// Perp markets stored column-wise, indexed by asset id. A tick touches a few
+// doubles in separate arrays, and re-sorting only permutes the order index,
+// so 200+ markets at the full feed rate stay cheap on the device.
+struct PerpMarketTable {
+    // Replaces the universe. Contexts (same order as metas) are optional.
+    void reset(const std::vector<PerpMarketMeta>& metas, const std::vector<PerpAssetCtx>& ctxs);
+    // True if metas describe the markets already held (same names, same order).
+    bool same_universe(const std::vector<PerpMarketMeta>& metas) const;
+
+    int size() const { return (int)name.size(); }
+    int find(const char* coin, size_t n) const; // asset id or -1
+
+    void apply_ctx(int asset, const PerpAssetCtx& ctx);
+    // Walks an allMids object ({"BTC":"97000.5",...}) once, updating the mid of
+    // every known perp. Returns the number of mids applied.
+    size_t apply_all_mids_json(const char* json, size_t len);
+
+    // Insertion sort of the display order by 24h notional volume. The order
+    // is nearly sorted between calls, so this is close to O(n). Returns true
+    // if the order changed.
+    bool resort();
+    const std::vector<int>& order() const { return order_; } // listed markets only
+
+    PerpRow row(int asset) const;
+
+    // Columns.
+    std::vector<std::string> name;
+    std::vector<int> sz_decimals;
+    std::vector<int> max_leverage;
+    std::vector<double> mark_px;
+    std::vector<double> oracle_px;
+    std::vector<double> mid_px;
+    std::vector<double> prev_day_px;
+    std::vector<double> funding;
+    std::vector<double> open_interest;
+    std::vector<double> day_ntl_vlm;
+
+private:
+    std::vector<int> order_;
+    std::unordered_map<std::string, int> index_;
+    mutable std::string key_; // lookup scratch; capacity is reused
+};
+
+} // namespace tradeboy::model
@@ -0,0 +1,121 @@
+#include "PerpPositions.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tradeboy::model {
+
+void PerpPositionBook::reset(const PerpAccountState& st, const PerpMarketTable& markets) {
+    pos_.clear();
+    ok_ = true;
+    account_value_poll_ = st.account_value;
+    cross_value_poll_ = st.cross_account_value;
+    withdrawable_ = st.withdrawable;
+    upnl_poll_ = 0.0;
+    cross_upnl_poll_ = 0.0;
+    upnl_ = 0.0;
+    cross_upnl_ = 0.0;
+    cross_maint_ = 0.0;
+
+    for (const PerpPositionState& s : st.positions) {
+        if (s.szi == 0.0) continue;
+        Position p;
+        p.st = s;
+        upnl_poll_ += s.unrealized_pnl;
+        if (s.cross) cross_upnl_poll_ += s.unrealized_pnl;
+        pos_.push_back(p);
+    }
+    reindex(markets);
+}
+
+void PerpPositionBook::reindex(const PerpMarketTable& markets) {
+    slot_by_asset_.assign((size_t)markets.size(), -1);
+    for (size_t i = 0; i < pos_.size(); i++) {
+        Position& p = pos_[i];
+        p.asset = markets.find(p.st.coin.data(), p.st.coin.size());
+        p.max_leverage = std::max(1, (int)std::ceil(p.st.leverage));
+        double mark = p.st.entry_px;
+        if (p.asset >= 0) {
+            slot_by_asset_[(size_t)p.asset] = (int)i;
+            p.max_leverage = std::max(1, markets.max_leverage[(size_t)p.asset]);
+            if (markets.mark_px[(size_t)p.asset] > 0.0) mark = markets.mark_px[(size_t)p.asset];
+        }
+        // Drop this position's old contribution before re-marking from scratch.
+        upnl_ -= p.upnl;
+        if (p.st.cross) {
+            cross_upnl_ -= p.upnl;
+            cross_maint_ -= p.maint;
+        }
+        p.upnl = 0.0;
+        p.maint = 0.0;
+        remark(p, mark);
+    }
+}
+
+void PerpPositionBook::remark(Position& p, double mark_px) {
+    const double upnl = p.st.szi * (mark_px - p.st.entry_px) + 0.0; // no "-0.00" for shorts at entry
+    const double value = std::fabs(p.st.szi) * mark_px;
+    const double maint = value / (2.0 * (double)p.max_leverage);
+    upnl_ += upnl - p.upnl;
+    if (p.st.cross) {
+        cross_upnl_ += upnl - p.upnl;
+        cross_maint_ += maint - p.maint;
+    }
+    p.mark_px = mark_px;
+    p.upnl = upnl;
+    p.value = value;
+    p.maint = maint;
+}
+
+bool PerpPositionBook::on_mark(int asset, double mark_px) {
+    if (!has_asset(asset) || !(mark_px > 0.0)) return false;
+    Position& p = pos_[(size_t)slot_by_asset_[(size_t)asset]];
+    if (p.mark_px == mark_px) return false;
+    remark(p, mark_px);
+    return true;
+}
+
+// Exchange formula: liq = mark - side * margin_available / size / (1 - l * side)
+// with l = 1 / maintenance leverage. Cross positions share the cross margin.
+double PerpPositionBook::liquidation_px(const Position& p) const {
+    const double side = (p.st.szi > 0.0) ? 1.0 : -1.0;
+    const double size = std::fabs(p.st.szi);
+    const double l = 1.0 / (2.0 * (double)p.max_leverage);
+    double margin_available = 0.0;
+    if (p.st.cross) {
+        margin_available = (cross_value_poll_ + cross_upnl_ - cross_upnl_poll_) - cross_maint_;
+    } else {
+        margin_available = (p.st.margin_used + p.upnl - p.st.unrealized_pnl) - p.maint;
+    }
+    const double liq = p.mark_px - side * margin_available / size / (1.0 - l * side);
+    return (std::isfinite(liq) && liq > 0.0) ? liq : 0.0;
+}
+
+void PerpPositionBook::publish(std::vector<PerpPositionRow>& out_rows, PerpAccountTotals& out_totals) const {
+    out_rows.clear();
+    out_rows.reserve(pos_.size());
+    for (const Position& p : pos_) {
+        PerpPositionRow r;
+        r.coin = p.st.coin;
+        r.asset = p.asset;
+        r.szi = p.st.szi;
+        r.entry_px = p.st.entry_px;
+        r.leverage = p.st.leverage;
+        r.cross = p.st.cross;
+        r.mark_px = p.mark_px;
+        r.position_value = p.value;
+        r.unrealized_pnl = p.upnl;
+        r.liquidation_px = liquidation_px(p);
+        out_rows.push_back(r);
+    }
+
+    out_totals = PerpAccountTotals();
+    out_totals.ok = ok_;
+    out_totals.account_value = account_value_poll_ + upnl_ - upnl_poll_;
+    out_totals.unrealized_pnl = upnl_;
+    out_totals.withdrawable = withdrawable_;
+    const double cross_value = cross_value_poll_ + cross_upnl_ - cross_upnl_poll_;
+    out_totals.cross_margin_ratio = (cross_value > 0.0) ? (cross_maint_ / cross_value) : 0.0;
+}
+
+} // namespace tradeboy::model
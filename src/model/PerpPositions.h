@@ -0,0 +1,104 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "PerpMarkets.h"
+
+namespace tradeboy::model {
+
+// One assetPositions entry of clearinghouseState, as polled.
+struct PerpPositionState {
+    std::string coin;
+    double szi = 0.0;        // signed size, + long / - short
+    double entry_px = 0.0;
+    double leverage = 0.0;
+    bool cross = true;
+    double margin_used = 0.0;
+    double unrealized_pnl = 0.0;
+};
+
+// Margin summary of clearinghouseState plus its positions.
+struct PerpAccountState {
+    double account_value = 0.0;
+    double cross_account_value = 0.0;
+    double withdrawable = 0.0;
+    std::vector<PerpPositionState> positions;
+};
+
+// Published per position (PerpSnapshot).
+struct PerpPositionRow {
+    std::string coin;
+    int asset = -1;
+    double szi = 0.0;
+    double entry_px = 0.0;
+    double leverage = 0.0;
+    bool cross = true;
+    double mark_px = 0.0;
+    double position_value = 0.0;
+    double unrealized_pnl = 0.0;
+    double liquidation_px = 0.0; // 0 = cannot be liquidated at any positive price
+};
+
+struct PerpAccountTotals {
+    bool ok = false;          // a clearinghouseState has been applied
+    double account_value = 0.0; // marked to the latest marks
+    double unrealized_pnl = 0.0;
+    double withdrawable = 0.0;
+    double cross_margin_ratio = 0.0; // cross maintenance margin / cross account value
+};
+
+// Open positions in a flat table with a per-asset slot index. A mark tick
+// goes straight to the position on that asset (if any) and updates its pnl,
+// value and maintenance margin plus running account sums, so a tick costs
+// O(1) no matter how many positions or markets there are. Liquidation prices
+// depend only on a position and those sums, so they are derived when the
+// snapshot is published rather than on every tick.
+//
+// Maintenance margin is taken as half the initial margin at max leverage,
+// which is the exchange's rule for single-tier markets.
+struct PerpPositionBook {
+    // Replaces positions with a fresh poll. Marks and max leverage come from
+    // the market table (falling back to entry price / position leverage).
+    void reset(const PerpAccountState& st, const PerpMarketTable& markets);
+    // Re-resolves asset ids after the perp universe was rebuilt.
+    void reindex(const PerpMarketTable& markets);
+
+    bool has_asset(int asset) const {
+        return asset >= 0 && asset < (int)slot_by_asset_.size() && slot_by_asset_[(size_t)asset] >= 0;
+    }
+    // Returns true if a position on the asset was re-marked.
+    bool on_mark(int asset, double mark_px);
+
+    size_t size() const { return pos_.size(); }
+    void publish(std::vector<PerpPositionRow>& out_rows, PerpAccountTotals& out_totals) const;
+
+private:
+    struct Position {
+        PerpPositionState st;
+        int asset = -1;
+        int max_leverage = 1;
+        double mark_px = 0.0;
+        double upnl = 0.0;
+        double value = 0.0;
+        double maint = 0.0;
+    };
+
+    void remark(Position& p, double mark_px);
+    double liquidation_px(const Position& p) const;
+
+    std::vector<Position> pos_;
+    std::vector<int> slot_by_asset_; // asset id -> index into pos_, or -1
+
+    bool ok_ = false;
+    double account_value_poll_ = 0.0;
+    double cross_value_poll_ = 0.0;
+    double withdrawable_ = 0.0;
+    double upnl_poll_ = 0.0;       // sum of polled pnl (all positions)
+    double cross_upnl_poll_ = 0.0;
+    double upnl_ = 0.0;            // running sums at the latest marks
+    double cross_upnl_ = 0.0;
+    double cross_maint_ = 0.0;
+};
+
+} // namespace tradeboy::model
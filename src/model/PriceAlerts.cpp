@@ -0,0 +1,138 @@
+#include "PriceAlerts.h"
+
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+namespace tradeboy::model {
+
+static std::string lower(std::string s) {
+    for (char& c : s) c = (char)std::tolower((unsigned char)c);
+    return s;
+}
+
+bool parse_price_alert(const std::string& s, PriceAlert& out) {
+    std::istringstream ss(s);
+    std::string coin, kind, value, extra;
+    if (!(ss >> coin >> kind >> value) || (ss >> extra)) return false;
+
+    const std::string k = lower(kind);
+    if (k == "above") out.kind = PriceAlertKind::Above;
+    else if (k == "below") out.kind = PriceAlertKind::Below;
+    else if (k == "move") out.kind = PriceAlertKind::Move;
+    else return false;
+
+    char* end = nullptr;
+    const double v = std::strtod(value.c_str(), &end);
+    if (!end || *end != 0 || !std::isfinite(v)) return false;
+    if (out.kind != PriceAlertKind::Move && !(v > 0.0)) return false;
+    if (out.kind == PriceAlertKind::Move && v == 0.0) return false;
+
+    out.coin = coin;
+    out.value = v;
+    return true;
+}
+
+std::string format_price_alert(const PriceAlert& a) {
+    const char* kind = "above";
+    if (a.kind == PriceAlertKind::Below) kind = "below";
+    else if (a.kind == PriceAlertKind::Move) kind = "move";
+    char buf[96];
+    std::snprintf(buf, sizeof(buf), "%s %s %.10g", a.coin.c_str(), kind, a.value);
+    return std::string(buf);
+}
+
+std::string describe_price_alert(const PriceAlert& a) {
+    char buf[96];
+    if (a.kind == PriceAlertKind::Move) {
+        std::snprintf(buf, sizeof(buf), "%s %+.4g%% 24H", a.coin.c_str(), a.value);
+    } else {
+        std::snprintf(buf, sizeof(buf), "%s %s %.10g", a.coin.c_str(), (a.kind == PriceAlertKind::Above) ? "ABOVE" : "BELOW", a.value);
+    }
+    return std::string(buf);
+}
+
+void PriceAlertEngine::set_alerts(const std::vector<PriceAlert>& alerts) {
+    alerts_ = alerts;
+    coins_.clear();
+
+    std::vector<int> slot(alerts_.size(), 0);
+    for (size_t i = 0; i < alerts_.size(); i++) {
+        size_t c = 0;
+        while (c < coins_.size() && coins_[c] != alerts_[i].coin) c++;
+        if (c == coins_.size()) coins_.push_back(alerts_[i].coin);
+        slot[i] = (int)c;
+    }
+
+    const size_t nc = coins_.size();
+    const size_t n = alerts_.size();
+    vals_.assign(2 * nc, 0.0f);
+    valid_.assign(2 * nc, 0);
+    src_.assign(n, 0);
+    sign_.assign(n, 1.0f);
+    thr_.assign(n, 0.0f);
+    armed_.assign(n, 0);
+    cur_.assign(n, 0.0f);
+    cur_ok_.assign(n, 0);
+    fire_.assign(n, 0);
+
+    for (size_t i = 0; i < n; i++) {
+        const PriceAlert& a = alerts_[i];
+        const bool move = (a.kind == PriceAlertKind::Move);
+        src_[i] = move ? (int)nc + slot[i] : slot[i];
+        sign_[i] = (a.kind == PriceAlertKind::Below || (move && a.value < 0.0)) ? -1.0f : 1.0f;
+        thr_[i] = (float)a.value;
+    }
+}
+
+void PriceAlertEngine::set_quote(int slot, double price, double prev_day_px) {
+    const size_t nc = coins_.size();
+    if (slot < 0 || (size_t)slot >= nc) return;
+    const size_t i = (size_t)slot;
+    const bool px_ok = (price > 0.0 && std::isfinite(price));
+    const bool chg_ok = px_ok && prev_day_px > 0.0 && std::isfinite(prev_day_px);
+    vals_[i] = px_ok ? (float)price : 0.0f;
+    valid_[i] = px_ok ? 1 : 0;
+    vals_[nc + i] = chg_ok ? (float)((price - prev_day_px) / prev_day_px * 100.0) : 0.0f;
+    valid_[nc + i] = chg_ok ? 1 : 0;
+}
+
+size_t PriceAlertEngine::evaluate(std::vector<int>& out_fired) {
+    const size_t n = src_.size();
+    if (n == 0) return 0;
+
+    for (size_t i = 0; i < n; i++) {
+        cur_[i] = vals_[(size_t)src_[i]];
+        cur_ok_[i] = valid_[(size_t)src_[i]];
+    }
+
+    // No branches in here so the compiler can vectorize it.
+    const float* cur = cur_.data();
+    const float* sign = sign_.data();
+    const float* thr = thr_.data();
+    const uint8_t* ok = cur_ok_.data();
+    uint8_t* armed = armed_.data();
+    uint8_t* fire = fire_.data();
+    uint8_t any = 0;
+    for (size_t i = 0; i < n; i++) {
+        const uint8_t cond = (uint8_t)(sign[i] * (cur[i] - thr[i]) >= 0.0f) & ok[i];
+        fire[i] = armed[i] & cond;
+        // Unknown quote: keep state. Otherwise armed while the condition is false.
+        armed[i] = (uint8_t)((armed[i] & (ok[i] ^ 1)) | (ok[i] & (cond ^ 1)));
+        any |= fire[i];
+    }
+    if (!any) return 0;
+
+    size_t fired = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (fire[i]) {
+            out_fired.push_back((int)i);
+            fired++;
+        }
+    }
+    return fired;
+}
+
+} // namespace tradeboy::model
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tradeboy::model {
+
+enum class PriceAlertKind {
+    Above, // price >= value
+    Below, // price <= value
+    Move,  // 24h change >= value % (value > 0) or <= value % (value < 0)
+};
+
+// One user alert, as stored in tradeboy.cfg: "alert=BTC above 100000",
+// "alert=ETH below 1800", "alert=HYPE move -5".
+struct PriceAlert {
+    std::string coin; // spot symbol or perp name
+    PriceAlertKind kind = PriceAlertKind::Above;
+    double value = 0.0;
+};
+
+// Parses the part after "alert=". Returns false for malformed lines.
+bool parse_price_alert(const std::string& s, PriceAlert& out);
+// Inverse of parse_price_alert.
+std::string format_price_alert(const PriceAlert& a);
+// Short upper-case line for the alert dialog, e.g. "BTC ABOVE 100000".
+std::string describe_price_alert(const PriceAlert& a);
+
+// Alerts kept column-wise next to a dense per-coin quote table. Every alert
+// is reduced to "sign * (value[src] - threshold) >= 0" over one source
+// column (price or 24h %), so a tick is a gather plus one branch-free pass
+// over flat float/byte arrays, no matter the mix of alert kinds.
+//
+// An alert fires when its condition becomes true and re-arms once the
+// condition is false again. Alerts start disarmed and arm on the first
+// valid quote, so a condition that already holds at startup (or when the
+// alert is added) does not fire until it is crossed again.
+struct PriceAlertEngine {
+    void set_alerts(const std::vector<PriceAlert>& alerts);
+    const std::vector<PriceAlert>& alerts() const { return alerts_; }
+
+    // Distinct coins of all alerts; the index is the coin slot for set_quote.
+    const std::vector<std::string>& coins() const { return coins_; }
+    // price <= 0 marks the coin as unknown; its alerts hold their state.
+    void set_quote(int slot, double price, double prev_day_px);
+
+    // Appends indices of alerts that fired on this pass.
+    size_t evaluate(std::vector<int>& out_fired);
+
+private:
+    std::vector<PriceAlert> alerts_;
+    std::vector<std::string> coins_;
+
+    // Quote columns: [price of every coin | 24h % of every coin].
+    std::vector<float> vals_;
+    std::vector<uint8_t> valid_;
+
+    // Per alert.
+    std::vector<int> src_;    // index into vals_
+    std::vector<float> sign_; // +1 for >=, -1 for <=
+    std::vector<float> thr_;
+    std::vector<uint8_t> armed_;
+
+    // Scratch for evaluate().
+    std::vector<float> cur_;
+    std::vector<uint8_t> cur_ok_;
+    std::vector<uint8_t> fire_;
+};
+
+} // namespace tradeboy::model
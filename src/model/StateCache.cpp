@@ -0,0 +1,312 @@
+#include "StateCache.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "TradeModel.h"
+
+namespace tradeboy::model {
+
+static const char kStateMagic[8] = {'T', 'B', 'S', 'T', 'A', 'T', 'E', 0};
+static const unsigned int kStateVersion = 1;
+
+enum : unsigned int {
+    kStateHasAccount = 1u << 0,
+};
+
+struct StateStr {
+    unsigned int off;
+    unsigned int len;
+};
+
+struct StateFileHeader {
+    char magic[8];
+    unsigned int version;
+    unsigned int n_rows;
+    int spot_row_idx;
+    unsigned int str_len;
+    unsigned int checksum; // FNV-1a of everything after the header
+    unsigned int flags;
+    long long saved_ms;
+};
+
+enum {
+    kAcctUsdc = 0,
+    kAcctPerpUsdc,
+    kAcctTotal,
+    kAcctPnl24h,
+    kAcctPnl24hPct,
+    kAcctPnl7d,
+    kAcctPnl30d,
+    kAcctFieldCount,
+};
+
+struct StateAccountRecord {
+    double v[kAcctFieldCount];
+    StateStr s[kAcctFieldCount];
+};
+
+struct StateRowRecord {
+    double price;
+    double prev_price;
+    double prev_day_px;
+    double day_base_vlm;
+    double day_ntl_vlm;
+    double balance;
+    double entry_price;
+    int price_decimals;
+    int asset_id;
+    int sz_decimals;
+    int reserved;
+    StateStr coin;
+    StateStr sym;
+};
+
+static_assert(sizeof(StateFileHeader) == 40, "state header layout");
+static_assert(sizeof(StateAccountRecord) == 112, "state account layout");
+static_assert(sizeof(StateRowRecord) == 88, "state row layout");
+
+static const unsigned int kMaxRows = 4096;
+static const unsigned int kMaxStrTable = 1u << 20;
+
+static unsigned int fnv1a(const char* p, size_t n) {
+    unsigned int h = 2166136261u;
+    for (size_t i = 0; i < n; i++) {
+        h ^= (unsigned char)p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static long long wall_ms() {
+    return (long long)std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+static StateStr add_str(std::string& table, const std::string& s) {
+    StateStr r;
+    r.off = (unsigned int)table.size();
+    r.len = (unsigned int)s.size();
+    table.append(s);
+    return r;
+}
+
+// UNKNOWN / empty means the field was never fetched; don't persist it as data.
+static bool has_value(const std::string& s) {
+    return !s.empty() && s != "UNKNOWN";
+}
+
+bool save_state_cache(const TradeModel& model, const std::string& path, std::string& out_err) {
+    const TradeModelSnapshot snap = model.snapshot();
+    if (snap.spot_rows.empty()) {
+        out_err = "state_cache_no_rows";
+        return false;
+    }
+    const AccountSnapshot acct = model.account_snapshot();
+
+    std::string table;
+    StateAccountRecord ar;
+    std::memset(&ar, 0, sizeof(ar));
+    const double vals[kAcctFieldCount] = {acct.hl_usdc,
+                                          acct.hl_perp_usdc,
+                                          acct.hl_total_asset,
+                                          acct.hl_pnl_24h,
+                                          acct.hl_pnl_24h_pct,
+                                          acct.hl_pnl_7d,
+                                          acct.hl_pnl_30d};
+    const std::string* strs[kAcctFieldCount] = {&acct.hl_usdc_str,
+                                                &acct.hl_perp_usdc_str,
+                                                &acct.hl_total_asset_str,
+                                                &acct.hl_pnl_24h_str,
+                                                &acct.hl_pnl_24h_pct_str,
+                                                &acct.hl_pnl_7d_str,
+                                                &acct.hl_pnl_30d_str};
+    for (int i = 0; i < kAcctFieldCount; i++) {
+        ar.v[i] = vals[i];
+        ar.s[i] = add_str(table, has_value(*strs[i]) ? *strs[i] : std::string());
+    }
+
+    const size_t n = std::min((size_t)kMaxRows, snap.spot_rows.size());
+    std::vector<StateRowRecord> recs(n);
+    for (size_t i = 0; i < n; i++) {
+        const SpotRow& r = snap.spot_rows[i];
+        StateRowRecord& o = recs[i];
+        std::memset(&o, 0, sizeof(o));
+        o.price = r.price;
+        o.prev_price = r.prev_price;
+        o.prev_day_px = r.prev_day_px;
+        o.day_base_vlm = r.day_base_vlm;
+        o.day_ntl_vlm = r.day_ntl_vlm;
+        o.balance = r.balance;
+        o.entry_price = r.entry_price;
+        o.price_decimals = r.price_decimals;
+        o.asset_id = r.asset_id;
+        o.sz_decimals = r.sz_decimals;
+        o.coin = add_str(table, r.coin);
+        o.sym = add_str(table, r.sym);
+    }
+    if (table.size() > kMaxStrTable) {
+        out_err = "state_cache_too_large";
+        return false;
+    }
+
+    std::string body;
+    body.reserve(sizeof(ar) + n * sizeof(StateRowRecord) + table.size());
+    body.append((const char*)&ar, sizeof(ar));
+    body.append((const char*)recs.data(), n * sizeof(StateRowRecord));
+    body.append(table);
+
+    StateFileHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, kStateMagic, sizeof(h.magic));
+    h.version = kStateVersion;
+    h.n_rows = (unsigned int)n;
+    h.spot_row_idx = snap.spot_row_idx;
+    h.str_len = (unsigned int)table.size();
+    h.checksum = fnv1a(body.data(), body.size());
+    bool any_acct = false;
+    for (int i = 0; i < kAcctFieldCount; i++) any_acct = any_acct || ar.s[i].len > 0;
+    h.flags = any_acct ? kStateHasAccount : 0u;
+    h.saved_ms = wall_ms();
+
+    const size_t slash = path.rfind('/');
+    if (slash != std::string::npos && slash > 0 && ::mkdir(path.substr(0, slash).c_str(), 0755) != 0 &&
+        errno != EEXIST) {
+        out_err = "state_cache_dir_failed";
+        return false;
+    }
+
+    const std::string tmp = path + ".tmp";
+    FILE* f = std::fopen(tmp.c_str(), "wb");
+    if (!f) {
+        out_err = "state_cache_open_failed";
+        return false;
+    }
+    bool ok = std::fwrite(&h, sizeof(h), 1, f) == 1 && std::fwrite(body.data(), 1, body.size(), f) == body.size();
+    ok = (std::fflush(f) == 0) && ok;
+    ok = (::fsync(fileno(f)) == 0) && ok;
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        out_err = "state_cache_write_failed";
+        return false;
+    }
+    return true;
+}
+
+static bool str_in(const StateStr& s, unsigned int table_len) {
+    return s.off <= table_len && s.len <= table_len - s.off;
+}
+
+bool load_state_cache(TradeModel& model, const std::string& path, long long& out_age_ms, std::string& out_err) {
+    out_age_ms = 0;
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        out_err = (errno == ENOENT) ? "state_cache_missing" : "state_cache_open_failed";
+        return false;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(StateFileHeader) + sizeof(StateAccountRecord)) {
+        ::close(fd);
+        out_err = "state_cache_short";
+        return false;
+    }
+    const size_t len = (size_t)st.st_size;
+    void* m = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (m == MAP_FAILED) {
+        out_err = "state_cache_mmap_failed";
+        return false;
+    }
+
+    const char* base = (const char*)m;
+    const StateFileHeader* h = (const StateFileHeader*)base;
+    const char* body = base + sizeof(StateFileHeader);
+    const size_t body_len = len - sizeof(StateFileHeader);
+    bool ok = std::memcmp(h->magic, kStateMagic, sizeof(kStateMagic)) == 0 && h->version == kStateVersion &&
+              h->n_rows > 0 && h->n_rows <= kMaxRows && h->str_len <= kMaxStrTable &&
+              body_len == sizeof(StateAccountRecord) + (size_t)h->n_rows * sizeof(StateRowRecord) + h->str_len &&
+              fnv1a(body, body_len) == h->checksum;
+    if (!ok) {
+        ::munmap(m, len);
+        out_err = "state_cache_invalid";
+        return false;
+    }
+
+    const StateAccountRecord* ar = (const StateAccountRecord*)body;
+    const StateRowRecord* recs = (const StateRowRecord*)(body + sizeof(StateAccountRecord));
+    const char* table = body + sizeof(StateAccountRecord) + (size_t)h->n_rows * sizeof(StateRowRecord);
+
+    std::vector<SpotRow> rows;
+    rows.reserve(h->n_rows);
+    for (unsigned int i = 0; i < h->n_rows && ok; i++) {
+        const StateRowRecord& r = recs[i];
+        if (!str_in(r.coin, h->str_len) || !str_in(r.sym, h->str_len) || r.coin.len == 0) {
+            ok = false;
+            break;
+        }
+        SpotRow row(std::string(table + r.coin.off, r.coin.len),
+                    std::string(table + r.sym.off, r.sym.len),
+                    r.price,
+                    r.prev_price,
+                    r.balance,
+                    r.entry_price);
+        row.prev_day_px = r.prev_day_px;
+        row.day_base_vlm = r.day_base_vlm;
+        row.day_ntl_vlm = r.day_ntl_vlm;
+        row.price_decimals = r.price_decimals;
+        row.asset_id = r.asset_id;
+        row.sz_decimals = r.sz_decimals;
+        rows.push_back(row);
+    }
+    std::string s[kAcctFieldCount];
+    double v[kAcctFieldCount];
+    for (int i = 0; i < kAcctFieldCount && ok; i++) {
+        if (!str_in(ar->s[i], h->str_len)) {
+            ok = false;
+            break;
+        }
+        s[i].assign(table + ar->s[i].off, ar->s[i].len);
+        v[i] = ar->v[i];
+    }
+    const int idx = h->spot_row_idx;
+    const unsigned int flags = h->flags;
+    const long long saved_ms = h->saved_ms;
+    ::munmap(m, len);
+    if (!ok) {
+        out_err = "state_cache_invalid";
+        return false;
+    }
+
+    model.set_spot_rows(std::move(rows));
+    model.set_spot_row_idx(idx);
+    if (flags & kStateHasAccount) {
+        if (!s[kAcctUsdc].empty()) model.set_hl_usdc(v[kAcctUsdc], s[kAcctUsdc], true);
+        if (!s[kAcctPerpUsdc].empty()) model.set_hl_perp_usdc(v[kAcctPerpUsdc], s[kAcctPerpUsdc], true);
+        if (!s[kAcctTotal].empty()) {
+            model.set_hl_portfolio(v[kAcctTotal],
+                                   s[kAcctTotal],
+                                   v[kAcctPnl24h],
+                                   s[kAcctPnl24h],
+                                   v[kAcctPnl24hPct],
+                                   s[kAcctPnl24hPct],
+                                   true);
+        }
+        model.set_hl_pnl_windows(v[kAcctPnl7d], s[kAcctPnl7d], v[kAcctPnl30d], s[kAcctPnl30d]);
+    }
+    out_age_ms = wall_ms() - saved_ms;
+    return true;
+}
+
+} // namespace tradeboy::model
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string>
+
+namespace tradeboy::model {
+
+struct TradeModel;
+
+// Warm-start snapshot of the model: spot rows (symbols, decimals, last prices,
+// balances), the selected row and the Hyperliquid account totals.
+//
+// Layout (native byte order): fixed header, account record, row records, then
+// one string table the records point into. Loading maps the file read-only and
+// rejects it whole on any mismatch (magic, version, sizes, checksum).
+static const char kStateCachePath[] = "./cache/state.bin";
+
+// Writes to path.tmp and renames over path, so a crash never leaves a torn
+// file. Saves nothing until the model has spot rows.
+bool save_state_cache(const TradeModel& model, const std::string& path, std::string& out_err);
+
+// Applies a saved snapshot to the model. out_age_ms is how old the snapshot is.
+bool load_state_cache(TradeModel& model, const std::string& path, long long& out_age_ms, std::string& out_err);
+
+} // namespace tradeboy::model
@@ -1,6 +1,8 @@
 #include "TradeModel.h"
 
 #include <algorithm>
+#include <chrono>
+#include <cstring>
 
 #include "../market/Hyperliquid.h"
 
@@ -10,11 +12,27 @@ namespace tradeboy::model {
 
 TradeModel::TradeModel() {
     log_str("[Model] ctor\n");
+    for (int i = 0; i < kModelSectionCount; i++) versions_[i].store(1, std::memory_order_relaxed);
 }
 
 TradeModel::~TradeModel() {
 }
 
+void TradeModel::set_change_listener(std::function<void(unsigned section_mask)> fn) {
+    change_listener_ = std::move(fn);
+}
+
+void TradeModel::mark_changed(unsigned section_mask) {
+    if (section_mask == 0) return;
+    for (int i = 0; i < kModelSectionCount; i++) {
+        if (section_mask & (1u << i)) versions_[i].fetch_add(1, std::memory_order_acq_rel);
+    }
+}
+
+void TradeModel::notify_changed(unsigned section_mask) {
+    if (section_mask != 0 && change_listener_) change_listener_(section_mask);
+}
+
 TradeModelSnapshot TradeModel::snapshot() const {
     int rc = pthread_mutex_lock(&mu);
     if (rc != 0) {
@@ -56,6 +74,10 @@ AccountSnapshot TradeModel::account_snapshot() const {
     a.hl_pnl_24h = hl_pnl_24h_;
     a.hl_pnl_24h_pct_str = hl_pnl_24h_pct_str_;
     a.hl_pnl_24h_pct = hl_pnl_24h_pct_;
+    a.hl_pnl_7d_str = hl_pnl_7d_str_;
+    a.hl_pnl_7d = hl_pnl_7d_;
+    a.hl_pnl_30d_str = hl_pnl_30d_str_;
+    a.hl_pnl_30d = hl_pnl_30d_;
     a.arb_eth_str = arb_eth_str_;
     a.arb_usdc_str = arb_usdc_str_;
     a.arb_gas_str = arb_gas_str_;
@@ -65,10 +87,17 @@ AccountSnapshot TradeModel::account_snapshot() const {
     return a;
 }
 
-std::string TradeModel::hl_perp_meta_json() const {
+PerpSnapshot TradeModel::perp_snapshot() const {
     int rc = pthread_mutex_lock(&mu);
-    if (rc != 0) return std::string();
-    std::string s = hl_perp_meta_ok_ ? hl_perp_meta_json_ : std::string();
+    if (rc != 0) {
+        return PerpSnapshot();
+    }
+    PerpSnapshot s;
+    s.perp_row_idx = perp_row_idx_;
+    const std::vector<int>& order = perp_.order();
+    s.rows.reserve(order.size());
+    for (int asset : order) s.rows.push_back(perp_.row(asset));
+    perp_positions_.publish(s.positions, s.account);
     pthread_mutex_unlock(&mu);
     return s;
 }
@@ -86,17 +115,99 @@ void TradeModel::set_wallet(const std::string& wallet_address, const std::string
     if (rc != 0) {
         return;
     }
+    const bool changed = (wallet_address_ != wallet_address || private_key_ != private_key);
     wallet_address_ = wallet_address;
     private_key_ = private_key;
+    const unsigned mask = changed ? model_section_bit(ModelSection::Wallet) : 0u;
+    mark_changed(mask);
+    pthread_mutex_unlock(&mu);
+    notify_changed(mask);
+}
+
+void TradeModel::set_perp_markets(const std::vector<PerpMarketMeta>& metas, const std::vector<PerpAssetCtx>& ctxs) {
+    int rc = pthread_mutex_lock(&mu);
+    if (rc != 0) return;
+    if (perp_.same_universe(metas)) {
+        for (size_t i = 0; i < ctxs.size() && i < metas.size(); i++) {
+            perp_.apply_ctx((int)i, ctxs[i]);
+            perp_positions_.on_mark((int)i, perp_.mark_px[i]);
+        }
+        const unsigned ctx_mask = ctxs.empty() ? 0u : model_section_bit(ModelSection::Perp);
+        mark_changed(ctx_mask);
+        pthread_mutex_unlock(&mu);
+        notify_changed(ctx_mask);
+        sort_perp_rows();
+        return;
+    }
+    perp_.reset(metas, ctxs);
+    perp_positions_.reindex(perp_);
+    bind_price_alerts();
+    perp_row_idx_ = 0;
+    const unsigned mask = model_section_bit(ModelSection::Perp);
+    mark_changed(mask);
+    pthread_mutex_unlock(&mu);
+    notify_changed(mask);
+}
+
+size_t TradeModel::apply_perp_ctx_updates(const PerpCtxUpdate* updates, size_t n) {
+    int rc = pthread_mutex_lock(&mu);
+    if (rc != 0) return 0;
+    size_t applied = 0;
+    for (size_t i = 0; i < n; i++) {
+        const int asset = perp_.find(updates[i].coin, std::strlen(updates[i].coin));
+        if (asset < 0) continue;
+        perp_.apply_ctx(asset, updates[i].ctx);
+        perp_positions_.on_mark(asset, perp_.mark_px[(size_t)asset]);
+        applied++;
+    }
+    const unsigned mask = (applied > 0) ? model_section_bit(ModelSection::Perp) : 0u;
+    mark_changed(mask);
     pthread_mutex_unlock(&mu);
+    notify_changed(mask);
+    return applied;
 }
 
-void TradeModel::set_hl_perp_meta_json(const std::string& json, bool ok) {
+void TradeModel::set_perp_account_state(const PerpAccountState& st) {
     int rc = pthread_mutex_lock(&mu);
     if (rc != 0) return;
-    hl_perp_meta_ok_ = ok;
-    hl_perp_meta_json_ = ok ? json : std::string();
+    perp_positions_.reset(st, perp_);
+    const unsigned mask = model_section_bit(ModelSection::Perp);
+    mark_changed(mask);
     pthread_mutex_unlock(&mu);
+    notify_changed(mask);
+}
+
+void TradeModel::set_perp_row_idx(int idx) {
+    int rc = pthread_mutex_lock(&mu);
+    if (rc != 0) return;
+    const int n = (int)perp_.order().size();
+    const int prev = perp_row_idx_;
+    perp_row_idx_ = (n == 0) ? 0 : std::max(0, std::min(n - 1, idx));
+    const unsigned mask = (perp_row_idx_ != prev) ? model_section_bit(ModelSection::Perp) : 0u;
+    mark_changed(mask);
+    pthread_mutex_unlock(&mu);
+    notify_changed(mask);
+}
+
+void TradeModel::sort_perp_rows() {
+    int rc = pthread_mutex_lock(&mu);
+    if (rc != 0) return;
+    const std::vector<int>& order = perp_.order();
+    const int n = (int)order.size();
+    const int selected = (perp_row_idx_ >= 0 && perp_row_idx_ < n) ? order[(size_t)perp_row_idx_] : -1;
+    const bool moved = perp_.resort();
+    if (moved && selected >= 0) {
+        for (int i = 0; i < n; i++) {
+            if (order[(size_t)i] == selected) {
+                perp_row_idx_ = i;
+                break;
+            }
+        }
+    }
+    const unsigned mask = moved ? model_section_bit(ModelSection::Perp) : 0u;
+    mark_changed(mask);
+    pthread_mutex_unlock(&mu);
+    notify_changed(mask);
 }
 
 void TradeModel::set_hl_spot_meta_json(const std::string& json, bool ok) {
@@ -118,13 +229,39 @@ void TradeModel::set_hl_portfolio(double total_asset,
     if (rc != 0) {
         return;
     }
+    const std::string prev_total = hl_total_asset_str_;
+    const std::string prev_pnl = hl_pnl_24h_str_;
+    const std::string prev_pct = hl_pnl_24h_pct_str_;
     hl_total_asset_ = ok ? total_asset : 0.0;
     hl_total_asset_str_ = ok ? total_asset_str : std::string("UNKNOWN");
     hl_pnl_24h_ = ok ? pnl_24h : 0.0;
     hl_pnl_24h_str_ = ok ? pnl_24h_str : std::string("UNKNOWN");
     hl_pnl_24h_pct_ = ok ? pnl_24h_pct : 0.0;
     hl_pnl_24h_pct_str_ = ok ? pnl_24h_pct_str : std::string("UNKNOWN");
+    const bool changed = (prev_total != hl_total_asset_str_ || prev_pnl != hl_pnl_24h_str_ || prev_pct != hl_pnl_24h_pct_str_);
+    const unsigned mask = changed ? model_section_bit(ModelSection::Account) : 0u;
+    mark_changed(mask);
     pthread_mutex_unlock(&mu);
+    notify_changed(mask);
+}
+
+void TradeModel::set_hl_pnl_windows(double pnl_7d,
+                                    const std::string& pnl_7d_str,
+                                    double pnl_30d,
+                                    const std::string& pnl_30d_str) {
+    int rc = pthread_mutex_lock(&mu);
+    if (rc != 0) {
+        return;
+    }
+    const bool changed = (hl_pnl_7d_str_ != pnl_7d_str || hl_pnl_30d_str_ != pnl_30d_str);
+    hl_pnl_7d_ = pnl_7d;
+    hl_pnl_7d_str_ = pnl_7d_str;
+    hl_pnl_30d_ = pnl_30d;
+    hl_pnl_30d_str_ = pnl_30d_str;
+    const unsigned mask = changed ? model_section_bit(ModelSection::Account) : 0u;
+    mark_changed(mask);
+    pthread_mutex_unlock(&mu);
+    notify_changed(mask);
 }
 
 void TradeModel::set_hl_usdc(double usdc, const std::string& usdc_str, bool ok) {
@@ -132,9 +269,14 @@ void TradeModel::set_hl_usdc(double usdc, const std::string& usdc_str, bool ok)
     if (rc != 0) {
         return;
     }
+    const double prev = hl_usdc_;
+    const std::string prev_str = hl_usdc_str_;
     hl_usdc_ = ok ? usdc : 0.0;
     hl_usdc_str_ = ok ? usdc_str : std::string("UNKNOWN");
+    const unsigned mask = (prev != hl_usdc_ || prev_str != hl_usdc_str_) ? model_section_bit(ModelSection::Account) : 0u;
+    mark_changed(mask);
     pthread_mutex_unlock(&mu);
+    notify_changed(mask);
 }
 
 void TradeModel::set_hl_perp_usdc(double usdc, const std::string& usdc_str, bool ok) {
@@ -142,9 +284,14 @@ void TradeModel::set_hl_perp_usdc(double usdc, const std::string& usdc_str, bool
     if (rc != 0) {
         return;
     }
+    const double prev = hl_perp_usdc_;
+    const std::string prev_str = hl_perp_usdc_str_;
     hl_perp_usdc_ = ok ? usdc : 0.0;
     hl_perp_usdc_str_ = ok ? usdc_str : std::string("UNKNOWN");
+    const unsigned mask = (prev != hl_perp_usdc_ || prev_str != hl_perp_usdc_str_) ? model_section_bit(ModelSection::Account) : 0u;
+    mark_changed(mask);
     pthread_mutex_unlock(&mu);
+    notify_changed(mask);
 }
 
 void TradeModel::set_arb_wallet_data(const std::string& eth_str,
@@ -156,6 +303,10 @@ void TradeModel::set_arb_wallet_data(const std::string& eth_str,
     if (rc != 0) {
         return;
     }
+    const std::string prev_eth = arb_eth_str_;
+    const std::string prev_usdc = arb_usdc_str_;
+    const std::string prev_gas = arb_gas_str_;
+    const bool prev_ok = arb_rpc_ok_;
     if (ok) {
         arb_eth_str_ = eth_str;
         arb_usdc_str_ = usdc_str;
@@ -169,7 +320,11 @@ void TradeModel::set_arb_wallet_data(const std::string& eth_str,
         arb_gas_price_wei_ = 0.0L;
         arb_rpc_ok_ = false;
     }
+    const bool changed = (prev_eth != arb_eth_str_ || prev_usdc != arb_usdc_str_ || prev_gas != arb_gas_str_ || prev_ok != arb_rpc_ok_);
+    const unsigned mask = changed ? model_section_bit(ModelSection::Arb) : 0u;
+    mark_changed(mask);
     pthread_mutex_unlock(&mu);
+    notify_changed(mask);
 }
 
 void TradeModel::set_spot_rows(std::vector<SpotRow> rows) {
@@ -179,7 +334,11 @@ void TradeModel::set_spot_rows(std::vector<SpotRow> rows) {
     spot_rows_.swap(rows);
     if (spot_row_idx_ < 0) spot_row_idx_ = 0;
     if (!spot_rows_.empty() && spot_row_idx_ >= (int)spot_rows_.size()) spot_row_idx_ = (int)spot_rows_.size() - 1;
+    bind_price_alerts();
+    const unsigned mask = model_section_bit(ModelSection::SpotRows) | model_section_bit(ModelSection::SpotSelection);
+    mark_changed(mask);
     pthread_mutex_unlock(&mu);
+    notify_changed(mask);
 }
 
 void TradeModel::set_spot_row_idx(int idx) {
@@ -190,38 +349,135 @@ void TradeModel::set_spot_row_idx(int idx) {
         pthread_mutex_unlock(&mu);
         return;
     }
+    const int prev = spot_row_idx_;
     spot_row_idx_ = std::max(0, std::min((int)spot_rows_.size() - 1, idx));
+    const unsigned mask = (spot_row_idx_ != prev) ? model_section_bit(ModelSection::SpotSelection) : 0u;
+    mark_changed(mask);
     pthread_mutex_unlock(&mu);
+    notify_changed(mask);
+}
+
+int TradeModel::spot_row_idx() const {
+    int rc = pthread_mutex_lock(&mu);
+    if (rc != 0) return 0;
+    const int idx = spot_row_idx_;
+    pthread_mutex_unlock(&mu);
+    return idx;
+}
+
+int TradeModel::spot_row_count() const {
+    int rc = pthread_mutex_lock(&mu);
+    if (rc != 0) return 0;
+    const int n = (int)spot_rows_.size();
+    pthread_mutex_unlock(&mu);
+    return n;
 }
 
 void TradeModel::update_mid_prices_from_allmids_json(const std::string& all_mids_json) {
+    const long long now_ms = (long long)std::chrono::duration_cast<std::chrono::milliseconds>(
+                                 std::chrono::system_clock::now().time_since_epoch())
+                                 .count();
     int rc = pthread_mutex_lock(&mu);
     if (rc != 0) return;
+    unsigned mask = 0;
     for (auto& r : spot_rows_) {
         double p = 0.0;
         if (tradeboy::market::parse_mid_price(all_mids_json, r.coin, p)) {
+            // prev_price drives the tick colour, so it moves even when p is unchanged.
+            if (r.price != p || r.prev_price != r.price) mask |= model_section_bit(ModelSection::SpotRows);
             r.prev_price = r.price;
             r.price = p;
+            std::unique_ptr<CoinCandles>& cc = candles_[r.coin];
+            if (!cc) cc.reset(new CoinCandles());
+            if (cc->update(now_ms, p)) mask |= model_section_bit(ModelSection::Candles);
         }
     }
+    if (perp_.apply_all_mids_json(all_mids_json.data(), all_mids_json.size()) > 0) {
+        mask |= model_section_bit(ModelSection::Perp);
+    }
+
+    if (!alerts_.alerts().empty()) {
+        for (size_t c = 0; c < alert_spot_idx_.size(); c++) {
+            double px = 0.0;
+            double prev = 0.0;
+            if (alert_spot_idx_[c] >= 0) {
+                const SpotRow& r = spot_rows_[(size_t)alert_spot_idx_[c]];
+                px = r.price;
+                prev = r.prev_day_px;
+            } else if (alert_perp_asset_[c] >= 0) {
+                px = perp_.mid_px[(size_t)alert_perp_asset_[c]];
+                prev = perp_.prev_day_px[(size_t)alert_perp_asset_[c]];
+            }
+            alerts_.set_quote((int)c, px, prev);
+        }
+        alert_fired_scratch_.clear();
+        if (alerts_.evaluate(alert_fired_scratch_) > 0) {
+            for (int i : alert_fired_scratch_) {
+                if (alert_fired_.size() >= 16) break; // UI not draining; drop
+                alert_fired_.push_back(describe_price_alert(alerts_.alerts()[(size_t)i]));
+            }
+            mask |= model_section_bit(ModelSection::Alerts);
+        }
+    }
+    mark_changed(mask);
+    pthread_mutex_unlock(&mu);
+    notify_changed(mask);
+}
+
+void TradeModel::seed_candles(const std::string& coin, CandleRes res, const Candle* hist, int n) {
+    int rc = pthread_mutex_lock(&mu);
+    if (rc != 0) return;
+    std::unique_ptr<CoinCandles>& cc = candles_[coin];
+    if (!cc) cc.reset(new CoinCandles());
+    cc->ring(res).seed(hist, n);
+    const unsigned mask = model_section_bit(ModelSection::Candles);
+    mark_changed(mask);
+    pthread_mutex_unlock(&mu);
+    notify_changed(mask);
+}
+
+void TradeModel::merge_candle(const std::string& coin, CandleRes res, const Candle& c) {
+    int rc = pthread_mutex_lock(&mu);
+    if (rc != 0) return;
+    std::unique_ptr<CoinCandles>& cc = candles_[coin];
+    if (!cc) cc.reset(new CoinCandles());
+    cc->ring(res).merge(c);
+    const unsigned mask = model_section_bit(ModelSection::Candles);
+    mark_changed(mask);
     pthread_mutex_unlock(&mu);
+    notify_changed(mask);
+}
+
+bool TradeModel::read_candles(const std::string& coin, CandleRes res, const std::function<void(const CandleRing&)>& fn) const {
+    int rc = pthread_mutex_lock(&mu);
+    if (rc != 0) return false;
+    auto it = candles_.find(coin);
+    const bool ok = (it != candles_.end() && it->second && it->second->ring(res).size() > 0);
+    if (ok && fn) fn(it->second->ring(res));
+    pthread_mutex_unlock(&mu);
+    return ok;
 }
 
 void TradeModel::update_spot_balances(const std::unordered_map<std::string, double>& balances_by_sym) {
     int rc = pthread_mutex_lock(&mu);
     if (rc != 0) return;
 
+    bool changed = false;
     for (auto& r : spot_rows_) {
         auto it = balances_by_sym.find(r.sym);
         if (it == balances_by_sym.end()) {
             it = balances_by_sym.find(r.coin);
         }
         if (it != balances_by_sym.end()) {
+            if (r.balance != it->second) changed = true;
             r.balance = it->second;
         }
     }
 
+    const unsigned mask = changed ? model_section_bit(ModelSection::SpotRows) : 0u;
+    mark_changed(mask);
     pthread_mutex_unlock(&mu);
+    notify_changed(mask);
 }
 
 void TradeModel::sort_spot_rows() {
@@ -238,6 +494,8 @@ void TradeModel::sort_spot_rows() {
         selected_coin = spot_rows_[(size_t)spot_row_idx_].coin;
     }
 
+    const uint64_t order_before = spot_order_hash(spot_rows_);
+
     std::stable_sort(spot_rows_.begin(), spot_rows_.end(), [](const SpotRow& a, const SpotRow& b) {
         const double aval = a.balance * a.price;
         const double bval = b.balance * b.price;
@@ -264,7 +522,61 @@ void TradeModel::sort_spot_rows() {
     if (spot_row_idx_ < 0) spot_row_idx_ = 0;
     if (spot_row_idx_ >= (int)spot_rows_.size()) spot_row_idx_ = (int)spot_rows_.size() - 1;
 
+    // Alerts bind by row index, so only a reorder needs them re-resolved.
+    const bool reordered = spot_order_hash(spot_rows_) != order_before;
+    if (reordered) bind_price_alerts();
+
+    const unsigned mask = reordered
+                              ? (model_section_bit(ModelSection::SpotRows) | model_section_bit(ModelSection::SpotSelection))
+                              : 0u;
+    mark_changed(mask);
     pthread_mutex_unlock(&mu);
+    notify_changed(mask);
+}
+
+void TradeModel::set_price_alerts(const std::vector<PriceAlert>& alerts) {
+    int rc = pthread_mutex_lock(&mu);
+    if (rc != 0) return;
+    alerts_.set_alerts(alerts);
+    bind_price_alerts();
+    pthread_mutex_unlock(&mu);
+}
+
+std::vector<PriceAlert> TradeModel::price_alerts() const {
+    std::vector<PriceAlert> out;
+    int rc = pthread_mutex_lock(&mu);
+    if (rc != 0) return out;
+    out = alerts_.alerts();
+    pthread_mutex_unlock(&mu);
+    return out;
+}
+
+std::vector<std::string> TradeModel::take_fired_alerts() {
+    std::vector<std::string> out;
+    int rc = pthread_mutex_lock(&mu);
+    if (rc != 0) return out;
+    out.swap(alert_fired_);
+    pthread_mutex_unlock(&mu);
+    return out;
+}
+
+void TradeModel::bind_price_alerts() {
+    const std::vector<std::string>& coins = alerts_.coins();
+    alert_spot_idx_.assign(coins.size(), -1);
+    alert_perp_asset_.assign(coins.size(), -1);
+    if (coins.empty()) return;
+    // The first row wins when a symbol repeats.
+    std::unordered_map<std::string, int> spot_by_sym;
+    spot_by_sym.reserve(spot_rows_.size());
+    for (size_t i = 0; i < spot_rows_.size(); i++) spot_by_sym.emplace(spot_rows_[i].sym, (int)i);
+    for (size_t c = 0; c < coins.size(); c++) {
+        auto it = spot_by_sym.find(coins[c]);
+        if (it != spot_by_sym.end()) {
+            alert_spot_idx_[c] = it->second;
+        } else {
+            alert_perp_asset_[c] = perp_.find(coins[c].data(), coins[c].size());
+        }
+    }
 }
 
 } // namespace tradeboy::model
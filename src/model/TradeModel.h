@@ -11,10 +11,19 @@
 #pragma once
 
 #include <pthread.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "Candles.h"
+#include "PerpMarkets.h"
+#include "PerpPositions.h"
+#include "PriceAlerts.h"
+
 namespace tradeboy::model {
 
 struct SpotRow {
@@ -26,6 +35,8 @@ struct SpotRow {
     double day_base_vlm = 0.0;
     double day_ntl_vlm = 0.0;
     int price_decimals = 2;
+    int asset_id = -1;     // order asset: 10000 + spot universe index
+    int sz_decimals = 0;   // lot size of the base token
     double balance = 0.0;
     double entry_price = 0.0;
 
@@ -39,12 +50,54 @@ struct SpotRow {
           entry_price(entry_price) {}
 };
 
+// Parts of the model the UI can watch. Each has its own version counter that
+// moves whenever a setter actually changed something in it.
+enum class ModelSection {
+    SpotRows = 0, // prices, balances, order
+    Account = 1,  // Hyperliquid balances and PnL
+    Wallet = 2,
+    Arb = 3,      // Arbitrum balances and gas
+    Perp = 4,     // perp table, positions, selection
+    Candles = 5,
+    Alerts = 6,   // fired price alerts waiting to be taken
+    SpotSelection = 7, // spot_row_idx only; moving the cursor copies no rows
+};
+
+static const int kModelSectionCount = 8;
+
+inline unsigned model_section_bit(ModelSection s) {
+    return 1u << (int)s;
+}
+
+// FNV-1a over coin and symbol in row order: tells a re-sort or a symbol
+// rename apart from a price-only update without copying the keys. Inline so
+// the spot index (and render_bench) need not link the model.
+inline uint64_t spot_order_hash(const std::vector<SpotRow>& rows) {
+    uint64_t h = 1469598103934665603ULL;
+    for (const auto& r : rows) {
+        for (char c : r.coin) h = (h ^ (unsigned char)c) * 1099511628211ULL;
+        h = (h ^ 0xFFu) * 1099511628211ULL;
+        for (char c : r.sym) h = (h ^ (unsigned char)c) * 1099511628211ULL;
+        h = (h ^ 0xFFu) * 1099511628211ULL;
+    }
+    return h;
+}
+
 struct TradeModelSnapshot {
     int spot_row_idx = 0;
 
     std::vector<SpotRow> spot_rows;
 };
 
+struct PerpSnapshot {
+    int perp_row_idx = 0;
+
+    std::vector<PerpRow> rows; // display order
+
+    std::vector<PerpPositionRow> positions;
+    PerpAccountTotals account;
+};
+
 struct WalletSnapshot {
     std::string wallet_address;
     std::string private_key;
@@ -63,6 +116,10 @@ struct AccountSnapshot {
     double hl_pnl_24h = 0.0;
     std::string hl_pnl_24h_pct_str;
     double hl_pnl_24h_pct = 0.0;
+    std::string hl_pnl_7d_str;
+    double hl_pnl_7d = 0.0;
+    std::string hl_pnl_30d_str;
+    double hl_pnl_30d = 0.0;
 
     std::string arb_eth_str;
     std::string arb_usdc_str;
@@ -82,12 +139,22 @@ struct TradeModel {
 
     mutable pthread_mutex_t mu = PTHREAD_MUTEX_INITIALIZER;
 
+    // Lock-free; cheap enough to call every frame before deciding whether to
+    // take a snapshot.
+    uint32_t version(ModelSection s) const { return versions_[(int)s].load(std::memory_order_acquire); }
+    // Called on the writing thread, outside the lock, after every change with
+    // the sections that moved. Set it before any writer thread starts.
+    void set_change_listener(std::function<void(unsigned section_mask)> fn);
+
     TradeModelSnapshot snapshot() const;
     WalletSnapshot wallet_snapshot() const;
     AccountSnapshot account_snapshot() const;
+    PerpSnapshot perp_snapshot() const;
 
     void set_spot_rows(std::vector<SpotRow> rows);
     void set_spot_row_idx(int idx);
+    int spot_row_idx() const;
+    int spot_row_count() const;
 
     void set_wallet(const std::string& wallet_address, const std::string& private_key);
 
@@ -100,27 +167,64 @@ struct TradeModel {
                           double pnl_24h_pct,
                           const std::string& pnl_24h_pct_str,
                           bool ok);
+    void set_hl_pnl_windows(double pnl_7d, const std::string& pnl_7d_str, double pnl_30d, const std::string& pnl_30d_str);
     void set_arb_wallet_data(const std::string& eth_str,
                              const std::string& usdc_str,
                              const std::string& gas_str,
                              long double gas_price_wei,
                              bool ok);
 
-    void set_hl_perp_meta_json(const std::string& json, bool ok);
     void set_hl_spot_meta_json(const std::string& json, bool ok);
 
-    std::string hl_perp_meta_json() const;
     std::string hl_spot_meta_json() const;
 
+    // metaAndAssetCtxs: rebuilds the table when the universe changed,
+    // otherwise only refreshes the contexts.
+    void set_perp_markets(const std::vector<PerpMarketMeta>& metas, const std::vector<PerpAssetCtx>& ctxs);
+    // Returns the number of updates that matched a known perp.
+    size_t apply_perp_ctx_updates(const PerpCtxUpdate* updates, size_t n);
+    // clearinghouseState poll; positions are then re-marked on every mark tick.
+    void set_perp_account_state(const PerpAccountState& st);
+    void set_perp_row_idx(int idx);
+    // Keeps the selected market selected across the re-sort.
+    void sort_perp_rows();
+
+    // Also folds each mid into the coin's candle rings, and updates perp mids.
     void update_mid_prices_from_allmids_json(const std::string& all_mids_json);
+    // Calls fn with the coin's ring under the model lock (no copy). Keep fn
+    // short; returns false if the coin has no history yet.
+    bool read_candles(const std::string& coin, CandleRes res, const std::function<void(const CandleRing&)>& fn) const;
+    // Loads cached/fetched history (oldest first) under the live candles.
+    void seed_candles(const std::string& coin, CandleRes res, const Candle* hist, int n);
+    // Streamed candle for the focused coin (see CandleRing::merge).
+    void merge_candle(const std::string& coin, CandleRes res, const Candle& c);
     void update_spot_balances(const std::unordered_map<std::string, double>& balances_by_sym);
     void sort_spot_rows();
 
+    // Alerts are checked after every allMids update. Coins resolve to a spot
+    // symbol first, then to a perp name.
+    void set_price_alerts(const std::vector<PriceAlert>& alerts);
+    std::vector<PriceAlert> price_alerts() const;
+    // Dialog lines of alerts fired since the last call.
+    std::vector<std::string> take_fired_alerts();
+
 private:
+    // Caller holds mu. Bumps the sections' versions.
+    void mark_changed(unsigned section_mask);
+    // Caller must NOT hold mu.
+    void notify_changed(unsigned section_mask);
+
+    // Caller holds mu. Re-resolves alert coins after rows/markets changed.
+    void bind_price_alerts();
+
     int spot_row_idx_ = 0;
 
     std::vector<SpotRow> spot_rows_;
 
+    // Keyed by SpotRow::coin. Heap nodes so rows can be re-sorted/replaced
+    // without moving history; bounded by the spot universe.
+    std::unordered_map<std::string, std::unique_ptr<CoinCandles>> candles_;
+
     std::string wallet_address_;
     std::string private_key_;
 
@@ -136,6 +240,10 @@ private:
     double hl_pnl_24h_ = 0.0;
     std::string hl_pnl_24h_pct_str_;
     double hl_pnl_24h_pct_ = 0.0;
+    std::string hl_pnl_7d_str_;
+    double hl_pnl_7d_ = 0.0;
+    std::string hl_pnl_30d_str_;
+    double hl_pnl_30d_ = 0.0;
 
     std::string arb_eth_str_;
     std::string arb_usdc_str_;
@@ -143,11 +251,21 @@ private:
     long double arb_gas_price_wei_ = 0.0L;
     bool arb_rpc_ok_ = false;
 
-    std::string hl_perp_meta_json_;
-    bool hl_perp_meta_ok_ = false;
+    PerpMarketTable perp_;
+    PerpPositionBook perp_positions_;
+    int perp_row_idx_ = 0;
+
+    PriceAlertEngine alerts_;
+    std::vector<int> alert_spot_idx_;   // per alert coin slot, or -1
+    std::vector<int> alert_perp_asset_; // per alert coin slot, or -1
+    std::vector<int> alert_fired_scratch_;
+    std::vector<std::string> alert_fired_;
 
     std::string hl_spot_meta_json_;
     bool hl_spot_meta_ok_ = false;
+
+    std::atomic<uint32_t> versions_[kModelSectionCount]; // start at 1, so a seen value of 0 is always stale
+    std::function<void(unsigned)> change_listener_;
 };
 
 } // namespace tradeboy::model
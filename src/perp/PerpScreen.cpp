@@ -1,33 +1,212 @@
 #include "perp/PerpScreen.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+
 #include "ui/MatrixTheme.h"
+#include "utils/Flash.h"
+#include "utils/Typewriter.h"
 
 namespace tradeboy::perp {
 
-void render_perp_screen(ImFont* font_bold) {
+// Hyperliquid perps quote at most 6 - szDecimals decimals.
+static void format_perp_px(double px, int sz_decimals, char* out, size_t cap) {
+    if (!(px > 0.0) || !std::isfinite(px)) {
+        std::snprintf(out, cap, "--");
+        return;
+    }
+    int d = std::max(0, 6 - sz_decimals);
+    // Keep wide prices inside the column.
+    if (px >= 10000.0) d = std::min(d, 1);
+    else if (px >= 100.0) d = std::min(d, 2);
+    else if (px >= 1.0) d = std::min(d, 4);
+    std::snprintf(out, cap, "%.*f", d, px);
+}
+
+static void format_usd_compact(double v, char* out, size_t cap) {
+    if (!std::isfinite(v) || v <= 0.0) {
+        std::snprintf(out, cap, "--");
+    } else if (v >= 1e9) {
+        std::snprintf(out, cap, "$%.1fB", v / 1e9);
+    } else if (v >= 1e6) {
+        std::snprintf(out, cap, "$%.1fM", v / 1e6);
+    } else if (v >= 1e3) {
+        std::snprintf(out, cap, "$%.1fK", v / 1e3);
+    } else {
+        std::snprintf(out, cap, "$%.0f", v);
+    }
+}
+
+static double row_px(const tradeboy::model::PerpRow& r) {
+    return r.ctx.mark_px > 0.0 ? r.ctx.mark_px : r.ctx.mid_px;
+}
+
+static void draw_right(ImDrawList* dl, float x, float y, ImU32 col, const char* s) {
+    ImVec2 sz = ImGui::CalcTextSize(s);
+    dl->AddText(ImVec2(x - sz.x, y), col, s);
+}
+
+void render_perp_screen(const std::vector<tradeboy::model::PerpRow>& rows,
+                        int page_start_idx,
+                        int selected_row_idx,
+                        const std::vector<tradeboy::model::PerpPositionRow>& positions,
+                        const tradeboy::model::PerpAccountTotals& account,
+                        ImFont* font_bold) {
     ImDrawList* dl = ImGui::GetWindowDrawList();
     ImVec2 p = ImGui::GetCursorScreenPos();
     ImVec2 size = ImGui::GetContentRegionAvail();
+    if (size.x <= 1.0f || size.y <= 1.0f) return;
     if (!dl) return;
 
     const float padding = 16.0f;
     const float headerH = 54.0f;
+    const float footerH = 55.0f;
+    const float tableHeaderH = 30.0f;
+    const int targetRows = 7;
 
     float left = p.x + padding;
     float right = p.x + size.x - padding;
+    float w = size.x - 2 * padding;
     float y = p.y + padding;
 
     y += headerH;
     dl->AddLine(ImVec2(left, y - 16), ImVec2(right, y - 16), MatrixTheme::DIM, 2.0f);
 
-    const char* msg = "IN DEVELOPMENT";
-    ImVec2 ts = font_bold ? font_bold->CalcTextSizeA(28.0f, FLT_MAX, 0.0f, msg) : ImGui::CalcTextSize(msg);
-    float cx = p.x + (size.x - ts.x) * 0.5f;
-    float cy = p.y + (size.y - ts.y) * 0.5f;
-    if (font_bold) {
-        dl->AddText(font_bold, 28.0f, ImVec2(cx, cy), MatrixTheme::DIM, msg);
-    } else {
-        dl->AddText(ImVec2(cx, cy), MatrixTheme::DIM, msg);
+    if (rows.empty()) {
+        const char* msg = "LOADING DATA...";
+        ImVec2 ts = font_bold ? font_bold->CalcTextSizeA(28.0f, FLT_MAX, 0.0f, msg) : ImGui::CalcTextSize(msg);
+        float cx = p.x + (size.x - ts.x) * 0.5f;
+        float cy = p.y + (size.y - ts.y) * 0.5f;
+        if (font_bold) {
+            dl->AddText(font_bold, 28.0f, ImVec2(cx, cy), MatrixTheme::DIM, msg);
+        } else {
+            dl->AddText(ImVec2(cx, cy), MatrixTheme::DIM, msg);
+        }
+        return;
+    }
+
+    page_start_idx = std::max(0, std::min((int)rows.size() - 1, page_start_idx));
+    selected_row_idx = std::max(0, std::min((int)rows.size() - 1, selected_row_idx));
+
+    // CODE | MARK | FUND (1h) | OI (USD) | 24H
+    const float col1 = left;
+    const float col2 = left + w * 0.44f;
+    const float col3 = left + w * 0.63f;
+    const float col4 = right - 130;
+    const float col5 = right;
+
+    {
+        dl->AddText(ImVec2(col1 + 30, y), MatrixTheme::DIM, "CODE");
+        draw_right(dl, col2, y, MatrixTheme::DIM, "MARK");
+        draw_right(dl, col3, y, MatrixTheme::DIM, "FUND");
+        draw_right(dl, col4, y, MatrixTheme::DIM, "OI");
+        draw_right(dl, col5, y, MatrixTheme::DIM, "24H");
+        y += tableHeaderH;
+    }
+
+    {
+        float listH = size.y - padding - footerH - y + p.y;
+        int startIdx = page_start_idx;
+        const int maxRows = targetRows;
+        float rowH = std::max(1.0f, std::ceil(listH / (float)maxRows));
+        if (startIdx + maxRows > (int)rows.size()) {
+            startIdx = std::max(0, (int)rows.size() - maxRows);
+        }
+        float textH = ImGui::CalcTextSize("A").y;
+
+        for (int i = startIdx; i < (int)rows.size() && (i - startIdx) < maxRows; ++i) {
+            const auto& r = rows[(size_t)i];
+            const bool isSelected = (i == selected_row_idx);
+            float rowY = y + (i - startIdx) * rowH;
+            float rowContentH = rowH - 4.0f;
+            float textY = rowY + (rowContentH - textH) * 0.5f;
+
+            if (isSelected) {
+                dl->AddRectFilled(ImVec2(left, rowY), ImVec2(right, rowY + rowContentH), MatrixTheme::TEXT, 0.0f);
+                if (tradeboy::utils::blink_on_time(ImGui::GetTime(), 3.0)) {
+                    float cursorPadY = 2.0f;
+                    float cursorH = std::max(1.0f, textH - cursorPadY * 2.0f);
+                    dl->AddRectFilled(ImVec2(left + 8, textY + cursorPadY),
+                                      ImVec2(left + 18, textY + cursorPadY + cursorH),
+                                      MatrixTheme::BLACK,
+                                      0.0f);
+                }
+            }
+
+            const double px = row_px(r);
+            const bool hasChg = (r.ctx.prev_day_px > 0.0 && px > 0.0);
+            const double chg = hasChg ? ((px - r.ctx.prev_day_px) / r.ctx.prev_day_px) * 100.0 : 0.0;
+            const ImU32 textCol = isSelected ? MatrixTheme::BLACK : MatrixTheme::TEXT;
+            const ImU32 fundCol = isSelected ? MatrixTheme::BLACK : (r.ctx.funding >= 0.0 ? MatrixTheme::TEXT : MatrixTheme::ALERT);
+            const ImU32 chgCol = isSelected ? MatrixTheme::BLACK : ((!hasChg || chg >= 0.0) ? MatrixTheme::TEXT : MatrixTheme::ALERT);
+
+            dl->AddText(ImVec2(col1 + 30, textY), textCol, r.name.c_str());
+
+            char buf[32];
+            format_perp_px(px, r.sz_decimals, buf, sizeof(buf));
+            draw_right(dl, col2, textY, textCol, buf);
+
+            std::snprintf(buf, sizeof(buf), "%+.4f%%", r.ctx.funding * 100.0);
+            draw_right(dl, col3, textY, fundCol, buf);
+
+            format_usd_compact(r.ctx.open_interest * px, buf, sizeof(buf));
+            draw_right(dl, col4, textY, textCol, buf);
+
+            if (hasChg) std::snprintf(buf, sizeof(buf), "%+.2f%%", chg);
+            else std::snprintf(buf, sizeof(buf), "--");
+            draw_right(dl, col5, textY, chgCol, buf);
+        }
+    }
+
+    // Footer: the position on the selected market, else its details.
+    {
+        float footerTop = p.y + size.y - footerH;
+        dl->AddLine(ImVec2(left, footerTop), ImVec2(right, footerTop), MatrixTheme::DIM, 2.0f);
+
+        const auto& sel = rows[(size_t)selected_row_idx];
+        const tradeboy::model::PerpPositionRow* pos = nullptr;
+        for (const auto& ps : positions) {
+            if (ps.asset == sel.asset) pos = &ps;
+        }
+        char body[128];
+        if (pos) {
+            char liq[24];
+            format_perp_px(pos->liquidation_px, sel.sz_decimals, liq, sizeof(liq));
+            std::snprintf(body,
+                          sizeof(body),
+                          "%s %g PNL %+.2f LIQ %s",
+                          pos->szi > 0.0 ? "LONG" : "SHORT",
+                          std::fabs(pos->szi),
+                          pos->unrealized_pnl,
+                          liq);
+        } else {
+            char oracle[24];
+            char vol[24];
+            format_perp_px(sel.ctx.oracle_px, sel.sz_decimals, oracle, sizeof(oracle));
+            format_usd_compact(sel.ctx.day_ntl_vlm, vol, sizeof(vol));
+            std::snprintf(body, sizeof(body), "ORACLE %s VOL %s %dX", oracle, vol, sel.max_leverage);
+        }
+
+        // Account equity and cross margin usage, small and right-aligned.
+        if (account.ok) {
+            char acct[64];
+            std::snprintf(acct,
+                          sizeof(acct),
+                          "EQUITY $%.2f\nMARGIN %.1f%%",
+                          account.account_value,
+                          account.cross_margin_ratio * 100.0);
+            const float smallFontSize = 16.0f;
+            ImFont* f = ImGui::GetFont();
+            ImVec2 aSz = f->CalcTextSizeA(smallFontSize, FLT_MAX, 0.0f, acct);
+            dl->AddText(f, smallFontSize, ImVec2(right - aSz.x, footerTop + (footerH - aSz.y) * 0.5f), MatrixTheme::DIM, acct);
+        }
+
+        static tradeboy::utils::TypewriterState tw;
+        std::string shown_text = tradeboy::utils::typewriter_shown(tw, std::string(body), ImGui::GetTime(), 35.0);
+        dl->AddText(ImVec2(left, footerTop + 20), MatrixTheme::TEXT, "> ");
+        dl->AddText(ImVec2(left + 18, footerTop + 20), MatrixTheme::TEXT, shown_text.c_str());
     }
 }
 
@@ -2,8 +2,18 @@
 
 #include "imgui.h"
 
+#include <vector>
+
+#include "../model/PerpMarkets.h"
+#include "../model/PerpPositions.h"
+
 namespace tradeboy::perp {
 
-void render_perp_screen(ImFont* font_bold);
+void render_perp_screen(const std::vector<tradeboy::model::PerpRow>& rows,
+                        int page_start_idx,
+                        int selected_row_idx,
+                        const std::vector<tradeboy::model::PerpPositionRow>& positions,
+                        const tradeboy::model::PerpAccountTotals& account,
+                        ImFont* font_bold);
 
 } // namespace tradeboy::perp
@@ -0,0 +1,85 @@
+#include "SpotIndex.h"
+
+#include <algorithm>
+#include <string>
+
+namespace tradeboy::spot {
+
+const char kSearchAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+const int kSearchAlphabetLen = (int)sizeof(kSearchAlphabet) - 1;
+
+static char fold(char c) {
+    return (c >= 'a' && c <= 'z') ? (char)(c - 'a' + 'A') : c;
+}
+
+static bool sym_less(const std::string& a, const std::string& b) {
+    const size_t n = std::min(a.size(), b.size());
+    for (size_t i = 0; i < n; i++) {
+        const char ca = fold(a[i]);
+        const char cb = fold(b[i]);
+        if (ca != cb) return ca < cb;
+    }
+    return a.size() < b.size();
+}
+
+void SpotSymbolIndex::update(const std::vector<tradeboy::model::SpotRow>& rows) {
+    const uint64_t h = tradeboy::model::spot_order_hash(rows);
+    if (h == signature_ && order_.size() == rows.size()) return;
+    signature_ = h;
+
+    order_.resize(rows.size());
+    for (size_t i = 0; i < rows.size(); i++) order_[i] = (int)i;
+    std::stable_sort(order_.begin(), order_.end(), [&rows](int a, int b) {
+        return sym_less(rows[(size_t)a].sym, rows[(size_t)b].sym);
+    });
+
+    // Sorted input means a node's rows are contiguous and its children arrive
+    // in order: each insert only ever extends the last child of a node.
+    nodes_.clear();
+    nodes_.push_back(Node());
+    nodes_[0].hi = (int)order_.size();
+    std::vector<int> last_child;
+    last_child.push_back(-1);
+    for (int pos = 0; pos < (int)order_.size(); pos++) {
+        const std::string& s = rows[(size_t)order_[(size_t)pos]].sym;
+        int node = 0;
+        for (size_t k = 0; k < s.size(); k++) {
+            const char c = fold(s[k]);
+            const int last = last_child[(size_t)node];
+            int child = -1;
+            if (last >= 0 && nodes_[(size_t)last].c == c) {
+                child = last;
+            } else {
+                child = (int)nodes_.size();
+                Node n;
+                n.c = c;
+                n.lo = pos;
+                nodes_.push_back(n);
+                last_child.push_back(-1);
+                if (last >= 0) nodes_[(size_t)last].next_sibling = child;
+                else nodes_[(size_t)node].first_child = child;
+                last_child[(size_t)node] = child;
+            }
+            nodes_[(size_t)child].hi = pos + 1;
+            node = child;
+        }
+    }
+}
+
+void SpotSymbolIndex::find(const char* prefix, int& lo, int& hi) const {
+    lo = 0;
+    hi = 0;
+    if (nodes_.empty()) return;
+    int node = 0;
+    for (const char* p = prefix; p && *p; p++) {
+        const char c = fold(*p);
+        int child = nodes_[(size_t)node].first_child;
+        while (child >= 0 && nodes_[(size_t)child].c != c) child = nodes_[(size_t)child].next_sibling;
+        if (child < 0) return;
+        node = child;
+    }
+    lo = nodes_[(size_t)node].lo;
+    hi = nodes_[(size_t)node].hi;
+}
+
+} // namespace tradeboy::spot
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "../model/TradeModel.h"
+
+namespace tradeboy::spot {
+
+// Prefix trie over the spot symbols (case-folded). Rows are kept in symbol
+// order and every trie node records the [lo, hi) slice of that order whose
+// symbols share its prefix, so a lookup walks one node per prefix char.
+class SpotSymbolIndex {
+public:
+    // Rebuilds only when the rows' spot_order_hash differs from the last
+    // build; price ticks leave it alone. Still O(rows), so callers gate it on
+    // the SpotRows version.
+    void update(const std::vector<tradeboy::model::SpotRow>& rows);
+
+    // Matching rows are order()[lo, hi); lo == hi when nothing matches.
+    void find(const char* prefix, int& lo, int& hi) const;
+
+    // Row indices (into the rows given to update) sorted by symbol.
+    const std::vector<int>& order() const { return order_; }
+
+private:
+    struct Node {
+        int lo = 0;
+        int hi = 0;
+        int first_child = -1;
+        int next_sibling = -1;
+        char c = 0;
+    };
+
+    uint64_t signature_ = 0;
+    std::vector<int> order_;
+    std::vector<Node> nodes_;
+};
+
+// Alphabet the d-pad cycles through while spelling a search prefix.
+extern const char kSearchAlphabet[];
+extern const int kSearchAlphabetLen;
+
+} // namespace tradeboy::spot
@@ -3,12 +3,13 @@
 #include <algorithm>
 #include <cstdio>
 #include <cmath>
-#include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "../model/TradeModel.h"
 #include "ui/MatrixTheme.h"
+#include "ui/TextCache.h"
 #include "utils/Flash.h"
 #include "utils/Typewriter.h"
 
@@ -21,15 +22,100 @@ static double round_to_decimals(double v, int decimals) {
     return std::round(v * p) / p;
 }
 
-static std::string format_fixed_round(double v, int decimals) {
-    if (!std::isfinite(v)) return std::string("0");
+static void format_fixed_round(tradeboy::ui::CachedText& out, double v, int decimals) {
+    if (!std::isfinite(v)) {
+        out.set(nullptr, 0.0f, "0");
+        return;
+    }
     int d = std::max(0, std::min(10, decimals));
-    double rv = round_to_decimals(v, d);
-    std::ostringstream ss;
-    ss.setf(std::ios::fixed);
-    ss.precision(d);
-    ss << rv;
-    return ss.str();
+    out.format(nullptr, 0.0f, "%.*f", d, round_to_decimals(v, d));
+}
+
+// Formatted cells of one market, kept across frames and redone only when the
+// values they show change (the fit() calls catch font changes).
+struct SpotRowText {
+    double balance = 0.0;
+    double price = 0.0;
+    double prev_day_px = 0.0;
+    int price_decimals = -1;
+    bool has_chg = false;
+    bool chg_neg = false;
+    tradeboy::ui::CachedText hold;
+    tradeboy::ui::CachedText price_s;
+    tradeboy::ui::CachedText chg;
+};
+
+static SpotRowText& spot_row_text(const tradeboy::model::SpotRow& coin) {
+    static std::unordered_map<std::string, SpotRowText> cache;
+    // Bounded by the spot universe; the clear only guards against a feed
+    // that keeps inventing coin names.
+    if (cache.size() > 8192) cache.clear();
+    SpotRowText& t = cache[coin.coin];
+    if (t.price_s.valid && t.balance == coin.balance && t.price == coin.price && t.prev_day_px == coin.prev_day_px &&
+        t.price_decimals == coin.price_decimals) {
+        return t;
+    }
+    t.balance = coin.balance;
+    t.price = coin.price;
+    t.prev_day_px = coin.prev_day_px;
+    t.price_decimals = coin.price_decimals;
+
+    if (coin.balance > 0) t.hold.format(nullptr, 0.0f, "%.2f", coin.balance);
+    format_fixed_round(t.price_s, coin.price, coin.price_decimals);
+
+    double chg24 = 0.0;
+    t.has_chg = (coin.prev_day_px > 0.0 && coin.price > 0.0 && std::isfinite(coin.prev_day_px) && std::isfinite(coin.price));
+    if (t.has_chg) chg24 = ((coin.price - coin.prev_day_px) / coin.prev_day_px) * 100.0;
+    t.chg_neg = t.has_chg && chg24 < 0;
+    if (t.has_chg) {
+        double c2 = round_to_decimals(chg24, 2);
+        if (std::fabs(c2) >= 1000.0) {
+            const double mult = (coin.price / coin.prev_day_px);
+            t.chg.format(nullptr, 0.0f, "%.2fx", mult);
+        } else {
+            t.chg.format(nullptr, 0.0f, "%+.2f%%", c2);
+        }
+    } else {
+        t.chg.set(nullptr, 0.0f, "--");
+    }
+    return t;
+}
+
+static void render_search_footer(ImDrawList* dl, float left, float right, float footerTop, const SpotSearchView& search) {
+    dl->AddLine(ImVec2(left, footerTop), ImVec2(right, footerTop), MatrixTheme::DIM, 2.0f);
+
+    const float ty = footerTop + 20;
+    static tradeboy::ui::CachedText label;
+    static tradeboy::ui::CachedText typed;
+    static tradeboy::ui::CachedText pend;
+    label.set(nullptr, 0.0f, "> FIND ");
+    typed.set(nullptr, 0.0f, search.prefix ? search.prefix : "");
+    const char pend_s[2] = {search.pending, 0};
+    pend.set(nullptr, 0.0f, pend_s);
+
+    float x = left;
+    dl->AddText(ImVec2(x, ty), MatrixTheme::TEXT, label.text);
+    x += label.size.x;
+    dl->AddText(ImVec2(x, ty), MatrixTheme::TEXT, typed.text);
+    x += typed.size.x;
+    // The letter being picked blinks as an inverted block.
+    if (tradeboy::utils::blink_on_time(ImGui::GetTime(), 3.0)) {
+        dl->AddRectFilled(ImVec2(x, ty), ImVec2(x + pend.size.x, ty + pend.size.y), MatrixTheme::TEXT, 0.0f);
+        dl->AddText(ImVec2(x, ty), MatrixTheme::BLACK, pend.text);
+    } else {
+        dl->AddText(ImVec2(x, ty), MatrixTheme::TEXT, pend.text);
+    }
+
+    const float hintFontSize = 16.0f;
+    ImFont* f = ImGui::GetFont();
+    static tradeboy::ui::CachedText hint;
+    static int hint_count = -1;
+    if (hint_count != search.count || !hint.valid) {
+        hint_count = search.count;
+        hint.format(f, hintFontSize, "%d MATCH%s  L2/R2 PICK  A GO  B BACK", search.count, search.count == 1 ? "" : "ES");
+    }
+    const ImVec2& hSz = hint.fit(f, hintFontSize);
+    dl->AddText(f, hintFontSize, ImVec2(right - hSz.x, ty + 4.0f), MatrixTheme::DIM, hint.text);
 }
 
 void render_spot_screen(const std::vector<tradeboy::model::SpotRow>& rows,
@@ -41,7 +127,10 @@ void render_spot_screen(const std::vector<tradeboy::model::SpotRow>& rows,
                         ImFont* font_bold,
                         bool action_btn_held,
                         bool l1_btn_held,
-                        bool r1_btn_held) {
+                        bool r1_btn_held,
+                        const char* flow_text,
+                        const std::function<void(ImDrawList*, const ImVec2&, const ImVec2&, ImU32)>& draw_sparkline,
+                        const SpotSearchView* search) {
     ImDrawList* dl = ImGui::GetWindowDrawList();
     ImVec2 p = ImGui::GetCursorScreenPos();
     ImVec2 size = ImGui::GetContentRegionAvail();
@@ -52,7 +141,8 @@ void render_spot_screen(const std::vector<tradeboy::model::SpotRow>& rows,
 
     if (size.x <= 1.0f || size.y <= 1.0f) return;
     if (!dl) return;
-    if (rows.empty()) {
+    const int n = search ? search->count : (int)rows.size();
+    if (n <= 0) {
         const float padding = 16.0f;
         const float headerH = 54.0f;
 
@@ -62,7 +152,7 @@ void render_spot_screen(const std::vector<tradeboy::model::SpotRow>& rows,
         y += headerH;
         dl->AddLine(ImVec2(left, y - 16), ImVec2(right, y - 16), MatrixTheme::DIM, 2.0f);
 
-        const char* msg = "LOADING DATA...";
+        const char* msg = search ? "NO MATCH" : "LOADING DATA...";
         ImVec2 ts = font_bold ? font_bold->CalcTextSizeA(28.0f, FLT_MAX, 0.0f, msg) : ImGui::CalcTextSize(msg);
         float cx = p.x + (size.x - ts.x) * 0.5f;
         float cy = p.y + (size.y - ts.y) * 0.5f;
@@ -71,11 +161,12 @@ void render_spot_screen(const std::vector<tradeboy::model::SpotRow>& rows,
         } else {
             dl->AddText(ImVec2(cx, cy), MatrixTheme::DIM, msg);
         }
+        if (search) render_search_footer(dl, left, right, p.y + size.y - 55.0f, *search);
         return;
     }
 
-    page_start_idx = std::max(0, std::min((int)rows.size() - 1, page_start_idx));
-    selected_row_idx = std::max(0, std::min((int)rows.size() - 1, selected_row_idx));
+    page_start_idx = std::max(0, std::min(n - 1, page_start_idx));
+    selected_row_idx = std::max(0, std::min(n - 1, selected_row_idx));
     action_idx = std::max(0, std::min(1, action_idx));
 
     const float padding = 16.0f;
@@ -102,17 +193,22 @@ void render_spot_screen(const std::vector<tradeboy::model::SpotRow>& rows,
 
         dl->AddText(ImVec2(col1 + 30, y), MatrixTheme::DIM, "CODE");
 
-        const char* h2 = "HOLDINGS";
-        ImVec2 sz2 = ImGui::CalcTextSize(h2);
-        dl->AddText(ImVec2(col2 - sz2.x * 0.5f, y), MatrixTheme::DIM, h2);
+        static tradeboy::ui::CachedText h2;
+        static tradeboy::ui::CachedText h3;
+        static tradeboy::ui::CachedText h4;
+        if (!h2.valid) {
+            h2.set(nullptr, 0.0f, "HOLDINGS");
+            h3.set(nullptr, 0.0f, "PRICE");
+            h4.set(nullptr, 0.0f, "24H");
+        }
+        const ImVec2& sz2 = h2.fit(nullptr, 0.0f);
+        dl->AddText(ImVec2(col2 - sz2.x * 0.5f, y), MatrixTheme::DIM, h2.text);
 
-        const char* h3 = "PRICE";
-        ImVec2 sz3 = ImGui::CalcTextSize(h3);
-        dl->AddText(ImVec2(col3 - sz3.x, y), MatrixTheme::DIM, h3);
+        const ImVec2& sz3 = h3.fit(nullptr, 0.0f);
+        dl->AddText(ImVec2(col3 - sz3.x, y), MatrixTheme::DIM, h3.text);
 
-        const char* h4 = "24H";
-        ImVec2 sz4 = ImGui::CalcTextSize(h4);
-        dl->AddText(ImVec2(col4 - sz4.x, y), MatrixTheme::DIM, h4);
+        const ImVec2& sz4 = h4.fit(nullptr, 0.0f);
+        dl->AddText(ImVec2(col4 - sz4.x, y), MatrixTheme::DIM, h4.text);
 
         y += tableHeaderH;
     }
@@ -123,14 +219,16 @@ void render_spot_screen(const std::vector<tradeboy::model::SpotRow>& rows,
         int startIdx = page_start_idx;
         int maxRows = std::max(1, targetRows);
         float rowH = std::max(1.0f, std::ceil(listH / (float)maxRows));
-        if (startIdx + maxRows > (int)rows.size()) {
-            startIdx = std::max(0, (int)rows.size() - maxRows);
+        if (startIdx + maxRows > n) {
+            startIdx = std::max(0, n - maxRows);
         }
         
-        float textH = ImGui::CalcTextSize("A").y;
+        static tradeboy::ui::CachedText line;
+        if (!line.valid) line.set(nullptr, 0.0f, "A");
+        float textH = line.fit(nullptr, 0.0f).y;
 
-        for (int i = startIdx; i < (int)rows.size() && (i - startIdx) < maxRows; ++i) {
-            const auto& coin = rows[(size_t)i];
+        for (int i = startIdx; i < n && (i - startIdx) < maxRows; ++i) {
+            const auto& coin = rows[(size_t)(search ? search->order[i] : i)];
             bool isSelected = (i == selected_row_idx);
             float rowY = y + (i - startIdx) * rowH;
 
@@ -153,12 +251,10 @@ void render_spot_screen(const std::vector<tradeboy::model::SpotRow>& rows,
                 }
             } 
 
+            SpotRowText& cells = spot_row_text(coin);
             ImU32 textCol = isSelected ? MatrixTheme::BLACK : MatrixTheme::TEXT;
             ImU32 numCol = isSelected ? MatrixTheme::BLACK : MatrixTheme::TEXT;
-            double chg24 = 0.0;
-            bool hasChg24 = (coin.prev_day_px > 0.0 && coin.price > 0.0 && std::isfinite(coin.prev_day_px) && std::isfinite(coin.price));
-            if (hasChg24) chg24 = ((coin.price - coin.prev_day_px) / coin.prev_day_px) * 100.0;
-            ImU32 changeCol = isSelected ? MatrixTheme::BLACK : ((!hasChg24 || chg24 >= 0) ? MatrixTheme::TEXT : MatrixTheme::ALERT);
+            ImU32 changeCol = isSelected ? MatrixTheme::BLACK : (cells.chg_neg ? MatrixTheme::ALERT : MatrixTheme::TEXT);
 
             float col1 = left;
             float col2 = left + w * 0.35f;
@@ -167,54 +263,61 @@ void render_spot_screen(const std::vector<tradeboy::model::SpotRow>& rows,
 
             dl->AddText(ImVec2(col1 + 30, textY), textCol, coin.sym.c_str());
 
-            if (coin.balance > 0) {
-                char holdBuf[32];
-                std::snprintf(holdBuf, sizeof(holdBuf), "%.2f", coin.balance);
-                ImVec2 sz = ImGui::CalcTextSize(holdBuf);
-                dl->AddText(ImVec2(col2 - sz.x * 0.5f, textY), textCol, holdBuf);
+            // Price history for the selected row, between holdings and price.
+            if (isSelected && draw_sparkline) {
+                float sx0 = col2 + 70.0f;
+                float sx1 = col3 - 150.0f;
+                if (sx1 - sx0 > 30.0f) {
+                    draw_sparkline(dl, ImVec2(sx0, rowY + 6.0f), ImVec2(sx1, rowY + rowContentH - 6.0f), textCol);
+                }
             }
 
-            std::string priceStr = format_fixed_round(coin.price, coin.price_decimals);
-            ImVec2 szP = ImGui::CalcTextSize(priceStr.c_str());
-            dl->AddText(ImVec2(col3 - szP.x, textY), numCol, priceStr.c_str());
-
-            char chgBuf[32];
-            if (hasChg24) {
-                double c2 = round_to_decimals(chg24, 2);
-                if (std::fabs(c2) >= 1000.0) {
-                    const double mult = (coin.price / coin.prev_day_px);
-                    std::snprintf(chgBuf, sizeof(chgBuf), "%.2fx", mult);
-                } else {
-                    std::snprintf(chgBuf, sizeof(chgBuf), "%+.2f%%", c2);
-                }
-            } else {
-                std::snprintf(chgBuf, sizeof(chgBuf), "--");
+            if (coin.balance > 0) {
+                const ImVec2& sz = cells.hold.fit(nullptr, 0.0f);
+                dl->AddText(ImVec2(col2 - sz.x * 0.5f, textY), textCol, cells.hold.text);
             }
-            ImVec2 szC = ImGui::CalcTextSize(chgBuf);
-            dl->AddText(ImVec2(col4 - szC.x, textY), changeCol, chgBuf);
+
+            const ImVec2& szP = cells.price_s.fit(nullptr, 0.0f);
+            dl->AddText(ImVec2(col3 - szP.x, textY), numCol, cells.price_s.text);
+
+            const ImVec2& szC = cells.chg.fit(nullptr, 0.0f);
+            dl->AddText(ImVec2(col4 - szC.x, textY), changeCol, cells.chg.text);
         }
     }
 
     // Footer
     {
         float footerTop = p.y + size.y - footerH;
+        if (search) {
+            render_search_footer(dl, left, right, footerTop, *search);
+            return;
+        }
         dl->AddLine(ImVec2(left, footerTop), ImVec2(right, footerTop), MatrixTheme::DIM, 2.0f);
 
         const auto& selCoin = rows[(size_t)selected_row_idx];
-        char body[128];
-        double val = selCoin.balance * selCoin.price;
-        if (selCoin.balance > 0)
-            std::snprintf(body, sizeof(body), "It worth $%.2f", val);
-        else
-            std::snprintf(body, sizeof(body), "No %s", selCoin.sym.c_str());
+        static std::string body_coin;
+        static double body_balance = -1.0;
+        static double body_price = -1.0;
+        static std::string full_body;
+        if (selCoin.coin != body_coin || selCoin.balance != body_balance || selCoin.price != body_price) {
+            body_coin = selCoin.coin;
+            body_balance = selCoin.balance;
+            body_price = selCoin.price;
+            char body[128];
+            double val = selCoin.balance * selCoin.price;
+            if (selCoin.balance > 0)
+                std::snprintf(body, sizeof(body), "It worth $%.2f", val);
+            else
+                std::snprintf(body, sizeof(body), "No %s", selCoin.sym.c_str());
+            full_body = body;
+        }
 
         static tradeboy::utils::TypewriterState tw;
-        std::string full_body = body;
-        std::string shown_text = tradeboy::utils::typewriter_shown(tw, full_body, ImGui::GetTime(), 35.0);
+        const size_t shown = tradeboy::utils::typewriter_shown_len(tw, full_body, ImGui::GetTime(), 35.0);
 
         // Prompt is always visible; only body is typed.
         dl->AddText(ImVec2(left, footerTop + 20), MatrixTheme::TEXT, "> ");
-        dl->AddText(ImVec2(left + 18, footerTop + 20), MatrixTheme::TEXT, shown_text.c_str());
+        dl->AddText(ImVec2(left + 18, footerTop + 20), MatrixTheme::TEXT, full_body.c_str(), full_body.c_str() + shown);
 
         float btnW = 100.0f;
         float btnH = 40.0f;
@@ -222,6 +325,16 @@ void render_spot_screen(const std::vector<tradeboy::model::SpotRow>& rows,
         float sellX = right - btnW;
         float buyX = sellX - btnW - 20;
 
+        // Short-term flow for the selected coin, right-aligned before BUY.
+        if (flow_text && flow_text[0]) {
+            const float flowFontSize = 16.0f;
+            ImFont* f = ImGui::GetFont();
+            static tradeboy::ui::CachedText flow_t;
+            flow_t.set(f, flowFontSize, flow_text);
+            const ImVec2& fSz = flow_t.size;
+            dl->AddText(f, flowFontSize, ImVec2(buyX - 16.0f - fSz.x, btnY + (btnH - fSz.y) * 0.5f), MatrixTheme::DIM, flow_text);
+        }
+
         bool buyFocus = (action_idx == 0);
         bool sellFocus = (action_idx == 1);
         
@@ -242,15 +355,18 @@ void render_spot_screen(const std::vector<tradeboy::model::SpotRow>& rows,
         dl->AddRectFilled(ImVec2(buyX, btnY), ImVec2(buyX + btnW, btnY + btnH), buyBg, 0.0f);
         dl->AddRect(ImVec2(buyX, btnY), ImVec2(buyX + btnW, btnY + btnH), buyBorder, 0.0f, 0, 2.0f);
         
-        ImVec2 bSz;
+        static tradeboy::ui::CachedText buy_t;
+        static tradeboy::ui::CachedText sell_t;
+        buy_t.set(font_bold, btnFontSize, "BUY");
+        sell_t.set(font_bold, btnFontSize, "SELL");
+
+        ImVec2 bSz = buy_t.size;
         if (font_bold) {
-            bSz = font_bold->CalcTextSizeA(btnFontSize, FLT_MAX, 0.0f, "BUY");
             dl->AddText(font_bold, btnFontSize, ImVec2(buyX + (btnW - bSz.x) * 0.5f, btnY + (btnH - bSz.y) * 0.5f), buyFg, "BUY");
         } else {
             // No custom size A for default font easily accessible without push/pop or scaling
             // Assuming default font size is 28, scaling 22/28 approx 0.8
             // But we can just use AddText with default if bold missing.
-            bSz = ImGui::CalcTextSize("BUY");
             dl->AddText(ImVec2(buyX + (btnW - bSz.x) * 0.5f, btnY + (btnH - bSz.y) * 0.5f), buyFg, "BUY");
         }
         
@@ -269,12 +385,10 @@ void render_spot_screen(const std::vector<tradeboy::model::SpotRow>& rows,
         dl->AddRectFilled(ImVec2(sellX, btnY), ImVec2(sellX + btnW, btnY + btnH), sellBg, 0.0f);
         dl->AddRect(ImVec2(sellX, btnY), ImVec2(sellX + btnW, btnY + btnH), sellBorder, 0.0f, 0, 2.0f);
         
-        ImVec2 sSz;
+        ImVec2 sSz = sell_t.size;
         if (font_bold) {
-            sSz = font_bold->CalcTextSizeA(btnFontSize, FLT_MAX, 0.0f, "SELL");
             dl->AddText(font_bold, btnFontSize, ImVec2(sellX + (btnW - sSz.x) * 0.5f, btnY + (btnH - sSz.y) * 0.5f), sellFg, "SELL");
         } else {
-            sSz = ImGui::CalcTextSize("SELL");
             dl->AddText(ImVec2(sellX + (btnW - sSz.x) * 0.5f, btnY + (btnH - sSz.y) * 0.5f), sellFg, "SELL");
         }
     }
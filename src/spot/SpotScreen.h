@@ -2,12 +2,24 @@
 
 #include "imgui.h"
 
+#include <functional>
 #include <vector>
 
 #include "../model/TradeModel.h"
 
 namespace tradeboy::spot {
 
+// Symbol search in progress: the list shows only the matches, in symbol
+// order, and the footer shows the prompt instead of BUY/SELL.
+struct SpotSearchView {
+    const int* order = nullptr; // list row i is rows[order[i]]
+    int count = 0;
+    const char* prefix = "";    // letters already placed
+    char pending = 'A';         // letter being picked with up/down
+};
+
+// Only the visible page of rows is read; with `search` the page and
+// selection index into the matches instead of rows.
 void render_spot_screen(const std::vector<tradeboy::model::SpotRow>& rows,
                          int page_start_idx,
                          int selected_row_idx,
@@ -17,6 +29,9 @@ void render_spot_screen(const std::vector<tradeboy::model::SpotRow>& rows,
                          ImFont* font_bold = nullptr,
                          bool action_btn_held = false,
                          bool l1_btn_held = false,
-                         bool r1_btn_held = false);
+                         bool r1_btn_held = false,
+                         const char* flow_text = nullptr,
+                         const std::function<void(ImDrawList*, const ImVec2&, const ImVec2&, ImU32)>& draw_sparkline = nullptr,
+                         const SpotSearchView* search = nullptr);
 
 } // namespace tradeboy::spot
@@ -12,10 +12,15 @@ static const char* side_label(Side s) {
     return (s == Side::Buy) ? "BUY" : "SELL";
 }
 
-void SpotOrderState::open_with(const tradeboy::model::SpotRow& row, Side in_side, double in_max_possible) {
+void SpotOrderState::open_with(const tradeboy::model::SpotRow& row,
+                               Side in_side,
+                               double in_max_possible,
+                               std::function<bool(double, double&)> estimate_fill_px) {
     side = in_side;
     sym = row.sym;
     price = row.price;
+    asset_id = row.asset_id;
+    sz_decimals = row.sz_decimals;
     
     tradeboy::ui::NumberInputConfig cfg;
     
@@ -35,6 +40,7 @@ void SpotOrderState::open_with(const tradeboy::model::SpotRow& row, Side in_side
     cfg.price = row.price;
     
     cfg.show_available_panel = true;
+    cfg.estimate_fill_px = estimate_fill_px;
     
     input_state.open_with(cfg);
 }
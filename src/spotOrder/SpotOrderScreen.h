@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <functional>
 #include <string>
 
 #include "imgui.h"
@@ -28,10 +29,16 @@ struct SpotOrderState {
     Side side = Side::Buy;
     std::string sym;
     double price = 0.0;
+    int asset_id = -1;
+    int sz_decimals = 0;
     
     bool open() const { return input_state.open; }
     
-    void open_with(const tradeboy::model::SpotRow& row, Side in_side, double in_max_possible);
+    // estimate_fill_px is passed through to the modal (see NumberInputConfig).
+    void open_with(const tradeboy::model::SpotRow& row,
+                   Side in_side,
+                   double in_max_possible,
+                   std::function<bool(double, double&)> estimate_fill_px = nullptr);
     void close();
     
     tradeboy::ui::NumberInputResult get_result() const { return input_state.result; }
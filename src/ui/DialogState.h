@@ -58,6 +58,11 @@ struct DialogState {
         }
     }
 
+    // An open/close animation or a button flash still needs frames.
+    bool animating() const {
+        return open && (closing || open_frames < 18 || flash_frames > 0);
+    }
+
     bool tick_open_anim() {
         if (!closing && open_frames < 18) {
             open_frames++;
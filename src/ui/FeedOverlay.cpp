@@ -0,0 +1,73 @@
+#include "FeedOverlay.h"
+
+#include <cstdio>
+
+#include "MatrixTheme.h"
+
+namespace tradeboy::ui {
+
+using tradeboy::market::Feed;
+using tradeboy::market::FeedStage;
+
+static void stage_text(const tradeboy::market::LatencyHistogram& h, char* out, size_t cap) {
+    if (h.count() == 0) {
+        std::snprintf(out, cap, "-");
+        return;
+    }
+    char p50[12];
+    char p99[12];
+    tradeboy::market::format_latency_us(h.percentile_us(0.50), p50, sizeof(p50));
+    tradeboy::market::format_latency_us(h.percentile_us(0.99), p99, sizeof(p99));
+    std::snprintf(out, cap, "%s/%s", p50, p99);
+}
+
+void render_feed_overlay(ImDrawList* dl, const tradeboy::market::FeedStats& st, const ImVec2& p0, float width) {
+    if (!dl) return;
+    ImFont* f = ImGui::GetFont();
+    const float fs = 16.0f;
+    const float line_h = 18.0f;
+    const int rows = tradeboy::market::kFeedCount + 1;
+    const float pad = 6.0f;
+
+    dl->AddRectFilled(p0, ImVec2(p0.x + width, p0.y + pad * 2.0f + line_h * (float)rows), IM_COL32(0, 0, 0, 220));
+    dl->AddRect(p0, ImVec2(p0.x + width, p0.y + pad * 2.0f + line_h * (float)rows), MatrixTheme::DIM);
+
+    float y = p0.y + pad;
+    char line[160];
+    std::snprintf(line, sizeof(line), "%-7s %6s %13s %13s %13s %13s", "FEED", "AGE", "PARSE", "PUBLISH", "FRAME", "E2E");
+    dl->AddText(f, fs, ImVec2(p0.x + pad, y), MatrixTheme::DIM, line);
+    y += line_h;
+
+    const long long now = tradeboy::market::feed_now_us();
+    for (int i = 0; i < tradeboy::market::kFeedCount; i++) {
+        const Feed feed = (Feed)i;
+        const long long age = st.age_ms(feed, now);
+        char age_s[16];
+        if (age < 0) std::snprintf(age_s, sizeof(age_s), "-");
+        else tradeboy::market::format_latency_us(age * 1000LL, age_s, sizeof(age_s));
+
+        char parse[24];
+        char pub[24];
+        char frame[24];
+        char e2e[24];
+        stage_text(st.hist(feed, FeedStage::Parse), parse, sizeof(parse));
+        if (tradeboy::market::feed_publishes(feed)) {
+            stage_text(st.hist(feed, FeedStage::Publish), pub, sizeof(pub));
+            stage_text(st.hist(feed, FeedStage::Frame), frame, sizeof(frame));
+            stage_text(st.hist(feed, FeedStage::EndToEnd), e2e, sizeof(e2e));
+        } else {
+            std::snprintf(pub, sizeof(pub), "n/a");
+            std::snprintf(frame, sizeof(frame), "n/a");
+            std::snprintf(e2e, sizeof(e2e), "n/a");
+        }
+        std::snprintf(line, sizeof(line), "%-7s %6s %13s %13s %13s %13s", tradeboy::market::feed_name(feed), age_s, parse, pub, frame, e2e);
+
+        ImU32 col = MatrixTheme::TEXT;
+        if (age < 0) col = MatrixTheme::DIM;
+        else if (st.stale(feed, now)) col = MatrixTheme::ALERT;
+        dl->AddText(f, fs, ImVec2(p0.x + pad, y), col, line);
+        y += line_h;
+    }
+}
+
+} // namespace tradeboy::ui
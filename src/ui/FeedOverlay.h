@@ -0,0 +1,13 @@
+#pragma once
+
+#include "imgui.h"
+
+#include "../market/FeedStats.h"
+
+namespace tradeboy::ui {
+
+// Debug overlay (L2): per-feed age and p50/p99 of each latency stage, drawn
+// over whatever screen is up. Stale feeds are shown in the alert colour.
+void render_feed_overlay(ImDrawList* dl, const tradeboy::market::FeedStats& st, const ImVec2& p0, float width);
+
+} // namespace tradeboy::ui
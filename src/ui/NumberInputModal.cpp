@@ -137,6 +137,12 @@ float NumberInputState::get_open_t() const {
     }
 }
 
+bool NumberInputState::animating() const {
+    if (!open) return false;
+    return closing || open_frames < 18 || flash_timer > 0 || l1_flash_timer > 0 || r1_flash_timer > 0 ||
+           b_flash_timer > 0 || out_of_range_dialog.animating();
+}
+
 bool NumberInputState::tick_open_anim() {
     if (!closing && open_frames < 18) {
         open_frames++;
@@ -447,8 +453,8 @@ void render(NumberInputState& st, ImFont* font_bold) {
     }
 
     {
-        const bool blink_on = (std::fmod(ImGui::GetTime(), 1.0) < 0.5);
-        if (blink_on) {
+        const bool cursor_on = tradeboy::utils::blink_on_time(ImGui::GetTime(), 2.0);
+        if (cursor_on) {
             float cx = in_x + in_sz.x + 2.0f;
             float cy = in_y;
             if (font_bold) {
@@ -460,11 +466,24 @@ void render(NumberInputState& st, ImFont* font_bold) {
     }
 
     double cur = parse_amount(st.input);
+    double fill_px = 0.0;
+    const bool have_fill = (cur > 0.0 && st.config.estimate_fill_px && st.config.estimate_fill_px(cur, fill_px) && fill_px > 0.0);
+    if (have_fill) {
+        char fill_label[64];
+        std::snprintf(fill_label, sizeof(fill_label), "AVG FILL: $%.6g", fill_px);
+        dl->AddText(ImVec2(left_x + 8.0f, input_y + 4.0f + ImGui::GetTextLineHeight()), dim, fill_label);
+    }
     if (st.config.price > 0.0) {
         char approx_usd[96];
-        std::snprintf(approx_usd, sizeof(approx_usd), "\xE2\x89\x88 $%.2f USD", cur * st.config.price);
+        std::snprintf(approx_usd, sizeof(approx_usd), "\xE2\x89\x88 $%.2f USD", cur * (have_fill ? fill_px : st.config.price));
         dl->AddText(ImVec2(left_x + left_w - input_pad - ImGui::CalcTextSize(approx_usd).x, input_y + input_h - 28.0f), dim, approx_usd);
     }
+    if (st.config.flow_text && st.config.flow_text[0]) {
+        const float flow_font = 16.0f;
+        ImFont* f = ImGui::GetFont();
+        ImVec2 f_sz = f->CalcTextSizeA(flow_font, FLT_MAX, 0.0f, st.config.flow_text);
+        dl->AddText(f, flow_font, ImVec2(left_x + 8.0f, input_y + input_h - 6.0f - f_sz.y), dim, st.config.flow_text);
+    }
 
     // Left: keypad grid
     float keypad_gap = 8.0f;
@@ -39,6 +39,14 @@ struct NumberInputConfig {
     
     std::string price_label;      // e.g. "PRICE: $87482.75"
     double price = 0.0;           // For USD approximation display
+
+    // Optional: expected average fill price for an amount (e.g. VWAP from the
+    // live order book). Returns false when no estimate is available.
+    std::function<bool(double amount, double& out_avg_px)> estimate_fill_px;
+
+    // Optional live status line (e.g. recent trade flow). Not owned; the
+    // caller keeps the buffer alive and may rewrite it while the modal is open.
+    const char* flow_text = nullptr;
     
     bool show_available_panel = true;
 };
@@ -78,6 +86,8 @@ struct NumberInputState {
     void close_with_result(NumberInputResult res, double value);
 
     float get_open_t() const;
+    // An open/close animation or a flash still needs frames.
+    bool animating() const;
     bool tick_open_anim();
     bool tick_close_anim(int close_dur = 18);
     
@@ -0,0 +1,57 @@
+#include "Sparkline.h"
+
+namespace tradeboy::ui {
+
+static const int kMaxSparkCols = 256;
+
+void render_candle_sparkline(ImDrawList* dl,
+                             const tradeboy::model::CandleRing& ring,
+                             const ImVec2& p0,
+                             const ImVec2& p1,
+                             ImU32 col) {
+    if (!dl) return;
+    const int n = ring.size();
+    const int w = (int)(p1.x - p0.x);
+    const float h = p1.y - p0.y;
+    if (n < 2 || w < 2 || h <= 1.0f) return;
+
+    float lo = ring.at(0).l;
+    float hi = ring.at(0).h;
+    for (int i = 1; i < n; i++) {
+        const tradeboy::model::Candle& c = ring.at(i);
+        if (c.l < lo) lo = c.l;
+        if (c.h > hi) hi = c.h;
+    }
+    const float span = hi - lo;
+    const float mid_y = p0.y + h * 0.5f;
+
+    int cols = n < w ? n : w;
+    if (cols > kMaxSparkCols) cols = kMaxSparkCols;
+
+    ImVec2 pts[kMaxSparkCols];
+    for (int c = 0; c < cols; c++) {
+        const int i0 = (int)((long long)c * n / cols);
+        const int i1 = (int)((long long)(c + 1) * n / cols);
+        float c_lo = ring.at(i0).l;
+        float c_hi = ring.at(i0).h;
+        for (int i = i0 + 1; i < i1; i++) {
+            const tradeboy::model::Candle& k = ring.at(i);
+            if (k.l < c_lo) c_lo = k.l;
+            if (k.h > c_hi) c_hi = k.h;
+        }
+        const float close = ring.at(i1 - 1).c;
+
+        const float x = p0.x + (float)c * (float)(w - 1) / (float)(cols - 1);
+        if (span > 0.0f) {
+            pts[c] = ImVec2(x, p1.y - (close - lo) / span * h);
+            if (i1 - i0 > 1 && c_hi > c_lo) {
+                dl->AddLine(ImVec2(x, p1.y - (c_hi - lo) / span * h), ImVec2(x, p1.y - (c_lo - lo) / span * h), col, 1.0f);
+            }
+        } else {
+            pts[c] = ImVec2(x, mid_y);
+        }
+    }
+    dl->AddPolyline(pts, cols, col, 0, 2.0f);
+}
+
+} // namespace tradeboy::ui
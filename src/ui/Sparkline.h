@@ -0,0 +1,17 @@
+#pragma once
+
+#include "imgui.h"
+
+#include "../model/Candles.h"
+
+namespace tradeboy::ui {
+
+// Close-price line over the ring, read in place. When there are more candles
+// than pixels, each column folds its candles into one point plus a low/high tick.
+void render_candle_sparkline(ImDrawList* dl,
+                             const tradeboy::model::CandleRing& ring,
+                             const ImVec2& p0,
+                             const ImVec2& p1,
+                             ImU32 col);
+
+} // namespace tradeboy::ui
@@ -0,0 +1,48 @@
+#include "TextCache.h"
+
+#include <cfloat>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+namespace tradeboy::ui {
+
+void CachedText::format(ImFont* font, float font_size, const char* fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    std::vsnprintf(text, sizeof(text), fmt, ap);
+    va_end(ap);
+    valid = true;
+    measure(font, font_size);
+}
+
+void CachedText::set(ImFont* font, float font_size, const char* s) {
+    if (valid && std::strncmp(text, s, sizeof(text) - 1) == 0) {
+        fit(font, font_size);
+        return;
+    }
+    std::snprintf(text, sizeof(text), "%s", s);
+    valid = true;
+    measure(font, font_size);
+}
+
+const ImVec2& CachedText::fit(ImFont* font, float font_size) {
+    const ImFont* f = font ? font : ImGui::GetFont();
+    const float fs = font ? font_size : ImGui::GetFontSize();
+    if (f != measured_font_ || fs != measured_size_) measure(font, font_size);
+    return size;
+}
+
+void CachedText::measure(ImFont* font, float font_size) {
+    if (font) {
+        size = font->CalcTextSizeA(font_size, FLT_MAX, 0.0f, text);
+        measured_font_ = font;
+        measured_size_ = font_size;
+    } else {
+        size = ImGui::CalcTextSize(text);
+        measured_font_ = ImGui::GetFont();
+        measured_size_ = ImGui::GetFontSize();
+    }
+}
+
+} // namespace tradeboy::ui
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "imgui.h"
+
+namespace tradeboy::ui {
+
+// A formatted string and its measured size, kept across frames. The owner
+// compares its inputs against what it last formatted and calls format() only
+// when they moved; fit() remeasures only when the font or size changed, so a
+// steady frame neither formats nor measures.
+struct CachedText {
+    char text[48] = {0};
+    ImVec2 size = ImVec2(0, 0);
+    bool valid = false;
+
+    // font == nullptr measures with the current ImGui font, like CalcTextSize.
+    void format(ImFont* font, float font_size, const char* fmt, ...) IM_FMTARGS(4);
+    void set(ImFont* font, float font_size, const char* s);
+    const ImVec2& fit(ImFont* font, float font_size);
+
+private:
+    void measure(ImFont* font, float font_size);
+
+    const ImFont* measured_font_ = nullptr;
+    float measured_size_ = 0.0f;
+};
+
+} // namespace tradeboy::ui
@@ -1,12 +1,19 @@
 #pragma once
 
+#include <cmath>
+
+#include "FrameSchedule.h"
+
 namespace tradeboy::utils {
 
 inline bool blink_on(int frames, int period = 6, int on = 3) {
     return (frames > 0) && ((frames % period) < on);
 }
 
+// Also schedules a redraw for the next toggle, so a blinking cursor keeps
+// the idle loop ticking at `hz` instead of vsync.
 inline bool blink_on_time(double now_time, double hz = 3.0) {
+    request_frame_at((std::floor(now_time * hz) + 1.0) / hz);
     return (((int)(now_time * hz)) % 2) == 0;
 }
 
@@ -0,0 +1,34 @@
+#include "FrameSchedule.h"
+
+#include <atomic>
+
+namespace tradeboy::utils {
+
+static double g_deadline = -1.0; // UI thread only
+static std::atomic<void (*)()> g_wake_hook{nullptr};
+
+void request_frame() {
+    g_deadline = 0.0;
+}
+
+void request_frame_at(double t) {
+    if (t < 0.0) t = 0.0;
+    if (g_deadline < 0.0 || t < g_deadline) g_deadline = t;
+}
+
+double take_frame_deadline() {
+    const double t = g_deadline;
+    g_deadline = -1.0;
+    return t;
+}
+
+void wake_frame_loop() {
+    void (*fn)() = g_wake_hook.load(std::memory_order_acquire);
+    if (fn) fn();
+}
+
+void set_frame_wake_hook(void (*fn)()) {
+    g_wake_hook.store(fn, std::memory_order_release);
+}
+
+} // namespace tradeboy::utils
@@ -0,0 +1,22 @@
+#pragma once
+
+namespace tradeboy::utils {
+
+// Redraw scheduling for the main loop. Render code declares when the screen
+// will next look different; main sleeps until the earliest declaration, new
+// input, or a wake from another thread. Times are ImGui::GetTime() seconds.
+
+// UI thread, while drawing. request_frame() is for frame-counted effects
+// (flashes, open/close animations) that need the very next vsync.
+void request_frame();
+void request_frame_at(double t);
+
+// Earliest request since the last call, or -1 when nothing asked. Clears.
+double take_frame_deadline();
+
+// Any thread: something not tracked by TradeModel versions (trade tape,
+// action results) is ready to be drawn. No-op until main installs the hook.
+void wake_frame_loop();
+void set_frame_wake_hook(void (*fn)());
+
+} // namespace tradeboy::utils
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdlib>
+#include <cstring>
+
+namespace tradeboy::utils {
+
+// Minimal forward scanner over raw JSON bytes. Used on hot WS channels so a
+// frame can be consumed without building a picojson tree. Strings are
+// returned as pointer/length into the buffer (escapes are not decoded).
+struct JsonScan {
+    const char* p = nullptr;
+    const char* end = nullptr;
+
+    JsonScan(const char* s, size_t n) : p(s), end(s + n) {}
+
+    void ws() {
+        while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) p++;
+    }
+    bool eat(char c) {
+        ws();
+        if (p < end && *p == c) {
+            p++;
+            return true;
+        }
+        return false;
+    }
+    bool peek(char c) {
+        ws();
+        return p < end && *p == c;
+    }
+    bool str(const char*& out_s, size_t& out_n) {
+        if (!eat('"')) return false;
+        const char* s = p;
+        while (p < end && *p != '"') {
+            if (*p == '\\') p++;
+            p++;
+        }
+        if (p >= end) return false;
+        out_s = s;
+        out_n = (size_t)(p - s);
+        p++;
+        return true;
+    }
+    // Number either bare or quoted ("px":"23.1").
+    bool number(double& out) {
+        ws();
+        const bool quoted = (p < end && *p == '"');
+        if (quoted) p++;
+        char buf[48];
+        size_t n = 0;
+        while (p < end && n + 1 < sizeof(buf) && ((*p >= '0' && *p <= '9') || *p == '.' || *p == '-' || *p == '+' || *p == 'e' || *p == 'E')) {
+            buf[n++] = *p++;
+        }
+        buf[n] = 0;
+        if (quoted) {
+            if (p >= end || *p != '"') return false;
+            p++;
+        }
+        if (n == 0) return false;
+        out = std::strtod(buf, nullptr);
+        return true;
+    }
+    // Skips any JSON value (used for unknown keys).
+    bool skip_value() {
+        ws();
+        if (p >= end) return false;
+        if (*p == '"') {
+            const char* s;
+            size_t n;
+            return str(s, n);
+        }
+        if (*p == '{' || *p == '[') {
+            int depth = 0;
+            bool in_str = false;
+            while (p < end) {
+                char c = *p++;
+                if (in_str) {
+                    if (c == '\\') p++;
+                    else if (c == '"') in_str = false;
+                    continue;
+                }
+                if (c == '"') in_str = true;
+                else if (c == '{' || c == '[') depth++;
+                else if (c == '}' || c == ']') {
+                    depth--;
+                    if (depth == 0) return true;
+                }
+            }
+            return false;
+        }
+        while (p < end && *p != ',' && *p != '}' && *p != ']') p++;
+        return true;
+    }
+};
+
+inline bool json_key_is(const char* s, size_t n, const char* key) {
+    return std::strlen(key) == n && std::memcmp(s, key, n) == 0;
+}
+
+} // namespace tradeboy::utils
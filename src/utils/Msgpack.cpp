@@ -0,0 +1,92 @@
+#include "Msgpack.h"
+
+#include <cstring>
+
+namespace tradeboy::utils {
+
+MsgpackWriter::MsgpackWriter() {
+    buf_.reserve(256);
+}
+
+void MsgpackWriter::put_be(unsigned long long v, int nbytes) {
+    for (int i = nbytes - 1; i >= 0; i--) {
+        put((unsigned char)((v >> (8 * i)) & 0xFFu));
+    }
+}
+
+void MsgpackWriter::map(size_t n) {
+    if (n < 16) {
+        put((unsigned char)(0x80u | (unsigned int)n));
+    } else if (n <= 0xFFFFu) {
+        put(0xde);
+        put_be(n, 2);
+    } else {
+        put(0xdf);
+        put_be(n, 4);
+    }
+}
+
+void MsgpackWriter::array(size_t n) {
+    if (n < 16) {
+        put((unsigned char)(0x90u | (unsigned int)n));
+    } else if (n <= 0xFFFFu) {
+        put(0xdc);
+        put_be(n, 2);
+    } else {
+        put(0xdd);
+        put_be(n, 4);
+    }
+}
+
+void MsgpackWriter::str(const char* s, size_t len) {
+    if (len < 32) {
+        put((unsigned char)(0xa0u | (unsigned int)len));
+    } else if (len <= 0xFFu) {
+        put(0xd9);
+        put_be(len, 1);
+    } else if (len <= 0xFFFFu) {
+        put(0xda);
+        put_be(len, 2);
+    } else {
+        put(0xdb);
+        put_be(len, 4);
+    }
+    raw((const unsigned char*)s, len);
+}
+
+void MsgpackWriter::str(const char* s) {
+    str(s, s ? std::strlen(s) : 0);
+}
+
+void MsgpackWriter::u64(unsigned long long v) {
+    if (v < 0x80u) {
+        put((unsigned char)v);
+    } else if (v <= 0xFFu) {
+        put(0xcc);
+        put_be(v, 1);
+    } else if (v <= 0xFFFFu) {
+        put(0xcd);
+        put_be(v, 2);
+    } else if (v <= 0xFFFFFFFFull) {
+        put(0xce);
+        put_be(v, 4);
+    } else {
+        put(0xcf);
+        put_be(v, 8);
+    }
+}
+
+void MsgpackWriter::boolean(bool v) {
+    put(v ? 0xc3 : 0xc2);
+}
+
+void MsgpackWriter::nil() {
+    put(0xc0);
+}
+
+void MsgpackWriter::raw(const unsigned char* p, size_t n) {
+    if (n == 0) return;
+    buf_.insert(buf_.end(), p, p + n);
+}
+
+} // namespace tradeboy::utils
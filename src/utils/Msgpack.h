@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace tradeboy::utils {
+
+// Minimal msgpack encoder for Hyperliquid L1 actions.
+// The buffer keeps its capacity across reset(), so once warmed up, encoding an
+// action does not touch the heap. Integers and strings use the smallest wire
+// form, matching python msgpack.packb (what the exchange hashes against).
+struct MsgpackWriter {
+    MsgpackWriter();
+
+    void reset() { buf_.clear(); }
+    void reserve(size_t n) { buf_.reserve(n); }
+
+    const unsigned char* data() const { return buf_.data(); }
+    size_t size() const { return buf_.size(); }
+
+    void map(size_t n);
+    void array(size_t n);
+    void str(const char* s, size_t len);
+    void str(const char* s);
+    void str(const std::string& s) { str(s.data(), s.size()); }
+    void u64(unsigned long long v);
+    void boolean(bool v);
+    void nil();
+    void raw(const unsigned char* p, size_t n);
+
+private:
+    void put(unsigned char b) { buf_.push_back(b); }
+    void put_be(unsigned long long v, int nbytes);
+
+    std::vector<unsigned char> buf_;
+};
+
+} // namespace tradeboy::utils
@@ -1,21 +1,66 @@
 #include "Process.h"
 
-#include <cstdio>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "core/Cancel.h"
+
+extern char** environ;
 
 namespace tradeboy::utils {
 
 bool run_cmd_capture(const std::string& cmd, std::string& out) {
     out.clear();
-    FILE* p = popen(cmd.c_str(), "r");
-    if (!p) return false;
+    int pfd[2];
+    if (pipe2(pfd, O_CLOEXEC) != 0) return false;
+
+    posix_spawn_file_actions_t fa;
+    posix_spawn_file_actions_init(&fa);
+    posix_spawn_file_actions_adddup2(&fa, pfd[1], STDOUT_FILENO);
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    // Own process group, so a cancel takes down whatever sh started too.
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP);
+    posix_spawnattr_setpgroup(&attr, 0);
+
+    pid_t pid = -1;
+    const char* argv[] = {"sh", "-c", cmd.c_str(), nullptr};
+    const int rc = posix_spawn(&pid, "/bin/sh", &fa, &attr, (char* const*)argv, environ);
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&fa);
+    close(pfd[1]);
+    if (rc != 0) {
+        close(pfd[0]);
+        return false;
+    }
+
+    bool cancelled = false;
     char buf[4096];
     while (true) {
-        size_t n = fread(buf, 1, sizeof(buf), p);
-        if (n > 0) out.append(buf, n);
-        if (n < sizeof(buf)) break;
+        if (tradeboy::core::wait_readable(pfd[0], -1) < 0) {
+            cancelled = true;
+            break;
+        }
+        const ssize_t n = read(pfd[0], buf, sizeof(buf));
+        if (n > 0) {
+            out.append(buf, (size_t)n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        break;
+    }
+    close(pfd[0]);
+
+    if (cancelled) kill(-pid, SIGKILL);
+    int st = 0;
+    while (waitpid(pid, &st, 0) < 0 && errno == EINTR) {
     }
-    int rc = pclose(p);
-    return rc == 0;
+    return !cancelled && WIFEXITED(st) && WEXITSTATUS(st) == 0;
 }
 
 } // namespace tradeboy::utils
@@ -4,6 +4,8 @@
 
 namespace tradeboy::utils {
 
+// Runs `sh -c cmd` and collects its stdout. Honors the thread's
+// core::current_cancel(): a cancel kills the child at once and returns false.
 bool run_cmd_capture(const std::string& cmd, std::string& out);
 
 } // namespace tradeboy::utils
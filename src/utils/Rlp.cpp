@@ -0,0 +1,91 @@
+#include "Rlp.h"
+
+#include <cstring>
+
+namespace tradeboy::utils {
+
+static int be_len_u64(unsigned long long v) {
+    int n = 0;
+    while (v > 0) {
+        n++;
+        v >>= 8;
+    }
+    return n;
+}
+
+static size_t header_len(size_t len) {
+    return (len <= 55) ? 1 : (size_t)(1 + be_len_u64((unsigned long long)len));
+}
+
+size_t rlp_len_bytes(const unsigned char* data, size_t n) {
+    if (n == 1 && data[0] < 0x80) return 1;
+    return header_len(n) + n;
+}
+
+size_t rlp_len_u64(unsigned long long v) {
+    if (v < 0x80) return 1; // includes zero (0x80)
+    return 1 + (size_t)be_len_u64(v);
+}
+
+size_t rlp_len_u256(const unsigned char be32[32]) {
+    size_t i = 0;
+    while (i < 32 && be32[i] == 0) i++;
+    return rlp_len_bytes(be32 + i, 32 - i);
+}
+
+size_t rlp_len_list(size_t payload_len) {
+    return header_len(payload_len) + payload_len;
+}
+
+void RlpWriter::put_n(const unsigned char* p, size_t n) {
+    if (n == 0) return;
+    if (n > cap_ - n_) {
+        overflow_ = true;
+        n_ = cap_;
+        return;
+    }
+    std::memcpy(buf_ + n_, p, n);
+    n_ += n;
+}
+
+void RlpWriter::header(unsigned char short_base, unsigned char long_base, size_t len) {
+    if (len <= 55) {
+        put((unsigned char)(short_base + len));
+        return;
+    }
+    const int nb = be_len_u64((unsigned long long)len);
+    put((unsigned char)(long_base + nb));
+    for (int i = nb - 1; i >= 0; i--) {
+        put((unsigned char)((len >> (8 * i)) & 0xFF));
+    }
+}
+
+void RlpWriter::bytes(const unsigned char* data, size_t n) {
+    if (n == 1 && data[0] < 0x80) {
+        put(data[0]);
+        return;
+    }
+    header(0x80, 0xB7, n);
+    put_n(data, n);
+}
+
+void RlpWriter::u64(unsigned long long v) {
+    unsigned char be[8];
+    const int nb = be_len_u64(v);
+    for (int i = 0; i < nb; i++) {
+        be[i] = (unsigned char)((v >> (8 * (nb - 1 - i))) & 0xFF);
+    }
+    bytes(be, (size_t)nb);
+}
+
+void RlpWriter::u256(const unsigned char be32[32]) {
+    size_t i = 0;
+    while (i < 32 && be32[i] == 0) i++;
+    bytes(be32 + i, 32 - i);
+}
+
+void RlpWriter::list(size_t payload_len) {
+    header(0xC0, 0xF7, payload_len);
+}
+
+} // namespace tradeboy::utils
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+
+namespace tradeboy::utils {
+
+// RLP encoder that writes into a caller-owned buffer.
+// Lengths are computed up front with the rlp_len_* helpers (pure arithmetic),
+// so a list header is written once, before its payload, and nothing is
+// encoded twice or copied through temporaries. Writing past the capacity sets
+// overflow() instead of touching memory.
+//
+// Integers are big-endian with leading zeros stripped; zero is the empty string.
+
+size_t rlp_len_bytes(const unsigned char* data, size_t n);
+size_t rlp_len_u64(unsigned long long v);
+size_t rlp_len_u256(const unsigned char be32[32]);
+size_t rlp_len_list(size_t payload_len);
+
+struct RlpWriter {
+    RlpWriter(unsigned char* buf, size_t cap) : buf_(buf), cap_(cap) {}
+
+    size_t size() const { return n_; }
+    bool overflow() const { return overflow_; }
+
+    void bytes(const unsigned char* data, size_t n);
+    void u64(unsigned long long v);
+    void u256(const unsigned char be32[32]);
+    // Header only; the caller then writes exactly payload_len bytes of items.
+    void list(size_t payload_len);
+    void raw_byte(unsigned char b) { put(b); }
+
+private:
+    void put(unsigned char b) {
+        if (n_ < cap_) buf_[n_++] = b;
+        else overflow_ = true;
+    }
+    void put_n(const unsigned char* p, size_t n);
+    void header(unsigned char short_base, unsigned char long_base, size_t len);
+
+    unsigned char* buf_ = nullptr;
+    size_t cap_ = 0;
+    size_t n_ = 0;
+    bool overflow_ = false;
+};
+
+} // namespace tradeboy::utils
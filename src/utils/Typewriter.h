@@ -2,6 +2,8 @@
 
 #include <string>
 
+#include "FrameSchedule.h"
+
 namespace tradeboy::utils {
 
 struct TypewriterState {
@@ -9,7 +11,9 @@ struct TypewriterState {
     double start_time = 0.0;
 };
 
-inline std::string typewriter_shown(TypewriterState& st, const std::string& full_text, double now_time, double chars_per_sec = 35.0) {
+// Number of leading chars of full_text to show; draw them in place to avoid
+// copying the prefix every frame.
+inline size_t typewriter_shown_len(TypewriterState& st, const std::string& full_text, double now_time, double chars_per_sec = 35.0) {
     if (full_text != st.last_text) {
         st.last_text = full_text;
         st.start_time = now_time;
@@ -18,7 +22,12 @@ inline std::string typewriter_shown(TypewriterState& st, const std::string& full
     int shown = (int)((now_time - st.start_time) * chars_per_sec);
     if (shown < 0) shown = 0;
     if (shown > (int)full_text.size()) shown = (int)full_text.size();
-    return full_text.substr(0, (size_t)shown);
+    if (shown < (int)full_text.size()) request_frame_at(st.start_time + (double)(shown + 1) / chars_per_sec);
+    return (size_t)shown;
+}
+
+inline std::string typewriter_shown(TypewriterState& st, const std::string& full_text, double now_time, double chars_per_sec = 35.0) {
+    return full_text.substr(0, typewriter_shown_len(st, full_text, now_time, chars_per_sec));
 }
 
 } // namespace tradeboy::utils
@@ -7,10 +7,15 @@
 #include "utils/Log.h"
 
 #include <algorithm>
+#include <cerrno>
 #include <cstdio>
 #include <sstream>
 #include <vector>
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 namespace tradeboy::wallet {
 
 static std::string trim_line(std::string s) {
@@ -39,6 +44,21 @@ static bool parse_kv(const std::string& text, const std::string& key, std::strin
     return false;
 }
 
+static void parse_kv_all(const std::string& text, const std::string& key, std::vector<std::string>& out_vals) {
+    std::istringstream ss(text);
+    std::string line;
+    while (std::getline(ss, line)) {
+        line = trim_line(line);
+        if (line.empty()) continue;
+        if (line[0] == '#') continue;
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) continue;
+        if (trim_line(line.substr(0, eq)) != key) continue;
+        std::string v = trim_line(line.substr(eq + 1));
+        if (!v.empty()) out_vals.push_back(v);
+    }
+}
+
 static std::string default_cfg_text(const std::string& rpc, const std::string& addr, const std::string& priv) {
     std::string s;
     s += "arb_rpc_url=" + rpc + "\n";
@@ -186,6 +206,10 @@ bool load_or_create_config(const std::string& path, WalletConfig& out_cfg, bool&
         parse_kv(text, "arb_rpc_url", out_cfg.arb_rpc_url);
         parse_kv(text, "wallet_address", out_cfg.wallet_address);
         parse_kv(text, "private_key", out_cfg.private_key);
+        parse_kv(text, "hl_exchange_url", out_cfg.hl_exchange_url);
+        parse_kv(text, "crt", out_cfg.crt_quality);
+        out_cfg.price_alerts.clear();
+        parse_kv_all(text, "alert", out_cfg.price_alerts);
 
         if (!out_cfg.arb_rpc_url.empty() && !out_cfg.wallet_address.empty() && !out_cfg.private_key.empty()) {
             return true;
@@ -218,4 +242,68 @@ bool load_or_create_config(const std::string& path, WalletConfig& out_cfg, bool&
     return true;
 }
 
+bool save_price_alerts(const std::string& path, const std::vector<std::string>& alerts, std::string& out_err) {
+    out_err.clear();
+    const std::string text = tradeboy::utils::read_text_file(path);
+    if (text.empty()) {
+        out_err = "read_cfg_failed";
+        return false;
+    }
+
+    std::string out;
+    std::istringstream ss(text);
+    std::string line;
+    while (std::getline(ss, line)) {
+        const std::string t = trim_line(line);
+        const size_t eq = t.find('=');
+        if (!t.empty() && t[0] != '#' && eq != std::string::npos && trim_line(t.substr(0, eq)) == "alert") continue;
+        out += line;
+        out += "\n";
+    }
+    for (const std::string& a : alerts) {
+        out += "alert=" + a + "\n";
+    }
+
+    // The config holds the private key: never truncate it in place, and make
+    // the new copy durable before it replaces the old one.
+    struct stat st;
+    const mode_t mode = (::stat(path.c_str(), &st) == 0) ? (st.st_mode & 0777) : 0600;
+    const std::string tmp = path + ".tmp";
+    const int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, mode);
+    if (fd < 0) {
+        out_err = "write_cfg_failed";
+        return false;
+    }
+    bool ok = true;
+    size_t off = 0;
+    while (ok && off < out.size()) {
+        const ssize_t w = ::write(fd, out.data() + off, out.size() - off);
+        if (w < 0 && errno == EINTR) continue;
+        ok = (w > 0);
+        if (ok) off += (size_t)w;
+    }
+    ok = (::fsync(fd) == 0) && ok;
+    ok = (::close(fd) == 0) && ok;
+    if (!ok) {
+        std::remove(tmp.c_str());
+        out_err = "write_cfg_failed";
+        return false;
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        out_err = "rename_cfg_failed";
+        return false;
+    }
+
+    // The rename itself only survives power loss once the directory is synced.
+    const size_t slash = path.rfind('/');
+    const std::string dir = (slash == std::string::npos) ? std::string(".") : (slash == 0 ? std::string("/") : path.substr(0, slash));
+    const int dfd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dfd >= 0) {
+        (void)::fsync(dfd);
+        ::close(dfd);
+    }
+    return true;
+}
+
 } // namespace tradeboy::wallet
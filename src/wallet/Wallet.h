@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 namespace tradeboy::wallet {
 
@@ -8,8 +9,14 @@ struct WalletConfig {
     std::string arb_rpc_url;
     std::string wallet_address; // 0x...
     std::string private_key;    // 0x...
+    std::string hl_exchange_url; // optional; empty = public Hyperliquid /exchange
+    std::string crt_quality;     // optional; "full" (default) | "reduced" | "off"
+    std::vector<std::string> price_alerts; // "alert=" lines, e.g. "BTC above 100000"
 };
 
 bool load_or_create_config(const std::string& path, WalletConfig& out_cfg, bool& out_created, std::string& out_err);
 
+// Rewrites the "alert=" lines of the config, keeping every other line.
+bool save_price_alerts(const std::string& path, const std::vector<std::string>& alerts, std::string& out_err);
+
 } // namespace tradeboy::wallet